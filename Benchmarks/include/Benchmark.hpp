@@ -0,0 +1,108 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "LinaGX/Common/CommonGfx.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LinaGX
+{
+    class Instance;
+}
+
+namespace LinaGX::Benchmarks
+{
+    struct BenchmarkResult
+    {
+        std::string name          = "";
+        uint64      opsPerIter    = 1; // Logical operations performed by one iteration, e.g. commands recorded.
+        uint64      iterations    = 0;
+        double      nsPerOpMin    = 0.0;
+        double      nsPerOpMedian = 0.0;
+        double      nsPerOpMean   = 0.0;
+        double      nsPerOpMax    = 0.0;
+    };
+
+    struct BenchmarkCase
+    {
+        std::string           name       = "";
+        uint64                opsPerIter = 1;
+        uint32                iterations = 100;
+        std::function<void()> setup      = nullptr; // Runs before each iteration, not timed.
+        std::function<void()> body       = nullptr; // Timed.
+        std::function<void()> teardown   = nullptr; // Runs after each iteration, not timed.
+    };
+
+    class BenchmarkRunner
+    {
+    public:
+        BenchmarkRunner(const std::string& filter, double iterationScale)
+            : m_filter(filter), m_iterationScale(iterationScale){};
+
+        /// <summary>
+        /// Runs the case if it passes the name filter, and records its timings.
+        /// </summary>
+        void Run(const BenchmarkCase& bench);
+
+        /// <summary>
+        /// Writes all collected results as a single JSON document. Writes to stdout if path is empty.
+        /// </summary>
+        bool WriteJSON(const std::string& path, const std::string& backendName) const;
+
+        inline const std::vector<BenchmarkResult>& GetResults() const
+        {
+            return m_results;
+        }
+
+    private:
+        std::vector<BenchmarkResult> m_results;
+        std::string                  m_filter         = "";
+        double                       m_iterationScale = 1.0;
+    };
+
+    /// <summary>
+    /// Absolute path to a file under Examples/, where all benchmark inputs live.
+    /// </summary>
+    std::string GetResourcePath(const char* relativePath);
+
+    /// <summary>
+    /// Expect an initialized instance, shader compilation relies on the compiler state set up by Instance::Initialize().
+    /// </summary>
+    void RunCommandBenchmarks(BenchmarkRunner& runner, Instance* lgx);
+    void RunUtilityBenchmarks(BenchmarkRunner& runner, Instance* lgx);
+
+} // namespace LinaGX::Benchmarks
@@ -0,0 +1,82 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "LinaGX/Common/CommonConfig.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LinaGX::Benchmarks
+{
+    /// <summary>
+    /// Minimal fork-join worker pool, used as Config.dispatchJobsCallback in the parallel benchmarks.
+    /// The calling thread takes part in the work, so a dispatcher with 0 workers runs everything serially.
+    /// </summary>
+    class JobDispatcher
+    {
+    public:
+        JobDispatcher(uint32 workerCount);
+        ~JobDispatcher();
+
+        void Dispatch(JobFunction job, void* userData, uint32 jobCount);
+
+        /// <summary>
+        /// Routes the calls to the dispatcher set with SetActive(), matches the signature of Config.dispatchJobsCallback.
+        /// </summary>
+        static void DispatchActive(JobFunction job, void* userData, uint32 jobCount);
+        static void SetActive(JobDispatcher* dispatcher);
+
+    private:
+        void Worker();
+        void RunJobs();
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::mutex               m_mtx;
+        std::condition_variable  m_cv;
+        std::condition_variable  m_doneCv;
+        JobFunction              m_job        = nullptr;
+        void*                    m_userData   = nullptr;
+        uint32                   m_jobCount   = 0;
+        uint64                   m_generation = 0;
+        uint32                   m_busy       = 0;
+        bool                     m_exit       = false;
+        std::atomic<uint32>      m_nextJob    = 0;
+    };
+
+} // namespace LinaGX::Benchmarks
@@ -0,0 +1,134 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace LinaGX::Benchmarks
+{
+    void BenchmarkRunner::Run(const BenchmarkCase& bench)
+    {
+        if (!m_filter.empty() && bench.name.find(m_filter) == std::string::npos)
+            return;
+
+        const uint32 iterations = std::max(1u, static_cast<uint32>(static_cast<double>(bench.iterations) * m_iterationScale));
+
+        auto runOnce = [&]() -> double {
+            if (bench.setup)
+                bench.setup();
+
+            const auto start = std::chrono::steady_clock::now();
+            bench.body();
+            const auto end = std::chrono::steady_clock::now();
+
+            if (bench.teardown)
+                bench.teardown();
+
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        };
+
+        // Warm caches and lazily grown containers before sampling.
+        runOnce();
+
+        std::vector<double> samples;
+        samples.reserve(iterations);
+
+        for (uint32 i = 0; i < iterations; i++)
+            samples.push_back(runOnce() / static_cast<double>(bench.opsPerIter));
+
+        std::sort(samples.begin(), samples.end());
+
+        double total = 0.0;
+        for (double s : samples)
+            total += s;
+
+        BenchmarkResult res = {};
+        res.name            = bench.name;
+        res.opsPerIter      = bench.opsPerIter;
+        res.iterations      = iterations;
+        res.nsPerOpMin      = samples.front();
+        res.nsPerOpMax      = samples.back();
+        res.nsPerOpMean     = total / static_cast<double>(samples.size());
+        res.nsPerOpMedian   = samples[samples.size() / 2];
+        m_results.push_back(res);
+
+        fprintf(stderr, "%-48s %12.1f ns/op (median, %u iterations)\n", res.name.c_str(), res.nsPerOpMedian, iterations);
+    }
+
+    bool BenchmarkRunner::WriteJSON(const std::string& path, const std::string& backendName) const
+    {
+        FILE* file = path.empty() ? stdout : fopen(path.c_str(), "w");
+
+        if (file == nullptr)
+        {
+            fprintf(stderr, "Benchmarks -> Failed opening %s for writing!\n", path.c_str());
+            return false;
+        }
+
+        fprintf(file, "{\n");
+        fprintf(file, "  \"version\": \"%d.%d.%d\",\n", LINAGX_VERSION_MAJOR, LINAGX_VERSION_MINOR, LINAGX_VERSION_PATCH);
+        fprintf(file, "  \"backend\": \"%s\",\n", backendName.c_str());
+        fprintf(file, "  \"benchmarks\": [\n");
+
+        for (size_t i = 0; i < m_results.size(); i++)
+        {
+            const BenchmarkResult& res = m_results[i];
+            fprintf(file, "    {\"name\": \"%s\", \"ops_per_iteration\": %llu, \"iterations\": %llu, \"ns_per_op_min\": %.3f, \"ns_per_op_median\": %.3f, \"ns_per_op_mean\": %.3f, \"ns_per_op_max\": %.3f}%s\n",
+                    res.name.c_str(),
+                    static_cast<unsigned long long>(res.opsPerIter),
+                    static_cast<unsigned long long>(res.iterations),
+                    res.nsPerOpMin,
+                    res.nsPerOpMedian,
+                    res.nsPerOpMean,
+                    res.nsPerOpMax,
+                    i == m_results.size() - 1 ? "" : ",");
+        }
+
+        fprintf(file, "  ]\n");
+        fprintf(file, "}\n");
+
+        if (file != stdout)
+            fclose(file);
+
+        return true;
+    }
+
+    std::string GetResourcePath(const char* relativePath)
+    {
+        return std::string(LINAGX_BENCHMARK_RESOURCES_DIR) + "/" + relativePath;
+    }
+
+} // namespace LinaGX::Benchmarks
@@ -0,0 +1,447 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "Benchmark.hpp"
+#include "JobDispatcher.hpp"
+#include "LinaGX/LinaGX.hpp"
+
+namespace LinaGX::Benchmarks
+{
+#define DRAWS_PER_STREAM  1000
+#define COMMANDS_PER_DRAW 4
+#define STREAM_COUNT      8
+#define HANDLE_POOL_ITEMS 10000
+
+    namespace
+    {
+        struct DrawConstants
+        {
+            uint32 materialIndex = 0;
+            uint32 objectIndex   = 0;
+        };
+
+        struct FrameResources
+        {
+            Instance*      lgx          = nullptr;
+            uint32         renderTarget = 0;
+            uint32         vertexBuffer = 0;
+            uint32         indexBuffer  = 0;
+            uint16         shader       = 0;
+            uint8          queue        = 0;
+            CommandStream* streams[STREAM_COUNT];
+            CommandStream* persistentStream = nullptr;
+        };
+
+        void RecordDraws(FrameResources& res, CommandStream* stream, uint32 drawCount)
+        {
+            // Shared by all constant bindings below.
+            ShaderStage* constantStages = stream->EmplaceInline<ShaderStage>(ShaderStage::Vertex, ShaderStage::Fragment);
+
+            for (uint32 i = 0; i < drawCount; i++)
+            {
+                CMDBindVertexBuffers* vtx = stream->AddCommand<CMDBindVertexBuffers>();
+                vtx->resource             = res.vertexBuffer;
+                vtx->vertexSize           = 32;
+
+                CMDBindIndexBuffers* idx = stream->AddCommand<CMDBindIndexBuffers>();
+                idx->resource            = res.indexBuffer;
+                idx->indexType           = IndexType::Uint32;
+
+                DrawConstants     constants = {i % 64, i};
+                CMDBindConstants* ct        = stream->AddCommand<CMDBindConstants>();
+                ct->data                    = stream->EmplaceInline<DrawConstants>(constants);
+                ct->size                    = sizeof(DrawConstants);
+                ct->stages                  = constantStages;
+                ct->stagesSize              = 2;
+
+                CMDDrawIndexedInstanced* draw = stream->AddCommand<CMDDrawIndexedInstanced>();
+                draw->indexCountPerInstance   = 36;
+                draw->instanceCount           = 1;
+            }
+        }
+
+        void RecordFrame(FrameResources& res, CommandStream* stream, uint32 drawCount)
+        {
+            CMDBeginRenderPass* begin          = stream->AddCommand<CMDBeginRenderPass>();
+            begin->colorAttachments            = stream->EmplaceInline<RenderPassColorAttachment>(RenderPassColorAttachment{});
+            begin->colorAttachments[0].texture = res.renderTarget;
+            begin->colorAttachmentCount        = 1;
+            begin->viewport                    = {0, 0, 1920, 1080, 0.0f, 1.0f};
+            begin->scissors                    = {0, 0, 1920, 1080};
+
+            CMDBindPipeline* pipeline = stream->AddCommand<CMDBindPipeline>();
+            pipeline->shader          = res.shader;
+
+            RecordDraws(res, stream, drawCount);
+            stream->AddCommand<CMDEndRenderPass>();
+        }
+
+        void SubmitStreams(FrameResources& res, CommandStream** streams, uint32 streamCount)
+        {
+            // Submission resets the streams so the next iteration starts from empty memory.
+            SubmitDesc submit           = {};
+            submit.targetQueue          = res.queue;
+            submit.streams              = streams;
+            submit.streamCount          = streamCount;
+            submit.standaloneSubmission = true;
+            res.lgx->SubmitCommandStreams(submit);
+        }
+
+        void SubmitStreams(FrameResources& res, uint32 streamCount)
+        {
+            SubmitStreams(res, res.streams, streamCount);
+        }
+
+        void CreateFrameResources(FrameResources& res)
+        {
+            TextureDesc rtDesc = {};
+            rtDesc.format      = Format::R8G8B8A8_UNORM;
+            rtDesc.flags       = TF_ColorAttachment;
+            rtDesc.width       = 1920;
+            rtDesc.height      = 1080;
+            rtDesc.debugName   = "Benchmark RT";
+            res.renderTarget   = res.lgx->CreateTexture(rtDesc);
+
+            ResourceDesc bufferDesc  = {};
+            bufferDesc.size          = 1024 * 1024;
+            bufferDesc.typeHintFlags = TH_VertexBuffer;
+            bufferDesc.heapType      = ResourceHeap::GPUOnly;
+            res.vertexBuffer         = res.lgx->CreateResource(bufferDesc);
+            bufferDesc.typeHintFlags = TH_IndexBuffer;
+            res.indexBuffer          = res.lgx->CreateResource(bufferDesc);
+
+            // The Null backend does not consume shader blobs, an empty description is enough to obtain a valid handle.
+            ShaderDesc shaderDesc = {};
+            res.shader            = res.lgx->CreateShader(shaderDesc);
+            res.queue             = res.lgx->GetPrimaryQueue(CommandType::Graphics);
+
+            CommandStreamDesc streamDesc = {};
+            streamDesc.type              = CommandType::Graphics;
+            streamDesc.commandCount      = DRAWS_PER_STREAM * COMMANDS_PER_DRAW + 16;
+            streamDesc.totalMemoryLimit  = 64 * 1024;
+            streamDesc.auxMemorySize     = 1024;
+            streamDesc.debugName         = "Benchmark Stream";
+
+            for (uint32 i = 0; i < STREAM_COUNT; i++)
+                res.streams[i] = res.lgx->CreateCommandStream(streamDesc);
+
+            streamDesc.persistent = true;
+            streamDesc.debugName  = "Benchmark Persistent Stream";
+            res.persistentStream  = res.lgx->CreateCommandStream(streamDesc);
+        }
+
+        void DestroyFrameResources(FrameResources& res)
+        {
+            for (uint32 i = 0; i < STREAM_COUNT; i++)
+                res.lgx->DestroyCommandStream(res.streams[i]);
+
+            res.lgx->DestroyCommandStream(res.persistentStream);
+
+            res.lgx->DestroyShader(res.shader);
+            res.lgx->DestroyResource(res.vertexBuffer);
+            res.lgx->DestroyResource(res.indexBuffer);
+            res.lgx->DestroyTexture(res.renderTarget);
+        }
+
+        struct HandlePoolItem
+        {
+            bool   isValid = false;
+            uint64 payload = 0;
+        };
+    } // namespace
+
+    void RunCommandBenchmarks(BenchmarkRunner& runner, Instance* lgx)
+    {
+        FrameResources res = {};
+        res.lgx            = lgx;
+        CreateFrameResources(res);
+
+        runner.Run({
+            .name       = "CommandStream/AddCommand/SetViewport",
+            .opsPerIter = DRAWS_PER_STREAM,
+            .iterations = 500,
+            .body =
+                [&]() {
+                    for (uint32 i = 0; i < DRAWS_PER_STREAM; i++)
+                    {
+                        CMDSetViewport* vp = res.streams[0]->AddCommand<CMDSetViewport>();
+                        vp->width          = 1920;
+                        vp->height         = 1080;
+                    }
+                },
+            .teardown = [&]() { SubmitStreams(res, 1); },
+        });
+
+        runner.Run({
+            .name       = "CommandStream/AddCommand/IndexedDraw",
+            .opsPerIter = DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 500,
+            .body       = [&]() { RecordDraws(res, res.streams[0], DRAWS_PER_STREAM); },
+            .teardown   = [&]() { SubmitStreams(res, 1); },
+        });
+
+        runner.Run({
+            .name       = "CommandStream/CloseCommandStreams/1Stream",
+            .opsPerIter = DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 500,
+            .setup      = [&]() { RecordFrame(res, res.streams[0], DRAWS_PER_STREAM); },
+            .body       = [&]() { res.lgx->CloseCommandStreams(res.streams, 1); },
+            .teardown   = [&]() { SubmitStreams(res, 1); },
+        });
+
+        // Same frame recorded once, every iteration only closes and submits it again.
+        RecordFrame(res, res.persistentStream, DRAWS_PER_STREAM);
+
+        runner.Run({
+            .name       = "CommandStream/CloseCommandStreams/1StreamPersistent",
+            .opsPerIter = DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 500,
+            .body       = [&]() { res.lgx->CloseCommandStreams(&res.persistentStream, 1); },
+            .teardown   = [&]() { SubmitStreams(res, &res.persistentStream, 1); },
+        });
+
+        // Same frame, every draw re-binds the vertex and index buffer so most bindings are elided.
+        const uint64 prevElided         = PerformanceStats.elidedCommands.load();
+        Config.eliminateRedundantState = true;
+
+        runner.Run({
+            .name       = "CommandStream/CloseCommandStreams/1StreamEliminateRedundantState",
+            .opsPerIter = DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 500,
+            .setup      = [&]() { RecordFrame(res, res.streams[0], DRAWS_PER_STREAM); },
+            .body       = [&]() { res.lgx->CloseCommandStreams(res.streams, 1); },
+            .teardown   = [&]() { SubmitStreams(res, 1); },
+        });
+
+        Config.eliminateRedundantState = false;
+
+        if (!runner.GetResults().empty() && runner.GetResults().back().name == "CommandStream/CloseCommandStreams/1StreamEliminateRedundantState")
+            fprintf(stderr, "%-48s %12llu elided commands\n", "", static_cast<unsigned long long>(PerformanceStats.elidedCommands.load() - prevElided));
+
+        runner.Run({
+            .name       = "CommandStream/CloseCommandStreams/8Streams",
+            .opsPerIter = STREAM_COUNT * DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 100,
+            .setup =
+                [&]() {
+                    for (uint32 i = 0; i < STREAM_COUNT; i++)
+                        RecordFrame(res, res.streams[i], DRAWS_PER_STREAM);
+                },
+            .body     = [&]() { res.lgx->CloseCommandStreams(res.streams, STREAM_COUNT); },
+            .teardown = [&]() { SubmitStreams(res, STREAM_COUNT); },
+        });
+
+        const uint32  hardwareThreads = Max(std::thread::hardware_concurrency(), 1u);
+        JobDispatcher dispatcher(Min(hardwareThreads, static_cast<uint32>(STREAM_COUNT)) - 1);
+        JobDispatcher::SetActive(&dispatcher);
+        Config.dispatchJobsCallback = &JobDispatcher::DispatchActive;
+
+        runner.Run({
+            .name       = "CommandStream/CloseCommandStreams/8StreamsParallel",
+            .opsPerIter = STREAM_COUNT * DRAWS_PER_STREAM * COMMANDS_PER_DRAW,
+            .iterations = 100,
+            .setup =
+                [&]() {
+                    for (uint32 i = 0; i < STREAM_COUNT; i++)
+                        RecordFrame(res, res.streams[i], DRAWS_PER_STREAM);
+                },
+            .body     = [&]() { res.lgx->CloseCommandStreams(res.streams, STREAM_COUNT); },
+            .teardown = [&]() { SubmitStreams(res, STREAM_COUNT); },
+        });
+
+        Config.dispatchJobsCallback = nullptr;
+        JobDispatcher::SetActive(nullptr);
+
+        DestroyFrameResources(res);
+
+        HandlePool<uint32, HandlePoolItem> pool;
+        LINAGX_VEC<uint32>                 handles;
+        handles.reserve(HANDLE_POOL_ITEMS);
+
+        runner.Run({
+            .name       = "HandlePool/AddRemove/Sequential",
+            .opsPerIter = HANDLE_POOL_ITEMS * 2,
+            .iterations = 200,
+            .body =
+                [&]() {
+                    for (uint32 i = 0; i < HANDLE_POOL_ITEMS; i++)
+                        handles.push_back(pool.AddItem({true, i}));
+
+                    for (uint32 handle : handles)
+                        pool.RemoveItem(handle);
+                },
+            .teardown = [&]() { handles.clear(); },
+        });
+
+        // Steady-state churn: half the handles stay alive while the other half is recycled every iteration.
+        for (uint32 i = 0; i < HANDLE_POOL_ITEMS / 2; i++)
+            handles.push_back(pool.AddItem({true, i}));
+
+        runner.Run({
+            .name       = "HandlePool/AddRemove/Churn",
+            .opsPerIter = HANDLE_POOL_ITEMS,
+            .iterations = 200,
+            .body =
+                [&]() {
+                    for (uint32 i = 0; i < HANDLE_POOL_ITEMS / 2; i++)
+                    {
+                        const uint32 slot = (i * 7919) % handles.size();
+                        pool.RemoveItem(handles[slot]);
+                        handles[slot] = pool.AddItem({true, i});
+                    }
+                },
+        });
+
+        for (uint32 handle : handles)
+            pool.RemoveItem(handle);
+
+        // Same churn split across jobs, every job recycles its own handles without any locking.
+        {
+            const uint32                   hardwareThreads = Max(std::thread::hardware_concurrency(), 1u);
+            const uint32                   jobCount        = Min(hardwareThreads, static_cast<uint32>(STREAM_COUNT));
+            LINAGX_VEC<LINAGX_VEC<uint32>> jobHandles(jobCount);
+            JobDispatcher                  dispatcher(jobCount - 1);
+
+            struct ChurnJob
+            {
+                HandlePool<uint32, HandlePoolItem>* pool;
+                LINAGX_VEC<LINAGX_VEC<uint32>>*     handles;
+            };
+
+            ChurnJob job = {&pool, &jobHandles};
+
+            runner.Run({
+                .name       = "HandlePool/AddRemove/Concurrent",
+                .opsPerIter = HANDLE_POOL_ITEMS * 2,
+                .iterations = 200,
+                .body =
+                    [&]() {
+                        dispatcher.Dispatch(
+                            [](void* userData, uint32 jobIndex) {
+                                ChurnJob*           data    = static_cast<ChurnJob*>(userData);
+                                LINAGX_VEC<uint32>& handles = (*data->handles)[jobIndex];
+                                const uint32        count   = HANDLE_POOL_ITEMS / static_cast<uint32>(data->handles->size());
+
+                                for (uint32 i = 0; i < count; i++)
+                                    handles.push_back(data->pool->AddItem({true, i}));
+
+                                for (uint32 handle : handles)
+                                    data->pool->RemoveItem(handle);
+
+                                handles.clear();
+                            },
+                            &job, jobCount);
+                    },
+            });
+        }
+
+        // Streaming-style load with creation/deletion locking on: even jobs create textures, odd jobs map their own constant buffer.
+        // Neither should wait on the other, lock contentions are reported so regressions in lock granularity show up.
+        {
+            const uint32       hardwareThreads = Max(std::thread::hardware_concurrency(), 1u);
+            const uint32       jobCount        = Max(Min(hardwareThreads, static_cast<uint32>(STREAM_COUNT)), 2u);
+            LINAGX_VEC<uint32> constantBuffers(jobCount);
+            JobDispatcher      dispatcher(jobCount - 1);
+
+            ResourceDesc cbDesc  = {};
+            cbDesc.size          = 256;
+            cbDesc.typeHintFlags = TH_ConstantBuffer;
+            cbDesc.heapType      = ResourceHeap::StagingHeap;
+
+            for (uint32& cb : constantBuffers)
+                cb = lgx->CreateResource(cbDesc);
+
+            struct StreamingJob
+            {
+                Instance*           lgx;
+                LINAGX_VEC<uint32>* constantBuffers;
+            };
+
+            StreamingJob job       = {lgx, &constantBuffers};
+            const bool   prevLock  = Config.mutexLockCreationDeletion;
+            const uint64 prevCount = PerformanceStats.lockContentions.load();
+
+            Config.mutexLockCreationDeletion = true;
+
+            runner.Run({
+                .name       = "Instance/CreateTextureMapResource/Concurrent",
+                .opsPerIter = 256 * jobCount,
+                .iterations = 100,
+                .body =
+                    [&]() {
+                        dispatcher.Dispatch(
+                            [](void* userData, uint32 jobIndex) {
+                                StreamingJob* data = static_cast<StreamingJob*>(userData);
+
+                                if (jobIndex % 2 == 0)
+                                {
+                                    TextureDesc desc = {};
+                                    desc.format      = Format::R8G8B8A8_UNORM;
+                                    desc.width       = 256;
+                                    desc.height      = 256;
+                                    desc.debugName   = "Streamed Texture";
+
+                                    for (uint32 i = 0; i < 128; i++)
+                                        data->lgx->DestroyTexture(data->lgx->CreateTexture(desc));
+                                }
+                                else
+                                {
+                                    const uint32 cb = (*data->constantBuffers)[jobIndex];
+
+                                    for (uint32 i = 0; i < 256; i++)
+                                    {
+                                        uint8* ptr = nullptr;
+                                        data->lgx->MapResource(cb, ptr);
+                                        ptr[i] = static_cast<uint8>(i);
+                                        data->lgx->UnmapResource(cb);
+                                    }
+                                }
+                            },
+                            &job, jobCount);
+                    },
+            });
+
+            if (!runner.GetResults().empty() && runner.GetResults().back().name == "Instance/CreateTextureMapResource/Concurrent")
+                fprintf(stderr, "%-48s %12llu lock contentions\n", "", static_cast<unsigned long long>(PerformanceStats.lockContentions.load() - prevCount));
+            Config.mutexLockCreationDeletion = prevLock;
+
+            for (uint32 cb : constantBuffers)
+                lgx->DestroyResource(cb);
+
+            // Destruction is deferred, retire the streamed textures before the next benchmark.
+            lgx->Join();
+        }
+    }
+
+} // namespace LinaGX::Benchmarks
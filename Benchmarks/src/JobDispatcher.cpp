@@ -0,0 +1,125 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "JobDispatcher.hpp"
+
+namespace LinaGX::Benchmarks
+{
+    namespace
+    {
+        JobDispatcher* s_activeDispatcher = nullptr;
+    }
+
+    JobDispatcher::JobDispatcher(uint32 workerCount)
+    {
+        for (uint32 i = 0; i < workerCount; i++)
+            m_workers.emplace_back(&JobDispatcher::Worker, this);
+    }
+
+    JobDispatcher::~JobDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_exit = true;
+        }
+
+        m_cv.notify_all();
+
+        for (std::thread& worker : m_workers)
+            worker.join();
+    }
+
+    void JobDispatcher::Dispatch(JobFunction job, void* userData, uint32 jobCount)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_job      = job;
+            m_userData = userData;
+            m_jobCount = jobCount;
+            m_nextJob.store(0);
+            m_busy = static_cast<uint32>(m_workers.size());
+            m_generation++;
+        }
+
+        m_cv.notify_all();
+        RunJobs();
+
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_doneCv.wait(lock, [this]() { return m_busy == 0; });
+    }
+
+    void JobDispatcher::DispatchActive(JobFunction job, void* userData, uint32 jobCount)
+    {
+        s_activeDispatcher->Dispatch(job, userData, jobCount);
+    }
+
+    void JobDispatcher::SetActive(JobDispatcher* dispatcher)
+    {
+        s_activeDispatcher = dispatcher;
+    }
+
+    void JobDispatcher::Worker()
+    {
+        uint64 seenGeneration = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cv.wait(lock, [&]() { return m_exit || m_generation != seenGeneration; });
+
+                if (m_exit)
+                    return;
+
+                seenGeneration = m_generation;
+            }
+
+            RunJobs();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_busy--;
+            }
+
+            m_doneCv.notify_one();
+        }
+    }
+
+    void JobDispatcher::RunJobs()
+    {
+        for (uint32 i = m_nextJob.fetch_add(1); i < m_jobCount; i = m_nextJob.fetch_add(1))
+            m_job(m_userData, i);
+    }
+
+} // namespace LinaGX::Benchmarks
@@ -0,0 +1,119 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/*
+
+LinaGX Benchmarks
+
+Micro and macro benchmarks for the CPU-side hot paths: command recording and translation, handle bookkeeping,
+shader compilation, model loading and mip generation. Runs on the Null backend so it works on headless machines,
+results are written as JSON to track regressions per commit.
+
+Usage: LinaGXBenchmarks [--output results.json] [--filter name] [--scale 0.1]
+
+*/
+
+#include "Benchmark.hpp"
+#include "LinaGX/LinaGX.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace LinaGX::Benchmarks;
+
+namespace
+{
+    void LogError(const char* err, ...)
+    {
+        va_list args;
+        va_start(args, err);
+        fprintf(stderr, "LinaGX Error: ");
+        vfprintf(stderr, err, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+    }
+
+    void LogInfo(const char* info, ...)
+    {
+        va_list args;
+        va_start(args, info);
+        fprintf(stderr, "LinaGX Info: ");
+        vfprintf(stderr, info, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string outputPath     = "";
+    std::string filter         = "";
+    double      iterationScale = 1.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            iterationScale = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--output results.json] [--filter name] [--scale factor]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    LinaGX::Config.api           = LinaGX::BackendAPI::Null;
+    LinaGX::Config.logLevel      = LinaGX::LogLevel::OnlyErrors;
+    LinaGX::Config.errorCallback = LogError;
+    LinaGX::Config.infoCallback  = LogInfo;
+
+    LinaGX::Instance* lgx = new LinaGX::Instance();
+    if (!lgx->Initialize())
+    {
+        fprintf(stderr, "Benchmarks -> Failed initializing LinaGX!\n");
+        delete lgx;
+        return 1;
+    }
+
+    BenchmarkRunner runner(filter, iterationScale);
+    RunUtilityBenchmarks(runner, lgx);
+    RunCommandBenchmarks(runner, lgx);
+    delete lgx;
+
+    return runner.WriteJSON(outputPath, "Null") ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "Benchmark.hpp"
+#include "JobDispatcher.hpp"
+#include "LinaGX/LinaGX.hpp"
+#include "LinaGX/Utility/PlatformUtility.hpp"
+#include "LinaGX/Utility/ImageUtility.hpp"
+#include "LinaGX/Utility/ModelUtility.hpp"
+#include "LinaGX/Utility/ShaderCache.hpp"
+
+namespace LinaGX::Benchmarks
+{
+    namespace
+    {
+        struct ShaderCase
+        {
+            const char* name;
+            ShaderStage stage;
+            const char* path;
+        };
+
+        struct ModelCase
+        {
+            const char* name;
+            const char* path;
+        };
+
+        struct FilterCase
+        {
+            const char*  name;
+            MipmapFilter filter;
+        };
+    } // namespace
+
+    void RunUtilityBenchmarks(BenchmarkRunner& runner, Instance* lgx)
+    {
+        const ShaderCase shaderCases[] = {
+            {"Vertex", ShaderStage::Vertex, "05-FoxLounge/Resources/Shaders/default_pbr_vert.glsl"},
+            {"Fragment", ShaderStage::Fragment, "05-FoxLounge/Resources/Shaders/default_pbr_frag.glsl"},
+            {"Compute", ShaderStage::Compute, "04-BindlessIndirectComputeQueue/Resources/Shaders/compute.glsl"},
+        };
+
+        // Second pass measures warm hits of the in-memory shader cache.
+        for (const bool cached : {false, true})
+        {
+            Config.enableShaderCache = cached;
+            ShaderCache::Clear();
+
+            for (const ShaderCase& sc : shaderCases)
+            {
+                const LINAGX_STRING           text = ReadFileContentsAsString(GetResourcePath(sc.path).c_str());
+                LINAGX_VEC<ShaderCompileData> compileData;
+                ShaderLayout                  layout = {};
+
+                if (text.empty())
+                {
+                    fprintf(stderr, "Benchmarks -> Could not read %s, skipping!\n", sc.path);
+                    continue;
+                }
+
+                runner.Run({
+                    .name       = std::string(cached ? "Instance/CompileShader/Cached/" : "Instance/CompileShader/") + sc.name,
+                    .opsPerIter = 1,
+                    .iterations = 20,
+                    .setup =
+                        [&]() {
+                            layout = {};
+                            compileData.clear();
+                            compileData.push_back({sc.stage, text, GetResourcePath("05-FoxLounge/Resources/Shaders/Include")});
+                        },
+                    .body = [&]() { lgx->CompileShader(compileData, layout); },
+                    .teardown =
+                        [&]() {
+                            for (ShaderCompileData& data : compileData)
+                                delete[] data.outBlob.ptr;
+                        },
+                });
+            }
+        }
+
+        Config.enableShaderCache = false;
+
+        // Every shader case as a single batch, stages of the batch are independent jobs.
+        {
+            LINAGX_VEC<ShaderCompileBatchEntry> batch;
+            LINAGX_VEC<ShaderCompileBatchEntry> batchTemplate;
+
+            for (const ShaderCase& sc : shaderCases)
+            {
+                ShaderCompileBatchEntry entry = {};
+                entry.compileData.push_back({sc.stage, ReadFileContentsAsString(GetResourcePath(sc.path).c_str()), GetResourcePath("05-FoxLounge/Resources/Shaders/Include")});
+                batchTemplate.push_back(entry);
+            }
+
+            const uint32  hardwareThreads = Max(std::thread::hardware_concurrency(), 1u);
+            JobDispatcher dispatcher(Min(hardwareThreads, static_cast<uint32>(batchTemplate.size())) - 1);
+            JobDispatcher::SetActive(&dispatcher);
+
+            for (const bool parallel : {false, true})
+            {
+                Config.dispatchJobsCallback = parallel ? &JobDispatcher::DispatchActive : nullptr;
+
+                runner.Run({
+                    .name       = parallel ? "Instance/CompileShaders/BatchParallel" : "Instance/CompileShaders/Batch",
+                    .opsPerIter = batchTemplate.size(),
+                    .iterations = 10,
+                    .setup      = [&]() { batch = batchTemplate; },
+                    .body       = [&]() { Instance::CompileShaders(batch); },
+                    .teardown =
+                        [&]() {
+                            for (ShaderCompileBatchEntry& entry : batch)
+                            {
+                                for (ShaderCompileData& data : entry.compileData)
+                                    delete[] data.outBlob.ptr;
+                            }
+                        },
+                });
+            }
+
+            Config.dispatchJobsCallback = nullptr;
+            JobDispatcher::SetActive(nullptr);
+        }
+
+        const ModelCase modelCases[] = {
+            {"Fox", "03-RenderTargetsGLTF/Resources/Models/Fox.glb"},
+            {"Duck", "04-BindlessIndirectComputeQueue/Resources/Models/Duck.glb"},
+        };
+
+        for (const ModelCase& mc : modelCases)
+        {
+            const std::string path  = GetResourcePath(mc.path);
+            ModelData*        model = nullptr;
+
+            runner.Run({
+                .name       = std::string("ModelUtility/LoadGLTFBinary/") + mc.name,
+                .opsPerIter = 1,
+                .iterations = 50,
+                .setup      = [&]() { model = new ModelData(); },
+                .body       = [&]() { LoadGLTFBinary(path.c_str(), *model); },
+                .teardown   = [&]() { delete model; },
+            });
+        }
+
+        TextureBuffer source = {};
+        LoadImageFromFile(GetResourcePath("02-TexturesAndBinding/Resources/Textures/LinaGX.png").c_str(), source, 4);
+
+        if (source.pixels == nullptr)
+        {
+            fprintf(stderr, "Benchmarks -> Could not load mipmap source texture, skipping!\n");
+            return;
+        }
+
+        const FilterCase filterCases[] = {
+            {"Box", MipmapFilter::Box},
+            {"Triangle", MipmapFilter::Triangle},
+            {"CubicSpline", MipmapFilter::CubicSpline},
+            {"CatmullRom", MipmapFilter::CatmullRom},
+            {"Mitchell", MipmapFilter::Mitchell},
+        };
+
+        LINAGX_VEC<TextureBuffer> mips;
+
+        for (const FilterCase& fc : filterCases)
+        {
+            runner.Run({
+                .name       = std::string("ImageUtility/GenerateMipmaps/") + fc.name,
+                .opsPerIter = 1,
+                .iterations = 10,
+                .body       = [&]() { GenerateMipmaps(source, mips, fc.filter, 4, false); },
+                .teardown =
+                    [&]() {
+                        for (const TextureBuffer& mip : mips)
+                            FreeImage(mip.pixels);
+                        mips.clear();
+                    },
+            });
+        }
+
+        FreeImage(source.pixels);
+    }
+
+} // namespace LinaGX::Benchmarks
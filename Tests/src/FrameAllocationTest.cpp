@@ -0,0 +1,346 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+/*
+
+LinaGX Tests
+
+Headless checks registered with CTest.
+
+FrameAllocationTest: records, translates, submits and presents the same frame repeatedly, and fails if a steady-state
+frame performs any heap allocation, either through LinaGX::AllocateMemory() or through the global operator new.
+Takes the backend as its first argument (Null, Vulkan, DX12 or Metal, defaults to Null). Real backends exit with
+SKIP_RETURN_CODE when no device is available, and record the same frame without the pipeline, descriptor set binding and
+draws, as those need compiled shaders.
+
+*/
+
+#include "LinaGX/LinaGX.hpp"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    std::atomic<LinaGX::uint64> s_newCount = 0;
+
+    void LogError(const char* err, ...)
+    {
+        va_list args;
+        va_start(args, err);
+        fprintf(stderr, "LinaGX Error: ");
+        vfprintf(stderr, err, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+    }
+} // namespace
+
+// Catches std containers and any other allocation that bypasses LinaGX::AllocateMemory().
+void* operator new(size_t size)
+{
+    s_newCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+using namespace LinaGX;
+
+#define WARMUP_FRAMES    8
+#define MEASURED_FRAMES  64
+#define STREAM_COUNT     4
+#define DRAW_COUNT       256
+#define SKIP_RETURN_CODE 77
+
+struct FrameResources
+{
+    Instance*      lgx            = nullptr;
+    uint32         texture        = 0;
+    uint32         renderTarget   = 0;
+    uint32         vertexBuffer   = 0;
+    uint32         constantBuffer = 0;
+    uint16         shader         = 0;
+    uint16         descriptorSet  = 0;
+    uint8          queue          = 0;
+    bool           usePipeline    = false;
+    CommandStream* streams[STREAM_COUNT];
+};
+
+void CreateResources(FrameResources& res)
+{
+    TextureDesc txtDesc = {};
+    txtDesc.format      = Format::R8G8B8A8_UNORM;
+    txtDesc.flags       = TF_Sampled | TF_CopyDest;
+    txtDesc.width       = 64;
+    txtDesc.height      = 64;
+    res.texture         = res.lgx->CreateTexture(txtDesc);
+    txtDesc.flags       = TF_ColorAttachment;
+    txtDesc.width       = 1280;
+    txtDesc.height      = 720;
+    res.renderTarget    = res.lgx->CreateTexture(txtDesc);
+
+    ResourceDesc bufferDesc  = {};
+    bufferDesc.size          = 64 * 1024;
+    bufferDesc.typeHintFlags = TH_VertexBuffer;
+    bufferDesc.heapType      = ResourceHeap::GPUOnly;
+    res.vertexBuffer         = res.lgx->CreateResource(bufferDesc);
+    bufferDesc.size          = 256;
+    bufferDesc.typeHintFlags = TH_ConstantBuffer;
+    bufferDesc.heapType      = ResourceHeap::StagingHeap;
+    res.constantBuffer       = res.lgx->CreateResource(bufferDesc);
+
+    // Only the Null backend accepts a shader without stages.
+    if (res.usePipeline)
+    {
+        ShaderDesc shaderDesc = {};
+        res.shader            = res.lgx->CreateShader(shaderDesc);
+    }
+
+    res.queue = res.lgx->GetPrimaryQueue(CommandType::Graphics);
+
+    DescriptorBinding binding = {};
+    binding.type              = DescriptorType::UBO;
+    binding.stages            = {ShaderStage::Vertex};
+
+    DescriptorSetDesc setDesc = {};
+    setDesc.bindings          = {binding};
+    res.descriptorSet         = res.lgx->CreateDescriptorSet(setDesc);
+
+    CommandStreamDesc streamDesc = {};
+    streamDesc.type              = CommandType::Graphics;
+    streamDesc.commandCount      = DRAW_COUNT * 3 + 16;
+    streamDesc.totalMemoryLimit  = 16 * 1024;
+    streamDesc.auxMemorySize     = 1024;
+
+    for (uint32 i = 0; i < STREAM_COUNT; i++)
+        res.streams[i] = res.lgx->CreateCommandStream(streamDesc);
+}
+
+void DestroyResources(FrameResources& res)
+{
+    for (uint32 i = 0; i < STREAM_COUNT; i++)
+        res.lgx->DestroyCommandStream(res.streams[i]);
+
+    res.lgx->DestroyDescriptorSet(res.descriptorSet);
+
+    if (res.usePipeline)
+        res.lgx->DestroyShader(res.shader);
+
+    res.lgx->DestroyResource(res.constantBuffer);
+    res.lgx->DestroyResource(res.vertexBuffer);
+    res.lgx->DestroyTexture(res.renderTarget);
+    res.lgx->DestroyTexture(res.texture);
+}
+
+void RecordStream(FrameResources& res, CommandStream* stream, const TextureBuffer& upload)
+{
+    CMDBarrier* toCopy          = stream->AddCommand<CMDBarrier>();
+    toCopy->textureBarrierCount = 1;
+    toCopy->textureBarriers     = stream->EmplaceInline<TextureBarrier>(TextureBarrier{res.texture, false, TextureState::TransferDestination, AF_ShaderRead, AF_TransferWrite});
+    toCopy->srcStageFlags       = PSF_FragmentShader;
+    toCopy->dstStageFlags       = PSF_Transfer;
+
+    CMDCopyBufferToTexture2D* copy = stream->AddCommand<CMDCopyBufferToTexture2D>();
+    copy->destTexture              = res.texture;
+    copy->mipLevels                = 1;
+    copy->buffers                  = stream->EmplaceInline<TextureBuffer>(upload);
+
+    CMDBarrier* barrier          = stream->AddCommand<CMDBarrier>();
+    barrier->textureBarrierCount = 2;
+    barrier->textureBarriers     = stream->EmplaceInline<TextureBarrier>(TextureBarrier{res.texture, false, TextureState::ShaderRead, AF_TransferWrite, AF_ShaderRead}, TextureBarrier{res.renderTarget, false, TextureState::ColorAttachment, 0, AF_ColorAttachmentWrite});
+    barrier->srcStageFlags       = PSF_Transfer | PSF_ColorAttachment;
+    barrier->dstStageFlags       = PSF_FragmentShader | PSF_ColorAttachment;
+
+    CMDBeginRenderPass* begin          = stream->AddCommand<CMDBeginRenderPass>();
+    begin->colorAttachments            = stream->EmplaceInline<RenderPassColorAttachment>(RenderPassColorAttachment{});
+    begin->colorAttachments[0].texture = res.renderTarget;
+    begin->colorAttachmentCount        = 1;
+    begin->viewport                    = {0, 0, 1280, 720, 0.0f, 1.0f};
+    begin->scissors                    = {0, 0, 1280, 720};
+
+    if (res.usePipeline)
+    {
+        CMDBindPipeline* pipeline = stream->AddCommand<CMDBindPipeline>();
+        pipeline->shader          = res.shader;
+
+        CMDBindDescriptorSets* sets = stream->AddCommand<CMDBindDescriptorSets>();
+        sets->setCount              = 1;
+        sets->descriptorSetHandles  = stream->EmplaceInline<uint16>(res.descriptorSet);
+    }
+
+    for (uint32 i = 0; i < DRAW_COUNT; i++)
+    {
+        CMDBindVertexBuffers* vtx = stream->AddCommand<CMDBindVertexBuffers>();
+        vtx->resource             = res.vertexBuffer;
+        vtx->vertexSize           = 32;
+
+        if (!res.usePipeline)
+            continue;
+
+        CMDDrawInstanced* draw       = stream->AddCommand<CMDDrawInstanced>();
+        draw->vertexCountPerInstance = 3;
+        draw->instanceCount          = 1;
+    }
+
+    stream->AddCommand<CMDEndRenderPass>();
+}
+
+bool ParseBackend(const char* name, BackendAPI& outAPI)
+{
+    const struct
+    {
+        const char* name;
+        BackendAPI  api;
+    } apis[] = {{"Null", BackendAPI::Null}, {"Vulkan", BackendAPI::Vulkan}, {"DX12", BackendAPI::DX12}, {"Metal", BackendAPI::Metal}};
+
+    for (const auto& entry : apis)
+    {
+        if (strcmp(entry.name, name) == 0)
+        {
+            outAPI = entry.api;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    Config.api           = BackendAPI::Null;
+    Config.logLevel      = LogLevel::OnlyErrors;
+    Config.errorCallback = LogError;
+
+    if (argc > 1 && !ParseBackend(argv[1], Config.api))
+    {
+        fprintf(stderr, "FrameAllocationTest -> Unknown backend %s!\n", argv[1]);
+        return 1;
+    }
+
+    Instance* lgx = new Instance();
+    if (!lgx->Initialize())
+    {
+        delete lgx;
+
+        // Build machines without a GPU can't run the real backends.
+        if (Config.api != BackendAPI::Null)
+        {
+            fprintf(stderr, "FrameAllocationTest -> No device for the requested backend, skipping.\n");
+            return SKIP_RETURN_CODE;
+        }
+
+        fprintf(stderr, "FrameAllocationTest -> Failed initializing LinaGX!\n");
+        return 1;
+    }
+
+    FrameResources res = {};
+    res.lgx            = lgx;
+    res.usePipeline    = Config.api == BackendAPI::Null;
+    CreateResources(res);
+
+    uint8         pixels[16 * 16 * 4] = {};
+    TextureBuffer upload              = {pixels, 16, 16, 4};
+
+    // Descriptions are built once, only their submission is part of the frame.
+    DescriptorUpdateBufferDesc update = {};
+    update.setHandle                  = res.descriptorSet;
+    update.buffers                    = {res.constantBuffer};
+
+    SubmitDesc submit  = {};
+    submit.targetQueue = res.queue;
+    submit.streams     = res.streams;
+    submit.streamCount = STREAM_COUNT;
+
+    PresentDesc present = {};
+
+    uint32 failedFrames = 0;
+
+    for (uint32 frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++)
+    {
+        const uint64 newCountStart = s_newCount.load(std::memory_order_relaxed);
+
+        lgx->StartFrame();
+
+        uint8* mapped = nullptr;
+        lgx->MapResource(res.constantBuffer, mapped);
+        mapped[0] = static_cast<uint8>(frame);
+        lgx->UnmapResource(res.constantBuffer);
+        lgx->DescriptorUpdateBuffer(update);
+
+        for (uint32 i = 0; i < STREAM_COUNT; i++)
+            RecordStream(res, res.streams[i], upload);
+
+        lgx->CloseCommandStreams(res.streams, STREAM_COUNT);
+        lgx->SubmitCommandStreams(submit);
+        lgx->Present(present);
+        lgx->EndFrame();
+
+        const uint64 newCount = s_newCount.load(std::memory_order_relaxed) - newCountStart;
+
+        if (frame >= WARMUP_FRAMES && (PerformanceStats.frameHeapAllocations != 0 || newCount != 0))
+        {
+            fprintf(stderr, "FrameAllocationTest -> Frame %u: %llu AllocateMemory, %llu operator new calls.\n", frame, static_cast<unsigned long long>(PerformanceStats.frameHeapAllocations), static_cast<unsigned long long>(newCount));
+            failedFrames++;
+        }
+    }
+
+    lgx->Join();
+    DestroyResources(res);
+    delete lgx;
+
+    if (failedFrames != 0)
+    {
+        fprintf(stderr, "FrameAllocationTest -> %u of %u steady-state frames allocated.\n", failedFrames, MEASURED_FRAMES);
+        return 1;
+    }
+
+    fprintf(stderr, "FrameAllocationTest -> %u steady-state frames, no heap allocations.\n", MEASURED_FRAMES);
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+
+
+/*
+
+LinaGX Tests
+
+PersistentStreamTest: records one persistent stream with timestamps per frame in flight once, then closes and submits them
+for several times framesInFlight frames. Every frame after the first framesInFlight ones must read back all of its queries.
+Halfway through, the streams are rotated to different frame indices, which has to translate them again. Fails if any error
+is logged. Takes the backend as its first argument like FrameAllocationTest, and skips the same way without a device.
+
+*/
+
+#include "LinaGX/LinaGX.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    LinaGX::uint32 s_errorCount = 0;
+
+    void LogError(const char* err, ...)
+    {
+        va_list args;
+        va_start(args, err);
+        fprintf(stderr, "LinaGX Error: ");
+        vfprintf(stderr, err, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+        s_errorCount++;
+    }
+} // namespace
+
+using namespace LinaGX;
+
+#define CYCLES           4
+#define QUERY_COUNT      2
+#define MAX_STREAMS      8
+#define SKIP_RETURN_CODE 77
+
+bool ParseBackend(const char* name, BackendAPI& outAPI)
+{
+    const struct
+    {
+        const char* name;
+        BackendAPI  api;
+    } apis[] = {{"Null", BackendAPI::Null}, {"Vulkan", BackendAPI::Vulkan}, {"DX12", BackendAPI::DX12}, {"Metal", BackendAPI::Metal}};
+
+    for (const auto& entry : apis)
+    {
+        if (strcmp(entry.name, name) == 0)
+        {
+            outAPI = entry.api;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    Config.api           = BackendAPI::Null;
+    Config.logLevel      = LogLevel::OnlyErrors;
+    Config.errorCallback = LogError;
+
+    if (argc > 1 && !ParseBackend(argv[1], Config.api))
+    {
+        fprintf(stderr, "PersistentStreamTest -> Unknown backend %s!\n", argv[1]);
+        return 1;
+    }
+
+    Instance* lgx = new Instance();
+    if (!lgx->Initialize())
+    {
+        delete lgx;
+
+        // Build machines without a GPU can't run the real backends.
+        if (Config.api != BackendAPI::Null)
+        {
+            fprintf(stderr, "PersistentStreamTest -> No device for the requested backend, skipping.\n");
+            return SKIP_RETURN_CODE;
+        }
+
+        fprintf(stderr, "PersistentStreamTest -> Failed initializing LinaGX!\n");
+        return 1;
+    }
+
+    const uint32 framesInFlight = Config.framesInFlight;
+    if (framesInFlight > MAX_STREAMS)
+    {
+        fprintf(stderr, "PersistentStreamTest -> More frames in flight than streams!\n");
+        delete lgx;
+        return 1;
+    }
+
+    QueryPoolDesc poolDesc = {};
+    poolDesc.type          = QueryType::Timestamp;
+    poolDesc.queryCount    = QUERY_COUNT;
+    const uint16 pool      = lgx->CreateQueryPool(poolDesc);
+
+    CommandStreamDesc streamDesc = {};
+    streamDesc.type              = CommandType::Graphics;
+    streamDesc.commandCount      = 16;
+    streamDesc.totalMemoryLimit  = 1024;
+    streamDesc.persistent        = true;
+
+    // Recorded once, each stream is translated for the frame index it is first closed in.
+    CommandStream* streams[MAX_STREAMS] = {};
+    for (uint32 i = 0; i < framesInFlight; i++)
+    {
+        streams[i] = lgx->CreateCommandStream(streamDesc);
+
+        for (uint32 j = 0; j < QUERY_COUNT; j++)
+        {
+            CMDWriteTimestamp* timestamp = streams[i]->AddCommand<CMDWriteTimestamp>();
+            timestamp->queryPool         = pool;
+            timestamp->queryIndex        = j;
+        }
+    }
+
+    SubmitDesc submit  = {};
+    submit.targetQueue = lgx->GetPrimaryQueue(CommandType::Graphics);
+    submit.streamCount = 1;
+
+    const uint32 totalFrames  = CYCLES * framesInFlight;
+    uint32       failedFrames = 0;
+
+    for (uint32 frame = 0; frame < totalFrames; frame++)
+    {
+        // Rotated streams are closed in a frame index whose fence doesn't cover their last submission.
+        const uint32 rotation = frame < totalFrames / 2 ? 0 : 1;
+        if (frame == totalFrames / 2)
+            lgx->Join();
+
+        lgx->StartFrame();
+
+        const uint32 frameIndex = lgx->GetCurrentFrameIndex();
+
+        if (frame >= framesInFlight)
+        {
+            QueryResults results = {};
+            bool         valid   = lgx->GetQueryResults(pool, results) && results.queryCount == QUERY_COUNT;
+
+            for (uint32 j = 0; valid && j < QUERY_COUNT; j++)
+                valid = results.available[j] != 0;
+
+            if (!valid)
+            {
+                fprintf(stderr, "PersistentStreamTest -> Frame %u: queries of the replayed stream weren't written.\n", frame);
+                failedFrames++;
+            }
+        }
+
+        CommandStream* stream = streams[(frameIndex + rotation) % framesInFlight];
+        submit.streams        = &stream;
+        lgx->CloseCommandStreams(&stream, 1);
+        lgx->SubmitCommandStreams(submit);
+        lgx->EndFrame();
+    }
+
+    lgx->Join();
+
+    for (uint32 i = 0; i < framesInFlight; i++)
+        lgx->DestroyCommandStream(streams[i]);
+
+    lgx->DestroyQueryPool(pool);
+    delete lgx;
+
+    if (failedFrames != 0 || s_errorCount != 0)
+    {
+        fprintf(stderr, "PersistentStreamTest -> %u of %u frames missed their queries, %u errors logged.\n", failedFrames, totalFrames - framesInFlight, s_errorCount);
+        return 1;
+    }
+
+    fprintf(stderr, "PersistentStreamTest -> %u replayed frames read back all their queries.\n", totalFrames - framesInFlight);
+    return 0;
+}
@@ -0,0 +1,302 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+
+
+/*
+
+LinaGX Tests
+
+RenderGraphTest: builds small graphs and checks the passes Compile() culls, and the barriers, batches and queue waits it
+derives, through RenderGraph::IsPassCulled() and RenderGraph::GetStatistics(). Every graph is then executed for a few frames.
+Fails if any check doesn't hold or any error is logged. Takes the backend as its first argument like FrameAllocationTest,
+and skips the same way without a device.
+
+*/
+
+#include "LinaGX/LinaGX.hpp"
+#include "LinaGX/Utility/RenderGraph.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    LinaGX::uint32 s_errorCount   = 0;
+    LinaGX::uint32 s_failedChecks = 0;
+
+    void LogError(const char* err, ...)
+    {
+        va_list args;
+        va_start(args, err);
+        fprintf(stderr, "LinaGX Error: ");
+        vfprintf(stderr, err, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+        s_errorCount++;
+    }
+
+    void Check(bool condition, const char* graph, const char* what)
+    {
+        if (condition)
+            return;
+
+        fprintf(stderr, "RenderGraphTest -> %s: %s\n", graph, what);
+        s_failedChecks++;
+    }
+} // namespace
+
+using namespace LinaGX;
+
+#define EXECUTED_FRAMES  4
+#define SKIP_RETURN_CODE 77
+
+bool ParseBackend(const char* name, BackendAPI& outAPI)
+{
+    const struct
+    {
+        const char* name;
+        BackendAPI  api;
+    } apis[] = {{"Null", BackendAPI::Null}, {"Vulkan", BackendAPI::Vulkan}, {"DX12", BackendAPI::DX12}, {"Metal", BackendAPI::Metal}};
+
+    for (const auto& entry : apis)
+    {
+        if (strcmp(entry.name, name) == 0)
+        {
+            outAPI = entry.api;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ExecuteFrames(Instance* lgx, RenderGraph& graph)
+{
+    for (uint32 i = 0; i < EXECUTED_FRAMES; i++)
+    {
+        lgx->StartFrame();
+        graph.Execute();
+        lgx->EndFrame();
+    }
+
+    lgx->Join();
+}
+
+RGPassDesc MakePass(const char* name, CommandType type = CommandType::Graphics, bool sideEffects = false)
+{
+    RGPassDesc desc  = {};
+    desc.name        = name;
+    desc.type        = type;
+    desc.sideEffects = sideEffects;
+    return desc;
+}
+
+/// <summary>
+/// Passes writing only what nothing needs are culled, along with passes only they feed. Side effects keep a pass alive.
+/// Texture barriers are derived from state changes, and imported textures return to their final state at the end.
+/// </summary>
+void TestCullingAndTextureBarriers(Instance* lgx, uint32 textures[4])
+{
+    RenderGraph graph(lgx);
+
+    const uint32 gbuffer = graph.ImportTexture(textures[0], TextureState::ShaderRead, TextureState::ShaderRead);
+    const uint32 output  = graph.ImportTexture(textures[1], TextureState::ShaderRead, TextureState::ShaderRead);
+    const uint32 unused  = graph.ImportTexture(textures[2], TextureState::ShaderRead, TextureState::ShaderRead);
+    const uint32 debug   = graph.ImportTexture(textures[3], TextureState::ShaderRead, TextureState::ShaderRead);
+    graph.MarkOutput(output);
+
+    const uint32 geometry = graph.AddPass(MakePass("Geometry"));
+    graph.WriteTexture(geometry, gbuffer, TextureState::ColorAttachment);
+
+    const uint32 lighting = graph.AddPass(MakePass("Lighting"));
+    graph.ReadTexture(lighting, gbuffer, TextureState::ShaderRead);
+    graph.WriteTexture(lighting, output, TextureState::ColorAttachment);
+
+    const uint32 dead = graph.AddPass(MakePass("Dead"));
+    graph.WriteTexture(dead, unused, TextureState::ColorAttachment);
+
+    // Only feeds the culled debug view, culled along with it.
+    const uint32 debugSource = graph.AddPass(MakePass("DebugSource"));
+    graph.ReadTexture(debugSource, output, TextureState::ShaderRead);
+    graph.WriteTexture(debugSource, debug, TextureState::ColorAttachment);
+
+    const uint32 debugView = graph.AddPass(MakePass("DebugView"));
+    graph.ReadTexture(debugView, debug, TextureState::ShaderRead);
+    graph.WriteTexture(debugView, unused, TextureState::ColorAttachment);
+
+    const uint32 readback = graph.AddPass(MakePass("Readback", CommandType::Graphics, true));
+
+    graph.Compile();
+
+    const char*         name  = "Culling";
+    const RGStatistics& stats = graph.GetStatistics();
+    Check(!graph.IsPassCulled(geometry), name, "Geometry feeds an output and must be kept.");
+    Check(!graph.IsPassCulled(lighting), name, "Lighting writes an output and must be kept.");
+    Check(graph.IsPassCulled(dead), name, "Dead writes nothing needed and must be culled.");
+    Check(graph.IsPassCulled(debugSource), name, "DebugSource only feeds a culled pass and must be culled.");
+    Check(graph.IsPassCulled(debugView), name, "DebugView writes nothing needed and must be culled.");
+    Check(!graph.IsPassCulled(readback), name, "Readback has side effects and must be kept.");
+    Check(stats.passCount == 6 && stats.culledPassCount == 3, name, "Expected 3 of 6 passes culled.");
+    Check(stats.batchCount == 1 && stats.queueWaits == 0, name, "Expected a single batch without queue waits.");
+
+    // Geometry: gbuffer to attachment. Lighting: gbuffer to read & output to attachment. Final: output back to read.
+    Check(stats.barrierCount == 3, name, "Expected a barrier for Geometry, Lighting and the final transitions.");
+    Check(stats.textureBarriers == 4, name, "Expected 4 texture barriers.");
+    Check(stats.resourceBarriers == 0 && stats.memoryBarriers == 0, name, "Expected no resource or memory barriers.");
+
+    ExecuteFrames(lgx, graph);
+}
+
+/// <summary>
+/// Reads after a write wait once, later reads in the same state don't need another barrier.
+/// </summary>
+void TestReadAfterRead(Instance* lgx, uint32 resource)
+{
+    RenderGraph graph(lgx);
+
+    const uint32 buffer = graph.ImportResource(resource);
+
+    const uint32 write = graph.AddPass(MakePass("Write", CommandType::Graphics, true));
+    graph.WriteResource(write, buffer, RGResourceAccess::ShaderWrite);
+
+    const uint32 read0 = graph.AddPass(MakePass("Read0", CommandType::Graphics, true));
+    graph.ReadResource(read0, buffer, RGResourceAccess::ShaderRead);
+
+    const uint32 read1 = graph.AddPass(MakePass("Read1", CommandType::Graphics, true));
+    graph.ReadResource(read1, buffer, RGResourceAccess::ShaderRead);
+
+    graph.Compile();
+
+    const char*         name  = "ReadAfterRead";
+    const RGStatistics& stats = graph.GetStatistics();
+    Check(stats.culledPassCount == 0, name, "Passes with side effects must be kept.");
+    Check(stats.barrierCount == 2 && stats.memoryBarriers == 2, name, "Expected memory barriers before the write and the first read only.");
+    Check(stats.textureBarriers == 0 && stats.resourceBarriers == 0, name, "Expected no texture or resource barriers.");
+
+    ExecuteFrames(lgx, graph);
+}
+
+/// <summary>
+/// Passes on different queues are split into batches, a read on another queue than the write waits for the writing batch.
+/// </summary>
+void TestCrossQueue(Instance* lgx, uint32 resource, uint32 texture)
+{
+    RenderGraph graph(lgx);
+
+    const uint32 buffer = graph.ImportResource(resource);
+    const uint32 target = graph.ImportTexture(texture, TextureState::ShaderRead, TextureState::ShaderRead);
+    graph.MarkOutput(target);
+
+    const uint32 simulate = graph.AddPass(MakePass("Simulate", CommandType::Compute));
+    graph.WriteResource(simulate, buffer, RGResourceAccess::ShaderWrite);
+
+    const uint32 draw = graph.AddPass(MakePass("Draw"));
+    graph.ReadResource(draw, buffer, RGResourceAccess::ShaderRead);
+    graph.WriteTexture(draw, target, TextureState::ColorAttachment);
+
+    graph.Compile();
+
+    const char*         name  = "CrossQueue";
+    const RGStatistics& stats = graph.GetStatistics();
+    Check(stats.culledPassCount == 0, name, "Simulate feeds Draw, which writes an output, both must be kept.");
+    Check(stats.batchCount == 2, name, "Expected a batch per queue.");
+    Check(stats.queueWaits == 1, name, "Expected Draw to wait for Simulate.");
+
+    // Simulate: before the write. Draw: after the queue wait, plus the target to attachment. Final: target back to read.
+    Check(stats.barrierCount == 3, name, "Expected barriers for Simulate, Draw and the final transition.");
+    Check(stats.memoryBarriers == 2 && stats.textureBarriers == 2, name, "Expected 2 memory and 2 texture barriers.");
+
+    ExecuteFrames(lgx, graph);
+}
+
+int main(int argc, char** argv)
+{
+    Config.api           = BackendAPI::Null;
+    Config.logLevel      = LogLevel::OnlyErrors;
+    Config.errorCallback = LogError;
+
+    if (argc > 1 && !ParseBackend(argv[1], Config.api))
+    {
+        fprintf(stderr, "RenderGraphTest -> Unknown backend %s!\n", argv[1]);
+        return 1;
+    }
+
+    Instance* lgx = new Instance();
+    if (!lgx->Initialize())
+    {
+        delete lgx;
+
+        // Build machines without a GPU can't run the real backends.
+        if (Config.api != BackendAPI::Null)
+        {
+            fprintf(stderr, "RenderGraphTest -> No device for the requested backend, skipping.\n");
+            return SKIP_RETURN_CODE;
+        }
+
+        fprintf(stderr, "RenderGraphTest -> Failed initializing LinaGX!\n");
+        return 1;
+    }
+
+    TextureDesc txtDesc = {};
+    txtDesc.format      = Format::R8G8B8A8_UNORM;
+    txtDesc.flags       = TF_ColorAttachment | TF_Sampled;
+    txtDesc.width       = 256;
+    txtDesc.height      = 256;
+
+    uint32 textures[4] = {};
+    for (uint32 i = 0; i < 4; i++)
+        textures[i] = lgx->CreateTexture(txtDesc);
+
+    ResourceDesc bufferDesc  = {};
+    bufferDesc.size          = 1024;
+    bufferDesc.typeHintFlags = TH_StorageBuffer;
+    bufferDesc.heapType      = ResourceHeap::GPUOnly;
+    const uint32 resource    = lgx->CreateResource(bufferDesc);
+
+    TestCullingAndTextureBarriers(lgx, textures);
+    TestReadAfterRead(lgx, resource);
+    TestCrossQueue(lgx, resource, textures[0]);
+
+    lgx->DestroyResource(resource);
+
+    for (uint32 i = 0; i < 4; i++)
+        lgx->DestroyTexture(textures[i]);
+
+    delete lgx;
+
+    if (s_failedChecks != 0 || s_errorCount != 0)
+    {
+        fprintf(stderr, "RenderGraphTest -> %u checks failed, %u errors logged.\n", s_failedChecks, s_errorCount);
+        return 1;
+    }
+
+    fprintf(stderr, "RenderGraphTest -> All graphs culled and synchronized as expected.\n");
+    return 0;
+}
@@ -59,7 +59,8 @@ namespace LinaGX
     {
         Vulkan,
         DX12,
-        Metal
+        Metal,
+        Null, // No GPU work, only handle bookkeeping and command stream translation. Useful for headless CI and CPU-side profiling.
     };
 
     enum class PreferredGPUType
@@ -81,6 +82,7 @@ namespace LinaGX
         bool   flipViewport            = true;
         uint32 extraGraphicsQueueCount = 0;
         uint32 enableVulkanFeatures    = 0;
+        uint32 stagingRingSize         = 32 * 1024 * 1024; // Persistently mapped upload memory per frame in flight, CMDCopyBufferToTexture2D only allocates a dedicated staging buffer if an upload doesn't fit. 0 disables the ring.
     };
 
     struct DX12Configuration
@@ -120,32 +122,54 @@ namespace LinaGX
         uint32 maxDescriptorSets  = 512;
     };
 
+    struct MemoryStatistics
+    {
+        std::atomic<uint64> allocations = 0; // AllocateMemory() calls since startup.
+        std::atomic<uint64> frees       = 0;
+        std::atomic<uint64> liveBytes   = 0; // Requested bytes currently allocated, excluding bookkeeping and alignment overhead.
+    };
+
     struct PerformanceStatistics
     {
-        uint64 totalFrames = 0;
+        uint64              totalFrames          = 0;
+        uint64              frameHeapAllocations = 0; // AllocateMemory() calls between the last StartFrame() and EndFrame(), stays 0 in a steady-state frame.
+        std::atomic<uint64> totalHeapAllocations = 0; // AllocateMemory() calls since startup, all tags.
+        std::atomic<uint64> totalHeapFrees       = 0;
+        MemoryStatistics    memory[static_cast<uint32>(AllocationTag::Count)]; // Indexed by AllocationTag.
+        std::atomic<uint64> elidedCommands       = 0; // Commands dropped during translation because they set already bound state, see Configuration::eliminateRedundantState.
+        std::atomic<uint64> coalescedDraws       = 0; // Draws issued as part of a multi-draw indirect instead of on their own, see CommandStreamDesc::coalesceIndexedDraws.
+        std::atomic<uint64> mergedBarriers       = 0; // CMDBarrier commands folded into the previous barrier call while translating, Vulkan only.
+        std::atomic<uint64> lockContentions      = 0; // Times a creation/deletion call had to wait for another thread holding the same object type's lock, see Configuration::mutexLockCreationDeletion.
     };
 
     typedef void (*LogCallback)(const char*, ...);
+    typedef void (*JobFunction)(void* userData, uint32 jobIndex);
+    typedef void (*DispatchJobsCallback)(JobFunction job, void* userData, uint32 jobCount);
 
     struct Configuration
     {
-        BackendAPI          api                             = BackendAPI::Vulkan;
-        PreferredGPUType    gpu                             = PreferredGPUType::Discrete;
-        const char*         appName                         = "LinaGX App";
-        uint32              framesInFlight                  = 2;
-        uint32              backbufferCount                 = 2;
-        GPULimits           gpuLimits                       = {};
-        VulkanConfiguration vulkanConfig                    = {};
-        DX12Configuration   dx12Config                      = {};
-        MetalConfiguration  mtlConfig                       = {};
-        LogCallback         errorCallback                   = nullptr;
-        LogCallback         infoCallback                    = nullptr;
-        LogLevel            logLevel                        = LogLevel::Normal;
-        bool                mutexLockCreationDeletion       = false;
-        bool                multithreadedQueueSubmission    = false;
-        bool                enableAPIDebugLayers            = true;
-        bool                enableShaderDebugInformation    = false;
-        bool                serializeShaderDebugInformation = false;
+        BackendAPI           api                             = BackendAPI::Vulkan;
+        PreferredGPUType     gpu                             = PreferredGPUType::Discrete;
+        const char*          appName                         = "LinaGX App";
+        uint32               framesInFlight                  = 2;
+        uint32               backbufferCount                 = 2;
+        GPULimits            gpuLimits                       = {};
+        VulkanConfiguration  vulkanConfig                    = {};
+        DX12Configuration    dx12Config                      = {};
+        MetalConfiguration   mtlConfig                       = {};
+        LogCallback          errorCallback                   = nullptr;
+        LogCallback          infoCallback                    = nullptr;
+        AllocatorCallbacks   allocator                       = {};      // Set before Initialize() and keep it valid until the instance is destroyed, memory isn't migrated between allocators.
+        DispatchJobsCallback dispatchJobsCallback            = nullptr; // If set, CloseCommandStreams() translates streams and CompileShaders() compiles stages concurrently through it. It must call job(userData, i) for every i in [0, jobCount) on any threads, and return only after all of them finish.
+        LogLevel             logLevel                        = LogLevel::Normal;
+        bool                 mutexLockCreationDeletion       = false;
+        bool                 multithreadedQueueSubmission    = false;
+        bool                 eliminateRedundantState         = false; // Skips pipeline, viewport, scissors, descriptor set and vertex/index buffer bindings that set already bound state while translating. Vulkan and Null backends only.
+        bool                 enableAPIDebugLayers            = true;
+        bool                 enableShaderDebugInformation    = false;
+        bool                 serializeShaderDebugInformation = false;
+        bool                 enableShaderCache               = false;   // Caches CompileShader() results in memory, keyed by a hash of the preprocessed stage texts, API and debug flags.
+        const char*          shaderCacheDirectory            = nullptr; // If set along with enableShaderCache, cache entries are also read from and written to this directory.
     };
 
     extern Configuration         Config;
@@ -37,7 +37,13 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/LinaGXExports.hpp"
 #include "LinaGX/Common/Types.hpp"
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <typeinfo>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
 
 #ifndef LINAGX_VEC
 #include <vector>
@@ -51,6 +57,10 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <deque>
 #endif
 
+#ifndef LINAGX_MAP
+#include <unordered_map>
+#endif
+
 namespace LinaGX
 {
 
@@ -101,6 +111,10 @@ namespace LinaGX
 #define LINAGX_DEQUE std::deque
 #endif
 
+#ifndef LINAGX_MAP
+#define LINAGX_MAP std::unordered_map
+#endif
+
 #ifndef LINAGX_MALLOC
 #define LINAGX_MALLOC(...) malloc(__VA_ARGS__)
 #endif
@@ -109,6 +123,10 @@ namespace LinaGX
 #define LINAGX_MEMCPY(...) memcpy(__VA_ARGS__)
 #endif
 
+#ifndef LINAGX_MEMSET
+#define LINAGX_MEMSET(...) memset(__VA_ARGS__)
+#endif
+
 #ifndef LINAGX_FREE
 #define LINAGX_FREE(...) free(__VA_ARGS__)
 #endif
@@ -125,6 +143,53 @@ namespace LinaGX
 #define ALIGN_SIZE(sizeToAlign, Alignment)      (sizeToAlign + Alignment - 1) - sizeToAlign % Alignment;
 #define IS_SIZE_ALIGNED(sizeToTest, PowerOfTwo) (((sizeToTest) & ((PowerOfTwo)-1)) == 0)
 
+    /// <summary>
+    /// Categories every LinaGX allocation is accounted under, see Configuration::allocator and PerformanceStatistics::memory.
+    /// </summary>
+    enum class AllocationTag : uint8
+    {
+        Commands, // Command stream pages, constant blocks and translation scratch.
+        Backend,  // Backend object storage, submission and frame scratch.
+        Assets,   // Image and model data loaded through the utilities.
+        Driver,   // CPU-side allocations of the graphics API and its memory allocator, e.g. VkAllocationCallbacks and VMA.
+        Count,
+    };
+
+    typedef void* (*AllocateCallback)(void* userData, size_t size, size_t alignment, AllocationTag tag);
+    typedef void (*FreeCallback)(void* userData, void* ptr, size_t size, AllocationTag tag);
+
+    /// <summary>
+    /// Runtime allocator LinaGX routes its memory through, leave the callbacks null to use LINAGX_MALLOC/LINAGX_FREE.
+    /// allocate should return memory aligned to alignment or nullptr on failure, free receives the same size and tag the block was allocated with.
+    /// </summary>
+    struct AllocatorCallbacks
+    {
+        AllocateCallback allocate = nullptr;
+        FreeCallback     free     = nullptr;
+        void*            userData = nullptr;
+    };
+
+    /// <summary>
+    /// Allocates size bytes aligned to alignment through Configuration::allocator and accounts them under tag.
+    /// Memory must be released with FreeMemory().
+    /// </summary>
+    LINAGX_API void* AllocateMemory(size_t size, AllocationTag tag, size_t alignment = alignof(std::max_align_t));
+
+    /// <summary>
+    /// realloc() semantics, a null ptr allocates and a size of 0 frees. Contents are kept up to the smaller of the two sizes.
+    /// </summary>
+    LINAGX_API void* ReallocateMemory(void* ptr, size_t size, AllocationTag tag, size_t alignment = alignof(std::max_align_t));
+
+    /// <summary>
+    /// Releases memory returned from AllocateMemory() or ReallocateMemory(), ignores nullptr.
+    /// </summary>
+    LINAGX_API void FreeMemory(void* ptr);
+
+    /// <summary>
+    /// Logs a HandlePool running out of handles, pools can't log themselves as they are declared before the configuration.
+    /// </summary>
+    LINAGX_API void ReportHandlesExhausted(const char* itemType, uint32 capacity);
+
     class UtilVector
     {
     public:
@@ -148,105 +213,301 @@ namespace LinaGX
             return it;
         }
     };
+    /// <summary>
+    /// Handles reserve their upper bits for the generation, which limits how many items of a pool can be alive at once:
+    /// 63 for uint8 handles (swapchains, queues), 4095 for uint16 handles (shaders, descriptor sets, pipeline layouts, fences, user semaphores, query pools, transient groups)
+    /// and 1048575 for uint32 handles (textures, resources, samplers, command streams).
+    /// </summary>
+    template <typename U>
+    struct HandleTraits;
+
+    template <>
+    struct HandleTraits<uint8>
+    {
+        static constexpr uint32 IndexBits = 6;
+        static constexpr uint32 ChunkSize = 64;
+    };
+
+    template <>
+    struct HandleTraits<uint16>
+    {
+        static constexpr uint32 IndexBits = 12;
+        static constexpr uint32 ChunkSize = 256;
+    };
+
+    template <>
+    struct HandleTraits<uint32>
+    {
+        static constexpr uint32 IndexBits = 20;
+        static constexpr uint32 ChunkSize = 1024;
+    };
+
+    /// <summary>
+    /// Backend object table. Handles are a slot index in the low HandleTraits<U>::IndexBits and the slot's generation in the remaining bits,
+    /// the generation is bumped whenever an item is removed so stale handles are caught by GetItemR() in debug builds.
+    /// Items live in fixed-size chunks that are never moved, references returned from GetItemR() stay valid until the item is removed.
+    /// AddItem() and RemoveItem() are lock-free and can be called from multiple threads, iterating while items are added is not supported.
+    /// At most Capacity items can be alive at once, see HandleTraits. Once exhausted AddItem() logs an error and returns InvalidHandle.
+    /// </summary>
     template <typename U, typename T>
-    class IDList
+    class HandlePool
     {
     public:
-        IDList(uint32 step)
+        static constexpr uint32 IndexBits     = HandleTraits<U>::IndexBits;
+        static constexpr uint32 ChunkSize     = HandleTraits<U>::ChunkSize;
+        static constexpr uint32 IndexMask     = (1u << IndexBits) - 1;
+        static constexpr uint32 Capacity      = IndexMask; // All-ones index is reserved for InvalidHandle.
+        static constexpr uint32 MaxChunks     = (Capacity + ChunkSize - 1) / ChunkSize;
+        static constexpr U      InvalidHandle = static_cast<U>(~static_cast<U>(0));
+
+    private:
+        struct Slot
         {
-            m_defaultStep = step;
-            m_items.resize(step, T());
-        }
+            T                   item       = T();
+            U                   generation = 0;
+            std::atomic<uint32> nextFree   = 0; // Index + 1 of the next free slot while this one is on the free list, 0 terminates.
+        };
+
+    public:
+        class Iterator
+        {
+        public:
+            Iterator(HandlePool* pool, uint32 index)
+                : m_pool(pool), m_index(index){};
+
+            T& operator*() const
+            {
+                return m_pool->GetSlot(m_index).item;
+            }
 
-        ~IDList() = default;
+            Iterator& operator++()
+            {
+                m_index++;
+                return *this;
+            }
+
+            bool operator!=(const Iterator& other) const
+            {
+                return m_index != other.m_index;
+            }
 
-        typename LINAGX_VEC<T>::iterator begin()
+        private:
+            HandlePool* m_pool  = nullptr;
+            uint32      m_index = 0;
+        };
+
+        HandlePool()
+        {
+            for (uint32 i = 0; i < MaxChunks; i++)
+                m_chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~HandlePool()
         {
-            return m_items.begin();
+            for (uint32 i = 0; i < MaxChunks; i++)
+                delete[] m_chunks[i].load(std::memory_order_relaxed);
         }
 
-        typename LINAGX_VEC<T>::iterator end()
+        HandlePool(const HandlePool&)            = delete;
+        HandlePool& operator=(const HandlePool&) = delete;
+
+        Iterator begin()
         {
-            return m_items.end();
+            return Iterator(this, 0);
         }
 
-        inline U AddItem(T item)
+        Iterator end()
         {
-            U id = 0;
+            return Iterator(this, GetNextFreeID());
+        }
 
-            if (!m_availableIDs.empty())
+        U AddItem(T item)
+        {
+            const uint32 index = AcquireIndex();
+            if (index == Capacity)
             {
-                id = m_availableIDs.front();
-                m_availableIDs.pop();
+                ReportHandlesExhausted(typeid(T).name(), Capacity);
+                return InvalidHandle;
             }
-            else
-                id = m_nextFreeID++;
 
-            const U currentSize = static_cast<U>(m_items.size());
-            if (id >= currentSize)
-                m_items.resize(m_defaultStep + currentSize);
+            Slot& slot = GetSlot(index);
+            slot.item  = item;
+            return static_cast<U>((static_cast<uint32>(slot.generation) << IndexBits) | index);
+        }
+
+        void RemoveItem(U handle)
+        {
+            const uint32 index = static_cast<uint32>(handle) & IndexMask;
+            Slot&        slot  = GetSlot(index);
+            assert(slot.generation == static_cast<U>(static_cast<uint32>(handle) >> IndexBits) && "HandlePool -> Removing a stale handle!");
+
+            slot.item       = T();
+            slot.generation = static_cast<U>((static_cast<uint32>(slot.generation) + 1) & (static_cast<uint32>(InvalidHandle) >> IndexBits));
+
+            uint64 head = m_freeHead.load(std::memory_order_relaxed);
+            uint64 newHead;
+            do
+            {
+                slot.nextFree.store(static_cast<uint32>(head), std::memory_order_relaxed);
+                newHead = ((head >> 32) + 1) << 32 | static_cast<uint64>(index + 1);
+            } while (!m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+        }
 
-            m_items[id] = item;
-            return id;
+        inline T GetItem(U handle)
+        {
+            return GetItemR(handle);
         }
 
-        inline void AddItem(T item, U index)
+        inline T& GetItemR(U handle)
         {
-            m_items[index] = item;
+            const uint32 index = static_cast<uint32>(handle) & IndexMask;
+            Slot&        slot  = GetSlot(index);
+            assert(slot.generation == static_cast<U>(static_cast<uint32>(handle) >> IndexBits) && "HandlePool -> Stale handle, the item was removed!");
+            return slot.item;
         }
 
-        inline void RemoveItem(U id)
+        /// <summary>
+        /// Number of slots ever used, upper bound for iteration.
+        /// </summary>
+        inline uint32 GetNextFreeID() const
         {
-            m_items[id] = T();
-            m_availableIDs.push(id);
+            const uint32 next = m_nextIndex.load(std::memory_order_acquire);
+            return next < Capacity ? next : Capacity;
         }
 
-        inline const LINAGX_VEC<T>& GetItems() const
+    private:
+        uint32 AcquireIndex()
         {
-            return m_items;
+            // Pop the free list, the tag in the upper 32 bits makes a concurrent pop & push of the same slot fail the exchange.
+            uint64 head = m_freeHead.load(std::memory_order_acquire);
+            while (static_cast<uint32>(head) != 0)
+            {
+                const uint32 index   = static_cast<uint32>(head) - 1;
+                const uint64 newHead = ((head >> 32) + 1) << 32 | GetSlot(index).nextFree.load(std::memory_order_relaxed);
+                if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+                    return index;
+            }
+
+            const uint32 index = m_nextIndex.fetch_add(1, std::memory_order_acq_rel);
+            if (index >= Capacity)
+                return Capacity;
+
+            // First user of a chunk allocates it, losers of the race discard theirs.
+            std::atomic<Slot*>& chunk = m_chunks[index / ChunkSize];
+            if (chunk.load(std::memory_order_acquire) == nullptr)
+            {
+                Slot* expected = nullptr;
+                Slot* newChunk = new Slot[ChunkSize];
+                if (!chunk.compare_exchange_strong(expected, newChunk, std::memory_order_acq_rel))
+                    delete[] newChunk;
+            }
+
+            return index;
         }
 
-        inline LINAGX_VEC<T>& GetItems()
+        inline Slot& GetSlot(uint32 index)
         {
-            return m_items;
+            return m_chunks[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
         }
 
-        inline T GetItem(int index)
+    private:
+        std::atomic<Slot*>  m_chunks[MaxChunks];
+        std::atomic<uint64> m_freeHead  = 0;
+        std::atomic<uint32> m_nextIndex = 0;
+    };
+
+    /// <summary>
+    /// Bump allocator over a chain of fixed-size pages. Pages are allocated on demand and never moved,
+    /// so returned pointers stay valid until Reset(), which recycles all pages for the next use instead of freeing them.
+    /// Requests larger than the page size get a dedicated page of their own size.
+    /// </summary>
+    class PagedLinearAllocator
+    {
+    public:
+        PagedLinearAllocator() = default;
+        PagedLinearAllocator(size_t pageSize, AllocationTag tag = AllocationTag::Commands);
+        ~PagedLinearAllocator();
+
+        PagedLinearAllocator(const PagedLinearAllocator&)            = delete;
+        PagedLinearAllocator& operator=(const PagedLinearAllocator&) = delete;
+
+        inline uint8* Allocate(size_t size, size_t alignment)
         {
-            return m_items[index];
+            if (m_currentPage < m_pages.size())
+            {
+                const Page&     page    = m_pages[m_currentPage];
+                const uintptr_t head    = reinterpret_cast<uintptr_t>(page.data) + m_pageOffset;
+                const size_t    padding = static_cast<size_t>(ALIGN_SIZE_POW(head, alignment) - head);
+
+                if (m_pageOffset + padding + size <= page.size)
+                {
+                    m_pageOffset += padding + size;
+                    m_usedSize += padding + size;
+                    return page.data + m_pageOffset - size;
+                }
+            }
+
+            return AllocateFromNextPage(size, alignment);
         }
 
-        inline T& GetItemR(int index)
+        /// <summary>
+        /// Uninitialized storage for count elements of T.
+        /// </summary>
+        template <typename T>
+        inline T* AllocateArray(size_t count)
         {
-            return m_items[index];
+            return reinterpret_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
         }
 
-        inline U GetNextFreeID()
+        void Reset();
+
+        /// <summary>
+        /// Bytes handed out since the last Reset(), including alignment padding.
+        /// </summary>
+        inline size_t GetUsedSize() const
         {
-            return m_nextFreeID;
+            return m_usedSize;
         }
 
-        inline void Clear()
+        /// <summary>
+        /// Largest used size observed across all Reset() cycles, including the current one.
+        /// </summary>
+        inline size_t GetHighWaterMark() const
         {
-            m_items.clear();
+            return m_usedSize > m_highWaterMark ? m_usedSize : m_highWaterMark;
         }
 
-        inline void Reset()
+        /// <summary>
+        /// Total bytes currently reserved by all pages.
+        /// </summary>
+        inline size_t GetReservedSize() const
         {
-            Clear();
-            m_items.resize(m_defaultStep, T());
+            return m_reservedSize;
         }
 
-        inline T* GetRaw()
+        inline uint32 GetPageCount() const
         {
-            return m_items.data();
+            return static_cast<uint32>(m_pages.size());
         }
 
     private:
-        LINAGX_VEC<T>   m_items;
-        LINAGX_QUEUE<U> m_availableIDs;
-        U               m_nextFreeID  = 0;
-        uint32          m_defaultStep = 50;
+        uint8* AllocateFromNextPage(size_t size, size_t alignment);
+
+    private:
+        struct Page
+        {
+            uint8* data = nullptr;
+            size_t size = 0;
+        };
+
+        LINAGX_VEC<Page> m_pages;
+        size_t           m_pageSize      = 0;
+        size_t           m_currentPage   = 0;
+        size_t           m_pageOffset    = 0;
+        size_t           m_usedSize      = 0;
+        size_t           m_highWaterMark = 0;
+        size_t           m_reservedSize  = 0;
+        AllocationTag    m_tag           = AllocationTag::Commands;
     };
 
     // https://gist.github.com/hwei/1950649d523afd03285c
@@ -188,6 +188,13 @@ namespace LinaGX
         Secondary,
     };
 
+    enum class QueryType
+    {
+        Timestamp = 0,
+        Occlusion,
+        PipelineStatistics,
+    };
+
     enum class VKVsync
     {
         None,
@@ -245,6 +252,7 @@ namespace LinaGX
         TH_IndexBuffer    = 1 << 4,
         TH_IndirectBuffer = 1 << 5,
         TH_ReadbackDest   = 1 << 6,
+        TH_QueryResult    = 1 << 7,
     };
 
     enum class ResourceHeap
@@ -285,20 +293,21 @@ namespace LinaGX
     /// </summary>
     enum PipelineStageFlags
     {
-        PSF_TopOfPipe       = 0x00000001,
-        PSF_DrawIndirect    = 0x00000002,
-        PSF_VertexInput     = 0x00000004,
-        PSF_VertexShader    = 0x00000008,
-        PSF_FragmentShader  = 0x00000080,
-        PSF_EarlyFragment   = 0x00000100,
-        PSF_LateFragment    = 0x00000200,
-        PSF_ColorAttachment = 0x00000400,
-        PSF_Compute         = 0x00000800,
-        PSF_Transfer        = 0x00001000,
-        PSF_BottomOfPipe    = 0x00002000,
-        PSF_Host            = 0x00004000,
-        PSF_AllGraphics     = 0x00008000,
-        PSF_AllCommands     = 0x00010000,
+        PSF_TopOfPipe            = 0x00000001,
+        PSF_DrawIndirect         = 0x00000002,
+        PSF_VertexInput          = 0x00000004,
+        PSF_VertexShader         = 0x00000008,
+        PSF_FragmentShader       = 0x00000080,
+        PSF_EarlyFragment        = 0x00000100,
+        PSF_LateFragment         = 0x00000200,
+        PSF_ColorAttachment      = 0x00000400,
+        PSF_Compute              = 0x00000800,
+        PSF_Transfer             = 0x00001000,
+        PSF_BottomOfPipe         = 0x00002000,
+        PSF_Host                 = 0x00004000,
+        PSF_AllGraphics          = 0x00008000,
+        PSF_AllCommands          = 0x00010000,
+        PSF_ConditionalRendering = 0x00040000,
     };
 
     /// <summary>
@@ -323,6 +332,7 @@ namespace LinaGX
         AF_HostWrite                   = 0x00004000,
         AF_MemoryRead                  = 0x00008000,
         AF_MemoryWrite                 = 0x00010000,
+        AF_ConditionalRenderingRead    = 0x00100000,
     };
 
     enum class TextureState
@@ -342,6 +352,7 @@ namespace LinaGX
     {
         TransferRead,
         TransferWrite,
+        ConditionalRenderingRead,
     };
 
     enum TextureFlags
@@ -493,6 +504,9 @@ namespace LinaGX
     /// If targeting Vulkan, need to use srcAccessFlags and dstAccessFlags. Use AccessFlags enumeration.
     /// In DX12 access flags are not required.
     /// In Metal no transition/barrier is required at all.
+    /// Leave the subresource range zeroed to transition the whole texture, or target a mip & layer range, e.g. a single mip while generating the chain or a single cubemap face.
+    /// Swapchains always transition as a whole.
+    /// With VKF_Synchronization2 each barrier gets its own stages, any stage or access flags left at 0 are derived from the layouts it transitions between.
     /// </summary>
     struct TextureBarrier
     {
@@ -501,12 +515,20 @@ namespace LinaGX
         TextureState toState;
         uint32       srcAccessFlags;
         uint32       dstAccessFlags;
+        bool         discardContents; // Transient textures only, previous contents are undefined. Set on the first use in a frame as another texture might have used the memory.
+        uint32       baseMip;
+        uint32       mipCount; // 0 for all mips starting from baseMip.
+        uint32       baseLayer;
+        uint32       layerCount;    // 0 for all layers starting from baseLayer.
+        uint32       srcStageFlags; // VKF_Synchronization2 only, CMDBarrier::srcStageFlags otherwise.
+        uint32       dstStageFlags; // VKF_Synchronization2 only, CMDBarrier::dstStageFlags otherwise.
     };
 
     /// <summary>
     /// If targeting Vulkan, need to use srcAccessFlags and dstAccessFlags. Use AccessFlags enumeration.
     /// In DX12 access flags are not required.
     /// In Metal no transition/barrier is required at all.
+    /// With VKF_Synchronization2 each barrier gets its own stages, destination stage & access flags left at 0 are derived from toState, source ones from srcAccessFlags.
     /// </summary>
     struct ResourceBarrier
     {
@@ -514,6 +536,8 @@ namespace LinaGX
         ResourceBarrierState toState;
         uint32               srcAccessFlags;
         uint32               dstAccessFlags;
+        uint32               srcStageFlags; // VKF_Synchronization2 only, CMDBarrier::srcStageFlags otherwise.
+        uint32               dstStageFlags; // VKF_Synchronization2 only, CMDBarrier::dstStageFlags otherwise.
     };
 
     /// <summary>
@@ -529,12 +553,15 @@ namespace LinaGX
 
     enum VulkanFeatureFlags
     {
-        VKF_Bindless          = 1 << 0,
-        VKF_UpdateAfterBind   = 1 << 1,
-        VKF_MultiDrawIndirect = 1 << 2,
-        VKF_SamplerAnisotropy = 1 << 3,
-        VKF_DepthClamp        = 1 << 4,
-        VKF_DepthBiasClamp    = 1 << 5,
+        VKF_Bindless             = 1 << 0,
+        VKF_UpdateAfterBind      = 1 << 1,
+        VKF_MultiDrawIndirect    = 1 << 2,
+        VKF_SamplerAnisotropy    = 1 << 3,
+        VKF_DepthClamp           = 1 << 4,
+        VKF_DepthBiasClamp       = 1 << 5,
+        VKF_PipelineStats        = 1 << 6,
+        VKF_ConditionalRendering = 1 << 7,
+        VKF_Synchronization2     = 1 << 8,
     };
 
     struct SubmitDesc
@@ -586,12 +613,28 @@ namespace LinaGX
 
     struct CommandStreamDesc
     {
-        CommandType type              = CommandType::Graphics;
-        uint32      commandCount      = 200;   // Maximum number of commands that can be recorded in this stream.
-        size_t      totalMemoryLimit  = 24000; // Maximum allowed memory pool, this amount will be reserved for the lifetime of stream, so experiment and keep it sensible.
-        size_t      auxMemorySize     = 4096;  // Maximum allowed auxilary memory poolthis amount will be reserved for the lifetime of stream, so experiment and keep it sensible.
-        size_t      constantBlockSize = 64;    // Not used in Vulkan, but in DX12 and Metal used to store constant bindings data in the shaders. If constants to be bound is bigger than available space, they are MALLOC'ed directly.
-        const char* debugName         = "LinaGXCommandStream";
+        CommandType type                 = CommandType::Graphics;
+        uint32      commandCount         = 200;   // Initial capacity of the command list, grows on demand.
+        size_t      totalMemoryLimit     = 24000; // Page size for command memory. Pages are chained on demand and recycled after submission, so this doesn't need to cover the worst frame.
+        size_t      auxMemorySize        = 4096;  // Page size for auxiliary memory, grows the same way as command memory.
+        size_t      constantBlockSize    = 64;    // Not used in Vulkan, but in DX12 and Metal used to store constant bindings data in the shaders. If constants to be bound is bigger than available space, they are MALLOC'ed directly.
+        const char* debugName            = "LinaGXCommandStream";
+        bool        persistent           = false; // Commands are kept after submission and only translated on the first CloseCommandStreams(), later closes and submissions reuse the translated buffer until CommandStream::Invalidate(). Streams with queries or uploads are translated again when needed, see CommandStream::Invalidate() for restrictions.
+        bool        coalesceIndexedDraws = false; // Vulkan only. Back-to-back CMDDrawIndexedInstanced commands, with nothing but redundant state in between, are issued as a single vkCmdDrawIndexedIndirect from a transient buffer. Falls back to separate draws without multi-draw indirect support, and never applies to pipelines reading LGX_DRAW_ID.
+    };
+
+    struct CommandStreamStatistics
+    {
+        uint32 commandCount               = 0; // Commands recorded since the last submission.
+        uint32 commandCountHighWaterMark  = 0;
+        size_t commandMemoryUsed          = 0;
+        size_t commandMemoryHighWaterMark = 0;
+        size_t commandMemoryReserved      = 0;
+        uint32 commandMemoryPageCount     = 0;
+        size_t auxMemoryUsed              = 0;
+        size_t auxMemoryHighWaterMark     = 0;
+        size_t auxMemoryReserved          = 0;
+        uint32 auxMemoryPageCount         = 0;
     };
 
     struct ShaderCompileData
@@ -602,6 +645,13 @@ namespace LinaGX
         DataBlob      outBlob     = {};
     };
 
+    struct ShaderCompileBatchEntry
+    {
+        LINAGX_VEC<ShaderCompileData> compileData;
+        ShaderLayout                  outLayout = {};
+        bool                          success   = false;
+    };
+
     struct ColorBlendAttachment
     {
         bool                            blendEnabled        = false;
@@ -699,6 +749,26 @@ namespace LinaGX
         const char*          debugName                = "LinaGXTexture";
     };
 
+    struct TransientTextureDesc
+    {
+        TextureDesc desc;
+        uint32      firstUse = 0; // First & last use within a frame, e.g. pass indices. Textures whose ranges don't overlap can share memory.
+        uint32      lastUse  = 0;
+    };
+
+    struct TransientTextureGroupDesc
+    {
+        LINAGX_VEC<TransientTextureDesc> textures;
+        const char*                      debugName = "LinaGXTransientTextureGroup";
+    };
+
+    struct TransientTextureGroupInfo
+    {
+        LINAGX_VEC<uint32> textures;          // In the same order as TransientTextureGroupDesc.textures.
+        uint64             allocatedSize = 0; // Total size of the memory blocks the textures are placed in.
+        uint64             requiredSize  = 0; // Total size the textures would take with dedicated allocations.
+    };
+
     struct ResourceDesc
     {
         uint64       size          = 0;
@@ -714,6 +784,33 @@ namespace LinaGX
         const char* debugName = "LinaGXQueue";
     };
 
+    struct QueryPoolDesc
+    {
+        QueryType   type       = QueryType::Timestamp;
+        uint32      queryCount = 32; // Queries available to a single frame, the pool keeps a set for each frame in flight.
+        const char* debugName  = "LinaGXQueryPool";
+    };
+
+    struct PipelineStatistics
+    {
+        uint64 inputVertices             = 0;
+        uint64 inputPrimitives           = 0;
+        uint64 vertexShaderInvocations   = 0;
+        uint64 clippingInvocations       = 0;
+        uint64 clippingPrimitives        = 0;
+        uint64 fragmentShaderInvocations = 0;
+        uint64 computeShaderInvocations  = 0;
+    };
+
+    struct QueryResults
+    {
+        const uint64*             values     = nullptr; // One per query, timestamps are in nanoseconds. Occlusion results are only meaningful as zero or non-zero.
+        const PipelineStatistics* statistics = nullptr; // One per query, PipelineStatistics pools only.
+        const uint8*              available  = nullptr; // One per query, 0 if the query wasn't written in that frame.
+        uint32                    queryCount = 0;
+        uint64                    frame      = 0; // PerformanceStats.totalFrames of the frame the queries were written in.
+    };
+
     struct DescriptorBinding
     {
         uint32                  descriptorCount  = 1;
@@ -35,12 +35,53 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "LinaGX/Common/CommonGfx.hpp"
+#include <mutex>
+#include <atomic>
 
 namespace LinaGX
 {
     class Instance;
     class CommandStream;
 
+    enum class DeferredObjectType : uint8
+    {
+        Texture,
+        Resource,
+        Shader,
+        DescriptorSet,
+        Sampler,
+        QueryPool,
+        TransientTextureGroup,
+    };
+
+    struct DeferredDestruction
+    {
+        uint64             timelineValue = 0; // Frame timeline value that has to be reached on the GPU before the object can go, see Backend::SignalFrameTimeline().
+        uint32             handle        = 0;
+        DeferredObjectType type          = DeferredObjectType::Texture;
+    };
+
+    /// <summary>
+    /// Memory requirements of a single transient texture, see Backend::PackTransientAllocations().
+    /// </summary>
+    struct TransientAllocation
+    {
+        uint64 size      = 0;
+        uint64 alignment = 1;
+        uint32 key       = 0; // Only allocations with the same key can share a block, e.g. memory type bits or heap category.
+        uint32 firstUse  = 0;
+        uint32 lastUse   = 0;
+        uint32 block     = 0; // Filled by PackTransientAllocations().
+        uint64 offset    = 0; // Filled by PackTransientAllocations().
+    };
+
+    struct TransientBlock
+    {
+        uint64 size      = 0;
+        uint64 alignment = 1;
+        uint32 key       = 0;
+    };
+
     class Backend
     {
     public:
@@ -54,38 +95,99 @@ namespace LinaGX
         virtual void EndFrame()                          = 0;
         virtual void Present(const PresentDesc& present) = 0;
 
-        virtual uint16 CreateUserSemaphore()                                            = 0;
-        virtual void   DestroyUserSemaphore(uint16 handle)                              = 0;
-        virtual void   WaitForUserSemaphore(uint16 handle, uint64 value)                = 0;
-        virtual uint8  CreateSwapchain(const SwapchainDesc& desc)                       = 0;
-        virtual void   DestroySwapchain(uint8 handle)                                   = 0;
-        virtual void   RecreateSwapchain(const SwapchainRecreateDesc& desc)             = 0;
-        virtual void   SetSwapchainActive(uint8 swp, bool isActive)                     = 0;
-        virtual uint16 CreateShader(const ShaderDesc& shaderDesc)                       = 0;
-        virtual void   DestroyShader(uint16 handle)                                     = 0;
-        virtual uint32 CreateTexture(const TextureDesc& desc)                           = 0;
-        virtual void   DestroyTexture(uint32 handle)                                    = 0;
-        virtual uint32 CreateSampler(const SamplerDesc& desc)                           = 0;
-        virtual void   DestroySampler(uint32 handle)                                    = 0;
-        virtual uint32 CreateResource(const ResourceDesc& desc)                         = 0;
-        virtual void   DestroyResource(uint32 handle)                                   = 0;
-        virtual void   MapResource(uint32 resource, uint8*& ptr)                        = 0;
-        virtual void   UnmapResource(uint32 resource)                                   = 0;
-        virtual uint16 CreateDescriptorSet(const DescriptorSetDesc& desc)               = 0;
-        virtual void   DestroyDescriptorSet(uint16 handle)                              = 0;
-        virtual void   DescriptorUpdateBuffer(const DescriptorUpdateBufferDesc& desc)   = 0;
-        virtual void   DescriptorUpdateImage(const DescriptorUpdateImageDesc& desc)     = 0;
-        virtual uint16 CreatePipelineLayout(const PipelineLayoutDesc& desc)             = 0;
-        virtual void   DestroyPipelineLayout(uint16 layout)                             = 0;
-        virtual uint32 CreateCommandStream(const CommandStreamDesc& desc)               = 0;
-        virtual void   DestroyCommandStream(uint32 handle)                              = 0;
-        virtual void   SetCommandStreamImpl(uint32 handle, CommandStream* stream)       = 0;
-        virtual void   CloseCommandStreams(CommandStream** streams, uint32 streamCount) = 0;
-        virtual void   SubmitCommandStreams(const SubmitDesc& desc)                     = 0;
-        virtual uint8  CreateQueue(const QueueDesc& desc)                               = 0;
-        virtual void   DestroyQueue(uint8 queue)                                        = 0;
-        virtual uint8  GetPrimaryQueue(CommandType type)                                = 0;
+        virtual uint16 CreateUserSemaphore()                                                                                  = 0;
+        virtual void   DestroyUserSemaphore(uint16 handle)                                                                    = 0;
+        virtual void   WaitForUserSemaphore(uint16 handle, uint64 value)                                                      = 0;
+        virtual uint8  CreateSwapchain(const SwapchainDesc& desc)                                                             = 0;
+        virtual void   DestroySwapchain(uint8 handle)                                                                         = 0;
+        virtual void   RecreateSwapchain(const SwapchainRecreateDesc& desc)                                                   = 0;
+        virtual void   SetSwapchainActive(uint8 swp, bool isActive)                                                           = 0;
+        virtual uint16 CreateShader(const ShaderDesc& shaderDesc)                                                             = 0;
+        virtual void   DestroyShader(uint16 handle)                                                                           = 0;
+        virtual uint32 CreateTexture(const TextureDesc& desc)                                                                 = 0;
+        virtual void   DestroyTexture(uint32 handle)                                                                          = 0;
+        virtual uint32 CreateSampler(const SamplerDesc& desc)                                                                 = 0;
+        virtual void   DestroySampler(uint32 handle)                                                                          = 0;
+        virtual uint32 CreateResource(const ResourceDesc& desc)                                                               = 0;
+        virtual void   DestroyResource(uint32 handle)                                                                         = 0;
+        virtual void   MapResource(uint32 resource, uint8*& ptr)                                                              = 0;
+        virtual void   UnmapResource(uint32 resource)                                                                         = 0;
+        virtual uint16 CreateDescriptorSet(const DescriptorSetDesc& desc)                                                     = 0;
+        virtual void   DestroyDescriptorSet(uint16 handle)                                                                    = 0;
+        virtual void   DescriptorUpdateBuffer(const DescriptorUpdateBufferDesc& desc)                                         = 0;
+        virtual void   DescriptorUpdateImage(const DescriptorUpdateImageDesc& desc)                                           = 0;
+        virtual uint16 CreatePipelineLayout(const PipelineLayoutDesc& desc)                                                   = 0;
+        virtual void   DestroyPipelineLayout(uint16 layout)                                                                   = 0;
+        virtual uint32 CreateCommandStream(const CommandStreamDesc& desc)                                                     = 0;
+        virtual void   DestroyCommandStream(uint32 handle)                                                                    = 0;
+        virtual void   SetCommandStreamImpl(uint32 handle, CommandStream* stream)                                             = 0;
+        virtual void   CloseCommandStreams(CommandStream** streams, uint32 streamCount)                                       = 0;
+        virtual void   SubmitCommandStreams(const SubmitDesc& desc)                                                           = 0;
+        virtual uint8  CreateQueue(const QueueDesc& desc)                                                                     = 0;
+        virtual void   DestroyQueue(uint8 queue)                                                                              = 0;
+        virtual uint8  GetPrimaryQueue(CommandType type)                                                                      = 0;
+        virtual bool   LoadPipelineCache(const uint8* data, size_t size)                                                      = 0;
+        virtual bool   GetPipelineCacheData(LINAGX_VEC<uint8>& outData)                                                       = 0;
+        virtual uint16 CreateQueryPool(const QueryPoolDesc& desc)                                                             = 0;
+        virtual void   DestroyQueryPool(uint16 handle)                                                                        = 0;
+        virtual bool   GetQueryResults(uint16 handle, QueryResults& outResults)                                               = 0;
+        virtual uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) = 0;
+        virtual void   DestroyTransientTextureGroup(uint16 handle)                                                            = 0;
 
         static Backend* CreateBackend();
+
+        /// <summary>
+        /// Queues the object to be destroyed once the GPU has finished everything submitted so far, including submissions whose fence is not signaled yet.
+        /// Can be called from any thread, including translation jobs.
+        /// </summary>
+        void DeferDestruction(DeferredObjectType type, uint32 handle);
+
+        /// <summary>
+        /// Pops the oldest queued destruction if the GPU is done with it, or any queued destruction if all is true.
+        /// Timeline values are handed out in order, so the queue is sorted by retirement and this never looks past the first object still in use.
+        /// </summary>
+        bool PopDeferredDestruction(bool all, DeferredDestruction& outDestruction);
+
+    protected:
+        /// <summary>
+        /// Returns the next frame timeline value. Backends call this whenever they signal a fence or semaphore that StartFrame() waits on, and keep the value next to it.
+        /// </summary>
+        uint64 SignalFrameTimeline();
+
+        /// <summary>
+        /// Backends call this once a wait returned, with the largest timeline value kept next to the fences or semaphores waited on.
+        /// StartFrame() has to wait on every queue submitted to in the frame index, not only graphics, or objects still used by the others would be retired.
+        /// </summary>
+        void CompleteFrameTimeline(uint64 value);
+
+        /// <summary>
+        /// Places the allocations into as few blocks as possible, one per key. Allocations only overlap in memory if their use ranges don't overlap.
+        /// Largest allocations are placed first, each at the lowest aligned offset that doesn't collide with an already placed allocation alive at the same time.
+        /// </summary>
+        static void PackTransientAllocations(LINAGX_VEC<TransientAllocation>& allocations, LINAGX_VEC<TransientBlock>& outBlocks);
+
+        /// <summary>
+        /// Calls TranslateCommandStream() for all streams. If Config.dispatchJobsCallback is set, streams are translated concurrently,
+        /// except the ones containing any of the commands in serialCommandMask (bits of CommandID), which are translated on the calling thread first.
+        /// Use the mask for commands that modify backend-wide state during translation.
+        /// Persistent streams that are already translated are skipped, their backend buffers are submitted as they are. frameIndex is the current frame in flight,
+        /// persistent streams with queries translated in another frame and persistent streams with uploads are translated again.
+        /// </summary>
+        void         TranslateCommandStreams(CommandStream** streams, uint32 streamCount, uint64 serialCommandMask, uint32 frameIndex);
+        virtual void TranslateCommandStream(CommandStream*) {}
+
+        /// <summary>
+        /// Whether TranslateCommandStreams() would translate the stream in frameIndex, use it to skip per-translation preparation of streams that are replayed.
+        /// </summary>
+        bool NeedsTranslation(const CommandStream* stream, uint32 frameIndex) const;
+
+    private:
+        void TranslateIfNeeded(CommandStream* stream, uint32 frameIndex);
+
+    private:
+        std::mutex                        m_deferredDestructionMtx;
+        LINAGX_DEQUE<DeferredDestruction> m_deferredDestructions;
+        std::atomic<uint64>               m_signaledTimeline  = 0;
+        std::atomic<uint64>               m_completedTimeline = 0;
     };
 } // namespace LinaGX
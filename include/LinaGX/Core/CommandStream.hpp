@@ -44,6 +44,16 @@ namespace LinaGX
     class DX12Backend;
     class MTLBackend;
     class VKBackend;
+    class NullBackend;
+
+    /// <summary>
+    /// Every command is stored as this header followed by the command structure and any inline payload.
+    /// Header is padded so the command that follows is naturally aligned for all of its members.
+    /// </summary>
+    struct alignas(8) CommandHeader
+    {
+        LINAGX_TYPEID tid;
+    };
 
     class CommandStream
     {
@@ -58,25 +68,23 @@ namespace LinaGX
         template <typename T>
         T* AddCommand()
         {
-            LOGA((m_commandCount < m_maxCommands), "Command Stream -> Max command count (%d) is exceeded (%d)!", m_maxCommands, m_commandCount);
-            const LINAGX_TYPEID tid      = LGX_GetTypeID<T>();
-            const size_t        typeSize = sizeof(LINAGX_TYPEID);
+            static_assert(alignof(T) <= alignof(CommandHeader), "Command requires stricter alignment than the command header provides!");
+            static_assert(T::TypeID < 64, "Command id doesn't fit the recorded command mask!");
 
-            uint8* currentHead = m_commandBuffer + m_commandIndex;
+            uint8* currentHead = m_commandArena.Allocate(sizeof(CommandHeader) + sizeof(T), alignof(CommandHeader));
 
             // Place type header.
-            LINAGX_MEMCPY(currentHead, &tid, typeSize);
-
-            // Find command start.
-            uint8* ptr = currentHead + typeSize;
+            reinterpret_cast<CommandHeader*>(currentHead)->tid = T::TypeID;
 
             // Assign command ptr
-            m_commands[m_commandCount] = currentHead;
-            m_commandIndex += sizeof(T) + typeSize;
-            LOGA(m_commandIndex < m_commandBufferSize, "Exceeded command memory limit!");
+            if (m_commandCount < m_commands.size())
+                m_commands[m_commandCount] = currentHead;
+            else
+                m_commands.push_back(currentHead);
 
             m_commandCount++;
-            T* retVal = reinterpret_cast<T*>(ptr);
+            m_recordedCommandMask |= 1ull << T::TypeID;
+            T* retVal = reinterpret_cast<T*>(currentHead + sizeof(CommandHeader));
 
             // Commons
             retVal->Init();
@@ -84,6 +92,45 @@ namespace LinaGX
             return retVal;
         }
 
+        /// <summary>
+        /// Places the given values in command memory, right after the last added command, instead of the separate aux memory block.
+        /// Use it for the array parameters of the command you've just added, e.g. barriers, attachments or descriptor set handles,
+        /// so the backend reads them from the same cache lines as the command itself while translating.
+        /// The command still refers to them through its pointer members, only the distance to the pointed memory changes.
+        /// Same lifetime rules as EmplaceAuxMemory apply.
+        /// </summary>
+        /// <returns>The beginning address of the memory block containing the values you've passed.</returns>
+        template <typename T, typename... Args>
+        T* EmplaceInline(T firstValue, Args... remainingValues)
+        {
+            const T values[] = {firstValue, static_cast<T>(remainingValues)...};
+            uint8*  head     = m_commandArena.Allocate(sizeof(values), alignof(T));
+            LINAGX_MEMCPY(head, values, sizeof(values));
+            return reinterpret_cast<T*>(head);
+        }
+
+        /// <summary>
+        /// Places size bytes from data right after the last added command, see EmplaceInline().
+        /// </summary>
+        template <typename T>
+        T* EmplaceInline(void* data, size_t size)
+        {
+            uint8* head = m_commandArena.Allocate(size, alignof(T));
+            LINAGX_MEMCPY(head, data, size);
+            return reinterpret_cast<T*>(head);
+        }
+
+        /// <summary>
+        /// Reserves a zero-initialized block of size bytes right after the last added command, you can fill the data yourself. See EmplaceInline().
+        /// </summary>
+        template <typename T>
+        T* EmplaceInlineSizeOnly(size_t size)
+        {
+            uint8* head = m_commandArena.Allocate(size, alignof(T));
+            LINAGX_MEMSET(head, 0, size);
+            return reinterpret_cast<T*>(head);
+        }
+
         /// <summary>
         /// Some commands you add require memory addresses for some parameters, specifically arrays.
         /// But none of the commands will be executed immediately as you add them, but will be executed upon calling CloseCommandStreams().
@@ -96,21 +143,11 @@ namespace LinaGX
         template <typename T, typename... Args>
         T* EmplaceAuxMemory(T firstValue, Args... remainingValues)
         {
-            uint8* initialHead = m_auxMemory + m_auxMemoryIndex;
-
-            // Place the first value in memory
-            uint8* currentHead = initialHead;
-            LINAGX_MEMCPY(currentHead, &firstValue, sizeof(T));
-            m_auxMemoryIndex += sizeof(T);
-            LOGA(m_auxMemoryIndex < m_auxMemorySize, "Exceeded aux memory limit!");
-
-            // Recursively place the remaining values in memory
-            if constexpr (sizeof...(remainingValues) > 0)
-            {
-                EmplaceAuxMemory<T>(remainingValues...);
-            }
-
-            return reinterpret_cast<T*>(initialHead);
+            // All values are placed in a single allocation so they stay contiguous even if the aux memory needs a new page.
+            const T values[] = {firstValue, static_cast<T>(remainingValues)...};
+            uint8*  head     = m_auxArena.Allocate(sizeof(values), alignof(T));
+            LINAGX_MEMCPY(head, values, sizeof(values));
+            return reinterpret_cast<T*>(head);
         }
 
         /// <summary>
@@ -125,11 +162,9 @@ namespace LinaGX
         template <typename T>
         T* EmplaceAuxMemory(void* data, size_t size)
         {
-            uint8* initialHead = m_auxMemory + m_auxMemoryIndex;
-            LINAGX_MEMCPY(initialHead, data, size);
-            m_auxMemoryIndex += static_cast<uint32>(size);
-            LOGA(m_auxMemoryIndex < m_auxMemorySize, "Exceeded aux memory limit!");
-            return reinterpret_cast<T*>(initialHead);
+            uint8* head = m_auxArena.Allocate(size, alignof(T));
+            LINAGX_MEMCPY(head, data, size);
+            return reinterpret_cast<T*>(head);
         }
 
         /// <summary>
@@ -140,14 +175,40 @@ namespace LinaGX
         /// In such cases, use EmplaceAuxMemory to place your variables' values alongside the command stream's persistenly mapped memory space. The space will only be
         /// cleared once all the commands are executed.
         /// </summary>
-        /// <returns>The beginning address of an empty memory block of size 'size', you can fill the data yourself.</returns>
+        /// <returns>The beginning address of a zero-initialized memory block of size 'size', you can fill the data yourself. Fields you don't set stay at their defaults of 0.</returns>
         template <typename T>
         T* EmplaceAuxMemorySizeOnly(size_t size)
         {
-            uint8* initialHead = m_auxMemory + m_auxMemoryIndex;
-            m_auxMemoryIndex += static_cast<uint32>(size);
-            LOGA(m_auxMemoryIndex < m_auxMemorySize, "Exceeded aux memory limit!");
-            return reinterpret_cast<T*>(initialHead);
+            uint8* head = m_auxArena.Allocate(size, alignof(T));
+            LINAGX_MEMSET(head, 0, size);
+            return reinterpret_cast<T*>(head);
+        }
+
+        /// <summary>
+        /// Memory usage of this stream, use the high-water marks to size CommandStreamDesc for your worst frame.
+        /// </summary>
+        CommandStreamStatistics GetStatistics() const;
+
+        /// <summary>
+        /// Whether any of the commands in mask (bits of CommandID) have been recorded since the last submission.
+        /// </summary>
+        inline bool HasAnyCommand(uint64 mask) const
+        {
+            return (m_recordedCommandMask & mask) != 0;
+        }
+
+        /// <summary>
+        /// Drops the commands and the translated buffer of a persistent stream, so it can be recorded and closed again. Has no effect on regular streams.
+        /// The stream must not be in flight on the GPU anymore, keep one persistent stream per frame in flight or Join() before invalidating.
+        /// Persistent streams are replayed as they were translated: they can't render into or transition swapchains, and any texture or resource they reference must outlive them.
+        /// Streams with queries are translated again when closed in a different frame in flight, streams with CMDCopyBufferToTexture2D on every close.
+        /// Both only replay correctly in the frame they were last closed in, so close them again before submitting them in another frame.
+        /// </summary>
+        void Invalidate();
+
+        inline bool IsPersistent() const
+        {
+            return m_isPersistent;
         }
 
         inline uint32 GetConstantBlockSize() const
@@ -162,27 +223,31 @@ namespace LinaGX
 
     private:
         friend class Instance;
+        friend class Backend;
         friend class VKBackend;
         friend class MTLBackend;
         friend class DX12Backend;
+        friend class NullBackend;
         ~CommandStream();
         void Reset();
 
+        bool IsFrameBound() const;
+
     private:
-        uint8**     m_commands     = nullptr;
-        uint32      m_commandCount = 0;
-        uint32      m_gpuHandle    = 0;
-        Backend*    m_backend      = nullptr;
-        CommandType m_type         = CommandType::Graphics;
-
-        uint8* m_commandBuffer     = nullptr;
-        size_t m_commandIndex      = 0;
-        uint32 m_maxCommands       = 0;
-        uint32 m_commandBufferSize = 0;
-
-        uint8* m_auxMemory      = nullptr;
-        uint32 m_auxMemoryIndex = 0;
-        uint32 m_auxMemorySize  = 0;
+        LINAGX_VEC<uint8*> m_commands; // Command headers in recording order. Arena pages aren't contiguous, so backends walk this instead of the arena.
+        uint32             m_commandCount         = 0;
+        uint32             m_commandHighWaterMark = 0;
+        uint64             m_recordedCommandMask  = 0;
+        uint32             m_gpuHandle            = 0;
+        Backend*           m_backend              = nullptr;
+        CommandType        m_type                 = CommandType::Graphics;
+        bool               m_isPersistent         = false;
+        bool               m_isTranslated         = false; // Persistent streams only, set once the backend has translated the recorded commands.
+        uint32             m_translatedFrameIndex = 0;     // Frame in flight the stream was last translated in.
+
+        PagedLinearAllocator m_commandArena;
+        PagedLinearAllocator m_auxArena;
+        PagedLinearAllocator m_scratchArena; // Backend-owned, temporary API structures built while translating. Reset at the start of every translation.
 
         uint8* m_constantBlockMemory = nullptr;
         uint32 m_constantBlockSize   = 0;
@@ -39,6 +39,44 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace LinaGX
 {
 
+    /// <summary>
+    /// Dense compile-time identifiers of all commands, written as the header of each command recorded in a CommandStream.
+    /// Backends use them to directly index their command function tables.
+    /// </summary>
+    enum CommandID : LINAGX_TYPEID
+    {
+        CMDID_BeginRenderPass           = 0,
+        CMDID_EndRenderPass             = 1,
+        CMDID_SetViewport               = 2,
+        CMDID_SetScissors               = 3,
+        CMDID_BindPipeline              = 4,
+        CMDID_DrawInstanced             = 5,
+        CMDID_DrawIndexedInstanced      = 6,
+        CMDID_DrawIndexedIndirect       = 7,
+        CMDID_DrawIndirect              = 8,
+        CMDID_CopyResource              = 9,
+        CMDID_CopyBufferToTexture2D     = 10,
+        CMDID_CopyTexture2DToBuffer     = 11,
+        CMDID_CopyTexture               = 12,
+        CMDID_BindVertexBuffers         = 13,
+        CMDID_BindIndexBuffers          = 14,
+        CMDID_BindDescriptorSets        = 15,
+        CMDID_BindConstants             = 16,
+        CMDID_Dispatch                  = 17,
+        CMDID_ExecuteSecondaryStream    = 18,
+        CMDID_Debug                     = 19,
+        CMDID_DebugBeginLabel           = 20,
+        CMDID_DebugEndLabel             = 21,
+        CMDID_Barrier                   = 22,
+        CMDID_WriteTimestamp            = 23,
+        CMDID_BeginQuery                = 24,
+        CMDID_EndQuery                  = 25,
+        CMDID_ResolveQueries            = 26,
+        CMDID_BeginConditionalRendering = 27,
+        CMDID_EndConditionalRendering   = 28,
+        CMDID_Count                     = 29,
+    };
+
     /// <summary>
     /// Defines a color render target.
     /// </summary>
@@ -79,6 +117,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBeginRenderPass
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BeginRenderPass;
+
         RenderPassColorAttachment*       colorAttachments;
         uint32                           colorAttachmentCount;
         RenderPassDepthStencilAttachment depthStencilAttachment;
@@ -100,6 +140,8 @@ namespace LinaGX
     /// </summary>
     struct CMDEndRenderPass
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_EndRenderPass;
+
         inline void Init()
         {
         }
@@ -110,6 +152,8 @@ namespace LinaGX
     /// </summary>
     struct CMDSetViewport
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_SetViewport;
+
         float  x;
         float  y;
         uint32 width;
@@ -131,6 +175,8 @@ namespace LinaGX
     /// </summary>
     struct CMDSetScissors
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_SetScissors;
+
         uint32 x;
         uint32 y;
         uint32 width;
@@ -147,6 +193,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBindPipeline
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BindPipeline;
+
         uint16 shader;
 
         inline void Init()
@@ -160,6 +208,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDrawInstanced
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DrawInstanced;
+
         uint32 vertexCountPerInstance;
         uint32 instanceCount;
         uint32 startVertexLocation;
@@ -179,6 +229,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDrawIndexedInstanced
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DrawIndexedInstanced;
+
         uint32 indexCountPerInstance;
         uint32 instanceCount;
         uint32 startIndexLocation;
@@ -200,6 +252,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDrawIndexedIndirect
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DrawIndexedIndirect;
+
         uint32 indirectBuffer;
         uint32 indirectBufferOffset;
         uint32 count;
@@ -217,6 +271,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDrawIndirect
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DrawIndirect;
+
         uint32 indirectBuffer;
         uint32 indirectBufferOffset;
         uint32 count;
@@ -234,6 +290,8 @@ namespace LinaGX
     /// </summary>
     struct CMDCopyResource
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_CopyResource;
+
         uint32 source;
         uint32 destination;
 
@@ -249,6 +307,8 @@ namespace LinaGX
     /// </summary>
     struct CMDCopyBufferToTexture2D
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_CopyBufferToTexture2D;
+
         uint32         destTexture;
         uint32         mipLevels;
         uint32         destinationSlice;
@@ -268,6 +328,8 @@ namespace LinaGX
     /// </summary>
     struct CMDCopyTexture2DToBuffer
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_CopyTexture2DToBuffer;
+
         uint32 destBuffer;
         uint32 srcTexture;
         uint32 srcLayer;
@@ -287,6 +349,8 @@ namespace LinaGX
     /// </summary>
     struct CMDCopyTexture
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_CopyTexture;
+
         uint32 srcTexture;
         uint32 dstTexture;
         uint32 srcLayer;
@@ -310,6 +374,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBindVertexBuffers
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BindVertexBuffers;
+
         uint32 slot;
         uint32 resource;
         uint32 vertexSize;
@@ -329,6 +395,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBindIndexBuffers
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BindIndexBuffers;
+
         uint32    resource;
         uint64    offset;
         IndexType indexType;
@@ -358,6 +426,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBindDescriptorSets
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BindDescriptorSets;
+
         uint32                     firstSet;
         uint32*                    allocationIndices;
         uint32                     setCount;
@@ -389,6 +459,8 @@ namespace LinaGX
     /// </summary>
     struct CMDBindConstants
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BindConstants;
+
         void*        data;
         uint32       offset;
         uint32       size;
@@ -410,6 +482,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDispatch
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_Dispatch;
+
         uint32 groupSizeX;
         uint32 groupSizeY;
         uint32 groupSizeZ;
@@ -423,10 +497,14 @@ namespace LinaGX
     };
 
     /// <summary>
-    ///
+    /// Executes a stream of type CommandType::Secondary. Close the secondary streams in the same CloseCommandStreams() call as the stream executing them,
+    /// they are translated first, concurrently if Config.dispatchJobsCallback is set. In Vulkan, secondary streams executed within a render pass inherit its attachment formats,
+    /// viewport and scissors, such a render pass can't record anything but CMDExecuteSecondaryStream and debug commands. Consecutive executions are issued with a single API call.
     /// </summary>
     struct CMDExecuteSecondaryStream
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_ExecuteSecondaryStream;
+
         CommandStream* secondaryStream;
 
         inline void Init()
@@ -440,6 +518,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDebug
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_Debug;
+
         uint32 id;
 
         inline void Init()
@@ -454,6 +534,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDebugBeginLabel
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DebugBeginLabel;
+
         const char* label;
 
         inline void Init()
@@ -467,6 +549,8 @@ namespace LinaGX
     /// </summary>
     struct CMDDebugEndLabel
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_DebugEndLabel;
+
         inline void Init()
         {
         }
@@ -475,10 +559,13 @@ namespace LinaGX
     /// <summary>
     /// Barrier operations in Vulkan, resource transitions in DX12, dull face of emptiness in Metal.
     /// If targeting Vulkan, srcStageFlags and dstStageFlags are required. Use PipelineStageFlags enumeration.
+    /// With VKF_Synchronization2 they only apply to memory barriers and to the texture & resource barriers whose stages can't be derived, e.g. the first use of a discarded texture.
     /// In DX12 stage flags are not required to be filled. In Metal no transition/barriers are needed.
     /// </summary>
     struct CMDBarrier
     {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_Barrier;
+
         uint32           textureBarrierCount;
         TextureBarrier*  textureBarriers;
         uint32           resourceBarrierCount;
@@ -501,30 +588,142 @@ namespace LinaGX
         }
     };
 
+    /// <summary>
+    /// Writes the GPU time once all previous commands have finished executing. Results are read back with Instance::GetQueryResults() framesInFlight frames later.
+    /// Each query can be written once per frame, from graphics or secondary streams. Not supported in Metal.
+    /// </summary>
+    struct CMDWriteTimestamp
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_WriteTimestamp;
+
+        uint16 queryPool;
+        uint32 queryIndex;
+
+        inline void Init()
+        {
+            queryPool  = 0;
+            queryIndex = 0;
+        }
+    };
+
+    /// <summary>
+    /// Starts an occlusion or pipeline statistics query, every draw until the matching CMDEndQuery contributes to it.
+    /// Same rules as CMDWriteTimestamp apply to query indices. Occlusion queries must begin and end within the same render pass. Not supported in Metal.
+    /// </summary>
+    struct CMDBeginQuery
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BeginQuery;
+
+        uint16 queryPool;
+        uint32 queryIndex;
+
+        inline void Init()
+        {
+            queryPool  = 0;
+            queryIndex = 0;
+        }
+    };
+
+    struct CMDEndQuery
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_EndQuery;
+
+        uint16 queryPool;
+        uint32 queryIndex;
+
+        inline void Init()
+        {
+            queryPool  = 0;
+            queryIndex = 0;
+        }
+    };
+
+    /// <summary>
+    /// Copies the results of queries ended earlier in this frame into a resource created with TH_QueryResult, on the GPU, without waiting on the CPU.
+    /// Each query writes a uint64 at destinationOffset + i * 8, which can be used as the condition of CMDBeginConditionalRendering, e.g. for occlusion culling.
+    /// Pipeline statistics are written in the API's own layout, read them through Instance::GetQueryResults() instead.
+    /// Must be recorded outside of render passes. The destination must be in ResourceBarrierState::TransferWrite, use CMDBarrier to transition it afterwards.
+    /// </summary>
+    struct CMDResolveQueries
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_ResolveQueries;
+
+        uint16 queryPool;
+        uint32 firstQuery;
+        uint32 queryCount;
+        uint32 destination;
+        uint64 destinationOffset;
+
+        inline void Init()
+        {
+            queryPool         = 0;
+            firstQuery        = 0;
+            queryCount        = 1;
+            destination       = 0;
+            destinationOffset = 0;
+        }
+    };
+
+    /// <summary>
+    /// Draws and dispatches until CMDEndConditionalRendering are skipped by the GPU if the value at offset in resource is zero, or non-zero if inverted.
+    /// Resource must be in ResourceBarrierState::ConditionalRenderingRead, offset must be a multiple of 8.
+    /// Vulkan requires VKF_ConditionalRendering. Metal doesn't support it and always executes the commands, which is still correct for culling.
+    /// </summary>
+    struct CMDBeginConditionalRendering
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_BeginConditionalRendering;
+
+        uint32 resource;
+        uint64 offset;
+        bool   inverted;
+
+        inline void Init()
+        {
+            resource = 0;
+            offset   = 0;
+            inverted = false;
+        }
+    };
+
+    struct CMDEndConditionalRendering
+    {
+        static constexpr LINAGX_TYPEID TypeID = CMDID_EndConditionalRendering;
+
+        inline void Init()
+        {
+        }
+    };
+
     extern LINAGX_STRING GetCMDDebugName(LINAGX_TYPEID tid);
 
-#define BACKEND_BIND_COMMANDS(BACKEND)                                                                            \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBeginRenderPass>(), &BACKEND::CMD_BeginRenderPass});               \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDEndRenderPass>(), &BACKEND::CMD_EndRenderPass});                   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDSetViewport>(), &BACKEND::CMD_SetViewport});                       \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDSetScissors>(), &BACKEND::CMD_SetScissors});                       \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBindPipeline>(), &BACKEND::CMD_BindPipeline});                     \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDrawInstanced>(), &BACKEND::CMD_DrawInstanced});                   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDrawIndexedInstanced>(), &BACKEND::CMD_DrawIndexedInstanced});     \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDrawIndexedIndirect>(), &BACKEND::CMD_DrawIndexedIndirect});       \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDrawIndirect>(), &BACKEND::CMD_DrawIndirect});                     \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBindVertexBuffers>(), &BACKEND::CMD_BindVertexBuffers});           \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBindIndexBuffers>(), &BACKEND::CMD_BindIndexBuffers});             \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDCopyResource>(), &BACKEND::CMD_CopyResource});                     \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDCopyTexture2DToBuffer>(), &BACKEND::CMD_CopyTexture2DToBuffer});   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDCopyBufferToTexture2D>(), &BACKEND::CMD_CopyBufferToTexture2D});   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDCopyTexture>(), &BACKEND::CMD_CopyTexture});                       \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBindDescriptorSets>(), &BACKEND::CMD_BindDescriptorSets});         \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDispatch>(), &BACKEND::CMD_Dispatch});                             \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBindConstants>(), &BACKEND::CMD_BindConstants});                   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDExecuteSecondaryStream>(), &BACKEND::CMD_ExecuteSecondaryStream}); \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDBarrier>(), &BACKEND::CMD_Barrier});                               \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDebug>(), &BACKEND::CMD_Debug});                                   \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDebugBeginLabel>(), &BACKEND::CMD_DebugBeginLabel});               \
-    m_cmdFunctions.push_back({LGX_GetTypeID<CMDDebugEndLabel>(), &BACKEND::CMD_DebugEndLabel});
+#define BACKEND_BIND_COMMANDS(BACKEND)                                                         \
+    m_cmdFunctions[CMDID_BeginRenderPass]           = &BACKEND::CMD_BeginRenderPass;           \
+    m_cmdFunctions[CMDID_EndRenderPass]             = &BACKEND::CMD_EndRenderPass;             \
+    m_cmdFunctions[CMDID_SetViewport]               = &BACKEND::CMD_SetViewport;               \
+    m_cmdFunctions[CMDID_SetScissors]               = &BACKEND::CMD_SetScissors;               \
+    m_cmdFunctions[CMDID_BindPipeline]              = &BACKEND::CMD_BindPipeline;              \
+    m_cmdFunctions[CMDID_DrawInstanced]             = &BACKEND::CMD_DrawInstanced;             \
+    m_cmdFunctions[CMDID_DrawIndexedInstanced]      = &BACKEND::CMD_DrawIndexedInstanced;      \
+    m_cmdFunctions[CMDID_DrawIndexedIndirect]       = &BACKEND::CMD_DrawIndexedIndirect;       \
+    m_cmdFunctions[CMDID_DrawIndirect]              = &BACKEND::CMD_DrawIndirect;              \
+    m_cmdFunctions[CMDID_CopyResource]              = &BACKEND::CMD_CopyResource;              \
+    m_cmdFunctions[CMDID_CopyBufferToTexture2D]     = &BACKEND::CMD_CopyBufferToTexture2D;     \
+    m_cmdFunctions[CMDID_CopyTexture2DToBuffer]     = &BACKEND::CMD_CopyTexture2DToBuffer;     \
+    m_cmdFunctions[CMDID_CopyTexture]               = &BACKEND::CMD_CopyTexture;               \
+    m_cmdFunctions[CMDID_BindVertexBuffers]         = &BACKEND::CMD_BindVertexBuffers;         \
+    m_cmdFunctions[CMDID_BindIndexBuffers]          = &BACKEND::CMD_BindIndexBuffers;          \
+    m_cmdFunctions[CMDID_BindDescriptorSets]        = &BACKEND::CMD_BindDescriptorSets;        \
+    m_cmdFunctions[CMDID_BindConstants]             = &BACKEND::CMD_BindConstants;             \
+    m_cmdFunctions[CMDID_Dispatch]                  = &BACKEND::CMD_Dispatch;                  \
+    m_cmdFunctions[CMDID_ExecuteSecondaryStream]    = &BACKEND::CMD_ExecuteSecondaryStream;    \
+    m_cmdFunctions[CMDID_Debug]                     = &BACKEND::CMD_Debug;                     \
+    m_cmdFunctions[CMDID_DebugBeginLabel]           = &BACKEND::CMD_DebugBeginLabel;           \
+    m_cmdFunctions[CMDID_DebugEndLabel]             = &BACKEND::CMD_DebugEndLabel;             \
+    m_cmdFunctions[CMDID_Barrier]                   = &BACKEND::CMD_Barrier;                   \
+    m_cmdFunctions[CMDID_WriteTimestamp]            = &BACKEND::CMD_WriteTimestamp;            \
+    m_cmdFunctions[CMDID_BeginQuery]                = &BACKEND::CMD_BeginQuery;                \
+    m_cmdFunctions[CMDID_EndQuery]                  = &BACKEND::CMD_EndQuery;                  \
+    m_cmdFunctions[CMDID_ResolveQueries]            = &BACKEND::CMD_ResolveQueries;            \
+    m_cmdFunctions[CMDID_BeginConditionalRendering] = &BACKEND::CMD_BeginConditionalRendering; \
+    m_cmdFunctions[CMDID_EndConditionalRendering]   = &BACKEND::CMD_EndConditionalRendering;
 } // namespace LinaGX
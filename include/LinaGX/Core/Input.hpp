@@ -162,8 +162,8 @@ namespace LinaGX
 
         LGXVector2 m_mousePosTrackingClick = {};
 
-        bool m_currentMouseStates[NUM_MOUSE_STATES];
-        bool m_prevMouseStates[NUM_MOUSE_STATES];
+        bool m_currentMouseStates[NUM_MOUSE_STATES] = {0};
+        bool m_prevMouseStates[NUM_MOUSE_STATES]    = {0};
         bool m_currentStates[NUM_KEY_STATES]  = {0};
         bool m_previousStates[NUM_KEY_STATES] = {0};
 
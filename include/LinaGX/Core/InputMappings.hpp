@@ -336,6 +336,153 @@ namespace LinaGX
 #define LINAGX_KEY_RALT   0x3D // Option key
 #define LINAGX_KEY_RGUI   0x36 // Command key
 
+#endif
+
+#if !defined(LINAGX_PLATFORM_WINDOWS) && !defined(LINAGX_PLATFORM_APPLE)
+
+// No window system, key codes follow the Windows virtual-key values.
+
+#define LINAGX_MOUSE_0      0
+#define LINAGX_MOUSE_1      1
+#define LINAGX_MOUSE_2      2
+#define LINAGX_MOUSE_3      3
+#define LINAGX_MOUSE_4      4
+#define LINAGX_MOUSE_5      5
+#define LINAGX_MOUSE_6      6
+#define LINAGX_MOUSE_7      7
+#define LINAGX_MOUSE_LAST   LINAGX_MOUSE_7
+#define LINAGX_MOUSE_LEFT   LINAGX_MOUSE_0
+#define LINAGX_MOUSE_RIGHT  LINAGX_MOUSE_1
+#define LINAGX_MOUSE_MIDDLE LINAGX_MOUSE_2
+
+#define LINAGX_GAMEPAD_A             0
+#define LINAGX_GAMEPAD_B             1
+#define LINAGX_GAMEPAD_X             2
+#define LINAGX_GAMEPAD_Y             3
+#define LINAGX_GAMEPAD_LEFT_BUMPER   4
+#define LINAGX_GAMEPAD_RIGHT_BUMPER  5
+#define LINAGX_GAMEPAD_BACK          6
+#define LINAGX_GAMEPAD_START         7
+#define LINAGX_GAMEPAD_GUIDE         8
+#define LINAGX_GAMEPAD_LEFT_THUMB    9
+#define LINAGX_GAMEPAD_RIGHT_THUMB   10
+#define LINAGX_GAMEPAD_DPAD_UP       11
+#define LINAGX_GAMEPAD_DPAD_RIGHT    12
+#define LINAGX_GAMEPAD_DPAD_DOWN     13
+#define LINAGX_GAMEPAD_DPAD_LEFT     14
+#define LINAGX_GAMEPAD_LEFT_TRIGGER  4
+#define LINAGX_GAMEPAD_RIGHT_TRIGGER 5
+#define LINAGX_GAMEPAD_LAST          LINAGX_GAMEPAD_RIGHT_TRIGGER
+
+#define LINAGX_KEY_UNKNOWN -1
+#define LINAGX_KEY_A       0x41
+#define LINAGX_KEY_B       0x42
+#define LINAGX_KEY_C       0x43
+#define LINAGX_KEY_D       0x44
+#define LINAGX_KEY_E       0x45
+#define LINAGX_KEY_F       0x46
+#define LINAGX_KEY_G       0x47
+#define LINAGX_KEY_H       0x48
+#define LINAGX_KEY_I       0x49
+#define LINAGX_KEY_J       0x4A
+#define LINAGX_KEY_K       0x4B
+#define LINAGX_KEY_L       0x4C
+#define LINAGX_KEY_M       0x4D
+#define LINAGX_KEY_N       0x4E
+#define LINAGX_KEY_O       0x4F
+#define LINAGX_KEY_P       0x50
+#define LINAGX_KEY_Q       0x51
+#define LINAGX_KEY_R       0x52
+#define LINAGX_KEY_S       0x53
+#define LINAGX_KEY_T       0x54
+#define LINAGX_KEY_U       0x55
+#define LINAGX_KEY_V       0x56
+#define LINAGX_KEY_W       0x57
+#define LINAGX_KEY_X       0x58
+#define LINAGX_KEY_Y       0x59
+#define LINAGX_KEY_Z       0x5A
+
+#define LINAGX_KEY_0 0x30
+#define LINAGX_KEY_1 0x31
+#define LINAGX_KEY_2 0x32
+#define LINAGX_KEY_3 0x33
+#define LINAGX_KEY_4 0x34
+#define LINAGX_KEY_5 0x35
+#define LINAGX_KEY_6 0x36
+#define LINAGX_KEY_7 0x37
+#define LINAGX_KEY_8 0x38
+#define LINAGX_KEY_9 0x39
+
+#define LINAGX_KEY_RETURN    0x0D
+#define LINAGX_KEY_ESCAPE    0x1B
+#define LINAGX_KEY_BACKSPACE 0x08
+#define LINAGX_KEY_TAB       0x09
+#define LINAGX_KEY_SPACE     0x20
+
+#define LINAGX_KEY_MINUS    0xBD
+#define LINAGX_KEY_GRAVE    0xC0 // 41 // ?
+#define LINAGX_KEY_COMMA    0xBC
+#define LINAGX_KEY_PERIOD   0xBE
+#define LINAGX_KEY_SLASH    0x6F
+#define LINAGX_KEY_CAPSLOCK 0x14
+
+#define LINAGX_KEY_F1  0x70
+#define LINAGX_KEY_F2  0x71
+#define LINAGX_KEY_F3  0x72
+#define LINAGX_KEY_F4  0x73
+#define LINAGX_KEY_F5  0x74
+#define LINAGX_KEY_F6  0x75
+#define LINAGX_KEY_F7  0x76
+#define LINAGX_KEY_F8  0x77
+#define LINAGX_KEY_F9  0x78
+#define LINAGX_KEY_F10 0x79
+#define LINAGX_KEY_F11 0x7A
+#define LINAGX_KEY_F12 0x7B
+#define LINAGX_KEY_F13 0x7C
+#define LINAGX_KEY_F14 0x7D
+#define LINAGX_KEY_F15 0x7E
+
+#define LINAGX_KEY_PRINTSCREEN  0x2A
+#define LINAGX_KEY_SCROLLLOCK   0x91
+#define LINAGX_KEY_PAUSE        0x13
+#define LINAGX_KEY_INSERT       0x2D
+#define LINAGX_KEY_HOME         0x24
+#define LINAGX_KEY_PAGEUP       0x21
+#define LINAGX_KEY_DELETE       0x2E
+#define LINAGX_KEY_END          0x23
+#define LINAGX_KEY_PAGEDOWN     0x22
+#define LINAGX_KEY_RIGHT        0x27
+#define LINAGX_KEY_LEFT         0x25
+#define LINAGX_KEY_DOWN         0x28
+#define LINAGX_KEY_UP           0x26
+#define LINAGX_KEY_NUMLOCKCLEAR 0x0C
+
+#define LINAGX_KEY_KP_DECIMAL  0x6E
+#define LINAGX_KEY_KP_DIVIDE   0x6F
+#define LINAGX_KEY_KP_MULTIPLY 0x6A
+#define LINAGX_KEY_KP_MINUS    0xBD
+#define LINAGX_KEY_KP_PLUS     0xBB
+#define LINAGX_KEY_KP_ENTER    0x0D
+#define LINAGX_KEY_KP_1        0x61
+#define LINAGX_KEY_KP_2        0x62
+#define LINAGX_KEY_KP_3        0x63
+#define LINAGX_KEY_KP_4        0x64
+#define LINAGX_KEY_KP_5        0x65
+#define LINAGX_KEY_KP_6        0x66
+#define LINAGX_KEY_KP_7        0x67
+#define LINAGX_KEY_KP_8        0x68
+#define LINAGX_KEY_KP_9        0x69
+#define LINAGX_KEY_KP_0        0x60
+
+#define LINAGX_KEY_LCTRL  0xA2
+#define LINAGX_KEY_LSHIFT 0xA0
+#define LINAGX_KEY_LALT   0xA4
+#define LINAGX_KEY_LGUI   0xA4
+#define LINAGX_KEY_RCTRL  0xA3
+#define LINAGX_KEY_RSHIFT 0xA1
+#define LINAGX_KEY_RALT   0xA5
+#define LINAGX_KEY_RGUI   0xA5
+
 #endif
 
     enum InputCode
@@ -35,6 +35,7 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "LinaGX/Common/CommonGfx.hpp"
+#include "LinaGX/Common/CommonConfig.hpp"
 #include "WindowManager.hpp"
 #include "Input.hpp"
 #include <mutex>
@@ -44,6 +45,9 @@ namespace LinaGX
     class Backend;
     class CommandStream;
 
+    /// <summary>
+    /// Create functions return an all-ones handle once the backend runs out of handles for that object type, see HandleTraits for the limits.
+    /// </summary>
     class Instance
     {
     public:
@@ -52,7 +56,7 @@ namespace LinaGX
 
         /// <summary>
         /// Deleting LinaGX instance requires you to DestroyXXX all resources you have created.
-        /// Prior to destroying resources, make sure to use Join() so all operations on the GPU will be completed.
+        /// Textures, resources, samplers, shaders and descriptor sets are destroyed after the GPU is done with them, others require a Join() prior.
         /// </summary>
         virtual ~Instance();
 
@@ -65,8 +69,8 @@ namespace LinaGX
         bool Initialize();
 
         /// <summary>
-        /// Waits the calling thread for all the frames-in-flight operations to finish on the GPU.
-        /// Definitely use when deleting a resource that might be still processing on the GPU, before shutting down and destroying LinaGX instance.
+        /// Waits the calling thread for all the frames-in-flight operations to finish on the GPU, then destroys every object with a deferred destruction.
+        /// Definitely use before shutting down and destroying LinaGX instance.
         /// </summary>
         void Join();
 
@@ -150,13 +154,20 @@ namespace LinaGX
         static bool CompileShaderToSPV(LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout);
         static bool CompileShaderFromSPV(LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout);
 
+        /// <summary>
+        /// Same as calling CompileShader() for every entry, but all stages of all entries are compiled concurrently through Config.dispatchJobsCallback, serially if it's not set.
+        /// Reflection of each entry is merged in stage order afterwards, so the layouts are identical to the ones CompileShader() would output.
+        /// </summary>
+        /// <returns>True if all entries compiled successfully, check success of each entry otherwise. Blobs of failed entries are released.</returns>
+        static bool CompileShaders(LINAGX_VEC<ShaderCompileBatchEntry>& batch);
+
         /// <summary>
         /// Creates a shader pipeline state object.
         /// </summary>
         uint16 CreateShader(const ShaderDesc& shaderDesc);
 
         /// <summary>
-        /// Make sure all frames-in-flight operations are complete prior.
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
         /// </summary>
         /// <param name="handle"></param>
         void DestroyShader(uint16 handle);
@@ -164,7 +175,7 @@ namespace LinaGX
         /// <summary>
         /// Create a command stream, which are LinaGX representations of CommandBuffers (VK) or CommandLists (DX12). Use them to record all GPU operations.
         /// </summary>
-        /// <returns></returns>
+        /// <returns>nullptr if the backend is out of command stream handles.</returns>
         CommandStream* CreateCommandStream(const CommandStreamDesc& desc);
 
         /// <summary>
@@ -179,7 +190,7 @@ namespace LinaGX
         uint32 CreateTexture(const TextureDesc& desc);
 
         /// <summary>
-        /// Make sure all frames-in-flight operations are complete prior.
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
         /// </summary>
         void DestroyTexture(uint32 handle);
 
@@ -190,7 +201,7 @@ namespace LinaGX
         uint32 CreateSampler(const SamplerDesc& desc);
 
         /// <summary>
-        /// Make sure all frames-in-flight operations are complete prior.
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
         /// </summary>
         void DestroySampler(uint32 handle);
 
@@ -200,7 +211,7 @@ namespace LinaGX
         uint32 CreateResource(const ResourceDesc& desc);
 
         /// <summary>
-        /// Make sure all frames-in-flight operations are complete prior.
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
         /// </summary>
         void DestroyResource(uint32 handle);
 
@@ -222,7 +233,7 @@ namespace LinaGX
         uint16 CreateDescriptorSet(const DescriptorSetDesc& desc);
 
         /// <summary>
-        /// Make sure all frames-in-flight operations are complete prior.
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
         /// </summary>
         /// <param name="handle"></param>
         void DestroyDescriptorSet(uint16 handle);
@@ -274,6 +285,59 @@ namespace LinaGX
         /// <returns></returns>
         uint8 GetPrimaryQueue(CommandType type);
 
+        /// <summary>
+        /// Merges previously serialized pipeline cache data into the instance's pipeline cache, call it right after Initialize() and before creating any shaders.
+        /// Data created by a different vendor, device or driver version is rejected. Only Vulkan supports pipeline caches for now, other backends return false.
+        /// </summary>
+        /// <returns>True if the data was valid and loaded.</returns>
+        bool LoadPipelineCache(const uint8* data, size_t size);
+
+        /// <summary>
+        /// Reads the file at path and loads it via LoadPipelineCache(). Missing files are not an error, simply returns false, e.g. on first launch.
+        /// </summary>
+        bool LoadPipelineCache(const char* path);
+
+        /// <summary>
+        /// Serializes the current contents of the pipeline cache into outData, e.g. before shutting down.
+        /// </summary>
+        bool GetPipelineCacheData(LINAGX_VEC<uint8>& outData);
+
+        /// <summary>
+        /// Serializes the pipeline cache via GetPipelineCacheData() and writes it to the file at path.
+        /// </summary>
+        bool SavePipelineCache(const char* path);
+
+        /// <summary>
+        /// Create a pool of GPU queries, write to them with CMDWriteTimestamp for timestamp pools and CMDBeginQuery/CMDEndQuery for the others. Each frame in flight gets its own set of desc.queryCount queries,
+        /// so query indices are always in [0, queryCount) and can be reused every frame.
+        /// </summary>
+        uint16 CreateQueryPool(const QueryPoolDesc& desc);
+
+        /// <summary>
+        /// Destruction is deferred until the frames in flight that might use it are done on the GPU, no need to Join() prior.
+        /// </summary>
+        void DestroyQueryPool(uint16 handle);
+
+        /// <summary>
+        /// Results of the queries written framesInFlight frames ago, e.g. the last time the current frame index was used. They are read back in StartFrame() after
+        /// the frame's fence is waited on, so this never stalls. Returned pointers stay valid until the next StartFrame().
+        /// </summary>
+        /// <returns>False if no frame has been resolved yet.</returns>
+        bool GetQueryResults(uint16 handle, QueryResults& outResults);
+
+        /// <summary>
+        /// Creates the textures in desc, placing the ones whose use ranges don't overlap into the same memory, e.g. G-buffer, SSAO and bloom targets of a frame.
+        /// Memory of a transient texture is undefined at the start of its use range, make its first barrier in every frame set TextureBarrier::discardContents.
+        /// Textures are owned by the group, destroy the group instead of the individual textures. Backends without aliasing support create dedicated textures.
+        /// </summary>
+        /// <returns>Handle of the group, outInfo is filled with the texture handles and memory sizes.</returns>
+        uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo);
+
+        /// <summary>
+        /// Destroys the group along with all of its textures. Destruction is deferred until the frames in flight that might use it are done on the GPU.
+        /// </summary>
+        void DestroyTransientTextureGroup(uint16 handle);
+
         /// <summary>
         /// Vulkan Only, queries feature support and returns a bitmask containing VulkanFeatureFlags of supported features on at least 1 of the preffered devices.
         /// </summary>
@@ -343,18 +407,33 @@ namespace LinaGX
 
     private:
         void Shutdown();
+        void RetireDeferredDestructions(bool all);
 
     private:
         friend class VKBackend;
         friend class MTLBackend;
         friend class DX12Backend;
+        friend class NullBackend;
 
     private:
         Backend*      m_backend = nullptr;
         WindowManager m_windowManager;
         Input         m_input;
-        uint32        m_currentFrameIndex = 0;
-        std::mutex    m_globalMtx;
+        uint32        m_currentFrameIndex         = 0;
+        uint64        m_frameStartHeapAllocations = 0;
+
+        // Creation/deletion locks, one per object type so unrelated calls don't serialize. Map/Unmap take none.
+        std::mutex m_semaphoreMtx;
+        std::mutex m_swapchainMtx;
+        std::mutex m_shaderMtx;
+        std::mutex m_commandStreamMtx;
+        std::mutex m_textureMtx;
+        std::mutex m_samplerMtx;
+        std::mutex m_resourceMtx;
+        std::mutex m_descriptorSetMtx;
+        std::mutex m_pipelineLayoutMtx;
+        std::mutex m_queueMtx;
+        std::mutex m_queryPoolMtx;
 
         LINAGX_VEC<CommandStream*> m_commandStreams;
     };
@@ -0,0 +1,94 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#pragma once
+
+#include "LinaGX/Core/Commands.hpp"
+
+namespace LinaGX
+{
+#define STATE_FILTER_MAX_SETS           8
+#define STATE_FILTER_MAX_VERTEX_BUFFERS 8
+
+    /// <summary>
+    /// Tracks the state a single stream sets while it's being translated, and reports the commands that would set the same state again.
+    /// Pipeline, viewport, scissors, descriptor set, vertex and index buffer bindings persist across render passes,
+    /// BeginRenderPass sets the viewport and scissors it was given, ExecuteSecondaryStream leaves everything unknown.
+    /// Used by the backends when Config.eliminateRedundantState is set, create one per translation.
+    /// </summary>
+    class RedundantStateFilter
+    {
+    public:
+        /// <summary>
+        /// Returns true if the command wouldn't change any state and can be skipped, otherwise records the state it sets.
+        /// </summary>
+        bool IsRedundant(LINAGX_TYPEID tid, const uint8* cmd);
+
+    private:
+        struct BoundSet
+        {
+            bool                       isBound            = false;
+            uint16                     handle             = 0;
+            uint32                     allocationIndex    = 0;
+            DescriptorSetsLayoutSource layoutSource       = DescriptorSetsLayoutSource::LastBoundShader;
+            uint16                     customLayout       = 0;
+            uint32                     customLayoutShader = 0;
+        };
+
+        struct BoundVertexBuffer
+        {
+            bool   isBound    = false;
+            uint32 resource   = 0;
+            uint32 vertexSize = 0;
+            uint64 offset     = 0;
+        };
+
+        bool IsRedundantDescriptorSets(const CMDBindDescriptorSets* cmd);
+        void InvalidateDescriptorSets();
+
+    private:
+        bool                m_hasPipeline    = false;
+        uint16              m_pipeline       = 0;
+        bool                m_hasViewport    = false;
+        CMDSetViewport      m_viewport       = {};
+        bool                m_hasScissors    = false;
+        CMDSetScissors      m_scissors       = {};
+        bool                m_hasIndexBuffer = false;
+        CMDBindIndexBuffers m_indexBuffer    = {};
+        BoundVertexBuffer   m_vertexBuffers[STATE_FILTER_MAX_VERTEX_BUFFERS];
+        BoundSet            m_sets[2][STATE_FILTER_MAX_SETS]; // Graphics and compute bind points.
+    };
+
+} // namespace LinaGX
@@ -40,6 +40,8 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/Platform/Windows/Win32Window.hpp"
 #elif LINAGX_PLATFORM_APPLE
 #include "LinaGX/Platform/Apple/OSXWindow.hpp"
+#else
+#include "LinaGX/Core/Window.hpp"
 #endif
 
 namespace LinaGX
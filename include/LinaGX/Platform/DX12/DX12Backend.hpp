@@ -35,6 +35,7 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "LinaGX/Core/Backend.hpp"
+#include "LinaGX/Core/Commands.hpp"
 #include "LinaGX/Platform/DX12/DX12Common.hpp"
 #include <atomic>
 
@@ -104,11 +105,13 @@ namespace LinaGX
         uint64                                 requiredAlignment  = 0;
         D3D12MA::Allocation*                   allocation         = NULL;
         D3D12_RESOURCE_STATES                  state              = D3D12_RESOURCE_STATES::D3D12_RESOURCE_STATE_COMMON;
+        LINAGX_VEC<D3D12_RESOURCE_STATES>      subresourceStates  = {}; // Per layer * mipLevels + mip once a barrier targets part of the texture, empty while all subresources are in state.
         TextureDesc                            desc               = {};
         DXGI_FORMAT                            format             = DXGI_FORMAT::DXGI_FORMAT_UNKNOWN;
         uint32                                 bytesPerPixel      = 0;
         bool                                   isValid            = false;
         bool                                   isSwapchainTexture = false;
+        bool                                   isTransient        = false; // Placed into a DX12TransientTextureGroup block, resource is in rawRes.
     };
 
     struct DX12Sampler
@@ -157,16 +160,16 @@ namespace LinaGX
         CommandType                                             type               = CommandType::Graphics;
         Microsoft::WRL::ComPtr<ID3D12CommandAllocator>          allocator;
         Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>      list;
-        LINAGX_VEC<LINAGX_PAIR<uint32, uint64>>                 intermediateResources;
-        LINAGX_VEC<LINAGX_PAIR<void*, uint64>>                  adjustedBuffers;
         LINAGX_VEC<LINAGX_PAIR<uint32, DX12BoundDescriptorSet>> boundDescriptorSets;
         DX12BoundConstant                                       boundConstants;
         CommandStream*                                          streamImpl = nullptr;
         LINAGX_VEC<DX12MSAATargetInfo>                          lastMSAATargets;
+        LINAGX_VEC<LINAGX_PAIR<uint16, uint32>>                 writtenQueries; // Pool & heap slot, marked written on submission.
     };
 
     struct DX12PerFrameData
     {
+        uint64 storedFrameTimelineValue = 0; // Signaled together with the frame fences of this frame index.
     };
 
     struct DX12Resource
@@ -216,6 +219,30 @@ namespace LinaGX
         std::atomic_flag*                               inUse = nullptr;
     };
 
+    struct DX12QueryPool
+    {
+        bool                                    isValid    = false;
+        Microsoft::WRL::ComPtr<ID3D12QueryHeap> heap       = nullptr;
+        QueryType                               type       = QueryType::Timestamp;
+        D3D12_QUERY_TYPE                        queryType  = D3D12_QUERY_TYPE_TIMESTAMP;
+        uint32                                  queryCount = 0; // Per frame, the heap holds queryCount * framesInFlight queries.
+        uint32                                  stride     = 0; // Bytes per query in the readback buffer.
+        uint64                                  frequency  = 0; // Ticks per second of the graphics queue.
+        uint32                                  readback   = 0;
+        uint8*                                  mapped     = nullptr;
+        LINAGX_VEC<uint8>                       written; // There is no availability in D3D12, track which queries were resolved into the readback buffer.
+        LINAGX_VEC<uint64>                      values;
+        LINAGX_VEC<PipelineStatistics>          statistics;
+        LINAGX_VEC<uint8>                       available;
+    };
+
+    struct DX12TransientTextureGroup
+    {
+        bool                             isValid = false;
+        LINAGX_VEC<uint32>               textures;
+        LINAGX_VEC<D3D12MA::Allocation*> blocks;
+    };
+
     class DX12Backend : public Backend
     {
     private:
@@ -258,6 +285,13 @@ namespace LinaGX
         virtual uint8  CreateQueue(const QueueDesc& desc) override;
         virtual void   DestroyQueue(uint8 queue) override;
         virtual uint8  GetPrimaryQueue(CommandType type) override;
+        virtual bool   LoadPipelineCache(const uint8* data, size_t size) override;
+        virtual bool   GetPipelineCacheData(LINAGX_VEC<uint8>& outData) override;
+        virtual uint16 CreateQueryPool(const QueryPoolDesc& desc) override;
+        virtual void   DestroyQueryPool(uint16 handle) override;
+        virtual bool   GetQueryResults(uint16 handle, QueryResults& outResults) override;
+        virtual uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) override;
+        virtual void   DestroyTransientTextureGroup(uint16 handle) override;
 
         void            DX12Exception(HrException e);
         ID3D12Resource* GetGPUResource(const DX12Resource& res);
@@ -268,12 +302,16 @@ namespace LinaGX
         }
 
     private:
-        uint16 CreateFence();
-        void   DestroyFence(uint16 handle);
-        void   WaitForFences(ID3D12Fence* fence, uint64 frameFenceValue);
-        void   BindDescriptorSets(DX12CommandStream& stream, DX12Shader& shader);
-        void   BindConstants(DX12CommandStream& stream, DX12Shader& shader);
-        void   IncreaseGraphicsFences();
+        uint16              CreateFence();
+        void                DestroyFence(uint16 handle);
+        void                WaitForFences(ID3D12Fence* fence, uint64 frameFenceValue);
+        void                BindDescriptorSets(DX12CommandStream& stream, DX12Shader& shader);
+        void                BindConstants(DX12CommandStream& stream, DX12Shader& shader);
+        void                IncreaseFrameFences();
+        void                ResolveQueries(uint32 frameIndex);
+        uint32              CreateTexture(const TextureDesc& txtDesc, D3D12MA::Allocation* aliasingBlock, uint64 aliasingOffset);
+        D3D12_RESOURCE_DESC GetTextureResourceDesc(const TextureDesc& txtDesc);
+        bool                ReserveTextureHandles(uint32 count, LINAGX_VEC<uint32>& outHandles);
 
     public:
         virtual bool Initialize() override;
@@ -283,6 +321,9 @@ namespace LinaGX
         virtual void Present(const PresentDesc& present) override;
         virtual void EndFrame() override;
 
+    protected:
+        virtual void TranslateCommandStream(CommandStream* stream) override;
+
     private:
         void CMD_BeginRenderPass(uint8* data, DX12CommandStream& stream);
         void CMD_EndRenderPass(uint8* data, DX12CommandStream& stream);
@@ -307,6 +348,12 @@ namespace LinaGX
         void CMD_Debug(uint8* data, DX12CommandStream& stream);
         void CMD_DebugBeginLabel(uint8* data, DX12CommandStream& stream);
         void CMD_DebugEndLabel(uint8* data, DX12CommandStream& stream);
+        void CMD_WriteTimestamp(uint8* data, DX12CommandStream& stream);
+        void CMD_BeginQuery(uint8* data, DX12CommandStream& stream);
+        void CMD_EndQuery(uint8* data, DX12CommandStream& stream);
+        void CMD_ResolveQueries(uint8* data, DX12CommandStream& stream);
+        void CMD_BeginConditionalRendering(uint8* data, DX12CommandStream& stream);
+        void CMD_EndConditionalRendering(uint8* data, DX12CommandStream& stream);
 
     private:
         D3D12MA::Allocator*                        m_dx12Allocator = nullptr;
@@ -316,26 +363,28 @@ namespace LinaGX
         Microsoft::WRL::ComPtr<IDXGIFactory4>      m_factory      = nullptr;
         bool                                       m_allowTearing = false;
 
-        DX12HeapStaging*                                    m_rtvHeap         = nullptr;
-        DX12HeapStaging*                                    m_bufferHeap      = nullptr;
-        DX12HeapStaging*                                    m_textureHeap     = nullptr;
-        DX12HeapStaging*                                    m_dsvHeap         = nullptr;
-        DX12HeapStaging*                                    m_samplerHeap     = nullptr;
-        IDList<uint8, DX12Swapchain>                        m_swapchains      = {10};
-        IDList<uint16, DX12Shader>                          m_shaders         = {20};
-        IDList<uint32, DX12Texture2D>                       m_textures        = {50};
-        IDList<uint32, DX12CommandStream>                   m_cmdStreams      = {50};
-        IDList<uint16, Microsoft::WRL::ComPtr<ID3D12Fence>> m_fences          = {20};
-        IDList<uint32, DX12Resource>                        m_resources       = {100};
-        IDList<uint16, DX12UserSemaphore>                   m_userSemaphores  = {20};
-        IDList<uint32, DX12Sampler>                         m_samplers        = {100};
-        IDList<uint16, DX12DescriptorSet>                   m_descriptorSets  = {20};
-        IDList<uint8, DX12Queue>                            m_queues          = {5};
-        IDList<uint16, DX12PipelineLayout>                  m_pipelineLayouts = {10};
-        DX12HeapGPU*                                        m_gpuHeapBuffer   = nullptr;
-        DX12HeapGPU*                                        m_gpuHeapSampler  = nullptr;
-
-        LINAGX_VEC<LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>> m_cmdFunctions;
+        DX12HeapStaging*                                        m_rtvHeap        = nullptr;
+        DX12HeapStaging*                                        m_bufferHeap     = nullptr;
+        DX12HeapStaging*                                        m_textureHeap    = nullptr;
+        DX12HeapStaging*                                        m_dsvHeap        = nullptr;
+        DX12HeapStaging*                                        m_samplerHeap    = nullptr;
+        HandlePool<uint8, DX12Swapchain>                        m_swapchains;
+        HandlePool<uint16, DX12Shader>                          m_shaders;
+        HandlePool<uint32, DX12Texture2D>                       m_textures;
+        HandlePool<uint32, DX12CommandStream>                   m_cmdStreams;
+        HandlePool<uint16, Microsoft::WRL::ComPtr<ID3D12Fence>> m_fences;
+        HandlePool<uint32, DX12Resource>                        m_resources;
+        HandlePool<uint16, DX12UserSemaphore>                   m_userSemaphores;
+        HandlePool<uint32, DX12Sampler>                         m_samplers;
+        HandlePool<uint16, DX12DescriptorSet>                   m_descriptorSets;
+        HandlePool<uint8, DX12Queue>                            m_queues;
+        HandlePool<uint16, DX12PipelineLayout>                  m_pipelineLayouts;
+        HandlePool<uint16, DX12QueryPool>                       m_queryPools;
+        HandlePool<uint16, DX12TransientTextureGroup>           m_transientGroups;
+        DX12HeapGPU*                                            m_gpuHeapBuffer  = nullptr;
+        DX12HeapGPU*                                            m_gpuHeapSampler = nullptr;
+
+        CommandFunction                                         m_cmdFunctions[CMDID_Count] = {};
         uint32                                                  m_currentFrameIndex    = 0;
         uint32                                                  m_currentImageIndex    = 0;
         uint32                                                  m_previousRefreshCount = 0;
@@ -345,8 +394,9 @@ namespace LinaGX
         LINAGX_VEC<DX12PerFrameData>                m_perFrameData;
         LINAGX_VEC<LINAGX_PAIR<CommandType, uint8>> m_primaryQueues;
 
-        std::atomic<uint32> m_submissionPerFrame  = 0;
-        std::atomic<bool>   m_graphicsFencesDirty = false;
+        std::atomic<uint32> m_submissionPerFrame = 0;
+        std::atomic<bool>   m_frameFencesDirty   = false;
+        std::mutex          m_queryWriteMtx;
     };
 
 } // namespace LinaGX
@@ -36,6 +36,7 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "LinaGX/Common/CommonGfx.hpp"
 #include "LinaGX/Platform/DX12/DX12Common.hpp"
+#include <mutex>
 
 namespace LinaGX
 {
@@ -87,6 +88,8 @@ namespace LinaGX
         uint32                      m_maxDescriptors = 0;
         uint32                      m_descriptorSize = 0;
 
+        // RTV heap is shared by swapchains & textures, and the buffer heap is used during stream translation, so handle allocation is locked here.
+        std::mutex           m_mtx;
         LINAGX_DEQUE<uint32> m_freeDescriptors;
         uint32               m_currentDescriptorIndex = 0;
         uint32               m_activeHandleCount      = 0;
@@ -51,7 +51,8 @@ namespace LinaGX
         uint32            flags;
         uint32            bytesPerPixel;
         LGXVector2ui      size;
-        LINAGX_STRING debugName = "";
+        LINAGX_STRING debugName   = "";
+        bool          isTransient = false; // Owned by a MTLTransientTextureGroup.
     };
 
     struct MTLBoundDescriptorSet
@@ -93,7 +94,6 @@ namespace LinaGX
         bool                                                   currentShaderExists    = false;
         uint8                                                  indexBufferType        = 0;
         bool                                                   currentShaderIsCompute = false;
-        LINAGX_VEC<LINAGX_PAIR<uint32, uint64>>                intermediateResources;
         LINAGX_VEC<LINAGX_PAIR<uint32, MTLBoundDescriptorSet>> boundSets;
         CMDBindVertexBuffers                                   lastVertexBind;
         MTLBoundConstant                                       boundConstants;
@@ -206,6 +206,7 @@ namespace LinaGX
     struct MTLPerFrameData
     {
         uint64 submits        = 0;
+        uint64 storedFrameTimelineValue = 0; // Signaled by the last submission of this frame index.
         std::atomic<uint64> reachedSubmits = 0;
         
         MTLPerFrameData() : reachedSubmits(0) {};
@@ -228,6 +229,21 @@ namespace LinaGX
         bool isValid = false;
     };
 
+    struct MTLQueryPool
+    {
+        bool                           isValid    = false;
+        uint32                         queryCount = 0;
+        LINAGX_VEC<uint64>             values;
+        LINAGX_VEC<PipelineStatistics> statistics;
+        LINAGX_VEC<uint8>              available;
+    };
+
+    struct MTLTransientTextureGroup
+    {
+        bool               isValid = false;
+        LINAGX_VEC<uint32> textures;
+    };
+
     class MTLBackend : public Backend
     {
     private:
@@ -270,6 +286,13 @@ namespace LinaGX
         virtual uint8  CreateQueue(const QueueDesc& desc) override;
         virtual void   DestroyQueue(uint8 queue) override;
         virtual uint8  GetPrimaryQueue(CommandType type) override;
+        virtual bool   LoadPipelineCache(const uint8* data, size_t size) override;
+        virtual bool   GetPipelineCacheData(LINAGX_VEC<uint8>& outData) override;
+        virtual uint16 CreateQueryPool(const QueryPoolDesc& desc) override;
+        virtual void   DestroyQueryPool(uint16 handle) override;
+        virtual bool   GetQueryResults(uint16 handle, QueryResults& outResults) override;
+        virtual uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) override;
+        virtual void   DestroyTransientTextureGroup(uint16 handle) override;
 
     private:
         void BindDescriptorSets(MTLCommandStream& stream);
@@ -306,19 +329,27 @@ namespace LinaGX
         void CMD_Debug(uint8* data, MTLCommandStream& stream);
         void CMD_DebugBeginLabel(uint8* data, MTLCommandStream& stream);
         void CMD_DebugEndLabel(uint8* data, MTLCommandStream& stream);
+        void CMD_WriteTimestamp(uint8* data, MTLCommandStream& stream);
+        void CMD_BeginQuery(uint8* data, MTLCommandStream& stream);
+        void CMD_EndQuery(uint8* data, MTLCommandStream& stream);
+        void CMD_ResolveQueries(uint8* data, MTLCommandStream& stream);
+        void CMD_BeginConditionalRendering(uint8* data, MTLCommandStream& stream);
+        void CMD_EndConditionalRendering(uint8* data, MTLCommandStream& stream);
 
     private:
-        IDList<uint8, MTLSwapchain>       m_swapchains      = {10};
-        IDList<uint16, MTLShader>         m_shaders         = {20};
-        IDList<uint32, MTLTexture>        m_textures        = {50};
-        IDList<uint32, MTLCommandStream>  m_cmdStreams      = {50};
-        IDList<uint16, MTLFence>          m_fences          = {20};
-        IDList<uint32, MTLResource>       m_resources       = {100};
-        IDList<uint16, MTLUserSemaphore>  m_userSemaphores  = {20};
-        IDList<uint32, MTLSampler>        m_samplers        = {100};
-        IDList<uint16, MTLDescriptorSet>  m_descriptorSets  = {20};
-        IDList<uint8, MTLQueue>           m_queues          = {5};
-        IDList<uint16, MTLPipelineLayout> m_pipelineLayouts = {10};
+        HandlePool<uint8, MTLSwapchain>              m_swapchains;
+        HandlePool<uint16, MTLShader>                m_shaders;
+        HandlePool<uint32, MTLTexture>               m_textures;
+        HandlePool<uint32, MTLCommandStream>         m_cmdStreams;
+        HandlePool<uint16, MTLFence>                 m_fences;
+        HandlePool<uint32, MTLResource>              m_resources;
+        HandlePool<uint16, MTLUserSemaphore>         m_userSemaphores;
+        HandlePool<uint32, MTLSampler>               m_samplers;
+        HandlePool<uint16, MTLDescriptorSet>         m_descriptorSets;
+        HandlePool<uint8, MTLQueue>                  m_queues;
+        HandlePool<uint16, MTLPipelineLayout>        m_pipelineLayouts;
+        HandlePool<uint16, MTLQueryPool>             m_queryPools;
+        HandlePool<uint16, MTLTransientTextureGroup> m_transientGroups;
 
         uint32 m_currentFrameIndex = 0;
         uint32 m_currentImageIndex = 0;
@@ -330,7 +361,7 @@ namespace LinaGX
 
         uint8 m_primaryQueues[3];
 
-        LINAGX_VEC<LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>> m_cmdFunctions;
+        CommandFunction                                         m_cmdFunctions[CMDID_Count] = {};
         std::atomic_flag                                        m_submissionFlag;
     };
 
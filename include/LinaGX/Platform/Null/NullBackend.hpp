@@ -0,0 +1,260 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "LinaGX/Core/Backend.hpp"
+#include "LinaGX/Core/Commands.hpp"
+
+namespace LinaGX
+{
+    struct NullShader
+    {
+        bool   isValid      = false;
+        bool   isCompute    = false;
+        uint16 customLayout = 0;
+    };
+
+    struct NullTexture
+    {
+        bool   isValid     = false;
+        uint16 flags       = 0;
+        Format format      = Format::UNDEFINED;
+        uint32 width       = 0;
+        uint32 height      = 0;
+        uint32 mipLevels   = 0;
+        uint32 arrayLength = 0;
+        bool   isTransient = false; // Owned by a NullTransientTextureGroup.
+    };
+
+    struct NullSampler
+    {
+        bool isValid = false;
+    };
+
+    struct NullSwapchain
+    {
+        bool   isValid    = false;
+        bool   isActive   = true;
+        uint32 width      = 0;
+        uint32 height     = 0;
+        uint32 imageIndex = 0;
+    };
+
+    struct NullCommandStream
+    {
+        bool           isValid       = false;
+        CommandType    type          = CommandType::Graphics;
+        uint32         boundShader   = 0;
+        bool           inRenderPass  = false;
+        bool           inConditional = false;
+        uint32         labelDepth    = 0;
+        CommandStream* streamImpl    = nullptr;
+
+        // Query state stays with the stream during translation and is applied to the pools on submission.
+        LINAGX_VEC<LINAGX_PAIR<uint16, uint32>> writtenQueries; // Pool & query index.
+        LINAGX_VEC<LINAGX_PAIR<uint16, uint32>> activeQueries;  // Between CMDBeginQuery and CMDEndQuery.
+        LINAGX_VEC<CommandStream*>              executedSecondaries;
+    };
+
+    struct NullResource
+    {
+        bool         isValid  = false;
+        bool         isMapped = false;
+        uint64       size     = 0;
+        ResourceHeap heapType = ResourceHeap::StagingHeap;
+        uint8*       memory   = nullptr;
+    };
+
+    struct NullUserSemaphore
+    {
+        bool   isValid = false;
+        uint64 value   = 0;
+    };
+
+    struct NullDescriptorSet
+    {
+        bool                          isValid  = false;
+        uint32                        setCount = 1;
+        LINAGX_VEC<DescriptorBinding> bindings;
+    };
+
+    struct NullQueue
+    {
+        bool               isValid         = false;
+        CommandType        type            = CommandType::Graphics;
+        uint64             submissionCount = 0;
+        LINAGX_VEC<uint64> frameTimelineValues; // Per frame-in-flight, last frame timeline value signaled by a submission.
+    };
+
+    struct NullPipelineLayout
+    {
+        bool isValid = false;
+    };
+
+    struct NullQueryPool
+    {
+        bool                           isValid    = false;
+        QueryType                      type       = QueryType::Timestamp;
+        uint32                         queryCount = 0;
+        LINAGX_VEC<uint8>              written; // queryCount per frame in flight.
+        LINAGX_VEC<uint64>             values;
+        LINAGX_VEC<PipelineStatistics> statistics;
+        LINAGX_VEC<uint8>              available;
+    };
+
+    struct NullTransientTextureGroup
+    {
+        bool               isValid = false;
+        LINAGX_VEC<uint32> textures;
+    };
+
+    /// <summary>
+    /// Backend that performs all handle bookkeeping and walks recorded command streams exactly like the GPU backends do, but never talks to a driver.
+    /// Use BackendAPI::Null to measure or regression-test the CPU-side cost of LinaGX on machines without a GPU or a window system.
+    /// </summary>
+    class NullBackend : public Backend
+    {
+    private:
+        typedef void (NullBackend::*CommandFunction)(uint8*, NullCommandStream& stream);
+
+    public:
+        NullBackend()
+            : Backend(){};
+        virtual ~NullBackend(){};
+
+        virtual uint16 CreateUserSemaphore() override;
+        virtual void   DestroyUserSemaphore(uint16 handle) override;
+        virtual void   WaitForUserSemaphore(uint16 handle, uint64 value) override;
+        virtual uint8  CreateSwapchain(const SwapchainDesc& desc) override;
+        virtual void   DestroySwapchain(uint8 handle) override;
+        virtual void   RecreateSwapchain(const SwapchainRecreateDesc& desc) override;
+        virtual void   SetSwapchainActive(uint8 swp, bool isActive) override;
+        virtual uint16 CreateShader(const ShaderDesc& shaderDesc) override;
+        virtual void   DestroyShader(uint16 handle) override;
+        virtual uint32 CreateTexture(const TextureDesc& desc) override;
+        virtual void   DestroyTexture(uint32 handle) override;
+        virtual uint32 CreateSampler(const SamplerDesc& desc) override;
+        virtual void   DestroySampler(uint32 handle) override;
+        virtual uint32 CreateResource(const ResourceDesc& desc) override;
+        virtual void   MapResource(uint32 handle, uint8*& ptr) override;
+        virtual void   UnmapResource(uint32 handle) override;
+        virtual void   DestroyResource(uint32 handle) override;
+        virtual uint16 CreateDescriptorSet(const DescriptorSetDesc& desc) override;
+        virtual void   DestroyDescriptorSet(uint16 handle) override;
+        virtual void   DescriptorUpdateBuffer(const DescriptorUpdateBufferDesc& desc) override;
+        virtual void   DescriptorUpdateImage(const DescriptorUpdateImageDesc& desc) override;
+        virtual uint16 CreatePipelineLayout(const PipelineLayoutDesc& desc) override;
+        virtual void   DestroyPipelineLayout(uint16 layout) override;
+        virtual uint32 CreateCommandStream(const CommandStreamDesc& desc) override;
+        virtual void   DestroyCommandStream(uint32 handle) override;
+        virtual void   SetCommandStreamImpl(uint32 handle, CommandStream* stream) override;
+        virtual void   CloseCommandStreams(CommandStream** streams, uint32 streamCount) override;
+        virtual void   SubmitCommandStreams(const SubmitDesc& desc) override;
+        virtual uint8  CreateQueue(const QueueDesc& desc) override;
+        virtual void   DestroyQueue(uint8 queue) override;
+        virtual uint8  GetPrimaryQueue(CommandType type) override;
+        virtual bool   LoadPipelineCache(const uint8* data, size_t size) override;
+        virtual bool   GetPipelineCacheData(LINAGX_VEC<uint8>& outData) override;
+        virtual uint16 CreateQueryPool(const QueryPoolDesc& desc) override;
+        virtual void   DestroyQueryPool(uint16 handle) override;
+        virtual bool   GetQueryResults(uint16 handle, QueryResults& outResults) override;
+        virtual uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) override;
+        virtual void   DestroyTransientTextureGroup(uint16 handle) override;
+
+    public:
+        virtual bool Initialize() override;
+        virtual void Shutdown() override;
+        virtual void Join() override;
+        virtual void StartFrame(uint32 frameIndex) override;
+        virtual void Present(const PresentDesc& present) override;
+        virtual void EndFrame() override;
+
+    protected:
+        virtual void TranslateCommandStream(CommandStream* stream) override;
+
+    private:
+        void ApplyQueryWrites(const NullCommandStream& stream);
+
+        void CMD_BeginRenderPass(uint8* data, NullCommandStream& stream);
+        void CMD_EndRenderPass(uint8* data, NullCommandStream& stream);
+        void CMD_SetViewport(uint8* data, NullCommandStream& stream);
+        void CMD_SetScissors(uint8* data, NullCommandStream& stream);
+        void CMD_BindPipeline(uint8* data, NullCommandStream& stream);
+        void CMD_DrawInstanced(uint8* data, NullCommandStream& stream);
+        void CMD_DrawIndexedInstanced(uint8* data, NullCommandStream& stream);
+        void CMD_DrawIndexedIndirect(uint8* data, NullCommandStream& stream);
+        void CMD_DrawIndirect(uint8* data, NullCommandStream& stream);
+        void CMD_BindVertexBuffers(uint8* data, NullCommandStream& stream);
+        void CMD_BindIndexBuffers(uint8* data, NullCommandStream& stream);
+        void CMD_CopyResource(uint8* data, NullCommandStream& stream);
+        void CMD_CopyBufferToTexture2D(uint8* data, NullCommandStream& stream);
+        void CMD_CopyTexture2DToBuffer(uint8* data, NullCommandStream& stream);
+        void CMD_CopyTexture(uint8* data, NullCommandStream& stream);
+        void CMD_BindDescriptorSets(uint8* data, NullCommandStream& stream);
+        void CMD_BindConstants(uint8* data, NullCommandStream& stream);
+        void CMD_Dispatch(uint8* data, NullCommandStream& stream);
+        void CMD_ExecuteSecondaryStream(uint8* data, NullCommandStream& stream);
+        void CMD_Barrier(uint8* data, NullCommandStream& stream);
+        void CMD_Debug(uint8* data, NullCommandStream& stream);
+        void CMD_DebugBeginLabel(uint8* data, NullCommandStream& stream);
+        void CMD_DebugEndLabel(uint8* data, NullCommandStream& stream);
+        void CMD_WriteTimestamp(uint8* data, NullCommandStream& stream);
+        void CMD_BeginQuery(uint8* data, NullCommandStream& stream);
+        void CMD_EndQuery(uint8* data, NullCommandStream& stream);
+        void CMD_ResolveQueries(uint8* data, NullCommandStream& stream);
+        void CMD_BeginConditionalRendering(uint8* data, NullCommandStream& stream);
+        void CMD_EndConditionalRendering(uint8* data, NullCommandStream& stream);
+
+    private:
+        uint32 m_currentFrameIndex = 0;
+
+        HandlePool<uint8, NullSwapchain>              m_swapchains;
+        HandlePool<uint16, NullShader>                m_shaders;
+        HandlePool<uint32, NullTexture>               m_textures;
+        HandlePool<uint32, NullCommandStream>         m_cmdStreams;
+        HandlePool<uint16, NullUserSemaphore>         m_userSemaphores;
+        HandlePool<uint32, NullResource>              m_resources;
+        HandlePool<uint32, NullSampler>               m_samplers;
+        HandlePool<uint16, NullDescriptorSet>         m_descriptorSets;
+        HandlePool<uint8, NullQueue>                  m_queues;
+        HandlePool<uint16, NullPipelineLayout>        m_pipelineLayouts;
+        HandlePool<uint16, NullQueryPool>             m_queryPools;
+        HandlePool<uint16, NullTransientTextureGroup> m_transientGroups;
+
+        CommandFunction                             m_cmdFunctions[CMDID_Count] = {};
+        LINAGX_VEC<LINAGX_PAIR<CommandType, uint8>> m_primaryQueues;
+        std::mutex                                  m_queryWriteMtx;
+    };
+} // namespace LinaGX
@@ -35,7 +35,9 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "LinaGX/Core/Backend.hpp"
+#include "LinaGX/Core/Commands.hpp"
 #include <atomic>
+#include <mutex>
 
 #ifdef LINAGX_PLATFORM_WINDOWS
 #define VK_USE_PLATFORM_WIN32_KHR
@@ -57,6 +59,7 @@ namespace LinaGX
         bool                                                 usingCustomLayout = false;
         bool                                                 isValid           = false;
         bool                                                 isCompute         = false;
+        bool                                                 usesDrawID        = false;
         VkPipeline                                           ptrPipeline       = nullptr;
         VkPipelineLayout                                     ptrLayout         = nullptr;
         LINAGX_VEC<LINAGX_PAIR<ShaderStage, VkShaderModule>> modules;
@@ -65,16 +68,19 @@ namespace LinaGX
 
     struct VKBTexture2D
     {
-        bool                    isValid     = false;
-        uint16                  flags       = 0;
-        uint32                  arrayLength = 0;
-        uint32                  mipLevels   = 0;
-        VkImageLayout           imgLayout   = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED;
-        LINAGX_VEC<VkImageView> imgViews    = {};
-        VkImage                 img         = nullptr;
-        VmaAllocation_T*        allocation  = nullptr;
-        VkExtent3D              extent      = {};
-        VkImageAspectFlags      aspectFlags = 0;
+        bool                      isValid     = false;
+        uint16                    flags       = 0;
+        uint32                    arrayLength = 0;
+        uint32                    mipLevels   = 0;
+        LINAGX_VEC<VkImageLayout> layouts     = {}; // Per subresource, layer * mipLevels + mip. As of the last submission touching the texture, see VKBackend::ResolveLayouts().
+        LINAGX_VEC<VkImageView>   imgViews    = {};
+        VkImage                   img         = nullptr;
+        VmaAllocation_T*          allocation  = nullptr;
+        VkExtent3D                extent      = {};
+        VkImageAspectFlags        aspectFlags = 0;
+        VkFormat                  format      = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits     samples     = VK_SAMPLE_COUNT_1_BIT;
+        bool                      isTransient = false; // Memory is owned by a VKBTransientTextureGroup, allocation is null.
     };
 
     struct VKBSampler
@@ -105,7 +111,13 @@ namespace LinaGX
 
     struct VKBPerFrameData
     {
-        uint32 submissionCount = 0;
+        uint32 submissionCount   = 0;
+        uint32 stagingRing       = 0;
+        uint8* stagingRingMapped = nullptr;
+        uint64 stagingRingHead   = 0;
+
+        // Frame semaphores & values of the submissions reading from the ring, waited on before it is rewound. Under VKBackend::m_stagingRingMtx.
+        LINAGX_VEC<LINAGX_PAIR<VkSemaphore, uint64>> stagingRingWaits;
     };
 
     struct VKBRenderPassImage
@@ -114,16 +126,70 @@ namespace LinaGX
         bool    isSwapchain = false;
     };
 
+    struct VKBLayoutUse
+    {
+        uint32 texture = 0;
+        uint32 first   = 0; // Into VKBCommandStream::initialLayouts & finalLayouts, one entry per subresource.
+    };
+
+    struct VKBSwapchainLayoutUse
+    {
+        uint8         swapchain     = 0;
+        uint32        imageIndex    = 0;
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout finalLayout   = VK_IMAGE_LAYOUT_MAX_ENUM; // Until the stream transitions the image.
+    };
+
     struct VKBCommandStream
     {
-        bool                                    isValid     = false;
-        CommandType                             type        = CommandType::Graphics;
-        uint32                                  boundShader = 0;
-        VkCommandBuffer                         buffer      = nullptr;
-        VkCommandPool                           pool        = nullptr;
-        LINAGX_VEC<LINAGX_PAIR<uint32, uint64>> intermediateResources;
-        LINAGX_VEC<uint8>                       swapchainWrites;
-        CommandStream*                          streamImpl = nullptr;
+        bool              isValid     = false;
+        CommandType       type        = CommandType::Graphics;
+        uint32            boundShader = 0;
+        VkCommandBuffer   buffer      = nullptr;
+        VkCommandPool     pool        = nullptr;
+        LINAGX_VEC<uint8> swapchainWrites;
+        CommandStream*    streamImpl = nullptr;
+
+        // Draw coalescing, see CommandStreamDesc::coalesceIndexedDraws.
+        bool   coalesceIndexedDraws  = false;
+        bool   boundShaderUsesDrawID = false;
+        uint32 indirectBuffer        = 0;
+        uint8* indirectMapped        = nullptr;
+        uint32 indirectCapacity      = 0; // In IndexedIndirectCommand entries, sized by ReserveCoalescedDraws() before translation starts.
+        uint32 indirectHead          = 0; // Rewound every translation, the buffer lives as long as the command buffer recorded against it.
+        uint32 pendingDrawStart      = 0;
+        uint32 pendingDrawCount      = 0;
+
+        // Secondary streams, the render pass they are executed in, set by CloseCommandStreams() from the stream executing them.
+        bool                  inheritsRenderPass     = false;
+        LINAGX_VEC<VkFormat>  inheritedColorFormats;
+        VkFormat              inheritedDepthFormat   = VK_FORMAT_UNDEFINED;
+        VkFormat              inheritedStencilFormat = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits inheritedSamples       = VK_SAMPLE_COUNT_1_BIT;
+        CMDSetViewport        inheritedViewport      = {};
+        CMDSetScissors        inheritedScissors      = {};
+
+        // Primary streams, whether the render pass being translated is made of secondary streams.
+        bool passExecutesSecondaries = false;
+
+        // Whether the stream copies from the staging ring of stagingRingFrame, its submission is then waited on before the ring is rewound.
+        bool   usesStagingRing  = false;
+        uint32 stagingRingFrame = 0;
+
+        // Pool & query index, including the ones of executed secondaries. Marked written on submission, also reset there without host query reset.
+        LINAGX_VEC<LINAGX_PAIR<uint16, uint32>> writtenQueries;
+
+        // Textures transitioned by the stream. Recorded against the layouts the textures had at translation, fixed up at submission if other streams were submitted in between.
+        LINAGX_VEC<VKBLayoutUse>          layoutUses;
+        LINAGX_VEC<VkImageLayout>         initialLayouts;
+        LINAGX_VEC<VkImageLayout>         finalLayouts;     // VK_IMAGE_LAYOUT_MAX_ENUM for subresources the stream doesn't transition.
+        LINAGX_VEC<VKBSwapchainLayoutUse> swapchainLayouts; // Same for the acquired swapchain images, VKBSwapchain::imgLayouts is only written at submission.
+
+        // Consecutive CMDBarrier commands are merged into a single barrier call. Stored with per-barrier stages, see VKBackend::RecordBarriers().
+        LINAGX_VEC<VkImageMemoryBarrier2>  pendingImageBarriers;
+        LINAGX_VEC<VkBufferMemoryBarrier2> pendingBufferBarriers;
+        LINAGX_VEC<VkMemoryBarrier2>       pendingMemoryBarriers;
+        uint32                             mergedBarriers = 0;
     };
 
     struct VKBResource
@@ -155,8 +221,14 @@ namespace LinaGX
     {
         VkSemaphore             startFrameWaitSemaphore        = nullptr;
         uint64                  storedStartFrameSemaphoreValue = 0;
+        uint64                  storedFrameTimelineValue       = 0;
         LINAGX_VEC<VkSemaphore> submitSemaphoreBuffer;
         uint32                  submitSemaphoreIndex = 0;
+
+        // ResolveLayouts() buffers of the submissions in this frame, the pool is reset in StartFrame() once they completed.
+        VkCommandPool               fixupPool = nullptr;
+        LINAGX_VEC<VkCommandBuffer> fixupBuffers;
+        uint32                      fixupHead = 0;
     };
 
     struct VKBQueue
@@ -166,7 +238,8 @@ namespace LinaGX
         CommandType                      type                = CommandType::Graphics;
         uint64                           frameSemaphoreValue = 0;
         LINAGX_VEC<VKBQueuePerFrameData> pfd;
-        LINAGX_VEC<bool>                 wasSubmitted = {false};
+        LINAGX_VEC<bool>                 wasSubmitted  = {false};
+        PagedLinearAllocator*            submitScratch = nullptr; // Submit info arrays, reset on every submission to this queue.
     };
 
     struct VKBQueueData
@@ -185,6 +258,27 @@ namespace LinaGX
         LINAGX_VEC<VkDescriptorSetLayout> setLayouts;
     };
 
+    struct VKBQueryPool
+    {
+        bool                           isValid    = false;
+        VkQueryPool                    ptr        = nullptr;
+        QueryType                      type       = QueryType::Timestamp;
+        uint32                         queryCount = 0; // Per frame, the pool holds queryCount * framesInFlight queries.
+        uint32                         stride     = 0; // uint64 per query in raw, results followed by availability.
+        LINAGX_VEC<uint64>             raw;            // As returned by vkGetQueryPoolResults.
+        LINAGX_VEC<uint64>             values;
+        LINAGX_VEC<PipelineStatistics> statistics;
+        LINAGX_VEC<uint8>              available;
+        LINAGX_VEC<uint8>              written; // Per query of all frames, set on submission and cleared once resolved.
+    };
+
+    struct VKBTransientTextureGroup
+    {
+        bool                         isValid = false;
+        LINAGX_VEC<uint32>           textures;
+        LINAGX_VEC<VmaAllocation_T*> blocks;
+    };
+
     class VKBackend : public Backend
     {
     private:
@@ -192,7 +286,7 @@ namespace LinaGX
 
     public:
         VKBackend()
-            : Backend(){};
+            : Backend(), m_frameScratch(4096, AllocationTag::Backend){};
         virtual ~VKBackend(){};
 
         virtual uint16 CreateUserSemaphore() override;
@@ -226,6 +320,13 @@ namespace LinaGX
         virtual uint8  CreateQueue(const QueueDesc& desc) override;
         virtual void   DestroyQueue(uint8 queue) override;
         virtual uint8  GetPrimaryQueue(CommandType type) override;
+        virtual bool   LoadPipelineCache(const uint8* data, size_t size) override;
+        virtual bool   GetPipelineCacheData(LINAGX_VEC<uint8>& outData) override;
+        virtual uint16 CreateQueryPool(const QueryPoolDesc& desc) override;
+        virtual void   DestroyQueryPool(uint16 handle) override;
+        virtual bool   GetQueryResults(uint16 handle, QueryResults& outResults) override;
+        virtual uint16 CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) override;
+        virtual void   DestroyTransientTextureGroup(uint16 handle) override;
 
         static uint32 QueryFeatureSupport(PreferredGPUType gpuType);
 
@@ -233,6 +334,8 @@ namespace LinaGX
         uint16                CreateFence();
         void                  DestroyFence(uint16 handle);
         VkDescriptorSetLayout CreateDescriptorSetLayout(const DescriptorSetDesc& desc);
+        void                  FillTextureCreateInfo(const TextureDesc& txtDesc, VKBTexture2D& item, VkImageCreateInfo& imgCreateInfo);
+        void                  CreateTextureViews(const TextureDesc& txtDesc, VKBTexture2D& item);
 
     public:
         virtual bool Initialize() override;
@@ -242,6 +345,9 @@ namespace LinaGX
         virtual void Present(const PresentDesc& present) override;
         virtual void EndFrame() override;
 
+    protected:
+        virtual void TranslateCommandStream(CommandStream* stream) override;
+
     private:
         void CMD_BeginRenderPass(uint8* data, VKBCommandStream& stream);
         void CMD_EndRenderPass(uint8* data, VKBCommandStream& stream);
@@ -266,48 +372,93 @@ namespace LinaGX
         void CMD_Debug(uint8* data, VKBCommandStream& stream);
         void CMD_DebugBeginLabel(uint8* data, VKBCommandStream& stream);
         void CMD_DebugEndLabel(uint8* data, VKBCommandStream& stream);
+        void CMD_WriteTimestamp(uint8* data, VKBCommandStream& stream);
+        void CMD_BeginQuery(uint8* data, VKBCommandStream& stream);
+        void CMD_EndQuery(uint8* data, VKBCommandStream& stream);
+        void CMD_ResolveQueries(uint8* data, VKBCommandStream& stream);
+        void CMD_BeginConditionalRendering(uint8* data, VKBCommandStream& stream);
+        void CMD_EndConditionalRendering(uint8* data, VKBCommandStream& stream);
+
+        void ReserveCoalescedDraws(CommandStream* stream);
+        void CoalesceIndexedDraw(const CMDDrawIndexedInstanced* cmd, VKBCommandStream& stream);
+        void FlushCoalescedDraws(VKBCommandStream& stream);
+        void ResolveQueries(uint32 frameIndex);
+
+        uint32          GetLayoutUse(VKBCommandStream& stream, uint32 texture);
+        uint32          GetSwapchainLayoutUse(VKBCommandStream& stream, uint8 swapchain);
+        void            InheritLayouts(VKBCommandStream& stream, const VKBCommandStream& secondary);
+        VkCommandBuffer ResolveLayouts(VKBCommandStream& stream, VKBQueuePerFrameData& queuePfd, PagedLinearAllocator& scratch);
+        void            FlushBarriers(VKBCommandStream& stream);
+        void            RecordBarriers(VkCommandBuffer buffer, uint32 memoryBarrierCount, const VkMemoryBarrier2* memoryBarriers, uint32 bufferBarrierCount, const VkBufferMemoryBarrier2* bufferBarriers, uint32 imageBarrierCount, const VkImageMemoryBarrier2* imageBarriers, PagedLinearAllocator& scratch);
+
+        void   InheritRenderPasses(CommandStream* stream);
+        bool   PassExecutesSecondaries(CommandStream* stream, uint32 beginIndex);
+        uint32 ExecuteSecondaryStreams(CommandStream* stream, uint32 firstIndex, VKBCommandStream& sr);
 
     private:
     private:
-        VkInstance               m_vkInstance     = nullptr;
-        VkDebugUtilsMessengerEXT m_debugMessenger = nullptr;
-        VkAllocationCallbacks*   m_allocator      = nullptr;
-        VkDevice                 m_device         = nullptr;
-        VkPhysicalDevice         m_gpu            = nullptr;
-        VmaAllocator_T*          m_vmaAllocator   = nullptr;
+        VkInstance               m_vkInstance          = nullptr;
+        VkDebugUtilsMessengerEXT m_debugMessenger      = nullptr;
+        VkAllocationCallbacks    m_allocationCallbacks = {};
+        VkAllocationCallbacks*   m_allocator           = nullptr;
+        VkDevice                 m_device              = nullptr;
+        VkPhysicalDevice         m_gpu                 = nullptr;
+        VmaAllocator_T*          m_vmaAllocator        = nullptr;
 
         uint64 m_minUniformBufferOffsetAlignment = 0;
         uint64 m_minStorageBufferOffsetAlignment = 0;
         bool   m_supportsMultiDrawIndirect       = false;
+        bool   m_supportsPipelineStatistics      = false;
+        bool   m_supportsConditionalRendering    = false;
+        bool   m_supportsSynchronization2        = false;
         bool   m_supportsAnisotropy              = false;
         bool   m_supportsDedicatedTransferQueue  = false;
         bool   m_supportsDedicatedComputeQueue   = false;
         bool   m_supportsSeparateTransferQueue   = false;
         bool   m_supportsSeparateComputeQueue    = false;
+        bool   m_supportsHostQueryReset          = false;
+        uint64 m_timestampMask                   = 0; // timestampValidBits of the graphics family.
 
         uint32 m_currentFrameIndex = 0;
         uint32 m_currentImageIndex = 0;
 
-        IDList<uint8, VKBSwapchain>       m_swapchains      = {5};
-        IDList<uint16, VKBShader>         m_shaders         = {10};
-        IDList<uint32, VKBTexture2D>      m_textures        = {100};
-        IDList<uint32, VKBCommandStream>  m_cmdStreams      = {100};
-        IDList<uint16, VKBUserSemaphore>  m_userSemaphores  = {20};
-        IDList<uint16, VkFence>           m_fences          = {20};
-        IDList<uint32, VKBResource>       m_resources       = {100};
-        IDList<uint32, VKBSampler>        m_samplers        = {100};
-        IDList<uint16, VKBDescriptorSet>  m_descriptorSets  = {20};
-        IDList<uint8, VKBQueue>           m_queues          = {5};
-        IDList<uint16, VKBPipelineLayout> m_pipelineLayouts = {10};
+        HandlePool<uint8, VKBSwapchain>              m_swapchains;
+        HandlePool<uint16, VKBShader>                m_shaders;
+        HandlePool<uint32, VKBTexture2D>             m_textures;
+        HandlePool<uint32, VKBCommandStream>         m_cmdStreams;
+        HandlePool<uint16, VKBUserSemaphore>         m_userSemaphores;
+        HandlePool<uint16, VkFence>                  m_fences;
+        HandlePool<uint32, VKBResource>              m_resources;
+        HandlePool<uint32, VKBSampler>               m_samplers;
+        HandlePool<uint16, VKBDescriptorSet>         m_descriptorSets;
+        HandlePool<uint8, VKBQueue>                  m_queues;
+        HandlePool<uint16, VKBPipelineLayout>        m_pipelineLayouts;
+        HandlePool<uint16, VKBQueryPool>             m_queryPools;
+        HandlePool<uint16, VKBTransientTextureGroup> m_transientGroups;
 
         LINAGX_VEC<VKBPerFrameData>                             m_perFrameData = {};
-        LINAGX_VEC<LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>> m_cmdFunctions = {};
+        CommandFunction                                         m_cmdFunctions[CMDID_Count] = {};
         LINAGX_VEC<LINAGX_PAIR<CommandType, uint8>>             m_primaryQueues;
         LINAGX_VEC<LINAGX_PAIR<VkQueue, std::atomic_flag*>>     m_flagsPerQueue;
 
         VkDescriptorPool           m_descriptorPool = nullptr;
+        VkPipelineCache            m_pipelineCache  = nullptr;
         VkPhysicalDeviceProperties m_gpuProperties;
 
+        // Frame thread only: StartFrame(), Present() and Join() build their wait lists here instead of the heap.
+        PagedLinearAllocator m_frameScratch;
+
+        // Texture layouts are read while translating and written in submission order, possibly from several threads.
+        std::mutex                        m_layoutMtx;
+        LINAGX_VEC<VkImageMemoryBarrier2> m_layoutFixups; // ResolveLayouts() only, under m_layoutMtx.
+
+        // Query written flags are set from submissions on several threads.
+        std::mutex m_queryWriteMtx;
+
+        // Staging ring heads are advanced by CloseCommandStreams(), which might run on several threads at once.
+        std::mutex m_stagingRingMtx;
+
         LINAGX_VEC<LINAGX_PAIR<CommandType, VKBQueueData>> m_queueData;
+        LINAGX_VEC<uint32>                                 m_sharedQueueFamilies; // Distinct families of m_queueData, textures & resources are shared across them concurrently.
     };
 } // namespace LinaGX
@@ -231,7 +231,7 @@ namespace LinaGX
             {
                 for (auto& b : allTextures)
                 {
-                    delete[] b->buffer.pixels;
+                    FreeMemory(b->buffer.pixels);
                 }
 
                 delete[] allTextures[0];
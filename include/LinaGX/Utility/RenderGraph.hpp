@@ -0,0 +1,263 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#pragma once
+
+#include "LinaGX/Common/CommonGfx.hpp"
+#include <functional>
+
+namespace LinaGX
+{
+    class Instance;
+    class CommandStream;
+
+    /// <summary>
+    /// How a pass accesses an imported resource (buffer), used to derive access & stage masks of the barriers.
+    /// </summary>
+    enum class RGResourceAccess
+    {
+        VertexRead,
+        IndexRead,
+        IndirectRead,
+        UniformRead,
+        ShaderRead,
+        ShaderWrite,
+        TransferRead,
+        TransferWrite,
+        ConditionalRenderingRead,
+    };
+
+    typedef std::function<void(CommandStream* stream)> RGRecordFunction;
+
+    struct RGPassDesc
+    {
+        const char*      name        = "LinaGXPass"; // Also used as the debug label around the pass' commands.
+        CommandType      type        = CommandType::Graphics;
+        uint8            queue       = 255;   // Queue created with LinaGX::Instance::CreateQueue(), must match type. Leave as 255 to use the primary queue of type.
+        bool             sideEffects = false; // Passes with side effects, e.g. readbacks, are never culled.
+        RGRecordFunction record;              // Records the pass' commands, barriers for the declared reads & writes are already in the stream.
+    };
+
+    struct RGStatistics
+    {
+        uint32 passCount          = 0;
+        uint32 culledPassCount    = 0;
+        uint32 batchCount         = 0; // Submissions per frame, one per run of consecutive passes on the same queue.
+        uint32 barrierCount       = 0; // CMDBarrier commands per frame, at most one per pass plus the final transitions.
+        uint32 textureBarriers    = 0;
+        uint32 resourceBarriers   = 0;
+        uint32 memoryBarriers     = 0;
+        uint32 queueWaits         = 0; // Cross-queue semaphore waits per frame.
+        uint64 transientMemory    = 0; // Memory of the transient textures with aliasing.
+        uint64 transientUnaliased = 0; // Memory the transient textures would take with dedicated allocations.
+    };
+
+    /// <summary>
+    /// Optional frame graph on top of CommandStream. Import the textures & resources the frame touches, add passes in submission order and declare what each pass reads & writes.
+    /// Compile() culls passes none of the outputs depend on, batches consecutive passes on the same queue into a single submission, and derives the minimum set of barriers between them.
+    /// Execute() then records every live pass into the graph's own command streams, closes and submits them, with user semaphores ordering the batches across queues.
+    /// Declare all accesses a pass makes, anything undeclared is not synchronized. Barriers are recorded on the consuming queue without queue family ownership transfers,
+    /// which Vulkan allows as textures & resources are created with concurrent sharing across the queue families in use. Swapchains are only shared with the presenting
+    /// queue, so only graphics passes can access them.
+    /// Compile once and Execute every frame between StartFrame() and EndFrame(), call Reset() and rebuild the graph when passes or imports change.
+    /// </summary>
+    class RenderGraph
+    {
+    public:
+        /// <summary>
+        /// streamDesc is used as a template for the command streams the graph creates, type and debugName are overridden.
+        /// </summary>
+        RenderGraph(Instance* lgx, const CommandStreamDesc& streamDesc = {});
+
+        /// <summary>
+        /// Destroys the command streams & semaphores the graph created, make sure all frames-in-flight operations are complete prior.
+        /// </summary>
+        ~RenderGraph();
+
+        /// <summary>
+        /// The graph assumes the texture is in initialState at the start of every frame, and transitions it to finalState after the last pass using it.
+        /// </summary>
+        /// <returns>Graph handle to use in ReadTexture(), WriteTexture() and MarkOutput().</returns>
+        uint32 ImportTexture(uint32 texture, TextureState initialState, TextureState finalState);
+
+        /// <summary>
+        /// Same as ImportTexture() for the current image of a swapchain. Swapchains are always outputs of the graph.
+        /// </summary>
+        uint32 ImportSwapchain(uint8 swapchain, TextureState initialState = TextureState::Present, TextureState finalState = TextureState::Present);
+
+        /// <summary>
+        /// Texture that only lives within the frame, e.g. G-buffer, SSAO or bloom targets. Compile() creates it along with the other transient textures used on the same queue,
+        /// placing the ones whose lifetimes don't overlap into the same memory, and its first barrier in every frame discards the previous contents.
+        /// The texture is recreated on every Compile(), use GetTexture() afterwards to fetch the backend handle, e.g. to update descriptor sets. Culled textures are not created.
+        /// </summary>
+        /// <returns>Graph handle to use in ReadTexture() and WriteTexture().</returns>
+        uint32 CreateTransientTexture(const TextureDesc& desc);
+
+        /// <summary>
+        /// Buffers have no state to restore, only the accesses in between passes are synchronized.
+        /// </summary>
+        /// <returns>Graph handle to use in ReadResource(), WriteResource() and MarkOutput().</returns>
+        uint32 ImportResource(uint32 resource);
+
+        /// <summary>
+        /// Passes are executed in the order they are added, unless culled.
+        /// </summary>
+        /// <returns>Pass handle to declare the accesses with.</returns>
+        uint32 AddPass(const RGPassDesc& desc);
+
+        void ReadTexture(uint32 pass, uint32 texture, TextureState state = TextureState::ShaderRead);
+        void WriteTexture(uint32 pass, uint32 texture, TextureState state = TextureState::ColorAttachment);
+        void ReadResource(uint32 pass, uint32 resource, RGResourceAccess access = RGResourceAccess::ShaderRead);
+        void WriteResource(uint32 pass, uint32 resource, RGResourceAccess access = RGResourceAccess::ShaderWrite);
+
+        /// <summary>
+        /// Marks a texture or resource as used outside of the graph, so the passes writing it, and everything they depend on, are kept.
+        /// </summary>
+        void MarkOutput(uint32 handle);
+
+        /// <summary>
+        /// Culls, batches and derives the barriers. Needs to be called after the graph is built or modified, before Execute().
+        /// </summary>
+        void Compile();
+
+        /// <summary>
+        /// Records, closes and submits all live passes for the current frame.
+        /// </summary>
+        void Execute();
+
+        /// <summary>
+        /// Clears the passes & imports so the graph can be rebuilt. Command streams & semaphores are kept for reuse.
+        /// </summary>
+        void Reset();
+
+        bool IsPassCulled(uint32 pass) const;
+
+        /// <summary>
+        /// Backend handle of an imported or transient texture.
+        /// </summary>
+        uint32 GetTexture(uint32 handle) const;
+
+        inline const RGStatistics& GetStatistics() const
+        {
+            return m_statistics;
+        }
+
+    private:
+        struct Node
+        {
+            uint32       handle       = 0;
+            bool         isTexture    = false;
+            bool         isSwapchain  = false;
+            bool         isOutput     = false;
+            bool         isTransient  = false;
+            uint32       transient    = 0; // Index into m_transientDescs.
+            TextureState initialState = TextureState::ShaderRead;
+            TextureState finalState   = TextureState::ShaderRead;
+        };
+
+        struct Access
+        {
+            uint32           node     = 0;
+            bool             write    = false;
+            TextureState     state    = TextureState::ShaderRead;     // Textures only.
+            RGResourceAccess resource = RGResourceAccess::ShaderRead; // Resources only.
+        };
+
+        struct Barriers
+        {
+            LINAGX_VEC<TextureBarrier>  textureBarriers;
+            LINAGX_VEC<ResourceBarrier> resourceBarriers;
+            LINAGX_VEC<MemBarrier>      memoryBarriers;
+            uint32                      srcStageFlags = 0;
+            uint32                      dstStageFlags = 0;
+        };
+
+        struct Pass
+        {
+            RGPassDesc         desc;
+            LINAGX_VEC<Access> accesses;
+            Barriers           barriers;
+            bool               culled = false;
+        };
+
+        struct Batch
+        {
+            uint8              queue       = 0;
+            CommandType        type        = CommandType::Graphics;
+            uint32             streamIndex = 0; // Among the batches of the same type.
+            LINAGX_VEC<uint32> passes;
+            LINAGX_VEC<uint32> waitBatches; // Batches on other queues this one needs to wait for.
+            Barriers           finalBarriers;
+            bool               signal      = false;
+            uint64             signalValue = 0; // Set during Execute().
+        };
+
+        struct StreamPool
+        {
+            LINAGX_VEC<CommandStream*> streams[3]; // Per CommandType, except secondary. Grows on demand, never shrinks until destruction.
+        };
+
+        struct QueueSemaphore
+        {
+            uint8  queue     = 0;
+            uint16 semaphore = 0;
+            uint64 value     = 0;
+        };
+
+    private:
+        uint32          AddNode(const Node& node);
+        void            AddAccess(uint32 pass, const Access& access);
+        void            CreateTransientTextures();
+        void            DestroyTransientTextures();
+        void            RecordBarriers(CommandStream* stream, const Barriers& barriers);
+        QueueSemaphore& GetQueueSemaphore(uint8 queue);
+        CommandStream*  GetStream(uint32 frameIndex, const Batch& batch);
+
+    private:
+        Instance*                  m_lgx = nullptr;
+        CommandStreamDesc          m_streamDesc;
+        LINAGX_VEC<Node>           m_nodes;
+        LINAGX_VEC<Pass>           m_passes;
+        LINAGX_VEC<Batch>          m_batches;
+        LINAGX_VEC<QueueSemaphore> m_semaphores;
+        LINAGX_VEC<TextureDesc>    m_transientDescs;
+        LINAGX_VEC<uint16>         m_transientGroups;
+        LINAGX_VEC<StreamPool>     m_streamPools; // Per frame in flight.
+        LINAGX_VEC<CommandStream*> m_frameStreams;
+        LINAGX_VEC<uint16>         m_waitSemaphores;
+        LINAGX_VEC<uint64>         m_waitValues;
+        RGStatistics               m_statistics;
+        bool                       m_compiled = false;
+    };
+} // namespace LinaGX
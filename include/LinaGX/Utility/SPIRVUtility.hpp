@@ -47,6 +47,8 @@ namespace LinaGX
         static void Initialize();
         static void Shutdown();
         static bool GLSL2SPV(ShaderStage stg, const LINAGX_STRING& pShader, const LINAGX_STRING& includePath, DataBlob& spirv, ShaderLayout& outLayout, BackendAPI targetAPI);
+        static bool CompileGLSL(ShaderStage stg, const LINAGX_STRING& pShader, const LINAGX_STRING& includePath, DataBlob& spirv, LINAGX_STRING& outProcessedShader, bool& outUsesDrawID, BackendAPI targetAPI);
+        static void ReflectSPV(ShaderStage stg, const DataBlob& spirv, const LINAGX_STRING& processedShader, ShaderLayout& outLayout);
         static bool SPV2HLSL(ShaderStage stg, const DataBlob& spv, LINAGX_STRING& out, const ShaderLayout& layoutReflection);
         static bool SPV2MSL(ShaderStage stg, const DataBlob& spv, LINAGX_STRING& out, ShaderLayout& layoutReflection);
         static void PostFillReflection(ShaderLayout& outLayout, BackendAPI targetAPI);
@@ -0,0 +1,77 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#pragma once
+
+#include "LinaGX/Common/CommonGfx.hpp"
+#include <mutex>
+
+namespace LinaGX
+{
+    enum class BackendAPI;
+
+    /// <summary>
+    /// Content-addressed cache for Instance::CompileShaderToSPV() results, enabled via Config.enableShaderCache.
+    /// Entries are keyed by a hash of the stage texts with their includes resolved, target API and shader debug flags,
+    /// and contain the per-stage SPIR-V blobs along with the serialized ShaderLayout.
+    /// If Config.shaderCacheDirectory is set, entries missing in memory are looked up on disk, and new entries are written there as well.
+    /// </summary>
+    class ShaderCache
+    {
+    public:
+        static uint64 ComputeKey(const LINAGX_VEC<ShaderCompileData>& compileData, BackendAPI targetAPI);
+
+        /// <summary>
+        /// On hit, fills outBlob of all stages in compileData with a copy of the cached SPIR-V, allocated via new[] like compiled blobs, and outLayout with the cached reflection.
+        /// </summary>
+        static bool Load(uint64 key, LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout);
+        static void Store(uint64 key, const LINAGX_VEC<ShaderCompileData>& compileData, const ShaderLayout& layout);
+
+        /// <summary>
+        /// Clears the memory cache, files in Config.shaderCacheDirectory are left untouched.
+        /// </summary>
+        static void Clear();
+
+        static void SerializeLayout(const ShaderLayout& layout, LINAGX_VEC<uint8>& outData);
+        static bool DeserializeLayout(const uint8* data, size_t size, size_t& offset, ShaderLayout& outLayout);
+
+    private:
+        static LINAGX_STRING GetEntryPath(uint64 key);
+
+    private:
+        static std::mutex                            s_mtx;
+        static LINAGX_MAP<uint64, LINAGX_VEC<uint8>> s_entries;
+    };
+} // namespace LinaGX
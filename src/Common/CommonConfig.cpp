@@ -37,6 +37,7 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LinaGX/Common/CommonConfig.hpp"
+#include "LinaGX/Common/Math.hpp"
 
 namespace LinaGX
 {
@@ -44,4 +45,99 @@ namespace LinaGX
     GPUInformation        GPUInfo          = {};
     PerformanceStatistics PerformanceStats = {};
 
+    namespace
+    {
+        /// <summary>
+        /// Placed right before every block returned from AllocateMemory(), so frees and reallocations know the size, tag and start of the raw allocation.
+        /// </summary>
+        struct alignas(16) AllocationHeader
+        {
+            uint64        size          = 0;
+            uint32        offset        = 0; // From the start of the raw allocation.
+            uint8         alignmentLog2 = 0;
+            AllocationTag tag           = AllocationTag::Commands;
+        };
+
+        inline size_t GetRawSize(size_t size, size_t alignment)
+        {
+            return size + sizeof(AllocationHeader) + alignment - 1;
+        }
+
+        inline AllocationHeader* GetHeader(void* ptr)
+        {
+            return reinterpret_cast<AllocationHeader*>(static_cast<uint8*>(ptr) - sizeof(AllocationHeader));
+        }
+    } // namespace
+
+    void* AllocateMemory(size_t size, AllocationTag tag, size_t alignment)
+    {
+        alignment            = alignment < alignof(AllocationHeader) ? alignof(AllocationHeader) : alignment;
+        const size_t rawSize = GetRawSize(size, alignment);
+        void*        raw     = Config.allocator.allocate ? Config.allocator.allocate(Config.allocator.userData, rawSize, alignment, tag) : LINAGX_MALLOC(rawSize);
+
+        if (raw == nullptr)
+            return nullptr;
+
+        const uintptr_t head = reinterpret_cast<uintptr_t>(raw) + sizeof(AllocationHeader);
+        uint8*          ptr  = reinterpret_cast<uint8*>(ALIGN_SIZE_POW(head, alignment));
+
+        AllocationHeader* header = GetHeader(ptr);
+        header->size             = size;
+        header->offset           = static_cast<uint32>(ptr - static_cast<uint8*>(raw));
+        header->alignmentLog2    = static_cast<uint8>(FloorLog2(static_cast<uint32>(alignment)));
+        header->tag              = tag;
+
+        MemoryStatistics& stats = PerformanceStats.memory[static_cast<uint32>(tag)];
+        stats.allocations.fetch_add(1, std::memory_order_relaxed);
+        stats.liveBytes.fetch_add(size, std::memory_order_relaxed);
+        PerformanceStats.totalHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    void* ReallocateMemory(void* ptr, size_t size, AllocationTag tag, size_t alignment)
+    {
+        if (ptr == nullptr)
+            return AllocateMemory(size, tag, alignment);
+
+        if (size == 0)
+        {
+            FreeMemory(ptr);
+            return nullptr;
+        }
+
+        void* newPtr = AllocateMemory(size, tag, alignment);
+
+        if (newPtr == nullptr)
+            return nullptr;
+
+        const size_t oldSize = static_cast<size_t>(GetHeader(ptr)->size);
+        LINAGX_MEMCPY(newPtr, ptr, oldSize < size ? oldSize : size);
+        FreeMemory(ptr);
+        return newPtr;
+    }
+
+    void FreeMemory(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        const AllocationHeader header = *GetHeader(ptr);
+        void*                  raw    = static_cast<uint8*>(ptr) - header.offset;
+
+        MemoryStatistics& stats = PerformanceStats.memory[static_cast<uint32>(header.tag)];
+        stats.frees.fetch_add(1, std::memory_order_relaxed);
+        stats.liveBytes.fetch_sub(header.size, std::memory_order_relaxed);
+        PerformanceStats.totalHeapFrees.fetch_add(1, std::memory_order_relaxed);
+
+        if (Config.allocator.free)
+            Config.allocator.free(Config.allocator.userData, raw, GetRawSize(static_cast<size_t>(header.size), size_t(1) << header.alignmentLog2), header.tag);
+        else
+            LINAGX_FREE(raw);
+    }
+
+    void ReportHandlesExhausted(const char* itemType, uint32 capacity)
+    {
+        LOGE("HandlePool -> Out of handles for %s, at most %u can be alive at once!", itemType, capacity);
+    }
+
 } // namespace LinaGX
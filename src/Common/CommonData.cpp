@@ -40,6 +40,56 @@ namespace LinaGX
     {
         return FnvHash(ty);
     }
+
+    PagedLinearAllocator::PagedLinearAllocator(size_t pageSize, AllocationTag tag)
+    {
+        m_pageSize = pageSize;
+        m_tag      = tag;
+    }
+
+    PagedLinearAllocator::~PagedLinearAllocator()
+    {
+        for (const Page& page : m_pages)
+            FreeMemory(page.data);
+    }
+
+    uint8* PagedLinearAllocator::AllocateFromNextPage(size_t size, size_t alignment)
+    {
+        // Whatever is left in the current page is wasted until the next Reset().
+        if (m_currentPage < m_pages.size())
+        {
+            m_usedSize += m_pages[m_currentPage].size - m_pageOffset;
+            m_currentPage++;
+            m_pageOffset = 0;
+        }
+
+        // Skip recycled pages that are too small, only possible for requests larger than the page size.
+        while (m_currentPage < m_pages.size() && m_pages[m_currentPage].size < size + alignment)
+        {
+            m_usedSize += m_pages[m_currentPage].size;
+            m_currentPage++;
+        }
+
+        // Out of recycled pages, chain a new one.
+        if (m_currentPage == m_pages.size())
+        {
+            Page page = {};
+            page.size = size + alignment > m_pageSize ? size + alignment : m_pageSize;
+            page.data = static_cast<uint8*>(AllocateMemory(page.size, m_tag));
+            m_reservedSize += page.size;
+            m_pages.push_back(page);
+        }
+
+        return Allocate(size, alignment);
+    }
+
+    void PagedLinearAllocator::Reset()
+    {
+        m_highWaterMark = GetHighWaterMark();
+        m_currentPage   = 0;
+        m_pageOffset    = 0;
+        m_usedSize      = 0;
+    }
     // uint32 FnvHash::fnvHash(const char* str)
     // {
     //     const size_t length = strlen(str) + 1;
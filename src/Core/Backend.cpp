@@ -33,7 +33,10 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LinaGX/Core/Backend.hpp"
+#include "LinaGX/Core/CommandStream.hpp"
+#include "LinaGX/Core/Commands.hpp"
 #include "LinaGX/Common/CommonConfig.hpp"
+#include "LinaGX/Platform/Null/NullBackend.hpp"
 
 #ifdef LINAGX_PLATFORM_WINDOWS
 
@@ -55,6 +58,8 @@ namespace LinaGX
 {
     Backend* LinaGX::Backend::CreateBackend()
     {
+        if (Config.api == BackendAPI::Null)
+            return new NullBackend();
 
 #ifdef LINAGX_PLATFORM_WINDOWS
 
@@ -81,4 +86,162 @@ namespace LinaGX
 #endif
         return nullptr;
     }
+
+    void Backend::DeferDestruction(DeferredObjectType type, uint32 handle)
+    {
+        // Submissions made since the last signal are only covered by the next one.
+        std::lock_guard<std::mutex> lock(m_deferredDestructionMtx);
+        m_deferredDestructions.push_back({m_signaledTimeline.load(std::memory_order_acquire) + 1, handle, type});
+    }
+
+    bool Backend::PopDeferredDestruction(bool all, DeferredDestruction& outDestruction)
+    {
+        std::lock_guard<std::mutex> lock(m_deferredDestructionMtx);
+
+        if (m_deferredDestructions.empty())
+            return false;
+
+        const DeferredDestruction& front = m_deferredDestructions.front();
+        if (!all && front.timelineValue > m_completedTimeline.load(std::memory_order_acquire))
+            return false;
+
+        outDestruction = front;
+        m_deferredDestructions.pop_front();
+        return true;
+    }
+
+    uint64 Backend::SignalFrameTimeline()
+    {
+        return m_signaledTimeline.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    void Backend::CompleteFrameTimeline(uint64 value)
+    {
+        uint64 current = m_completedTimeline.load(std::memory_order_relaxed);
+        while (current < value && !m_completedTimeline.compare_exchange_weak(current, value, std::memory_order_acq_rel))
+        {
+        }
+    }
+
+    void Backend::PackTransientAllocations(LINAGX_VEC<TransientAllocation>& allocations, LINAGX_VEC<TransientBlock>& outBlocks)
+    {
+        outBlocks.clear();
+
+        LINAGX_VEC<uint32> order(allocations.size());
+        for (uint32 i = 0; i < static_cast<uint32>(order.size()); i++)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(), [&](uint32 a, uint32 b) { return allocations[a].size > allocations[b].size; });
+
+        LINAGX_VEC<uint32> placed;
+        LINAGX_VEC<uint32> conflicts;
+
+        for (auto index : order)
+        {
+            auto& alloc = allocations[index];
+
+            uint32 block = 0;
+            while (block < static_cast<uint32>(outBlocks.size()) && outBlocks[block].key != alloc.key)
+                block++;
+
+            if (block == static_cast<uint32>(outBlocks.size()))
+                outBlocks.push_back({0, 1, alloc.key});
+
+            // Only the allocations alive at the same time in the same block constrain the offset.
+            conflicts.clear();
+            for (auto other : placed)
+            {
+                const auto& o = allocations[other];
+                if (o.block == block && o.firstUse <= alloc.lastUse && alloc.firstUse <= o.lastUse)
+                    conflicts.push_back(other);
+            }
+
+            std::sort(conflicts.begin(), conflicts.end(), [&](uint32 a, uint32 b) { return allocations[a].offset < allocations[b].offset; });
+
+            const uint64 alignment = alloc.alignment == 0 ? 1 : alloc.alignment;
+            uint64       offset    = 0;
+
+            for (auto other : conflicts)
+            {
+                const auto& o = allocations[other];
+
+                if (offset + alloc.size <= o.offset)
+                    break;
+
+                const uint64 end = o.offset + o.size;
+                if (end > offset)
+                    offset = ((end + alignment - 1) / alignment) * alignment;
+            }
+
+            alloc.block  = block;
+            alloc.offset = offset;
+            placed.push_back(index);
+
+            auto& target     = outBlocks[block];
+            target.size      = target.size > offset + alloc.size ? target.size : offset + alloc.size;
+            target.alignment = target.alignment > alignment ? target.alignment : alignment;
+        }
+    }
+
+    namespace
+    {
+        struct TranslationJobData
+        {
+            Backend*        backend           = nullptr;
+            CommandStream** streams           = nullptr;
+            uint64          serialCommandMask = 0;
+            uint32          frameIndex        = 0;
+        };
+    } // namespace
+
+    bool Backend::NeedsTranslation(const CommandStream* stream, uint32 frameIndex) const
+    {
+        if (!stream->m_isTranslated)
+            return true;
+
+        // Queries resolve into a different set every frame in flight.
+        return stream->IsFrameBound() && stream->m_translatedFrameIndex != frameIndex;
+    }
+
+    void Backend::TranslateIfNeeded(CommandStream* stream, uint32 frameIndex)
+    {
+        if (!NeedsTranslation(stream, frameIndex))
+            return;
+
+        TranslateCommandStream(stream);
+        stream->m_translatedFrameIndex = frameIndex;
+
+        // Uploads are sub-allocated from memory that is recycled every frame, replaying them would read whatever was written there last.
+        stream->m_isTranslated = stream->m_isPersistent && stream->m_commandCount != 0 && !stream->HasAnyCommand(1ull << CMDID_CopyBufferToTexture2D);
+    }
+
+    void Backend::TranslateCommandStreams(CommandStream** streams, uint32 streamCount, uint64 serialCommandMask, uint32 frameIndex)
+    {
+        if (Config.dispatchJobsCallback == nullptr || streamCount < 2)
+        {
+            for (uint32 i = 0; i < streamCount; i++)
+                TranslateIfNeeded(streams[i], frameIndex);
+
+            return;
+        }
+
+        for (uint32 i = 0; i < streamCount; i++)
+        {
+            if (streams[i]->HasAnyCommand(serialCommandMask))
+                TranslateIfNeeded(streams[i], frameIndex);
+        }
+
+        TranslationJobData jobData = {this, streams, serialCommandMask, frameIndex};
+
+        Config.dispatchJobsCallback(
+            [](void* userData, uint32 jobIndex) {
+                TranslationJobData* data   = static_cast<TranslationJobData*>(userData);
+                CommandStream*      stream = data->streams[jobIndex];
+
+                if (!stream->HasAnyCommand(data->serialCommandMask))
+                    data->backend->TranslateIfNeeded(stream, data->frameIndex);
+            },
+            &jobData, streamCount);
+    }
+
 } // namespace LinaGX
@@ -36,32 +36,62 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/Core/Commands.hpp"
 #include "LinaGX/Core/Backend.hpp"
 #include "LinaGX/Common/CommonConfig.hpp"
+#include "LinaGX/Common/Math.hpp"
 
 namespace LinaGX
 {
+#define SCRATCH_PAGE_SIZE 4096
+
     CommandStream::CommandStream(Backend* backend, const CommandStreamDesc& desc, uint32 gpuHandle)
+        : m_commandArena(desc.totalMemoryLimit), m_auxArena(desc.auxMemorySize), m_scratchArena(SCRATCH_PAGE_SIZE)
     {
         m_backend           = backend;
-        m_commandBufferSize = static_cast<uint32>(desc.totalMemoryLimit);
-        m_commandBuffer     = (uint8*)LINAGX_MALLOC(desc.totalMemoryLimit);
-        m_commands          = static_cast<uint8**>(LINAGX_MALLOC(sizeof(uint8*) * desc.commandCount));
         m_type              = desc.type;
-        m_maxCommands       = desc.commandCount;
+        m_isPersistent      = desc.persistent;
         m_gpuHandle         = gpuHandle;
-        m_auxMemoryIndex    = 0;
-        m_auxMemorySize     = static_cast<uint32>(desc.auxMemorySize);
-        m_auxMemory         = (uint8*)LINAGX_MALLOC(desc.auxMemorySize);
         m_constantBlockSize = static_cast<uint32>(desc.constantBlockSize);
+        m_commands.resize(desc.commandCount);
 
         if (Config.api != BackendAPI::Vulkan && desc.constantBlockSize != 0)
-            m_constantBlockMemory = (uint8*)LINAGX_MALLOC(desc.constantBlockSize);
+            m_constantBlockMemory = static_cast<uint8*>(AllocateMemory(desc.constantBlockSize, AllocationTag::Commands));
     }
 
     void CommandStream::Reset()
     {
-        m_commandIndex   = 0;
-        m_commandCount   = 0;
-        m_auxMemoryIndex = 0;
+        m_commandHighWaterMark = Max(m_commandHighWaterMark, m_commandCount);
+        m_commandCount         = 0;
+        m_recordedCommandMask  = 0;
+        m_isTranslated         = false;
+        m_commandArena.Reset();
+        m_auxArena.Reset();
+    }
+
+    void CommandStream::Invalidate()
+    {
+        if (m_isPersistent)
+            Reset();
+    }
+
+    bool CommandStream::IsFrameBound() const
+    {
+        // Query slots and upload staging memory are picked per frame in flight while translating.
+        return m_isPersistent && HasAnyCommand(1ull << CMDID_WriteTimestamp | 1ull << CMDID_BeginQuery | 1ull << CMDID_EndQuery | 1ull << CMDID_ResolveQueries | 1ull << CMDID_CopyBufferToTexture2D);
+    }
+
+    CommandStreamStatistics CommandStream::GetStatistics() const
+    {
+        CommandStreamStatistics stats    = {};
+        stats.commandCount               = m_commandCount;
+        stats.commandCountHighWaterMark  = Max(m_commandHighWaterMark, m_commandCount);
+        stats.commandMemoryUsed          = m_commandArena.GetUsedSize();
+        stats.commandMemoryHighWaterMark = m_commandArena.GetHighWaterMark();
+        stats.commandMemoryReserved      = m_commandArena.GetReservedSize();
+        stats.commandMemoryPageCount     = m_commandArena.GetPageCount();
+        stats.auxMemoryUsed              = m_auxArena.GetUsedSize();
+        stats.auxMemoryHighWaterMark     = m_auxArena.GetHighWaterMark();
+        stats.auxMemoryReserved          = m_auxArena.GetReservedSize();
+        stats.auxMemoryPageCount         = m_auxArena.GetPageCount();
+        return stats;
     }
 
     void CommandStream::WriteToConstantBlock(void* data, size_t size)
@@ -72,11 +102,8 @@ namespace LinaGX
     CommandStream::~CommandStream()
     {
         m_backend->DestroyCommandStream(m_gpuHandle);
-        LINAGX_FREE(m_commands);
-        LINAGX_FREE(m_commandBuffer);
-        LINAGX_FREE(m_auxMemory);
 
         if (m_constantBlockMemory != nullptr)
-            LINAGX_FREE(m_constantBlockMemory);
+            FreeMemory(m_constantBlockMemory);
     }
 } // namespace LinaGX
@@ -36,8 +36,43 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace LinaGX
 {
+    static const char* s_cmdDebugNames[CMDID_Count] = {
+        "CMDBeginRenderPass",
+        "CMDEndRenderPass",
+        "CMDSetViewport",
+        "CMDSetScissors",
+        "CMDBindPipeline",
+        "CMDDrawInstanced",
+        "CMDDrawIndexedInstanced",
+        "CMDDrawIndexedIndirect",
+        "CMDDrawIndirect",
+        "CMDCopyResource",
+        "CMDCopyBufferToTexture2D",
+        "CMDCopyTexture2DToBuffer",
+        "CMDCopyTexture",
+        "CMDBindVertexBuffers",
+        "CMDBindIndexBuffers",
+        "CMDBindDescriptorSets",
+        "CMDBindConstants",
+        "CMDDispatch",
+        "CMDExecuteSecondaryStream",
+        "CMDDebug",
+        "CMDDebugBeginLabel",
+        "CMDDebugEndLabel",
+        "CMDBarrier",
+        "CMDWriteTimestamp",
+        "CMDBeginQuery",
+        "CMDEndQuery",
+        "CMDResolveQueries",
+        "CMDBeginConditionalRendering",
+        "CMDEndConditionalRendering",
+    };
+
     LINAGX_STRING GetCMDDebugName(LINAGX_TYPEID tid)
     {
-        return "";
-    } // namespace LinaGX
+        if (tid >= CMDID_Count)
+            return "";
+
+        return s_cmdDebugNames[tid];
+    }
 } // namespace LinaGX
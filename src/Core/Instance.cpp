@@ -35,9 +35,11 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/Core/Instance.hpp"
 #include "LinaGX/Core/Backend.hpp"
 #include "LinaGX/Utility/SPIRVUtility.hpp"
+#include "LinaGX/Utility/ShaderCache.hpp"
 #include "LinaGX/Core/CommandStream.hpp"
 #include "LinaGX/Common/Math.hpp"
 #include "LinaGX/Common/CommonConfig.hpp"
+#include <fstream>
 
 #ifdef LINAGX_PLATFORM_WINDOWS
 #ifndef LINAGX_DISABLE_VK
@@ -56,7 +58,40 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace LinaGX
 {
 
-#define LGX_CONDITIONAL_LOCK(condition, mtx) auto conditionalScope = condition ? std::unique_lock<std::mutex>(mtx) : std::unique_lock<std::mutex>()
+#define LGX_CONDITIONAL_LOCK(condition, mtx) auto conditionalScope = condition ? LockCounted(mtx) : std::unique_lock<std::mutex>()
+
+    namespace
+    {
+        /// <summary>
+        /// Locks mtx, counting the acquisition in PerformanceStats.lockContentions if another thread was holding it.
+        /// </summary>
+        std::unique_lock<std::mutex> LockCounted(std::mutex& mtx)
+        {
+            std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                PerformanceStats.lockContentions.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            return lock;
+        }
+
+        /// <summary>
+        /// Runs job(i) for every i in [0, count), through Config.dispatchJobsCallback if set.
+        /// </summary>
+        template <typename F>
+        void DispatchJobs(uint32 count, F&& job)
+        {
+            if (Config.dispatchJobsCallback == nullptr || count < 2)
+            {
+                for (uint32 i = 0; i < count; i++)
+                    job(i);
+                return;
+            }
+
+            Config.dispatchJobsCallback([](void* userData, uint32 jobIndex) { (*static_cast<std::remove_reference_t<F>*>(userData))(jobIndex); }, &job, count);
+        }
+    } // namespace
 
     Instance::~Instance()
     {
@@ -67,7 +102,7 @@ namespace LinaGX
     {
 #ifdef LINAGX_PLATFORM_APPLE
 
-        if (Config.api != BackendAPI::Metal)
+        if (Config.api != BackendAPI::Metal && Config.api != BackendAPI::Null)
         {
             LOGE("Backend API needs to be Metal for Apple platforms!");
             return false;
@@ -92,6 +127,14 @@ namespace LinaGX
         }
 #endif
 
+#endif
+
+#ifdef LINAGX_PLATFORM_UNIX
+        if (Config.api != BackendAPI::Null)
+        {
+            LOGE("Only the Null backend is supported on this platform!");
+            return false;
+        }
 #endif
 
         m_backend = Backend::CreateBackend();
@@ -105,6 +148,8 @@ namespace LinaGX
         if (!m_backend->Initialize())
         {
             LOGE("Instance -> Failed initializing backend!");
+            delete m_backend;
+            m_backend = nullptr;
             return false;
         }
 
@@ -118,11 +163,16 @@ namespace LinaGX
     void Instance::Join()
     {
         m_backend->Join();
+        RetireDeferredDestructions(true);
     }
 
     void Instance::Shutdown()
     {
-        m_backend->Join();
+        // Initialize() failed or was never called.
+        if (m_backend == nullptr)
+            return;
+
+        Join();
         m_windowManager.Shutdown();
         SPIRVUtility::Shutdown();
         m_backend->Shutdown();
@@ -131,7 +181,56 @@ namespace LinaGX
 
     void Instance::StartFrame()
     {
+        m_frameStartHeapAllocations = PerformanceStats.totalHeapAllocations.load(std::memory_order_relaxed);
         m_backend->StartFrame(m_currentFrameIndex);
+        RetireDeferredDestructions(false);
+    }
+
+    void Instance::RetireDeferredDestructions(bool all)
+    {
+        DeferredDestruction destruction = {};
+
+        while (m_backend->PopDeferredDestruction(all, destruction))
+        {
+            switch (destruction.type)
+            {
+            case DeferredObjectType::Texture: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_textureMtx);
+                m_backend->DestroyTexture(destruction.handle);
+                break;
+            }
+            case DeferredObjectType::Resource: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_resourceMtx);
+                m_backend->DestroyResource(destruction.handle);
+                break;
+            }
+            case DeferredObjectType::Shader: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_shaderMtx);
+                m_backend->DestroyShader(static_cast<uint16>(destruction.handle));
+                break;
+            }
+            case DeferredObjectType::DescriptorSet: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_descriptorSetMtx);
+                m_backend->DestroyDescriptorSet(static_cast<uint16>(destruction.handle));
+                break;
+            }
+            case DeferredObjectType::Sampler: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_samplerMtx);
+                m_backend->DestroySampler(destruction.handle);
+                break;
+            }
+            case DeferredObjectType::QueryPool: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_queryPoolMtx);
+                m_backend->DestroyQueryPool(static_cast<uint16>(destruction.handle));
+                break;
+            }
+            case DeferredObjectType::TransientTextureGroup: {
+                LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_textureMtx);
+                m_backend->DestroyTransientTextureGroup(static_cast<uint16>(destruction.handle));
+                break;
+            }
+            }
+        }
     }
 
     void Instance::CloseCommandStreams(CommandStream** streams, uint32 streamCount)
@@ -141,16 +240,27 @@ namespace LinaGX
 
     void Instance::SubmitCommandStreams(const SubmitDesc& desc)
     {
+        for (uint32 i = 0; i < desc.streamCount; i++)
+        {
+            const CommandStream* stream = desc.streams[i];
+            if (stream->IsFrameBound() && stream->m_translatedFrameIndex != m_currentFrameIndex)
+                LOGE("Instance -> Persistent command stream with queries or uploads is submitted in a different frame than it was closed in, close it again first!");
+        }
+
         m_backend->SubmitCommandStreams(desc);
 
         for (uint32 i = 0; i < desc.streamCount; i++)
-            desc.streams[i]->Reset();
+        {
+            if (!desc.streams[i]->m_isPersistent)
+                desc.streams[i]->Reset();
+        }
     }
 
     void Instance::EndFrame()
     {
         m_backend->EndFrame();
-        m_currentFrameIndex = (m_currentFrameIndex + 1) % Config.framesInFlight;
+        m_currentFrameIndex                   = (m_currentFrameIndex + 1) % Config.framesInFlight;
+        PerformanceStats.frameHeapAllocations = PerformanceStats.totalHeapAllocations.load(std::memory_order_relaxed) - m_frameStartHeapAllocations;
         PerformanceStats.totalFrames++;
         m_windowManager.EndFrame();
     }
@@ -173,13 +283,13 @@ namespace LinaGX
 
     uint16 Instance::CreateUserSemaphore()
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_semaphoreMtx);
         return m_backend->CreateUserSemaphore();
     }
 
     void Instance::DestroyUserSemaphore(uint16 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_semaphoreMtx);
         m_backend->DestroyUserSemaphore(handle);
     }
 
@@ -190,19 +300,19 @@ namespace LinaGX
 
     uint8 Instance::CreateSwapchain(const SwapchainDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_swapchainMtx);
         return m_backend->CreateSwapchain(desc);
     }
 
     void Instance::DestroySwapchain(uint8 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_swapchainMtx);
         m_backend->DestroySwapchain(handle);
     }
 
     void Instance::RecreateSwapchain(const SwapchainRecreateDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_swapchainMtx);
         m_backend->RecreateSwapchain(desc);
     }
 
@@ -221,6 +331,15 @@ namespace LinaGX
 
     bool Instance::CompileShaderToSPV(LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout)
     {
+        uint64 cacheKey = 0;
+
+        if (Config.enableShaderCache)
+        {
+            cacheKey = ShaderCache::ComputeKey(compileData, Config.api);
+            if (ShaderCache::Load(cacheKey, compileData, outLayout))
+                return true;
+        }
+
         outLayout.vertexInputs.clear();
 
         for (ShaderCompileData& data : compileData)
@@ -233,9 +352,117 @@ namespace LinaGX
         }
 
         SPIRVUtility::PostFillReflection(outLayout, Config.api);
+
+        if (Config.enableShaderCache)
+            ShaderCache::Store(cacheKey, compileData, outLayout);
+
         return true;
     }
 
+    bool Instance::CompileShaders(LINAGX_VEC<ShaderCompileBatchEntry>& batch)
+    {
+        struct StageJob
+        {
+            uint32 entry = 0;
+            uint32 stage = 0;
+        };
+
+        const uint32 entryCount = static_cast<uint32>(batch.size());
+
+        // Keeps glslang initialized for the whole batch even if called before Initialize(), worker threads set up their own glslang state lazily.
+        SPIRVUtility::Initialize();
+
+        LINAGX_VEC<uint64> cacheKeys(entryCount, 0);
+        LINAGX_VEC<uint8>  cacheHits(entryCount, 0);
+
+        if (Config.enableShaderCache)
+        {
+            DispatchJobs(entryCount, [&](uint32 i) {
+                cacheKeys[i] = ShaderCache::ComputeKey(batch[i].compileData, Config.api);
+                cacheHits[i] = ShaderCache::Load(cacheKeys[i], batch[i].compileData, batch[i].outLayout);
+            });
+        }
+
+        // Stages are independent until reflection, compile all of them at once.
+        LINAGX_VEC<StageJob> stageJobs;
+        LINAGX_VEC<uint32>   firstStageJob(entryCount, 0);
+
+        for (uint32 i = 0; i < entryCount; i++)
+        {
+            firstStageJob[i] = static_cast<uint32>(stageJobs.size());
+
+            if (cacheHits[i])
+                continue;
+
+            for (uint32 j = 0; j < static_cast<uint32>(batch[i].compileData.size()); j++)
+                stageJobs.push_back({i, j});
+        }
+
+        LINAGX_VEC<uint8>         stageSucceeded(stageJobs.size(), 0);
+        LINAGX_VEC<uint8>         stageUsesDrawID(stageJobs.size(), 0);
+        LINAGX_VEC<LINAGX_STRING> stageProcessedTexts(stageJobs.size());
+
+        DispatchJobs(static_cast<uint32>(stageJobs.size()), [&](uint32 i) {
+            ShaderCompileData& data       = batch[stageJobs[i].entry].compileData[stageJobs[i].stage];
+            bool               usesDrawID = false;
+            data.outBlob                  = {};
+            stageSucceeded[i]             = SPIRVUtility::CompileGLSL(data.stage, data.text, data.includePath, data.outBlob, stageProcessedTexts[i], usesDrawID, Config.api);
+            stageUsesDrawID[i]            = usesDrawID;
+        });
+
+        DispatchJobs(entryCount, [&](uint32 i) {
+            ShaderCompileBatchEntry& entry = batch[i];
+
+            if (!cacheHits[i])
+            {
+                const uint32 stageCount = static_cast<uint32>(entry.compileData.size());
+                bool         succeeded  = true;
+
+                for (uint32 j = 0; j < stageCount; j++)
+                    succeeded = succeeded && stageSucceeded[firstStageJob[i] + j];
+
+                if (!succeeded)
+                {
+                    for (ShaderCompileData& data : entry.compileData)
+                    {
+                        delete[] data.outBlob.ptr;
+                        data.outBlob = {};
+                    }
+
+                    entry.success = false;
+                    return;
+                }
+
+                entry.outLayout.vertexInputs.clear();
+
+                for (uint32 j = 0; j < stageCount; j++)
+                {
+                    const ShaderCompileData& data = entry.compileData[j];
+
+                    if (stageUsesDrawID[firstStageJob[i] + j])
+                        entry.outLayout.hasGLDrawID = true;
+
+                    SPIRVUtility::ReflectSPV(data.stage, data.outBlob, stageProcessedTexts[firstStageJob[i] + j], entry.outLayout);
+                }
+
+                SPIRVUtility::PostFillReflection(entry.outLayout, Config.api);
+
+                if (Config.enableShaderCache)
+                    ShaderCache::Store(cacheKeys[i], entry.compileData, entry.outLayout);
+            }
+
+            entry.success = CompileShaderFromSPV(entry.compileData, entry.outLayout);
+        });
+
+        SPIRVUtility::Shutdown();
+
+        bool allSucceeded = true;
+        for (const ShaderCompileBatchEntry& entry : batch)
+            allSucceeded = allSucceeded && entry.success;
+
+        return allSucceeded;
+    }
+
     bool Instance::CompileShaderFromSPV(LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout)
     {
         if (Config.api == BackendAPI::DX12)
@@ -323,21 +550,23 @@ namespace LinaGX
 
     uint16 Instance::CreateShader(const ShaderDesc& shaderDesc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_shaderMtx);
         return m_backend->CreateShader(shaderDesc);
     }
 
     void Instance::DestroyShader(uint16 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        m_backend->DestroyShader(handle);
+        m_backend->DeferDestruction(DeferredObjectType::Shader, handle);
     }
 
     CommandStream* Instance::CreateCommandStream(const CommandStreamDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        const uint32   strHandle = m_backend->CreateCommandStream(desc);
-        CommandStream* stream    = new CommandStream(m_backend, desc, strHandle);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_commandStreamMtx);
+        const uint32 strHandle = m_backend->CreateCommandStream(desc);
+        if (strHandle == static_cast<uint32>(~0u))
+            return nullptr;
+
+        CommandStream* stream = new CommandStream(m_backend, desc, strHandle);
         m_backend->SetCommandStreamImpl(strHandle, stream);
         m_commandStreams.push_back(stream);
         return stream;
@@ -345,68 +574,62 @@ namespace LinaGX
 
     void Instance::DestroyCommandStream(CommandStream* stream)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_commandStreamMtx);
         delete stream;
     }
 
     uint32 Instance::CreateTexture(const TextureDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_textureMtx);
         return m_backend->CreateTexture(desc);
     }
 
     void Instance::DestroyTexture(uint32 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        m_backend->DestroyTexture(handle);
+        m_backend->DeferDestruction(DeferredObjectType::Texture, handle);
     }
 
     uint32 Instance::CreateSampler(const SamplerDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_samplerMtx);
         return m_backend->CreateSampler(desc);
     }
 
     void Instance::DestroySampler(uint32 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        m_backend->DestroySampler(handle);
+        m_backend->DeferDestruction(DeferredObjectType::Sampler, handle);
     }
 
     uint32 Instance::CreateResource(const ResourceDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_resourceMtx);
         return m_backend->CreateResource(desc);
     }
 
     void Instance::DestroyResource(uint32 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        m_backend->DestroyResource(handle);
+        m_backend->DeferDestruction(DeferredObjectType::Resource, handle);
     }
 
     void Instance::MapResource(uint32 resource, uint8*& ptr)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
         m_backend->MapResource(resource, ptr);
     }
 
     void Instance::UnmapResource(uint32 resource)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
         m_backend->UnmapResource(resource);
     }
 
     uint16 Instance::CreateDescriptorSet(const DescriptorSetDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_descriptorSetMtx);
         return m_backend->CreateDescriptorSet(desc);
     }
 
     void Instance::DestroyDescriptorSet(uint16 handle)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
-        m_backend->DestroyDescriptorSet(handle);
+        m_backend->DeferDestruction(DeferredObjectType::DescriptorSet, handle);
     }
 
     void Instance::DescriptorUpdateBuffer(const DescriptorUpdateBufferDesc& desc)
@@ -421,25 +644,25 @@ namespace LinaGX
 
     uint16 Instance::CreatePipelineLayout(const PipelineLayoutDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_pipelineLayoutMtx);
         return m_backend->CreatePipelineLayout(desc);
     }
 
     void Instance::DestroyPipelineLayout(uint16 layout)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_pipelineLayoutMtx);
         m_backend->DestroyPipelineLayout(layout);
     }
 
     uint8 Instance::CreateQueue(const QueueDesc& desc)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_queueMtx);
         return m_backend->CreateQueue(desc);
     }
 
     void Instance::DestroyQueue(uint8 queue)
     {
-        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_globalMtx);
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_queueMtx);
         m_backend->DestroyQueue(queue);
     }
 
@@ -448,6 +671,90 @@ namespace LinaGX
         return m_backend->GetPrimaryQueue(type);
     }
 
+    bool Instance::LoadPipelineCache(const uint8* data, size_t size)
+    {
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_shaderMtx); // Merging into the cache needs to be externally synchronized with pipeline creation.
+        return m_backend->LoadPipelineCache(data, size);
+    }
+
+    bool Instance::LoadPipelineCache(const char* path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+
+        const std::streamsize size = file.tellg();
+        if (size <= 0)
+            return false;
+
+        LINAGX_VEC<uint8> data(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(data.data()), size))
+        {
+            LOGE("Instance -> Failed reading pipeline cache file %s", path);
+            return false;
+        }
+
+        return LoadPipelineCache(data.data(), data.size());
+    }
+
+    bool Instance::GetPipelineCacheData(LINAGX_VEC<uint8>& outData)
+    {
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_shaderMtx);
+        return m_backend->GetPipelineCacheData(outData);
+    }
+
+    bool Instance::SavePipelineCache(const char* path)
+    {
+        LINAGX_VEC<uint8> data;
+        if (!GetPipelineCacheData(data) || data.empty())
+            return false;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+        {
+            LOGE("Instance -> Failed writing pipeline cache file %s", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint16 Instance::CreateQueryPool(const QueryPoolDesc& desc)
+    {
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_queryPoolMtx);
+        return m_backend->CreateQueryPool(desc);
+    }
+
+    void Instance::DestroyQueryPool(uint16 handle)
+    {
+        m_backend->DeferDestruction(DeferredObjectType::QueryPool, handle);
+    }
+
+    bool Instance::GetQueryResults(uint16 handle, QueryResults& outResults)
+    {
+        // Nothing has been resolved until the first frame index wraps around.
+        if (PerformanceStats.totalFrames < Config.framesInFlight)
+            return false;
+
+        if (!m_backend->GetQueryResults(handle, outResults))
+            return false;
+
+        outResults.frame = PerformanceStats.totalFrames - Config.framesInFlight;
+        return true;
+    }
+
+    uint16 Instance::CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo)
+    {
+        LGX_CONDITIONAL_LOCK(Config.mutexLockCreationDeletion, m_textureMtx);
+        return m_backend->CreateTransientTextureGroup(desc, outInfo);
+    }
+
+    void Instance::DestroyTransientTextureGroup(uint16 handle)
+    {
+        m_backend->DeferDestruction(DeferredObjectType::TransientTextureGroup, handle);
+    }
+
     uint32 Instance::VKQueryFeatureSupport(PreferredGPUType gpuType)
     {
 #ifdef LINAGX_PLATFORM_WINDOWS
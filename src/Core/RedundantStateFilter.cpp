@@ -0,0 +1,167 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "LinaGX/Core/RedundantStateFilter.hpp"
+
+namespace LinaGX
+{
+    bool RedundantStateFilter::IsRedundant(LINAGX_TYPEID tid, const uint8* cmd)
+    {
+        switch (tid)
+        {
+        case CMDID_BindPipeline: {
+            const CMDBindPipeline* bind = reinterpret_cast<const CMDBindPipeline*>(cmd);
+
+            if (m_hasPipeline && m_pipeline == bind->shader)
+                return true;
+
+            // Layouts might differ, so sets bound for the previous pipeline can't be assumed to stay bound.
+            m_hasPipeline = true;
+            m_pipeline    = bind->shader;
+            InvalidateDescriptorSets();
+            return false;
+        }
+        case CMDID_SetViewport: {
+            const CMDSetViewport* vp = reinterpret_cast<const CMDSetViewport*>(cmd);
+
+            if (m_hasViewport && m_viewport.x == vp->x && m_viewport.y == vp->y && m_viewport.width == vp->width && m_viewport.height == vp->height && m_viewport.minDepth == vp->minDepth && m_viewport.maxDepth == vp->maxDepth)
+                return true;
+
+            m_hasViewport = true;
+            m_viewport    = *vp;
+            return false;
+        }
+        case CMDID_SetScissors: {
+            const CMDSetScissors* sc = reinterpret_cast<const CMDSetScissors*>(cmd);
+
+            if (m_hasScissors && m_scissors.x == sc->x && m_scissors.y == sc->y && m_scissors.width == sc->width && m_scissors.height == sc->height)
+                return true;
+
+            m_hasScissors = true;
+            m_scissors    = *sc;
+            return false;
+        }
+        case CMDID_BindVertexBuffers: {
+            const CMDBindVertexBuffers* bind = reinterpret_cast<const CMDBindVertexBuffers*>(cmd);
+
+            if (bind->slot >= STATE_FILTER_MAX_VERTEX_BUFFERS)
+                return false;
+
+            BoundVertexBuffer& bound = m_vertexBuffers[bind->slot];
+
+            if (bound.isBound && bound.resource == bind->resource && bound.vertexSize == bind->vertexSize && bound.offset == bind->offset)
+                return true;
+
+            bound = {true, bind->resource, bind->vertexSize, bind->offset};
+            return false;
+        }
+        case CMDID_BindIndexBuffers: {
+            const CMDBindIndexBuffers* bind = reinterpret_cast<const CMDBindIndexBuffers*>(cmd);
+
+            if (m_hasIndexBuffer && m_indexBuffer.resource == bind->resource && m_indexBuffer.offset == bind->offset && m_indexBuffer.indexType == bind->indexType)
+                return true;
+
+            m_hasIndexBuffer = true;
+            m_indexBuffer    = *bind;
+            return false;
+        }
+        case CMDID_BindDescriptorSets:
+            return IsRedundantDescriptorSets(reinterpret_cast<const CMDBindDescriptorSets*>(cmd));
+        case CMDID_BeginRenderPass: {
+            const CMDBeginRenderPass* begin = reinterpret_cast<const CMDBeginRenderPass*>(cmd);
+            m_hasViewport                   = true;
+            m_viewport                      = {};
+            m_viewport.x                    = begin->viewport.x;
+            m_viewport.y                    = begin->viewport.y;
+            m_viewport.width                = begin->viewport.width;
+            m_viewport.height               = begin->viewport.height;
+            m_viewport.minDepth             = begin->viewport.minDepth;
+            m_viewport.maxDepth             = begin->viewport.maxDepth;
+            m_hasScissors                   = true;
+            m_scissors                      = {};
+            m_scissors.x                    = begin->scissors.x;
+            m_scissors.y                    = begin->scissors.y;
+            m_scissors.width                = begin->scissors.width;
+            m_scissors.height               = begin->scissors.height;
+            return false;
+        }
+        case CMDID_ExecuteSecondaryStream:
+            *this = RedundantStateFilter();
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    bool RedundantStateFilter::IsRedundantDescriptorSets(const CMDBindDescriptorSets* cmd)
+    {
+        BoundSet* sets = m_sets[cmd->isCompute ? 1 : 0];
+
+        // Dynamic offsets aren't tracked, such bindings always go through and leave their range unknown.
+        bool redundant = cmd->dynamicOffsetCount == 0 && cmd->setCount != 0 && cmd->firstSet + cmd->setCount <= STATE_FILTER_MAX_SETS;
+
+        for (uint32 i = 0; redundant && i < cmd->setCount; i++)
+        {
+            const BoundSet& bound = sets[cmd->firstSet + i];
+            redundant             = bound.isBound && bound.handle == cmd->descriptorSetHandles[i] && bound.allocationIndex == (cmd->allocationIndices == nullptr ? 0 : cmd->allocationIndices[i]) && bound.layoutSource == cmd->layoutSource && bound.customLayout == cmd->customLayout && bound.customLayoutShader == cmd->customLayoutShader;
+        }
+
+        if (redundant)
+            return true;
+
+        for (uint32 i = 0; i < cmd->setCount && cmd->firstSet + i < STATE_FILTER_MAX_SETS; i++)
+        {
+            BoundSet& bound          = sets[cmd->firstSet + i];
+            bound.isBound            = cmd->dynamicOffsetCount == 0;
+            bound.handle             = cmd->descriptorSetHandles[i];
+            bound.allocationIndex    = cmd->allocationIndices == nullptr ? 0 : cmd->allocationIndices[i];
+            bound.layoutSource       = cmd->layoutSource;
+            bound.customLayout       = cmd->customLayout;
+            bound.customLayoutShader = cmd->customLayoutShader;
+        }
+
+        return false;
+    }
+
+    void RedundantStateFilter::InvalidateDescriptorSets()
+    {
+        for (auto& bindPoint : m_sets)
+        {
+            for (BoundSet& set : bindPoint)
+                set.isBound = false;
+        }
+    }
+
+} // namespace LinaGX
@@ -49,6 +49,8 @@ namespace LinaGX
         auto it = LINAGX_FIND_IF(m_windows.begin(), m_windows.end(), [sid](const auto& pair) -> bool { return pair.first == sid; });
         LOGA((it == m_windows.end()), "Window Manager -> Window with the same sid already exists! %d", sid);
 
+#if defined(LINAGX_PLATFORM_WINDOWS) || defined(LINAGX_PLATFORM_APPLE)
+
 #ifdef LINAGX_PLATFORM_WINDOWS
         Window* win = new Win32Window(m_input, this);
 #else
@@ -65,6 +67,10 @@ namespace LinaGX
         m_windows.push_back({sid, win});
 
         return win;
+#else
+        LOGE("Window Manager -> Windowing is not supported on this platform!");
+        return nullptr;
+#endif
     }
 
     void WindowManager::DestroyApplicationWindow(LINAGX_STRINGID sid)
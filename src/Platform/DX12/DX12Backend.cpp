@@ -666,10 +666,39 @@ namespace LinaGX
             return D3D12_RESOURCE_STATE_COPY_SOURCE;
         case LinaGX::ResourceBarrierState::TransferWrite:
             return D3D12_RESOURCE_STATE_COPY_DEST;
+        case LinaGX::ResourceBarrierState::ConditionalRenderingRead:
+            return D3D12_RESOURCE_STATE_PREDICATION;
         default:
             return D3D12_RESOURCE_STATE_COMMON;
         }
     }
+
+    D3D12_QUERY_HEAP_TYPE GetDXQueryHeapType(QueryType type)
+    {
+        switch (type)
+        {
+        case LinaGX::QueryType::Occlusion:
+            return D3D12_QUERY_HEAP_TYPE_OCCLUSION;
+        case LinaGX::QueryType::PipelineStatistics:
+            return D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+        default:
+            return D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        }
+    }
+
+    D3D12_QUERY_TYPE GetDXQueryType(QueryType type)
+    {
+        switch (type)
+        {
+        case LinaGX::QueryType::Occlusion:
+            // Resolves to 0 or 1, cheaper than sample counts and exactly what predication needs.
+            return D3D12_QUERY_TYPE_BINARY_OCCLUSION;
+        case LinaGX::QueryType::PipelineStatistics:
+            return D3D12_QUERY_TYPE_PIPELINE_STATISTICS;
+        default:
+            return D3D12_QUERY_TYPE_TIMESTAMP;
+        }
+    }
     void FillBorderColor(BorderColor bc, float* color)
     {
         switch (bc)
@@ -767,6 +796,10 @@ namespace LinaGX
 
     uint16 DX12Backend::CreateUserSemaphore()
     {
+        const uint16 handle = m_userSemaphores.AddItem({});
+        if (handle == m_userSemaphores.InvalidHandle)
+            return handle;
+
         DX12UserSemaphore item = {};
         item.isValid           = true;
 
@@ -779,7 +812,8 @@ namespace LinaGX
             DX12_THROW(e, "Backend-> Exception when creating a fence! {0}", e.what());
         }
 
-        return m_userSemaphores.AddItem(item);
+        m_userSemaphores.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::DestroyUserSemaphore(uint16 handle)
@@ -802,6 +836,17 @@ namespace LinaGX
 
     uint8 DX12Backend::CreateSwapchain(const SwapchainDesc& desc)
     {
+        const uint8 handle = m_swapchains.AddItem({});
+        if (handle == m_swapchains.InvalidHandle)
+            return handle;
+
+        LINAGX_VEC<uint32> colorHandles;
+        if (!ReserveTextureHandles(Config.backbufferCount, colorHandles))
+        {
+            m_swapchains.RemoveItem(handle);
+            return m_swapchains.InvalidHandle;
+        }
+
         DXGI_FORMAT swapFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
 
         // DXGI flip swapchains can only be b8g8r8a8_unorm, r16g16b16a16_float or r8g8b8a8_unorm.
@@ -875,11 +920,13 @@ namespace LinaGX
                     rtvDesc.Format                        = GetDXFormat(desc.format);
                     rtvDesc.ViewDimension                 = D3D12_RTV_DIMENSION_TEXTURE2D;
                     m_device->CreateRenderTargetView(color.rawRes.Get(), &rtvDesc, {color.rtvs[0].GetCPUHandle()});
-                    swp.colorTextures.push_back(m_textures.AddItem(color));
+                    m_textures.GetItemR(colorHandles[i]) = color;
+                    swp.colorTextures.push_back(colorHandles[i]);
                 }
             }
 
-            return m_swapchains.AddItem(swp);
+            m_swapchains.GetItemR(handle) = swp;
+            return handle;
         }
         catch (HrException e)
         {
@@ -922,6 +969,11 @@ namespace LinaGX
 
         Join();
 
+        // New handles are reserved before the old textures go away, so the swapchain never ends up without its textures.
+        LINAGX_VEC<uint32> colorHandles;
+        if (!ReserveTextureHandles(Config.backbufferCount, colorHandles))
+            return;
+
         auto&                swp     = m_swapchains.GetItemR(desc.swapchain);
         DXGI_SWAP_CHAIN_DESC swpDesc = {};
         swp.ptr->GetDesc(&swpDesc);
@@ -962,7 +1014,8 @@ namespace LinaGX
                 rtvDesc.Format                        = GetDXFormat(swp.format);
                 rtvDesc.ViewDimension                 = D3D12_RTV_DIMENSION_TEXTURE2D;
                 m_device->CreateRenderTargetView(color.rawRes.Get(), &rtvDesc, {color.rtvs[0].GetCPUHandle()});
-                swp.colorTextures[i] = m_textures.AddItem(color);
+                m_textures.GetItemR(colorHandles[i]) = color;
+                swp.colorTextures[i]                 = colorHandles[i];
             }
         }
         catch (HrException e)
@@ -1603,8 +1656,49 @@ namespace LinaGX
         m_shaders.RemoveItem(handle);
     }
 
+    D3D12_RESOURCE_DESC DX12Backend::GetTextureResourceDesc(const TextureDesc& txtDesc)
+    {
+        D3D12_RESOURCE_DESC resourceDesc = {};
+        resourceDesc.Dimension           = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        resourceDesc.Alignment           = 0;
+        resourceDesc.Width               = txtDesc.width;
+        resourceDesc.Height              = txtDesc.height;
+        resourceDesc.DepthOrArraySize    = txtDesc.arrayLength;
+        resourceDesc.MipLevels           = txtDesc.mipLevels;
+        resourceDesc.SampleDesc.Count    = txtDesc.samples;
+        resourceDesc.SampleDesc.Quality  = 0;
+        resourceDesc.Layout              = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        resourceDesc.Flags               = D3D12_RESOURCE_FLAG_NONE;
+        resourceDesc.Format              = GetDXFormat(txtDesc.format);
+
+        if (txtDesc.type == TextureType::Texture1D)
+            resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
+        else if (txtDesc.type == TextureType::Texture1D)
+            resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+
+        if ((txtDesc.flags & TextureFlags::TF_DepthTexture) || (txtDesc.flags & TextureFlags::TF_StencilTexture))
+            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+        if ((txtDesc.flags & TextureFlags::TF_ColorAttachment))
+            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+        if (txtDesc.samples == 1 && !(txtDesc.flags & TextureFlags::TF_Sampled) && !(txtDesc.flags & TextureFlags::TF_SampleOutsideFragment))
+            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+
+        return resourceDesc;
+    }
+
     uint32 DX12Backend::CreateTexture(const TextureDesc& txtDesc)
     {
+        return CreateTexture(txtDesc, nullptr, 0);
+    }
+
+    uint32 DX12Backend::CreateTexture(const TextureDesc& txtDesc, D3D12MA::Allocation* aliasingBlock, uint64 aliasingOffset)
+    {
+        const uint32 handle = m_textures.AddItem({});
+        if (handle == m_textures.InvalidHandle)
+            return handle;
+
         if (txtDesc.type == TextureType::Texture3D && txtDesc.arrayLength != 1)
         {
             LOGA(false, "Backend -> Array length needs to be 1 for 3D textures!");
@@ -1628,23 +1722,7 @@ namespace LinaGX
         item.format        = GetDXFormat(txtDesc.format);
         item.bytesPerPixel = GetDXBytesPerPixel(txtDesc.format);
 
-        D3D12_RESOURCE_DESC resourceDesc = {};
-        resourceDesc.Dimension           = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-        resourceDesc.Alignment           = 0;
-        resourceDesc.Width               = txtDesc.width;
-        resourceDesc.Height              = txtDesc.height;
-        resourceDesc.DepthOrArraySize    = txtDesc.arrayLength;
-        resourceDesc.MipLevels           = txtDesc.mipLevels;
-        resourceDesc.SampleDesc.Count    = txtDesc.samples;
-        resourceDesc.SampleDesc.Quality  = 0;
-        resourceDesc.Layout              = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-        resourceDesc.Flags               = D3D12_RESOURCE_FLAG_NONE;
-        resourceDesc.Format              = item.format;
-
-        if (txtDesc.type == TextureType::Texture1D)
-            resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
-        else if (txtDesc.type == TextureType::Texture1D)
-            resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+        D3D12_RESOURCE_DESC resourceDesc = GetTextureResourceDesc(txtDesc);
 
         D3D12MA::ALLOCATION_DESC allocationDesc = {};
         allocationDesc.HeapType                 = D3D12_HEAP_TYPE_DEFAULT;
@@ -1656,15 +1734,6 @@ namespace LinaGX
         auto                  colorClear = CD3DX12_CLEAR_VALUE(GetDXFormat(txtDesc.format), cc);
         item.state                       = state;
 
-        if ((txtDesc.flags & TextureFlags::TF_DepthTexture) || (txtDesc.flags & TextureFlags::TF_StencilTexture))
-            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-
-        if ((txtDesc.flags & TextureFlags::TF_ColorAttachment))
-            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-
-        if (txtDesc.samples == 1 && !(txtDesc.flags & TextureFlags::TF_Sampled) && !(txtDesc.flags & TextureFlags::TF_SampleOutsideFragment))
-            resourceDesc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
-
         // if (txtDesc.usage == TextureUsage::DepthStencilTexture)
         // {
         //     resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
@@ -1697,14 +1766,25 @@ namespace LinaGX
 
         try
         {
-            ThrowIfFailed(m_dx12Allocator->CreateResource(&allocationDesc, &resourceDesc, state, clear, &item.allocation, IID_NULL, NULL));
-            NAME_DX12_OBJECT_CSTR(item.allocation->GetResource(), txtDesc.debugName);
+            if (aliasingBlock != nullptr)
+            {
+                ThrowIfFailed(m_dx12Allocator->CreateAliasingResource(aliasingBlock, aliasingOffset, &resourceDesc, state, clear, IID_PPV_ARGS(&item.rawRes)));
+                NAME_DX12_OBJECT_CSTR(item.rawRes.Get(), txtDesc.debugName);
+                item.isTransient = true;
+            }
+            else
+            {
+                ThrowIfFailed(m_dx12Allocator->CreateResource(&allocationDesc, &resourceDesc, state, clear, &item.allocation, IID_NULL, NULL));
+                NAME_DX12_OBJECT_CSTR(item.allocation->GetResource(), txtDesc.debugName);
+            }
         }
         catch (HrException e)
         {
             DX12_THROW(e, "Backend -> Exception when creating a texture resource! %s", e.what());
         }
 
+        ID3D12Resource* dxRes = item.rawRes.Get() != nullptr ? item.rawRes.Get() : item.allocation->GetResource();
+
         auto createSRV = [&](DXGI_FORMAT format, bool createForCubemap, uint32 baseArrayLayer, uint32 layerCount, uint32 baseMipLevel, uint32 mipLevels, const DescriptorHandle& targetDescriptor) {
             D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
             srvDesc.Shader4ComponentMapping         = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -1752,7 +1832,7 @@ namespace LinaGX
                 srvDesc.Texture3D.MostDetailedMip = baseMipLevel;
             }
 
-            m_device->CreateShaderResourceView(item.allocation->GetResource(), &srvDesc, {targetDescriptor.GetCPUHandle()});
+            m_device->CreateShaderResourceView(dxRes, &srvDesc, {targetDescriptor.GetCPUHandle()});
         };
 
         auto createRTV = [&](DXGI_FORMAT format, uint32 baseArrayLayer, uint32 layerCount, uint32 baseMipLevel, uint32 mipLevels, const DescriptorHandle& targetDescriptor) {
@@ -1789,7 +1869,7 @@ namespace LinaGX
                 rtvDesc.Texture3D.MipSlice = baseMipLevel;
             }
 
-            m_device->CreateRenderTargetView(item.allocation->GetResource(), &rtvDesc, {targetDescriptor.GetCPUHandle()});
+            m_device->CreateRenderTargetView(dxRes, &rtvDesc, {targetDescriptor.GetCPUHandle()});
         };
 
         auto createDSV = [&](DXGI_FORMAT format, uint32 baseArrayLayer, uint32 layerCount, uint32 baseMipLevel, uint32 mipLevels, const DescriptorHandle& targetDescriptor) {
@@ -1825,7 +1905,7 @@ namespace LinaGX
                 LOGA(false, "Can't create a depth Texture 3D!");
             }
 
-            m_device->CreateDepthStencilView(item.allocation->GetResource(), &depthStencilDesc, {targetDescriptor.GetCPUHandle()});
+            m_device->CreateDepthStencilView(dxRes, &depthStencilDesc, {targetDescriptor.GetCPUHandle()});
         };
 
         if ((txtDesc.flags & TextureFlags::TF_Sampled) || (txtDesc.flags & TextureFlags::TF_SampleOutsideFragment))
@@ -1890,7 +1970,29 @@ namespace LinaGX
             }
         }
 
-        return m_textures.AddItem(item);
+        m_textures.GetItemR(handle) = item;
+        return handle;
+    }
+
+    bool DX12Backend::ReserveTextureHandles(uint32 count, LINAGX_VEC<uint32>& outHandles)
+    {
+        outHandles.clear();
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            const uint32 handle = m_textures.AddItem({});
+            if (handle == m_textures.InvalidHandle)
+            {
+                for (auto reserved : outHandles)
+                    m_textures.RemoveItem(reserved);
+                outHandles.clear();
+                return false;
+            }
+
+            outHandles.push_back(handle);
+        }
+
+        return true;
     }
 
     void DX12Backend::DestroyTexture(uint32 handle)
@@ -1902,6 +2004,12 @@ namespace LinaGX
             return;
         }
 
+        if (txt.isTransient)
+        {
+            LOGE("Backend -> Texture is owned by a transient texture group, destroy the group instead!");
+            return;
+        }
+
         for (const auto& rtv : txt.rtvs)
             m_rtvHeap->FreeHeapHandle(rtv);
 
@@ -1928,6 +2036,10 @@ namespace LinaGX
 
     uint32 DX12Backend::CreateSampler(const SamplerDesc& desc)
     {
+        const uint32 handle = m_samplers.AddItem({});
+        if (handle == m_samplers.InvalidHandle)
+            return handle;
+
         DX12Sampler item = {};
         item.isValid     = true;
 
@@ -1947,7 +2059,8 @@ namespace LinaGX
 
         m_device->CreateSampler(&samplerDesc, {item.descriptor.GetCPUHandle()});
 
-        return m_samplers.AddItem(item);
+        m_samplers.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::DestroySampler(uint32 handle)
@@ -1965,6 +2078,10 @@ namespace LinaGX
 
     uint32 DX12Backend::CreateResource(const ResourceDesc& desc)
     {
+        const uint32 handle = m_resources.AddItem({});
+        if (handle == m_resources.InvalidHandle)
+            return handle;
+
         const uint64 alignedSize = ALIGN_SIZE_POW(desc.size, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
         uint64       finalSize   = desc.size;
 
@@ -2085,7 +2202,8 @@ namespace LinaGX
 
         NAME_DX12_OBJECT_CSTR(GetGPUResource(item), desc.debugName);
 
-        return m_resources.AddItem(item);
+        m_resources.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::MapResource(uint32 handle, uint8*& ptr)
@@ -2176,6 +2294,10 @@ namespace LinaGX
 
     uint16 DX12Backend::CreateDescriptorSet(const DescriptorSetDesc& desc)
     {
+        const uint16 handle = m_descriptorSets.AddItem({});
+        if (handle == m_descriptorSets.InvalidHandle)
+            return handle;
+
         LOGA(desc.allocationCount > 0, "Backend -> Descriptor set allocation count must be at least 1!");
 
         DX12DescriptorSet item  = {};
@@ -2210,7 +2332,8 @@ namespace LinaGX
             }
         }
 
-        return m_descriptorSets.AddItem(item);
+        m_descriptorSets.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::DestroyDescriptorSet(uint16 handle)
@@ -2590,7 +2713,10 @@ namespace LinaGX
     uint16 DX12Backend::CreateFence()
     {
         const uint16 handle = m_fences.AddItem(ComPtr<ID3D12Fence>());
-        auto&        fence  = m_fences.GetItemR(handle);
+        if (handle == m_fences.InvalidHandle)
+            return handle;
+
+        auto& fence = m_fences.GetItemR(handle);
 
         try
         {
@@ -2815,6 +2941,11 @@ namespace LinaGX
             LOGA(!txt.isValid, "Backend -> Some textures were not destroyed!");
         }
 
+        for (auto& group : m_transientGroups)
+        {
+            LOGA(!group.isValid, "Backend -> Some transient texture groups were not destroyed!");
+        }
+
         for (auto& str : m_cmdStreams)
         {
             LOGA(!str.isValid, "Backend -> Some command streams were not destroyed!");
@@ -2850,6 +2981,11 @@ namespace LinaGX
             LOGA(!l.isValid, "Backend -> Some pipeline layouts were not destroyed!");
         }
 
+        for (auto& qp : m_queryPools)
+        {
+            LOGA(!qp.isValid, "Backend -> Some query pools were not destroyed!");
+        }
+
         if (Config.enableAPIDebugLayers)
         {
             ID3D12InfoQueue1* infoQueue = nullptr;
@@ -2880,9 +3016,9 @@ namespace LinaGX
 
     void DX12Backend::Join()
     {
-        if (m_graphicsFencesDirty.load())
+        if (m_frameFencesDirty.load())
         {
-            IncreaseGraphicsFences();
+            IncreaseFrameFences();
         }
 
         for (uint32 i = 0; i < Config.framesInFlight; i++)
@@ -2890,7 +3026,7 @@ namespace LinaGX
             const auto& frame = m_perFrameData[i];
             for (auto& q : m_queues)
             {
-                if (!q.isValid || q.type != CommandType::Graphics)
+                if (!q.isValid)
                     continue;
 
                 WaitForFences(q.frameFences[i].Get(), q.storedFenceValues[i]);
@@ -2900,6 +3036,10 @@ namespace LinaGX
 
     uint32 DX12Backend::CreateCommandStream(const CommandStreamDesc& desc)
     {
+        const uint32 handle = m_cmdStreams.AddItem({});
+        if (handle == m_cmdStreams.InvalidHandle)
+            return handle;
+
         DX12CommandStream item = {};
         item.isValid           = true;
         item.type              = desc.type;
@@ -2922,7 +3062,8 @@ namespace LinaGX
             DX12_THROW(e, "Backend -> Exception when creating a command allocator! %s", e.what());
         }
 
-        return m_cmdStreams.AddItem(item);
+        m_cmdStreams.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::SetCommandStreamImpl(uint32 handle, CommandStream* stream)
@@ -2938,42 +3079,14 @@ namespace LinaGX
 
         for (auto& q : m_queues)
         {
-            if (!q.isValid || q.type != CommandType::Graphics)
+            if (!q.isValid)
                 continue;
 
             WaitForFences(q.frameFences[m_currentFrameIndex].Get(), q.storedFenceValues[m_currentFrameIndex]);
         }
 
-        const uint32 next = m_cmdStreams.GetNextFreeID();
-        for (uint32 i = 0; i < next; i++)
-        {
-            auto& cs = m_cmdStreams.GetItemR(i);
-
-            if (!cs.isValid)
-                continue;
-
-            for (auto it = cs.intermediateResources.begin(); it != cs.intermediateResources.end();)
-            {
-                if (PerformanceStats.totalFrames > it->second + Config.framesInFlight + 1)
-                {
-                    DestroyResource(it->first);
-                    it = cs.intermediateResources.erase(it);
-                }
-                else
-                    ++it;
-            }
-
-            for (auto it = cs.adjustedBuffers.begin(); it != cs.adjustedBuffers.end();)
-            {
-                if (PerformanceStats.totalFrames > it->second + Config.framesInFlight + 1)
-                {
-                    LINAGX_FREE(it->first);
-                    it = cs.adjustedBuffers.erase(it);
-                }
-                else
-                    ++it;
-            }
-        }
+        CompleteFrameTimeline(m_perFrameData[m_currentFrameIndex].storedFrameTimelineValue);
+        ResolveQueries(m_currentFrameIndex);
     }
 
     void DX12Backend::DestroyCommandStream(uint32 handle)
@@ -2985,81 +3098,73 @@ namespace LinaGX
             return;
         }
 
-        for (const auto& [id, frame] : stream.intermediateResources)
-            DestroyResource(id);
-
-        for (const auto& [buf, frame] : stream.adjustedBuffers)
-            LINAGX_FREE(buf);
-
         stream.isValid = false;
         stream.list.Reset();
         stream.allocator.Reset();
-        stream.intermediateResources.clear();
-        stream.adjustedBuffers.clear();
 
         m_cmdStreams.RemoveItem(handle);
     }
 
     void DX12Backend::CloseCommandStreams(CommandStream** streams, uint32 streamCount)
     {
-        for (uint32 i = 0; i < streamCount; i++)
-        {
-            auto  stream    = streams[i];
-            auto& sr        = m_cmdStreams.GetItemR(stream->m_gpuHandle);
-            auto  list      = sr.list;
-            auto  allocator = sr.allocator;
+        // Staging buffer creation adds to the shared resource list.
+        TranslateCommandStreams(streams, streamCount, 1ull << CMDID_CopyBufferToTexture2D, m_currentFrameIndex);
+    }
 
-            if (stream->m_commandCount == 0)
-                continue;
+    void DX12Backend::TranslateCommandStream(CommandStream* stream)
+    {
+        auto& sr        = m_cmdStreams.GetItemR(stream->m_gpuHandle);
+        auto  list      = sr.list;
+        auto  allocator = sr.allocator;
 
-            try
+        if (stream->m_commandCount == 0)
+            return;
+
+        try
+        {
+            ThrowIfFailed(allocator->Reset());
+            ThrowIfFailed(list->Reset(allocator.Get(), nullptr));
+            sr.boundShader        = 0;
+            sr.boundRootSignature = nullptr;
+            sr.boundDescriptorSets.clear();
+            sr.writtenQueries.clear();
+            if (sr.boundConstants.data != nullptr)
             {
-                ThrowIfFailed(allocator->Reset());
-                ThrowIfFailed(list->Reset(allocator.Get(), nullptr));
-                sr.boundShader        = 0;
-                sr.boundRootSignature = nullptr;
-                sr.boundDescriptorSets.clear();
-                if (sr.boundConstants.data != nullptr)
-                {
-                    if (!sr.boundConstants.usesStreamAlloc)
-                        LINAGX_FREE(sr.boundConstants.data);
-                }
+                if (!sr.boundConstants.usesStreamAlloc)
+                    FreeMemory(sr.boundConstants.data);
+            }
 
-                sr.boundConstants = {};
+            sr.boundConstants = {};
 
-                if (sr.type == CommandType::Graphics || sr.type == CommandType::Compute)
-                {
-                    ID3D12DescriptorHeap* heaps[] = {m_gpuHeapBuffer->GetHeap(), m_gpuHeapSampler->GetHeap()};
-                    list->SetDescriptorHeaps(_countof(heaps), heaps);
-                }
-            }
-            catch (HrException e)
+            if (sr.type == CommandType::Graphics || sr.type == CommandType::Compute)
             {
-                DX12_THROW(e, "Backend-> Exception when resetting a command list! %s", e.what());
+                ID3D12DescriptorHeap* heaps[] = {m_gpuHeapBuffer->GetHeap(), m_gpuHeapSampler->GetHeap()};
+                list->SetDescriptorHeaps(_countof(heaps), heaps);
             }
+        }
+        catch (HrException e)
+        {
+            DX12_THROW(e, "Backend-> Exception when resetting a command list! %s", e.what());
+        }
 
-            for (uint32 i = 0; i < stream->m_commandCount; i++)
-            {
-                uint8*        data = stream->m_commands[i];
-                LINAGX_TYPEID tid  = 0;
-                LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
-                LINAGX_STRING name = GetCMDDebugName(tid);
+        for (uint32 i = 0; i < stream->m_commandCount; i++)
+        {
+            uint8*        data = stream->m_commands[i];
+            LINAGX_TYPEID tid  = 0;
+            LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
 
-                const size_t increment = sizeof(LINAGX_TYPEID);
-                uint8*       cmd       = data + increment;
-                auto         it        = LINAGX_FIND_IF(m_cmdFunctions.begin(), m_cmdFunctions.end(), [tid](const LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>& pair) -> bool { return pair.first == tid; });
-                (this->*(it->second))(cmd, sr);
-                // TODO: tids -> consecutive into arr
-            }
+            const size_t increment = sizeof(CommandHeader);
+            uint8*       cmd       = data + increment;
+            (this->*m_cmdFunctions[tid])(cmd, sr);
+        }
 
-            try
-            {
-                ThrowIfFailed(list->Close());
-            }
-            catch (HrException e)
-            {
-                DX12_THROW(e, "Backend -> Exception when closing a command list! %s", e.what());
-            }
+        try
+        {
+            ThrowIfFailed(list->Close());
+        }
+        catch (HrException e)
+        {
+            DX12_THROW(e, "Backend -> Exception when closing a command list! %s", e.what());
         }
     }
 
@@ -3083,6 +3188,14 @@ namespace LinaGX
                 auto& str = m_cmdStreams.GetItemR(stream->m_gpuHandle);
                 LOGA(str.type != CommandType::Secondary, "Backend -> Can not submit command streams of type Secondary directly to the queues! Use CMDExecuteSecondary instead!");
                 _lists.push_back(str.list.Get());
+
+                // Streams are translated concurrently, query state is only touched once they are submitted.
+                if (!str.writtenQueries.empty())
+                {
+                    std::lock_guard<std::mutex> lock(m_queryWriteMtx);
+                    for (const auto& [handle, slot] : str.writtenQueries)
+                        m_queryPools.GetItemR(handle).written[slot] = 1;
+                }
             }
 
             if (desc.useWait)
@@ -3094,9 +3207,8 @@ namespace LinaGX
             ID3D12CommandList* const* data = _lists.data();
             queue.queue->ExecuteCommandLists(desc.streamCount, data);
 
-            // If "Join" is called without an EndFrame(), we need to make sure the graphics fence are bumped...
-            if (queue.type == CommandType::Graphics || !desc.standaloneSubmission)
-                m_graphicsFencesDirty.store(true);
+            // If "Join" is called without an EndFrame(), we need to make sure the frame fences are bumped...
+            m_frameFencesDirty.store(true);
 
             if (desc.useSignal)
             {
@@ -3115,6 +3227,10 @@ namespace LinaGX
 
     uint8 DX12Backend::CreateQueue(const QueueDesc& desc)
     {
+        const uint8 handle = m_queues.AddItem({});
+        if (handle == m_queues.InvalidHandle)
+            return handle;
+
         DX12Queue item;
         item.isValid = true;
         item.type    = desc.type;
@@ -3139,7 +3255,8 @@ namespace LinaGX
             DX12_THROW(e, "Backend-> Exception when creating a fence! {0}", e.what());
         }
 
-        return m_queues.AddItem(item);
+        m_queues.GetItemR(handle) = item;
+        return handle;
     }
 
     void DX12Backend::DestroyQueue(uint8 queue)
@@ -3168,6 +3285,241 @@ namespace LinaGX
         return it->second;
     }
 
+    bool DX12Backend::LoadPipelineCache(const uint8* data, size_t size)
+    {
+        return false;
+    }
+
+    bool DX12Backend::GetPipelineCacheData(LINAGX_VEC<uint8>& outData)
+    {
+        return false;
+    }
+
+    uint16 DX12Backend::CreateQueryPool(const QueryPoolDesc& desc)
+    {
+        const uint16 handle = m_queryPools.AddItem({});
+        if (handle == m_queryPools.InvalidHandle)
+            return handle;
+
+        DX12QueryPool item = {};
+        item.isValid       = true;
+        item.type          = desc.type;
+        item.queryType     = GetDXQueryType(desc.type);
+        item.queryCount    = desc.queryCount;
+        item.stride        = desc.type == QueryType::PipelineStatistics ? sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS) : sizeof(uint64);
+        item.written.resize(desc.queryCount * Config.framesInFlight, 0);
+        item.values.resize(desc.queryCount, 0);
+        item.statistics.resize(desc.type == QueryType::PipelineStatistics ? desc.queryCount : 0);
+        item.available.resize(desc.queryCount, 0);
+
+        D3D12_QUERY_HEAP_DESC heapDesc = {};
+        heapDesc.Type                  = GetDXQueryHeapType(desc.type);
+        heapDesc.Count                 = desc.queryCount * Config.framesInFlight;
+        heapDesc.NodeMask              = 0;
+
+        try
+        {
+            ThrowIfFailed(m_device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&item.heap)));
+            NAME_DX12_OBJECT_CSTR(item.heap, desc.debugName);
+
+            if (desc.type == QueryType::Timestamp)
+                ThrowIfFailed(m_queues.GetItemR(GetPrimaryQueue(CommandType::Graphics)).queue->GetTimestampFrequency(&item.frequency));
+        }
+        catch (HrException e)
+        {
+            DX12_THROW(e, "Backend -> Exception when creating a query pool! %s", e.what());
+        }
+
+        ResourceDesc readbackDesc  = {};
+        readbackDesc.size          = heapDesc.Count * item.stride;
+        readbackDesc.typeHintFlags = TH_ReadbackDest;
+        readbackDesc.heapType      = ResourceHeap::StagingHeap;
+        readbackDesc.debugName     = desc.debugName;
+        item.readback              = CreateResource(readbackDesc);
+        MapResource(item.readback, item.mapped);
+
+        m_queryPools.GetItemR(handle) = item;
+        return handle;
+    }
+
+    void DX12Backend::DestroyQueryPool(uint16 handle)
+    {
+        auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool to be destroyed is not valid!");
+            return;
+        }
+
+        DestroyResource(item.readback);
+        item.heap.Reset();
+        m_queryPools.RemoveItem(handle);
+    }
+
+    bool DX12Backend::GetQueryResults(uint16 handle, QueryResults& outResults)
+    {
+        const auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool is not valid!");
+            return false;
+        }
+
+        outResults.values     = item.values.data();
+        outResults.statistics = item.statistics.empty() ? nullptr : item.statistics.data();
+        outResults.available  = item.available.data();
+        outResults.queryCount = item.queryCount;
+        return true;
+    }
+
+    uint16 DX12Backend::CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo)
+    {
+        const uint16 handle = m_transientGroups.AddItem({});
+        if (handle == m_transientGroups.InvalidHandle)
+            return handle;
+
+        DX12TransientTextureGroup group = {};
+        group.isValid                   = true;
+        outInfo                         = {};
+
+        const uint32                    count = static_cast<uint32>(desc.textures.size());
+        LINAGX_VEC<TransientAllocation> allocations(count);
+        LINAGX_VEC<TransientBlock>      blocks;
+
+        // Render targets & depth buffers can't share a heap with other textures on resource heap tier 1.
+        for (uint32 i = 0; i < count; i++)
+        {
+            const auto& txt          = desc.textures[i];
+            const auto  resourceDesc = GetTextureResourceDesc(txt.desc);
+            const auto  info         = m_device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+            auto& alloc     = allocations[i];
+            alloc.size      = info.SizeInBytes;
+            alloc.alignment = info.Alignment;
+            alloc.key       = (resourceDesc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) ? 0 : 1;
+            alloc.firstUse  = txt.firstUse;
+            alloc.lastUse   = txt.lastUse;
+
+            outInfo.requiredSize += info.SizeInBytes;
+        }
+
+        PackTransientAllocations(allocations, blocks);
+
+        for (const auto& block : blocks)
+        {
+            D3D12MA::ALLOCATION_DESC allocationDesc = {};
+            allocationDesc.HeapType                 = D3D12_HEAP_TYPE_DEFAULT;
+            allocationDesc.ExtraHeapFlags           = block.key == 0 ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+            D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = {};
+            allocationInfo.SizeInBytes                    = block.size;
+            allocationInfo.Alignment                      = block.alignment;
+
+            D3D12MA::Allocation* allocation = nullptr;
+
+            try
+            {
+                ThrowIfFailed(m_dx12Allocator->AllocateMemory(&allocationDesc, &allocationInfo, &allocation));
+            }
+            catch (HrException e)
+            {
+                DX12_THROW(e, "Backend -> Exception when allocating transient texture memory! %s", e.what());
+            }
+
+            group.blocks.push_back(allocation);
+            outInfo.allocatedSize += block.size;
+        }
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            const auto&  alloc     = allocations[i];
+            const uint32 txtHandle = CreateTexture(desc.textures[i].desc, group.blocks[alloc.block], alloc.offset);
+
+            // Out of texture handles, unwind whatever has been placed so far.
+            if (txtHandle == m_textures.InvalidHandle)
+            {
+                m_transientGroups.GetItemR(handle) = group;
+                DestroyTransientTextureGroup(handle);
+                return m_transientGroups.InvalidHandle;
+            }
+
+            group.textures.push_back(txtHandle);
+        }
+
+        LOGT("Backend -> Transient texture group %s placed %llu bytes of textures into %llu bytes.", desc.debugName, static_cast<unsigned long long>(outInfo.requiredSize), static_cast<unsigned long long>(outInfo.allocatedSize));
+
+        outInfo.textures = group.textures;
+        m_transientGroups.GetItemR(handle) = group;
+        return handle;
+    }
+
+    void DX12Backend::DestroyTransientTextureGroup(uint16 handle)
+    {
+        auto& group = m_transientGroups.GetItemR(handle);
+        if (!group.isValid)
+        {
+            LOGE("Backend -> Transient texture group to be destroyed is not valid!");
+            return;
+        }
+
+        for (auto txtHandle : group.textures)
+        {
+            auto& txt       = m_textures.GetItemR(txtHandle);
+            txt.isTransient = false;
+            txt.rawRes.Reset();
+            DestroyTexture(txtHandle);
+        }
+
+        for (auto* block : group.blocks)
+            block->Release();
+
+        group.isValid = false;
+        m_transientGroups.RemoveItem(handle);
+    }
+
+    void DX12Backend::ResolveQueries(uint32 frameIndex)
+    {
+        for (auto& qp : m_queryPools)
+        {
+            if (!qp.isValid)
+                continue;
+
+            const uint32 first   = frameIndex * qp.queryCount;
+            const double toNanos = qp.frequency == 0 ? 0.0 : 1000000000.0 / static_cast<double>(qp.frequency);
+            uint8*       written = qp.written.data() + first;
+
+            for (uint32 i = 0; i < qp.queryCount; i++)
+            {
+                const uint8* result = qp.mapped + (first + i) * qp.stride;
+                qp.available[i]     = written[i];
+                written[i]          = 0;
+
+                if (qp.type == QueryType::PipelineStatistics)
+                {
+                    PipelineStatistics stats = {};
+
+                    if (qp.available[i])
+                    {
+                        const D3D12_QUERY_DATA_PIPELINE_STATISTICS* data = reinterpret_cast<const D3D12_QUERY_DATA_PIPELINE_STATISTICS*>(result);
+                        stats.inputVertices                              = data->IAVertices;
+                        stats.inputPrimitives                            = data->IAPrimitives;
+                        stats.vertexShaderInvocations                    = data->VSInvocations;
+                        stats.clippingInvocations                        = data->CInvocations;
+                        stats.clippingPrimitives                         = data->CPrimitives;
+                        stats.fragmentShaderInvocations                  = data->PSInvocations;
+                        stats.computeShaderInvocations                   = data->CSInvocations;
+                    }
+
+                    qp.statistics[i] = stats;
+                    continue;
+                }
+
+                const uint64 value = qp.available[i] ? *reinterpret_cast<const uint64*>(result) : 0;
+                qp.values[i]       = qp.type == QueryType::Timestamp ? static_cast<uint64>(static_cast<double>(value) * toNanos) : value;
+            }
+        }
+    }
+
     void DX12Backend::Present(const PresentDesc& present)
     {
         for (uint32 i = 0; i < present.swapchainCount; i++)
@@ -3227,7 +3579,7 @@ namespace LinaGX
     void DX12Backend::EndFrame()
     {
         LOGA((m_submissionPerFrame < Config.gpuLimits.maxSubmitsPerFrame), "Backend -> Exceeded maximum submissions per frame! Please increase the limit.");
-        IncreaseGraphicsFences();
+        IncreaseFrameFences();
     }
 
     void DX12Backend::CMD_BeginRenderPass(uint8* data, DX12CommandStream& stream)
@@ -3247,6 +3599,7 @@ namespace LinaGX
 
             if (att.isSwapchain)
             {
+                LOGA(!stream.streamImpl->m_isPersistent, "Backend -> Persistent command streams can't reference swapchains, the image changes every frame!");
                 const auto&  swp    = m_swapchains.GetItemR(static_cast<uint8>(att.texture));
                 const uint32 handle = swp.colorTextures[swp._imageIndex];
                 const auto&  txt    = m_textures.GetItemR(handle);
@@ -3553,12 +3906,12 @@ namespace LinaGX
         stream.list->SetGraphicsRoot32BitConstants(param->rootParameter, stream.boundConstants.size / sizeof(uint32), stream.boundConstants.data, stream.boundConstants.offset / sizeof(uint32));
     }
 
-    void DX12Backend::IncreaseGraphicsFences()
+    void DX12Backend::IncreaseFrameFences()
     {
-        // Increase & signal, we'll wait for this value next time we are starting this frame index.
+        // Increase & signal on every queue, we'll wait for this value next time we are starting this frame index.
         for (auto& q : m_queues)
         {
-            if (!q.isValid || q.type != CommandType::Graphics)
+            if (!q.isValid)
                 continue;
 
             q.frameFenceValue++;
@@ -3566,7 +3919,9 @@ namespace LinaGX
             q.queue->Signal(q.frameFences[m_currentFrameIndex].Get(), q.frameFenceValue);
         }
 
-        m_graphicsFencesDirty.store(false);
+        m_perFrameData[m_currentFrameIndex].storedFrameTimelineValue = SignalFrameTimeline();
+
+        m_frameFencesDirty.store(false);
     }
 
     void DX12Backend::CMD_BindPipeline(uint8* data, DX12CommandStream& stream)
@@ -3697,7 +4052,7 @@ namespace LinaGX
         stagingDesc.typeHintFlags = TH_None;
         stagingDesc.heapType      = ResourceHeap::StagingHeap;
         uint32 stagingHandle      = CreateResource(stagingDesc);
-        stream.intermediateResources.push_back({stagingHandle, PerformanceStats.totalFrames});
+        DeferDestruction(DeferredObjectType::Resource, stagingHandle);
 
         LINAGX_VEC<D3D12_SUBRESOURCE_DATA> allData;
 
@@ -3713,12 +4068,15 @@ namespace LinaGX
         {
             const auto& buffer       = cmd->buffers[i];
             void*       adjustedData = AdjustBufferPitch(buffer.pixels, buffer.width, buffer.height, buffer.bytesPerPixel, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
-            stream.adjustedBuffers.push_back({adjustedData, PerformanceStats.totalFrames});
             calcTd(adjustedData, buffer.width, buffer.height, buffer.bytesPerPixel);
         }
 
+        // UpdateSubresources() copies into the mapped staging resource right away, the GPU only reads the staging resource.
         const auto& srcRes = m_resources.GetItemR(stagingHandle);
         UpdateSubresources(stream.list.Get(), dstTexture.allocation->GetResource(), GetGPUResource(srcRes), 0, static_cast<uint32>(allData.size()) * cmd->destinationSlice, static_cast<uint32>(allData.size()), allData.data());
+
+        for (const auto& td : allData)
+            FreeMemory(const_cast<void*>(td.pData));
     }
 
     void DX12Backend::CMD_CopyTexture2DToBuffer(uint8* data, DX12CommandStream& stream)
@@ -3819,7 +4177,7 @@ namespace LinaGX
         if (stream.boundConstants.data != nullptr)
         {
             if (!stream.boundConstants.usesStreamAlloc)
-                LINAGX_FREE(stream.boundConstants.data);
+                FreeMemory(stream.boundConstants.data);
         }
 
         // If fits to alloc.
@@ -3830,7 +4188,7 @@ namespace LinaGX
         }
         else
         {
-            stream.boundConstants.data            = (uint8*)LINAGX_MALLOC(cmd->size);
+            stream.boundConstants.data            = static_cast<uint8*>(AllocateMemory(cmd->size, AllocationTag::Commands));
             stream.boundConstants.usesStreamAlloc = false;
         }
 
@@ -3863,6 +4221,7 @@ namespace LinaGX
         CMDBarrier* cmd = reinterpret_cast<CMDBarrier*>(data);
 
         LINAGX_VEC<CD3DX12_RESOURCE_BARRIER> barriers;
+        LINAGX_VEC<ID3D12Resource*>          discards;
         barriers.reserve(cmd->textureBarrierCount + cmd->resourceBarrierCount);
 
         for (uint32 i = 0; i < cmd->textureBarrierCount; i++)
@@ -3873,24 +4232,75 @@ namespace LinaGX
 
             if (barrier.isSwapchain)
             {
+                LOGA(!stream.streamImpl->m_isPersistent, "Backend -> Persistent command streams can't reference swapchains, the image changes every frame!");
                 auto& swp = m_swapchains.GetItemR(static_cast<uint8>(barrier.texture));
                 txtIndex  = swp.colorTextures[swp._imageIndex];
             }
 
             auto& txt      = m_textures.GetItemR(txtIndex);
             auto  newState = GetDXTextureBarrierState(barrier.toState, txt.desc.flags);
+            auto  dxRes    = txt.rawRes.Get() != nullptr ? txt.rawRes.Get() : txt.allocation->GetResource();
 
             // Will decay to common & promoted on first usage.
             if (stream.type == CommandType::Transfer && newState != D3D12_RESOURCE_STATE_COPY_DEST && newState != D3D12_RESOURCE_STATE_COPY_SOURCE)
                 continue;
 
-            if (newState == txt.state)
+            // Another placed texture might have used the memory, activate this one. Render targets & depth buffers need to be initialized after activation.
+            if (barrier.discardContents && txt.isTransient)
+            {
+                barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, dxRes));
+
+                if (newState == D3D12_RESOURCE_STATE_RENDER_TARGET || newState == D3D12_RESOURCE_STATE_DEPTH_WRITE)
+                    discards.push_back(dxRes);
+            }
+
+            const uint32 mipLevels  = txt.desc.mipLevels;
+            const uint32 arrayCount = txt.desc.arrayLength;
+            const uint32 baseMip    = barrier.isSwapchain ? 0 : barrier.baseMip;
+            const uint32 baseLayer  = barrier.isSwapchain ? 0 : barrier.baseLayer;
+            const uint32 mipCount   = barrier.isSwapchain || barrier.mipCount == 0 ? mipLevels - baseMip : barrier.mipCount;
+            const uint32 layerCount = barrier.isSwapchain || barrier.layerCount == 0 ? arrayCount - baseLayer : barrier.layerCount;
+            LOGA(baseMip + mipCount <= mipLevels && baseLayer + layerCount <= arrayCount, "Backend -> Texture barrier subresource range is out of bounds!");
+
+            if (mipCount == mipLevels && layerCount == arrayCount && txt.subresourceStates.empty())
+            {
+                if (newState == txt.state)
+                    continue;
+
+                auto dxBar = CD3DX12_RESOURCE_BARRIER::Transition(dxRes, txt.state, newState);
+                txt.state  = newState;
+                barriers.push_back(dxBar);
                 continue;
+            }
 
-            auto dxRes = txt.rawRes.Get() != nullptr ? txt.rawRes.Get() : txt.allocation->GetResource();
-            auto dxBar = CD3DX12_RESOURCE_BARRIER::Transition(dxRes, txt.state, newState);
-            txt.state  = newState;
-            barriers.push_back(dxBar);
+            // Track per subresource until they are all in the same state again.
+            if (txt.subresourceStates.empty())
+                txt.subresourceStates.assign(mipLevels * arrayCount, txt.state);
+
+            // Depth-stencil formats have a separate stencil plane.
+            const uint32 planeCount = (txt.desc.flags & TextureFlags::TF_DepthTexture) && (txt.desc.flags & TextureFlags::TF_StencilTexture) ? 2 : 1;
+
+            for (uint32 layer = baseLayer; layer < baseLayer + layerCount; layer++)
+            {
+                for (uint32 mip = baseMip; mip < baseMip + mipCount; mip++)
+                {
+                    auto& state = txt.subresourceStates[layer * mipLevels + mip];
+                    if (state == newState)
+                        continue;
+
+                    for (uint32 plane = 0; plane < planeCount; plane++)
+                        barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(dxRes, state, newState, D3D12CalcSubresource(mip, layer, plane, mipLevels, arrayCount)));
+
+                    state = newState;
+                }
+            }
+
+            const auto first = txt.subresourceStates[0];
+            if (std::all_of(txt.subresourceStates.begin(), txt.subresourceStates.end(), [first](D3D12_RESOURCE_STATES st) { return st == first; }))
+            {
+                txt.state = first;
+                txt.subresourceStates.clear();
+            }
         }
 
         for (uint32 i = 0; i < cmd->resourceBarrierCount; i++)
@@ -3914,6 +4324,9 @@ namespace LinaGX
 
         if (!barriers.empty())
             stream.list->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+        for (auto* res : discards)
+            stream.list->DiscardResource(res, nullptr);
     }
 
     void DX12Backend::CMD_Debug(uint8* data, DX12CommandStream& stream)
@@ -3932,6 +4345,62 @@ namespace LinaGX
         PIXEndEvent();
     }
 
+    void DX12Backend::CMD_WriteTimestamp(uint8* data, DX12CommandStream& stream)
+    {
+        CMDWriteTimestamp* cmd  = reinterpret_cast<CMDWriteTimestamp*>(data);
+        const auto&        pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.type == QueryType::Timestamp, "Backend -> Writing a timestamp into a query pool of a different type!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Timestamp query index is out of bounds!");
+        LOGA(stream.type == CommandType::Graphics || stream.type == CommandType::Secondary, "Backend -> Timestamps can only be written from graphics or secondary streams!");
+
+        const uint32 slot = m_currentFrameIndex * pool.queryCount + cmd->queryIndex;
+        stream.list->EndQuery(pool.heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, slot);
+        stream.list->ResolveQueryData(pool.heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, slot, 1, GetGPUResource(m_resources.GetItemR(pool.readback)), slot * pool.stride);
+        stream.writtenQueries.push_back({cmd->queryPool, slot});
+    }
+
+    void DX12Backend::CMD_BeginQuery(uint8* data, DX12CommandStream& stream)
+    {
+        CMDBeginQuery* cmd  = reinterpret_cast<CMDBeginQuery*>(data);
+        const auto&    pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.type != QueryType::Timestamp, "Backend -> Timestamp queries are written with CMDWriteTimestamp!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Query index is out of bounds!");
+        stream.list->BeginQuery(pool.heap.Get(), pool.queryType, m_currentFrameIndex * pool.queryCount + cmd->queryIndex);
+    }
+
+    void DX12Backend::CMD_EndQuery(uint8* data, DX12CommandStream& stream)
+    {
+        CMDEndQuery* cmd  = reinterpret_cast<CMDEndQuery*>(data);
+        const auto&  pool = m_queryPools.GetItemR(cmd->queryPool);
+
+        // Every ended query is also resolved into the readback buffer for GetQueryResults().
+        const uint32 slot = m_currentFrameIndex * pool.queryCount + cmd->queryIndex;
+        stream.list->EndQuery(pool.heap.Get(), pool.queryType, slot);
+        stream.list->ResolveQueryData(pool.heap.Get(), pool.queryType, slot, 1, GetGPUResource(m_resources.GetItemR(pool.readback)), slot * pool.stride);
+        stream.writtenQueries.push_back({cmd->queryPool, slot});
+    }
+
+    void DX12Backend::CMD_ResolveQueries(uint8* data, DX12CommandStream& stream)
+    {
+        CMDResolveQueries* cmd  = reinterpret_cast<CMDResolveQueries*>(data);
+        const auto&        pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(cmd->firstQuery + cmd->queryCount <= pool.queryCount, "Backend -> Resolved query range is out of bounds!");
+        stream.list->ResolveQueryData(pool.heap.Get(), pool.queryType, m_currentFrameIndex * pool.queryCount + cmd->firstQuery, cmd->queryCount, GetGPUResource(m_resources.GetItemR(cmd->destination)), cmd->destinationOffset);
+    }
+
+    void DX12Backend::CMD_BeginConditionalRendering(uint8* data, DX12CommandStream& stream)
+    {
+        CMDBeginConditionalRendering* cmd = reinterpret_cast<CMDBeginConditionalRendering*>(data);
+
+        // Predication skips the commands when the condition holds, so regular conditional rendering predicates on zero.
+        stream.list->SetPredication(GetGPUResource(m_resources.GetItemR(cmd->resource)), cmd->offset, cmd->inverted ? D3D12_PREDICATION_OP_NOT_EQUAL_ZERO : D3D12_PREDICATION_OP_EQUAL_ZERO);
+    }
+
+    void DX12Backend::CMD_EndConditionalRendering(uint8* data, DX12CommandStream& stream)
+    {
+        stream.list->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+    }
+
 } // namespace LinaGX
 
 LINAGX_RESTORE_VC_WARNING()
@@ -74,7 +74,8 @@ namespace LinaGX
 
     DescriptorHandle DX12HeapStaging::GetNewHeapHandle()
     {
-        uint32 newHandleID = 0;
+        std::lock_guard<std::mutex> lock(m_mtx);
+        uint32                      newHandleID = 0;
 
         if (m_currentDescriptorIndex < m_maxDescriptors)
         {
@@ -102,6 +103,7 @@ namespace LinaGX
 
     void DX12HeapStaging::FreeHeapHandle(DescriptorHandle handle)
     {
+        std::lock_guard<std::mutex> lock(m_mtx);
         m_freeDescriptors.push_front(handle.GetHeapIndex());
 
         if (m_activeHandleCount == 0)
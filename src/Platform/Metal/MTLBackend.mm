@@ -653,6 +653,10 @@ MTLStoreAction GetMTLStoreOp(StoreOp op)
 }
 
 uint16 MTLBackend::CreateUserSemaphore() {
+    const uint16 handle = m_userSemaphores.AddItem({});
+    if (handle == m_userSemaphores.InvalidHandle)
+        return handle;
+
     MTLUserSemaphore item = {};
     item.isValid = true;
     
@@ -662,7 +666,8 @@ uint16 MTLBackend::CreateUserSemaphore() {
     item.semaphore = AS_VOID(ev);
     
     
-    return m_userSemaphores.AddItem(item);
+    m_userSemaphores.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyUserSemaphore(uint16 handle) {
@@ -694,6 +699,10 @@ void MTLBackend::WaitForUserSemaphore(uint16 handle, uint64 value)
 }
 
 uint8 MTLBackend::CreateSwapchain(const SwapchainDesc &desc) {
+    const uint8 handle = m_swapchains.AddItem({});
+    if (handle == m_swapchains.InvalidHandle)
+        return handle;
+
     MTLSwapchain item = {};
     item.isValid = true;
     
@@ -723,7 +732,8 @@ uint8 MTLBackend::CreateSwapchain(const SwapchainDesc &desc) {
     // TODO: vsync.
 
    
-    return m_swapchains.AddItem(item);
+    m_swapchains.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroySwapchain(uint8 handle) {
@@ -772,6 +782,10 @@ bool MTLBackend::CompileShader(ShaderStage stage, const std::string &source, Dat
 }
 
 uint16 MTLBackend::CreateShader(const ShaderDesc &shaderDesc) {
+    const uint16 handle = m_shaders.AddItem({});
+    if (handle == m_shaders.InvalidHandle)
+        return handle;
+
     MTLShader item = {};
     item.isValid = true;
     item.polygonMode = shaderDesc.polygonMode;
@@ -829,7 +843,8 @@ uint16 MTLBackend::CreateShader(const ShaderDesc &shaderDesc) {
         [computeFunc release];
         [src release];
         [computeDesc release];
-        return m_shaders.AddItem(item);
+        m_shaders.GetItemR(handle) = item;
+        return handle;
 
     }
     
@@ -1004,7 +1019,8 @@ uint16 MTLBackend::CreateShader(const ShaderDesc &shaderDesc) {
     [backStencil release];
     [depthStencilDescriptor release];
     
-    return m_shaders.AddItem(item);
+    m_shaders.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyShader(uint16 handle) {
@@ -1036,6 +1052,10 @@ void MTLBackend::DestroyShader(uint16 handle) {
 }
 
 uint32 MTLBackend::CreateTexture(const TextureDesc &desc) {
+    const uint32 handle = m_textures.AddItem({});
+    if (handle == m_textures.InvalidHandle)
+        return handle;
+
     
     if (desc.type == TextureType::Texture3D && desc.arrayLength != 1)
     {
@@ -1103,7 +1123,8 @@ uint32 MTLBackend::CreateTexture(const TextureDesc &desc) {
     item.ptr = AS_VOID(texture);
     NAME_OBJ_CSTR(texture, desc.debugName);
 
-    return m_textures.AddItem(item);
+    m_textures.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyTexture(uint32 handle) {
@@ -1113,6 +1134,12 @@ void MTLBackend::DestroyTexture(uint32 handle) {
         LOGE("Backend -> Texture to be destroyed is not valid!");
         return;
     }
+
+    if (txt.isTransient)
+    {
+        LOGE("Backend -> Texture is owned by a transient texture group, destroy the group instead!");
+        return;
+    }
     
     for(const auto& view : txt.views)
     {
@@ -1128,6 +1155,10 @@ void MTLBackend::DestroyTexture(uint32 handle) {
 }
 
 uint32 MTLBackend::CreateSampler(const SamplerDesc &desc) {
+    const uint32 handle = m_samplers.AddItem({});
+    if (handle == m_samplers.InvalidHandle)
+        return handle;
+
     MTLSampler item ={};
     item.isValid = true;
     
@@ -1154,7 +1185,8 @@ uint32 MTLBackend::CreateSampler(const SamplerDesc &desc) {
 
     [samplerDesc release];
     
-    return m_samplers.AddItem(item);
+    m_samplers.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroySampler(uint32 handle) {
@@ -1172,6 +1204,10 @@ void MTLBackend::DestroySampler(uint32 handle) {
 }
 
 uint32 MTLBackend::CreateResource(const ResourceDesc &desc) {
+    const uint32 handle = m_resources.AddItem({});
+    if (handle == m_resources.InvalidHandle)
+        return handle;
+
     MTLResource item = {};
     item.isValid = true;
     item.heapType = desc.heapType;
@@ -1203,7 +1239,8 @@ uint32 MTLBackend::CreateResource(const ResourceDesc &desc) {
     item.debugName = desc.debugName;
     NAME_OBJ_CSTR(buffer, desc.debugName);
 
-    return m_resources.AddItem(item);
+    m_resources.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::MapResource(uint32 handle, uint8 *&ptr) {
@@ -1238,6 +1275,10 @@ void MTLBackend::DestroyResource(uint32 handle) {
 }
 
 uint16 MTLBackend::CreateDescriptorSet(const DescriptorSetDesc &desc) {
+    const uint16 handle = m_descriptorSets.AddItem({});
+    if (handle == m_descriptorSets.InvalidHandle)
+        return handle;
+
     
     LOGA(desc.allocationCount > 0, "Backend -> Descriptor set allocation count must be at least 1!");
     
@@ -1302,7 +1343,8 @@ uint16 MTLBackend::CreateDescriptorSet(const DescriptorSetDesc &desc) {
     }
    
     
-    return m_descriptorSets.AddItem(item);
+    m_descriptorSets.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyDescriptorSet(uint16 handle) {
@@ -1499,10 +1541,15 @@ void MTLBackend::DescriptorUpdateImage(const DescriptorUpdateImageDesc &desc) {
 }
 
 uint16 MTLBackend::CreatePipelineLayout(const LinaGX::PipelineLayoutDesc &desc) {
+    const uint16 handle = m_pipelineLayouts.AddItem({});
+    if (handle == m_pipelineLayouts.InvalidHandle)
+        return handle;
+
     MTLPipelineLayout item = {};
     item.isValid = true;
     
-    return m_pipelineLayouts.AddItem(item);
+    m_pipelineLayouts.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyPipelineLayout(uint16 handle)
@@ -1519,10 +1566,15 @@ void MTLBackend::DestroyPipelineLayout(uint16 handle)
 
 
 uint32 MTLBackend::CreateCommandStream(const CommandStreamDesc& desc) {
+    const uint32 handle = m_cmdStreams.AddItem({});
+    if (handle == m_cmdStreams.InvalidHandle)
+        return handle;
+
     MTLCommandStream item = {};
     item.isValid = true;
     item.type = desc.type;
-    return m_cmdStreams.AddItem(item);
+    m_cmdStreams.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyCommandStream(uint32 handle) {
@@ -1533,9 +1585,6 @@ void MTLBackend::DestroyCommandStream(uint32 handle) {
         return;
     }
     
-    for (const auto [id, frame] : stream.intermediateResources)
-        DestroyResource(id);
-    
     if(stream.indirectCommandBuffer != nullptr)
     {
         id<MTLIndirectCommandBuffer> buf = AS_MTL(stream.indirectCommandBuffer, id<MTLIndirectCommandBuffer>);
@@ -1543,7 +1592,6 @@ void MTLBackend::DestroyCommandStream(uint32 handle) {
         stream.indirectCommandBuffer = nullptr;
     }
     
-    stream.intermediateResources.clear();
 
     for(auto ptr : stream.allBlitEncoders)
     {
@@ -1611,8 +1659,8 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
         {
             if(!sr.boundConstants.usesStreamAlloc)
             {
-                LINAGX_FREE(sr.boundConstants.data);
-                LINAGX_FREE(sr.boundConstants.stages);
+                FreeMemory(sr.boundConstants.data);
+                FreeMemory(sr.boundConstants.stages);
             }
         }
         
@@ -1623,12 +1671,12 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
              uint8*        data = stream->m_commands[i];
              LINAGX_TYPEID tid  = 0;
              LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
-             const size_t increment = sizeof(LINAGX_TYPEID);
+             const size_t increment = sizeof(CommandHeader);
              uint8*       cmd       = data + increment;
 
        
              // Starting blit ops but no blit encoder.
-             if(tid == LGX_GetTypeID<CMDCopyResource>() || tid == LGX_GetTypeID<CMDCopyBufferToTexture2D>() || tid == LGX_GetTypeID<CMDCopyTexture>() || tid == LGX_GetTypeID<CMDCopyTexture2DToBuffer>())
+             if(tid == CMDCopyResource::TypeID || tid == CMDCopyBufferToTexture2D::TypeID || tid == CMDCopyTexture::TypeID || tid == CMDCopyTexture2DToBuffer::TypeID)
              {
                  if(sr.currentBlitEncoder == nullptr)
                  {
@@ -1638,7 +1686,7 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
                      sr.allBlitEncoders.push_back(sr.currentBlitEncoder);
                  }
              }
-             else if(tid == LGX_GetTypeID<CMDBindPipeline>())
+             else if(tid == CMDBindPipeline::TypeID)
              {
                  // Binding pipeline, if blit encoder end it.
                  // If compute encoder, end if it binding non-compute pipeline.
@@ -1662,7 +1710,7 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
                      sr.allComputeEncoders.push_back(sr.currentComputeEncoder);
                  }
              }
-             else if(tid == LGX_GetTypeID<CMDBindDescriptorSets>() || tid == LGX_GetTypeID<CMDBindConstants>())
+             else if(tid == CMDBindDescriptorSets::TypeID || tid == CMDBindConstants::TypeID)
              {
                  // computer encoder exists, binding resources on non-compute shader(shouldn't be possible tbh)
                  // end blit if exists & compute.
@@ -1673,7 +1721,7 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
                  if(sr.currentComputeEncoder && !sr.currentShaderIsCompute)
                      endCurrentComputeEncoder();
              }
-             else if(tid == LGX_GetTypeID<CMDDispatch>())
+             else if(tid == CMDDispatch::TypeID)
              {
                  if(sr.currentComputeEncoder == nullptr)
                  {
@@ -1693,26 +1741,24 @@ void MTLBackend::CloseCommandStreams(CommandStream **streams, uint32 streamCount
              }
              
              // Include as a part of this one.
-             if(tid == LGX_GetTypeID<CMDExecuteSecondaryStream>())
+             if(tid == CMDExecuteSecondaryStream::TypeID)
              {
                  CMDExecuteSecondaryStream* exec = reinterpret_cast<CMDExecuteSecondaryStream*>(cmd);
                  auto* secondaryStream = exec->secondaryStream;
                  
                  for(uint32 j = 0; j < secondaryStream->m_commandCount; j++)
                  {
-                     uint8*        dataSecondary = secondaryStream->m_commands[i];
+                     uint8*        dataSecondary = secondaryStream->m_commands[j];
                      LINAGX_TYPEID secondaryTid  = 0;
                      LINAGX_MEMCPY(&secondaryTid, dataSecondary, sizeof(LINAGX_TYPEID));
-                     const size_t incrementSecondary = sizeof(LINAGX_TYPEID);
+                     const size_t incrementSecondary = sizeof(CommandHeader);
                      uint8*       cmdSecondary       = dataSecondary + incrementSecondary;
 
-                        auto         it        = LINAGX_FIND_IF(m_cmdFunctions.begin(), m_cmdFunctions.end(), [tid](const LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>& pair) -> bool { return pair.first == tid; });
-                      (this->*(it->second))(cmdSecondary, sr);
+                      (this->*m_cmdFunctions[secondaryTid])(cmdSecondary, sr);
                  }
              }
              
-                auto         it        = LINAGX_FIND_IF(m_cmdFunctions.begin(), m_cmdFunctions.end(), [tid](const LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>& pair) -> bool { return pair.first == tid; });
-                (this->*(it->second))(cmd, sr);
+                (this->*m_cmdFunctions[tid])(cmd, sr);
          }
         
         if(sr.currentBlitEncoder)
@@ -1742,10 +1788,12 @@ void MTLBackend::SubmitCommandStreams(const SubmitDesc &desc) {
             }
         }
         
-        const auto& queue = m_queues.GetItemR(desc.targetQueue);
-        
-        if(queue.type == CommandType::Graphics && !desc.standaloneSubmission)
+        // Every queue counts, StartFrame() waits for all of them before objects used in this frame index are retired.
+        if(!desc.standaloneSubmission)
+        {
             pfd.submits++;
+            pfd.storedFrameTimelineValue = SignalFrameTimeline();
+        }
         
         if(Config.multithreadedQueueSubmission && !desc.standaloneSubmission)
             m_submissionFlag.clear();
@@ -1773,7 +1821,7 @@ void MTLBackend::SubmitCommandStreams(const SubmitDesc &desc) {
                 }
             }
             
-            if(queue.type == CommandType::Graphics && !desc.standaloneSubmission)
+            if(!desc.standaloneSubmission)
             {
                 [buffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
                      while (m_submissionFlag.test_and_set(std::memory_order_acquire))
@@ -1845,6 +1893,10 @@ void MTLBackend::SubmitCommandStreams(const SubmitDesc &desc) {
 }
 
 uint8 MTLBackend::CreateQueue(const QueueDesc &desc) {
+    const uint8 handle = m_queues.AddItem({});
+    if (handle == m_queues.InvalidHandle)
+        return handle;
+
     MTLQueue item = {};
     item.isValid = true;
     item.type = desc.type;
@@ -1862,7 +1914,8 @@ uint8 MTLBackend::CreateQueue(const QueueDesc &desc) {
         item.queue = m_queues.GetItemR(0).queue;
     }
     
-    return m_queues.AddItem(item);
+    m_queues.GetItemR(handle) = item;
+    return handle;
 }
 
 void MTLBackend::DestroyQueue(uint8 queue) {
@@ -1887,6 +1940,107 @@ uint8 MTLBackend::GetPrimaryQueue(CommandType type) {
     return m_primaryQueues[static_cast<uint32>(type)];
 }
 
+bool MTLBackend::LoadPipelineCache(const uint8* data, size_t size) {
+    return false;
+}
+
+bool MTLBackend::GetPipelineCacheData(LINAGX_VEC<uint8>& outData) {
+    return false;
+}
+
+uint16 MTLBackend::CreateQueryPool(const QueryPoolDesc& desc) {
+    const uint16 handle = m_queryPools.AddItem({});
+    if (handle == m_queryPools.InvalidHandle)
+        return handle;
+
+    // Counter sample buffers are only available between encoder stages on most Apple GPUs, which doesn't map to a query per command yet.
+    LOGE("Backend -> Queries are not supported on Metal, queries will never be available!");
+    
+    MTLQueryPool item = {};
+    item.isValid = true;
+    item.queryCount = desc.queryCount;
+    item.values.resize(desc.queryCount, 0);
+    item.statistics.resize(desc.type == QueryType::PipelineStatistics ? desc.queryCount : 0);
+    item.available.resize(desc.queryCount, 0);
+    m_queryPools.GetItemR(handle) = item;
+    return handle;
+}
+
+void MTLBackend::DestroyQueryPool(uint16 handle) {
+    auto& item = m_queryPools.GetItemR(handle);
+    if (!item.isValid)
+    {
+        LOGE("Backend -> Query pool to be destroyed is not valid!");
+        return;
+    }
+    
+    m_queryPools.RemoveItem(handle);
+}
+
+bool MTLBackend::GetQueryResults(uint16 handle, QueryResults& outResults) {
+    const auto& item = m_queryPools.GetItemR(handle);
+    if (!item.isValid)
+    {
+        LOGE("Backend -> Query pool is not valid!");
+        return false;
+    }
+    
+    outResults.values = item.values.data();
+    outResults.statistics = item.statistics.empty() ? nullptr : item.statistics.data();
+    outResults.available = item.available.data();
+    outResults.queryCount = item.queryCount;
+    return true;
+}
+
+uint16 MTLBackend::CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo) {
+    const uint16 handle = m_transientGroups.AddItem({});
+    if (handle == m_transientGroups.InvalidHandle)
+        return handle;
+
+    // No aliasing yet, textures get dedicated memory.
+    MTLTransientTextureGroup group = {};
+    group.isValid = true;
+    outInfo = {};
+    
+    for (const auto& txt : desc.textures)
+    {
+        const uint32 txtHandle = CreateTexture(txt.desc);
+        
+        // Out of texture handles, unwind whatever has been created so far.
+        if (txtHandle == m_textures.InvalidHandle)
+        {
+            m_transientGroups.GetItemR(handle) = group;
+            DestroyTransientTextureGroup(handle);
+            return m_transientGroups.InvalidHandle;
+        }
+        
+        m_textures.GetItemR(txtHandle).isTransient = true;
+        group.textures.push_back(txtHandle);
+    }
+    
+    outInfo.textures = group.textures;
+    m_transientGroups.GetItemR(handle) = group;
+    return handle;
+}
+
+void MTLBackend::DestroyTransientTextureGroup(uint16 handle) {
+    auto& group = m_transientGroups.GetItemR(handle);
+    if (!group.isValid)
+    {
+        LOGE("Backend -> Transient texture group to be destroyed is not valid!");
+        return;
+    }
+    
+    for (auto txt : group.textures)
+    {
+        m_textures.GetItemR(txt).isTransient = false;
+        DestroyTexture(txt);
+    }
+    
+    group.isValid = false;
+    m_transientGroups.RemoveItem(handle);
+}
+
 
 bool MTLBackend::Initialize() {
         
@@ -1994,6 +2148,11 @@ void MTLBackend::Shutdown() {
         LOGA(!txt.isValid, "Backend -> Some textures were not destroyed!");
     }
 
+    for (auto& group : m_transientGroups)
+    {
+        LOGA(!group.isValid, "Backend -> Some transient texture groups were not destroyed!");
+    }
+
     for (auto& str : m_cmdStreams)
     {
         LOGA(!str.isValid, "Backend -> Some command streams were not destroyed!");
@@ -2028,6 +2187,11 @@ void MTLBackend::Shutdown() {
     {
         LOGA(!l.isValid, "Backend -> Some pipeline layouts were not destroyed!");
     }
+    
+    for (auto& qp : m_queryPools)
+    {
+        LOGA(!qp.isValid, "Backend -> Some query pools were not destroyed!");
+    }
 }
 
 void MTLBackend::Join() {
@@ -2055,6 +2219,7 @@ void MTLBackend::StartFrame(uint32 frameIndex) {
         
     }
     
+    CompleteFrameTimeline(pfd.storedFrameTimelineValue);
 
     for(auto& swp : m_swapchains)
     {
@@ -2068,26 +2233,6 @@ void MTLBackend::StartFrame(uint32 frameIndex) {
         [drawable retain];
         swp._currentDrawable = AS_VOID(drawable);
     }
-    
-    const uint32 next = m_cmdStreams.GetNextFreeID();
-    for (uint32 i = 0; i < next; i++)
-    {
-        auto& cs = m_cmdStreams.GetItemR(i);
-
-        if (!cs.isValid)
-            continue;
-
-        for (auto it = cs.intermediateResources.begin(); it != cs.intermediateResources.end();)
-        {
-            if (PerformanceStats.totalFrames > it->second + Config.framesInFlight + 1)
-            {
-                DestroyResource(it->first);
-                it = cs.intermediateResources.erase(it);
-            }
-            else
-                ++it;
-        }
-    }
 }
 
 void MTLBackend::Present(const PresentDesc &present) {
@@ -2836,7 +2981,7 @@ void MTLBackend::CMD_CopyBufferToTexture2D(uint8 *data, MTLCommandStream &stream
         offset += mipSize;
     }
     
-    stream.intermediateResources.push_back({intermediateResource, PerformanceStats.totalFrames});
+    DeferDestruction(DeferredObjectType::Resource, intermediateResource);
 }
 
 
@@ -2925,8 +3070,8 @@ void MTLBackend::CMD_BindConstants(uint8 *data, MTLCommandStream &stream) {
     {
         if (!stream.boundConstants.usesStreamAlloc)
         {
-            LINAGX_FREE(stream.boundConstants.data);
-            LINAGX_FREE(stream.boundConstants.stages);
+            FreeMemory(stream.boundConstants.data);
+            FreeMemory(stream.boundConstants.stages);
         }
     }
    
@@ -2938,8 +3083,8 @@ void MTLBackend::CMD_BindConstants(uint8 *data, MTLCommandStream &stream) {
     }
     else
     {
-        stream.boundConstants.data              = (uint8*)LINAGX_MALLOC(cmd->size);
-        stream.boundConstants.stages            = (ShaderStage*)LINAGX_MALLOC(cmd->stagesSize * sizeof(ShaderStage));
+        stream.boundConstants.data              = static_cast<uint8*>(AllocateMemory(cmd->size, AllocationTag::Commands));
+        stream.boundConstants.stages            = static_cast<ShaderStage*>(AllocateMemory(cmd->stagesSize * sizeof(ShaderStage), AllocationTag::Commands));
         stream.boundConstants.usesStreamAlloc   = false;
     }
 
@@ -2991,6 +3136,29 @@ void MTLBackend::CMD_DebugEndLabel(LinaGX::uint8 *data, LinaGX::MTLCommandStream
 
 }
 
+void MTLBackend::CMD_WriteTimestamp(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+    // Not supported, see CreateQueryPool().
+}
+
+void MTLBackend::CMD_BeginQuery(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+    // Not supported, see CreateQueryPool().
+}
+
+void MTLBackend::CMD_EndQuery(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+    // Not supported, see CreateQueryPool().
+}
+
+void MTLBackend::CMD_ResolveQueries(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+    // Not supported, see CreateQueryPool().
+}
+
+void MTLBackend::CMD_BeginConditionalRendering(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+    // Not supported, commands are always executed.
+}
+
+void MTLBackend::CMD_EndConditionalRendering(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
+}
+
 void MTLBackend::CMD_DebugBeginLabel(LinaGX::uint8 *data, LinaGX::MTLCommandStream &stream) {
     CMDDebugBeginLabel* cmd = reinterpret_cast<CMDDebugBeginLabel*>(data);
  
@@ -0,0 +1,987 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "LinaGX/Platform/Null/NullBackend.hpp"
+#include "LinaGX/Core/CommandStream.hpp"
+#include "LinaGX/Core/RedundantStateFilter.hpp"
+#include "LinaGX/Common/CommonConfig.hpp"
+
+namespace LinaGX
+{
+    uint16 NullBackend::CreateUserSemaphore()
+    {
+        NullUserSemaphore item = {};
+        item.isValid           = true;
+        return m_userSemaphores.AddItem(item);
+    }
+
+    void NullBackend::DestroyUserSemaphore(uint16 handle)
+    {
+        auto& semaphore = m_userSemaphores.GetItemR(handle);
+        if (!semaphore.isValid)
+        {
+            LOGE("Backend -> Semaphore to be destroyed is not valid!");
+            return;
+        }
+
+        m_userSemaphores.RemoveItem(handle);
+    }
+
+    void NullBackend::WaitForUserSemaphore(uint16 handle, uint64 value)
+    {
+        // Submissions complete immediately, semaphore values are signalled on submit.
+        auto& semaphore = m_userSemaphores.GetItemR(handle);
+        LOGA(semaphore.isValid, "Backend -> Waiting on an invalid semaphore!");
+        LOGA(semaphore.value >= value, "Backend -> Waiting on a semaphore value that is never signalled!");
+    }
+
+    uint8 NullBackend::CreateSwapchain(const SwapchainDesc& desc)
+    {
+        NullSwapchain item = {};
+        item.isValid       = true;
+        item.width         = desc.width;
+        item.height        = desc.height;
+        return m_swapchains.AddItem(item);
+    }
+
+    void NullBackend::DestroySwapchain(uint8 handle)
+    {
+        auto& swp = m_swapchains.GetItemR(handle);
+        if (!swp.isValid)
+        {
+            LOGE("Backend -> Swapchain to be destroyed is not valid!");
+            return;
+        }
+
+        m_swapchains.RemoveItem(handle);
+    }
+
+    void NullBackend::RecreateSwapchain(const SwapchainRecreateDesc& desc)
+    {
+        auto& swp  = m_swapchains.GetItemR(desc.swapchain);
+        swp.width  = desc.width;
+        swp.height = desc.height;
+    }
+
+    void NullBackend::SetSwapchainActive(uint8 swp, bool isActive)
+    {
+        m_swapchains.GetItemR(swp).isActive = isActive;
+    }
+
+    uint16 NullBackend::CreateShader(const ShaderDesc& shaderDesc)
+    {
+        NullShader item   = {};
+        item.isValid      = true;
+        item.customLayout = shaderDesc.useCustomPipelineLayout ? shaderDesc.customPipelineLayout : 0;
+
+        for (const auto& stg : shaderDesc.stages)
+        {
+            if (stg.stage == ShaderStage::Compute)
+                item.isCompute = true;
+        }
+
+        return m_shaders.AddItem(item);
+    }
+
+    void NullBackend::DestroyShader(uint16 handle)
+    {
+        auto& shader = m_shaders.GetItemR(handle);
+        if (!shader.isValid)
+        {
+            LOGE("Backend -> Shader to be destroyed is not valid!");
+            return;
+        }
+
+        m_shaders.RemoveItem(handle);
+    }
+
+    uint32 NullBackend::CreateTexture(const TextureDesc& desc)
+    {
+        NullTexture item = {};
+        item.isValid     = true;
+        item.flags       = desc.flags;
+        item.format      = desc.format;
+        item.width       = desc.width;
+        item.height      = desc.height;
+        item.mipLevels   = desc.mipLevels;
+        item.arrayLength = desc.arrayLength;
+        return m_textures.AddItem(item);
+    }
+
+    void NullBackend::DestroyTexture(uint32 handle)
+    {
+        auto& txt = m_textures.GetItemR(handle);
+        if (!txt.isValid)
+        {
+            LOGE("Backend -> Texture to be destroyed is not valid!");
+            return;
+        }
+
+        if (txt.isTransient)
+        {
+            LOGE("Backend -> Texture is owned by a transient texture group, destroy the group instead!");
+            return;
+        }
+
+        m_textures.RemoveItem(handle);
+    }
+
+    uint32 NullBackend::CreateSampler(const SamplerDesc&)
+    {
+        NullSampler item = {};
+        item.isValid     = true;
+        return m_samplers.AddItem(item);
+    }
+
+    void NullBackend::DestroySampler(uint32 handle)
+    {
+        auto& item = m_samplers.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Sampler to be destroyed is not valid!");
+            return;
+        }
+
+        m_samplers.RemoveItem(handle);
+    }
+
+    uint32 NullBackend::CreateResource(const ResourceDesc& desc)
+    {
+        NullResource item = {};
+        item.isValid      = true;
+        item.size         = desc.size;
+        item.heapType     = desc.heapType;
+        return m_resources.AddItem(item);
+    }
+
+    void NullBackend::MapResource(uint32 handle, uint8*& ptr)
+    {
+        auto& item = m_resources.GetItemR(handle);
+        LOGA(item.heapType != ResourceHeap::GPUOnly, "Backend -> Trying to map a GPU-only resource!");
+
+        // Host memory stands in for the mapped allocation, so user writes land somewhere valid.
+        if (item.memory == nullptr)
+            item.memory = static_cast<uint8*>(AllocateMemory(static_cast<size_t>(item.size), AllocationTag::Backend));
+
+        item.isMapped = true;
+        ptr           = item.memory;
+    }
+
+    void NullBackend::UnmapResource(uint32 handle)
+    {
+        auto& item    = m_resources.GetItemR(handle);
+        item.isMapped = false;
+    }
+
+    void NullBackend::DestroyResource(uint32 handle)
+    {
+        auto& item = m_resources.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Resource to be destroyed is not valid!");
+            return;
+        }
+
+        if (item.memory != nullptr)
+            FreeMemory(item.memory);
+
+        m_resources.RemoveItem(handle);
+    }
+
+    uint16 NullBackend::CreateDescriptorSet(const DescriptorSetDesc& desc)
+    {
+        NullDescriptorSet item = {};
+        item.isValid           = true;
+        item.setCount          = desc.allocationCount;
+        item.bindings          = desc.bindings;
+        return m_descriptorSets.AddItem(item);
+    }
+
+    void NullBackend::DestroyDescriptorSet(uint16 handle)
+    {
+        auto& item = m_descriptorSets.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Descriptor set to be destroyed is not valid!");
+            return;
+        }
+
+        m_descriptorSets.RemoveItem(handle);
+    }
+
+    void NullBackend::DescriptorUpdateBuffer(const DescriptorUpdateBufferDesc& desc)
+    {
+        const auto& item = m_descriptorSets.GetItemR(desc.setHandle);
+        LOGA(desc.binding < static_cast<uint32>(item.bindings.size()), "Backend -> Binding is not valid!");
+        LOGA(desc.setAllocationIndex < item.setCount, "Backend -> Set allocation index is not valid!");
+
+        for (uint32 buffer : desc.buffers)
+        {
+            LOGA(m_resources.GetItemR(buffer).isValid, "Backend -> Updating descriptor with an invalid resource!");
+        }
+    }
+
+    void NullBackend::DescriptorUpdateImage(const DescriptorUpdateImageDesc& desc)
+    {
+        const auto& item = m_descriptorSets.GetItemR(desc.setHandle);
+        LOGA(desc.binding < static_cast<uint32>(item.bindings.size()), "Backend -> Binding is not valid!");
+        LOGA(desc.setAllocationIndex < item.setCount, "Backend -> Set allocation index is not valid!");
+
+        for (uint32 txt : desc.textures)
+        {
+            LOGA(m_textures.GetItemR(txt).isValid, "Backend -> Updating descriptor with an invalid texture!");
+        }
+
+        for (uint32 smp : desc.samplers)
+        {
+            LOGA(m_samplers.GetItemR(smp).isValid, "Backend -> Updating descriptor with an invalid sampler!");
+        }
+    }
+
+    uint16 NullBackend::CreatePipelineLayout(const PipelineLayoutDesc&)
+    {
+        NullPipelineLayout item = {};
+        item.isValid            = true;
+        return m_pipelineLayouts.AddItem(item);
+    }
+
+    void NullBackend::DestroyPipelineLayout(uint16 layout)
+    {
+        auto& item = m_pipelineLayouts.GetItemR(layout);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Pipeline layout to be destroyed is not valid!");
+            return;
+        }
+
+        m_pipelineLayouts.RemoveItem(layout);
+    }
+
+    uint32 NullBackend::CreateCommandStream(const CommandStreamDesc& desc)
+    {
+        NullCommandStream item = {};
+        item.isValid           = true;
+        item.type              = desc.type;
+        return m_cmdStreams.AddItem(item);
+    }
+
+    void NullBackend::DestroyCommandStream(uint32 handle)
+    {
+        auto& stream = m_cmdStreams.GetItemR(handle);
+        if (!stream.isValid)
+        {
+            LOGE("Backend -> Command Stream to be destroyed is not valid!");
+            return;
+        }
+
+        m_cmdStreams.RemoveItem(handle);
+    }
+
+    void NullBackend::SetCommandStreamImpl(uint32 handle, CommandStream* stream)
+    {
+        auto& str      = m_cmdStreams.GetItemR(handle);
+        str.streamImpl = stream;
+    }
+
+    void NullBackend::CloseCommandStreams(CommandStream** streams, uint32 streamCount)
+    {
+        // Handlers only read backend-wide state and keep query writes with the stream until submission, so every stream can be translated concurrently.
+        TranslateCommandStreams(streams, streamCount, 0, m_currentFrameIndex);
+    }
+
+    void NullBackend::TranslateCommandStream(CommandStream* stream)
+    {
+        auto& sr = m_cmdStreams.GetItemR(stream->m_gpuHandle);
+
+        if (stream->m_commandCount == 0)
+            return;
+
+        sr.boundShader   = 0;
+        sr.inRenderPass  = false;
+        sr.inConditional = false;
+        sr.labelDepth    = 0;
+        sr.writtenQueries.clear();
+        sr.activeQueries.clear();
+        sr.executedSecondaries.clear();
+
+        RedundantStateFilter stateFilter;
+        uint64               elidedCount = 0;
+
+        for (uint32 i = 0; i < stream->m_commandCount; i++)
+        {
+            uint8*        data = stream->m_commands[i];
+            LINAGX_TYPEID tid  = 0;
+            LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
+            const size_t increment = sizeof(CommandHeader);
+            uint8*       cmd       = data + increment;
+
+            if (Config.eliminateRedundantState && stateFilter.IsRedundant(tid, cmd))
+            {
+                elidedCount++;
+                continue;
+            }
+
+            (this->*m_cmdFunctions[tid])(cmd, sr);
+        }
+
+        if (elidedCount != 0)
+            PerformanceStats.elidedCommands.fetch_add(elidedCount, std::memory_order_relaxed);
+
+        LOGA(!sr.inRenderPass, "Backend -> Command stream closed without ending its render pass!");
+        LOGA(sr.labelDepth == 0, "Backend -> Command stream closed with unbalanced debug labels!");
+        LOGA(!sr.inConditional, "Backend -> Command stream closed without ending conditional rendering!");
+        LOGA(sr.activeQueries.empty(), "Backend -> Command stream closed without ending its queries!");
+    }
+
+    void NullBackend::ApplyQueryWrites(const NullCommandStream& stream)
+    {
+        for (const auto& [handle, index] : stream.writtenQueries)
+        {
+            auto& pool                                                  = m_queryPools.GetItemR(handle);
+            pool.written[m_currentFrameIndex * pool.queryCount + index] = 1;
+        }
+
+        for (auto* secondary : stream.executedSecondaries)
+            ApplyQueryWrites(m_cmdStreams.GetItemR(secondary->m_gpuHandle));
+    }
+
+    void NullBackend::SubmitCommandStreams(const SubmitDesc& desc)
+    {
+        auto& queue = m_queues.GetItemR(desc.targetQueue);
+        LOGA(queue.isValid, "Backend -> Submitting to an invalid queue!");
+
+        for (uint32 i = 0; i < desc.streamCount; i++)
+        {
+            const auto& sr = m_cmdStreams.GetItemR(desc.streams[i]->m_gpuHandle);
+            LOGA(sr.type != CommandType::Secondary, "Backend -> Secondary command streams can not be submitted directly!");
+
+            // Work completes immediately, queries count as written into the frame they are submitted in.
+            if (!sr.writtenQueries.empty() || !sr.executedSecondaries.empty())
+            {
+                std::lock_guard<std::mutex> lock(m_queryWriteMtx);
+                ApplyQueryWrites(sr);
+            }
+        }
+
+        if (desc.useWait)
+        {
+            for (uint32 i = 0; i < desc.waitCount; i++)
+            {
+                LOGA(m_userSemaphores.GetItemR(desc.waitSemaphores[i]).isValid, "Backend -> Waiting on an invalid semaphore!");
+            }
+        }
+
+        // Work completes immediately, so signalled values become visible right away.
+        if (desc.useSignal)
+        {
+            for (uint32 i = 0; i < desc.signalCount; i++)
+            {
+                auto& semaphore = m_userSemaphores.GetItemR(desc.signalSemaphores[i]);
+                semaphore.value = Max(semaphore.value, desc.signalValues[i]);
+            }
+        }
+
+        queue.submissionCount++;
+        queue.frameTimelineValues[m_currentFrameIndex] = SignalFrameTimeline();
+    }
+
+    uint8 NullBackend::CreateQueue(const QueueDesc& desc)
+    {
+        NullQueue item = {};
+        item.isValid   = true;
+        item.type      = desc.type;
+        item.frameTimelineValues.resize(Config.framesInFlight);
+        return m_queues.AddItem(item);
+    }
+
+    void NullBackend::DestroyQueue(uint8 queue)
+    {
+        auto& item = m_queues.GetItemR(queue);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Queue to be destroyed is not valid!");
+            return;
+        }
+
+        m_queues.RemoveItem(queue);
+    }
+
+    uint8 NullBackend::GetPrimaryQueue(CommandType type)
+    {
+        LOGA(type != CommandType::Secondary, "Backend -> No queues of type Secondary exists, use either Graphics, Transfer or Compute!");
+        auto it = LINAGX_FIND_IF(m_primaryQueues.begin(), m_primaryQueues.end(), [type](const LINAGX_PAIR<CommandType, uint8>& pair) -> bool { return type == pair.first; });
+        return it->second;
+    }
+
+    bool NullBackend::LoadPipelineCache(const uint8*, size_t)
+    {
+        return false;
+    }
+
+    bool NullBackend::GetPipelineCacheData(LINAGX_VEC<uint8>&)
+    {
+        return false;
+    }
+
+    uint16 NullBackend::CreateQueryPool(const QueryPoolDesc& desc)
+    {
+        NullQueryPool item = {};
+        item.isValid       = true;
+        item.type          = desc.type;
+        item.queryCount    = desc.queryCount;
+        item.written.resize(desc.queryCount * Config.framesInFlight, 0);
+        item.values.resize(desc.queryCount, 0);
+        item.statistics.resize(desc.type == QueryType::PipelineStatistics ? desc.queryCount : 0);
+        item.available.resize(desc.queryCount, 0);
+        return m_queryPools.AddItem(item);
+    }
+
+    void NullBackend::DestroyQueryPool(uint16 handle)
+    {
+        auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool to be destroyed is not valid!");
+            return;
+        }
+
+        m_queryPools.RemoveItem(handle);
+    }
+
+    bool NullBackend::GetQueryResults(uint16 handle, QueryResults& outResults)
+    {
+        const auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool is not valid!");
+            return false;
+        }
+
+        outResults.values     = item.values.data();
+        outResults.statistics = item.statistics.empty() ? nullptr : item.statistics.data();
+        outResults.available  = item.available.data();
+        outResults.queryCount = item.queryCount;
+        return true;
+    }
+
+    uint16 NullBackend::CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo)
+    {
+        const uint16 handle = m_transientGroups.AddItem({});
+        if (handle == m_transientGroups.InvalidHandle)
+            return handle;
+
+        NullTransientTextureGroup item = {};
+        item.isValid                   = true;
+        outInfo                        = {};
+
+        // No driver to ask, assume 4 bytes per texel & 64kb placement alignment so the packing can still be inspected.
+        LINAGX_VEC<TransientAllocation> allocations(desc.textures.size());
+        LINAGX_VEC<TransientBlock>      blocks;
+
+        for (size_t i = 0; i < desc.textures.size(); i++)
+        {
+            const auto& txt   = desc.textures[i];
+            auto&       alloc = allocations[i];
+            alloc.size        = static_cast<uint64>(txt.desc.width) * txt.desc.height * txt.desc.arrayLength * txt.desc.samples * 4 * (txt.desc.mipLevels > 1 ? 2 : 1);
+            alloc.alignment   = 65536;
+            alloc.firstUse    = txt.firstUse;
+            alloc.lastUse     = txt.lastUse;
+
+            outInfo.requiredSize += alloc.size;
+
+            const uint32 txtHandle = CreateTexture(txt.desc);
+            if (txtHandle == m_textures.InvalidHandle)
+            {
+                m_transientGroups.GetItemR(handle) = item;
+                DestroyTransientTextureGroup(handle);
+                return m_transientGroups.InvalidHandle;
+            }
+
+            item.textures.push_back(txtHandle);
+            m_textures.GetItemR(txtHandle).isTransient = true;
+        }
+
+        PackTransientAllocations(allocations, blocks);
+
+        for (const auto& block : blocks)
+            outInfo.allocatedSize += block.size;
+
+        outInfo.textures                   = item.textures;
+        m_transientGroups.GetItemR(handle) = item;
+        return handle;
+    }
+
+    void NullBackend::DestroyTransientTextureGroup(uint16 handle)
+    {
+        auto& item = m_transientGroups.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Transient texture group to be destroyed is not valid!");
+            return;
+        }
+
+        for (auto txt : item.textures)
+            m_textures.RemoveItem(txt);
+
+        m_transientGroups.RemoveItem(handle);
+    }
+
+    bool NullBackend::Initialize()
+    {
+        // Queue support
+        {
+            QueueDesc descGfx, descTransfer, descCompute;
+            descGfx.type           = CommandType::Graphics;
+            descTransfer.type      = CommandType::Transfer;
+            descCompute.type       = CommandType::Compute;
+            descGfx.debugName      = "Primary Graphics Queue";
+            descTransfer.debugName = "Primary Transfer Queue";
+            descCompute.debugName  = "Primary Compute Queue";
+            m_primaryQueues.clear();
+            m_primaryQueues.push_back({CommandType::Graphics, CreateQueue(descGfx)});
+            m_primaryQueues.push_back({CommandType::Transfer, CreateQueue(descTransfer)});
+            m_primaryQueues.push_back({CommandType::Compute, CreateQueue(descCompute)});
+        }
+
+        // Every format is reported as supported.
+        {
+            GPUInfo.supportedTexture2DFormats.clear();
+
+            const uint32 last = static_cast<uint32>(Format::FORMAT_MAX);
+
+            for (uint32 i = 1; i < last; i++)
+                GPUInfo.supportedTexture2DFormats.push_back({static_cast<Format>(i), true, true, true});
+        }
+
+        // GPU props
+        {
+            GPUInfo.deviceName                       = "LinaGX Null Device";
+            GPUInfo.dedicatedVideoMemory             = 0;
+            GPUInfo.totalCPUVisibleGPUMemorySize     = 0;
+            GPUInfo.minConstantBufferOffsetAlignment = 256;
+            GPUInfo.minStorageBufferOffsetAlignment  = 256;
+        }
+
+        // Command functions
+        {
+            BACKEND_BIND_COMMANDS(NullBackend);
+        }
+
+        LOGT("Backend -> Null backend initialization complete. ");
+        return true;
+    }
+
+    void NullBackend::Shutdown()
+    {
+        DestroyQueue(GetPrimaryQueue(CommandType::Graphics));
+        DestroyQueue(GetPrimaryQueue(CommandType::Transfer));
+        DestroyQueue(GetPrimaryQueue(CommandType::Compute));
+
+        for (auto& swp : m_swapchains)
+        {
+            LOGA(!swp.isValid, "Backend -> Some swapchains were not destroyed!");
+        }
+
+        for (auto& pp : m_shaders)
+        {
+            LOGA(!pp.isValid, "Backend -> Some shader pipelines were not destroyed!");
+        }
+
+        for (auto& txt : m_textures)
+        {
+            LOGA(!txt.isValid, "Backend -> Some textures were not destroyed!");
+        }
+
+        for (auto& group : m_transientGroups)
+        {
+            LOGA(!group.isValid, "Backend -> Some transient texture groups were not destroyed!");
+        }
+
+        for (auto& str : m_cmdStreams)
+        {
+            LOGA(!str.isValid, "Backend -> Some command streams were not destroyed!");
+        }
+
+        for (auto& r : m_resources)
+        {
+            LOGA(!r.isValid, "Backend -> Some resources were not destroyed!");
+        }
+
+        for (auto& r : m_userSemaphores)
+        {
+            LOGA(!r.isValid, "Backend -> Some semaphores were not destroyed!");
+        }
+
+        for (auto& r : m_samplers)
+        {
+            LOGA(!r.isValid, "Backend -> Some samplers were not destroyed!");
+        }
+
+        for (auto& r : m_descriptorSets)
+        {
+            LOGA(!r.isValid, "Backend -> Some descriptor sets were not destroyed!");
+        }
+
+        for (auto& q : m_queues)
+        {
+            LOGA(!q.isValid, "Backend -> Some queues were not destroyed!");
+        }
+
+        for (auto& l : m_pipelineLayouts)
+        {
+            LOGA(!l.isValid, "Backend -> Some pipeline layouts were not destroyed!");
+        }
+
+        for (auto& qp : m_queryPools)
+        {
+            LOGA(!qp.isValid, "Backend -> Some query pools were not destroyed!");
+        }
+    }
+
+    void NullBackend::Join()
+    {
+    }
+
+    void NullBackend::StartFrame(uint32 frameIndex)
+    {
+        m_currentFrameIndex = frameIndex;
+
+        // Nothing to wait for, the work submitted the last time this frame index was used is done by now.
+        uint64 completedTimeline = 0;
+        for (auto& q : m_queues)
+        {
+            if (q.isValid)
+                completedTimeline = Max(completedTimeline, q.frameTimelineValues[frameIndex]);
+        }
+        CompleteFrameTimeline(completedTimeline);
+
+        for (auto& swp : m_swapchains)
+        {
+            if (!swp.isValid || !swp.isActive)
+                continue;
+
+            swp.imageIndex = (swp.imageIndex + 1) % Config.backbufferCount;
+        }
+
+        // Resolve the queries written the last time this frame index was used, there is no clock so every written query reads 0.
+        for (auto& qp : m_queryPools)
+        {
+            if (!qp.isValid)
+                continue;
+
+            uint8* written = qp.written.data() + frameIndex * qp.queryCount;
+            LINAGX_MEMCPY(qp.available.data(), written, qp.queryCount);
+            memset(written, 0, qp.queryCount);
+        }
+    }
+
+    void NullBackend::Present(const PresentDesc& present)
+    {
+        for (uint32 i = 0; i < present.swapchainCount; i++)
+        {
+            LOGA(m_swapchains.GetItemR(present.swapchains[i]).isValid, "Backend -> Presenting an invalid swapchain!");
+        }
+    }
+
+    void NullBackend::EndFrame()
+    {
+    }
+
+    void NullBackend::CMD_BeginRenderPass(uint8* data, NullCommandStream& stream)
+    {
+        CMDBeginRenderPass* begin = reinterpret_cast<CMDBeginRenderPass*>(data);
+        LOGA(!stream.inRenderPass, "Backend -> Beginning a render pass inside another one!");
+        LOGA(begin->colorAttachmentCount != 0 || begin->depthStencilAttachment.useDepth || begin->depthStencilAttachment.useStencil, "Backend -> Render pass needs at least one attachment!");
+
+        for (uint32 i = 0; i < begin->colorAttachmentCount; i++)
+        {
+            const auto& att = begin->colorAttachments[i];
+
+            if (att.isSwapchain)
+            {
+                LOGA(m_swapchains.GetItemR(static_cast<uint8>(att.texture)).isValid, "Backend -> Render pass swapchain is not valid!");
+            }
+            else
+            {
+                LOGA(m_textures.GetItemR(att.texture).isValid, "Backend -> Render pass texture is not valid!");
+            }
+        }
+
+        if (begin->depthStencilAttachment.useDepth || begin->depthStencilAttachment.useStencil)
+        {
+            LOGA(m_textures.GetItemR(begin->depthStencilAttachment.texture).isValid, "Backend -> Render pass depth texture is not valid!");
+        }
+
+        stream.inRenderPass = true;
+    }
+
+    void NullBackend::CMD_EndRenderPass(uint8*, NullCommandStream& stream)
+    {
+        LOGA(stream.inRenderPass, "Backend -> Ending a render pass that was never started!");
+        stream.inRenderPass = false;
+    }
+
+    void NullBackend::CMD_SetViewport(uint8*, NullCommandStream&)
+    {
+    }
+
+    void NullBackend::CMD_SetScissors(uint8*, NullCommandStream&)
+    {
+    }
+
+    void NullBackend::CMD_BindPipeline(uint8* data, NullCommandStream& stream)
+    {
+        CMDBindPipeline* cmd = reinterpret_cast<CMDBindPipeline*>(data);
+        LOGA(m_shaders.GetItemR(cmd->shader).isValid, "Backend -> Binding an invalid shader!");
+        stream.boundShader = cmd->shader;
+    }
+
+    void NullBackend::CMD_DrawInstanced(uint8*, NullCommandStream& stream)
+    {
+        LOGA(stream.inRenderPass, "Backend -> Drawing outside of a render pass!");
+    }
+
+    void NullBackend::CMD_DrawIndexedInstanced(uint8*, NullCommandStream& stream)
+    {
+        LOGA(stream.inRenderPass, "Backend -> Drawing outside of a render pass!");
+    }
+
+    void NullBackend::CMD_DrawIndexedIndirect(uint8* data, NullCommandStream& stream)
+    {
+        CMDDrawIndexedIndirect* cmd = reinterpret_cast<CMDDrawIndexedIndirect*>(data);
+        LOGA(stream.inRenderPass, "Backend -> Drawing outside of a render pass!");
+        LOGA(m_resources.GetItemR(cmd->indirectBuffer).isValid, "Backend -> Indirect buffer is not valid!");
+    }
+
+    void NullBackend::CMD_DrawIndirect(uint8* data, NullCommandStream& stream)
+    {
+        CMDDrawIndirect* cmd = reinterpret_cast<CMDDrawIndirect*>(data);
+        LOGA(stream.inRenderPass, "Backend -> Drawing outside of a render pass!");
+        LOGA(m_resources.GetItemR(cmd->indirectBuffer).isValid, "Backend -> Indirect buffer is not valid!");
+    }
+
+    void NullBackend::CMD_BindVertexBuffers(uint8* data, NullCommandStream&)
+    {
+        CMDBindVertexBuffers* cmd = reinterpret_cast<CMDBindVertexBuffers*>(data);
+        LOGA(m_resources.GetItemR(cmd->resource).isValid, "Backend -> Vertex buffer is not valid!");
+    }
+
+    void NullBackend::CMD_BindIndexBuffers(uint8* data, NullCommandStream&)
+    {
+        CMDBindIndexBuffers* cmd = reinterpret_cast<CMDBindIndexBuffers*>(data);
+        LOGA(m_resources.GetItemR(cmd->resource).isValid, "Backend -> Index buffer is not valid!");
+    }
+
+    void NullBackend::CMD_CopyResource(uint8* data, NullCommandStream&)
+    {
+        CMDCopyResource* cmd = reinterpret_cast<CMDCopyResource*>(data);
+        LOGA(m_resources.GetItemR(cmd->source).isValid, "Backend -> Copy source is not valid!");
+        LOGA(m_resources.GetItemR(cmd->destination).isValid, "Backend -> Copy destination is not valid!");
+    }
+
+    void NullBackend::CMD_CopyBufferToTexture2D(uint8* data, NullCommandStream&)
+    {
+        CMDCopyBufferToTexture2D* cmd = reinterpret_cast<CMDCopyBufferToTexture2D*>(data);
+        const auto&               txt = m_textures.GetItemR(cmd->destTexture);
+        LOGA(txt.isValid, "Backend -> Copy destination texture is not valid!");
+        LOGA(cmd->mipLevels <= txt.mipLevels, "Backend -> Copying more mip levels than the texture has!");
+        LOGA(cmd->buffers != nullptr, "Backend -> No texture buffers to copy from!");
+    }
+
+    void NullBackend::CMD_CopyTexture2DToBuffer(uint8* data, NullCommandStream&)
+    {
+        CMDCopyTexture2DToBuffer* cmd = reinterpret_cast<CMDCopyTexture2DToBuffer*>(data);
+        LOGA(m_textures.GetItemR(cmd->srcTexture).isValid, "Backend -> Copy source texture is not valid!");
+        LOGA(m_resources.GetItemR(cmd->destBuffer).isValid, "Backend -> Copy destination buffer is not valid!");
+    }
+
+    void NullBackend::CMD_CopyTexture(uint8* data, NullCommandStream&)
+    {
+        CMDCopyTexture* cmd = reinterpret_cast<CMDCopyTexture*>(data);
+        LOGA(m_textures.GetItemR(cmd->srcTexture).isValid, "Backend -> Copy source texture is not valid!");
+        LOGA(m_textures.GetItemR(cmd->dstTexture).isValid, "Backend -> Copy destination texture is not valid!");
+    }
+
+    void NullBackend::CMD_BindDescriptorSets(uint8* data, NullCommandStream& stream)
+    {
+        CMDBindDescriptorSets* cmd = reinterpret_cast<CMDBindDescriptorSets*>(data);
+
+        if (cmd->layoutSource == DescriptorSetsLayoutSource::LastBoundShader)
+        {
+            LOGA(m_shaders.GetItemR(stream.boundShader).isValid, "Backend -> Binding descriptor sets from the last bound shader but no shader is bound!");
+        }
+        else if (cmd->layoutSource == DescriptorSetsLayoutSource::CustomLayout)
+        {
+            LOGA(m_pipelineLayouts.GetItemR(cmd->customLayout).isValid, "Backend -> Custom pipeline layout is not valid!");
+        }
+        else
+        {
+            LOGA(m_shaders.GetItemR(cmd->customLayoutShader).isValid, "Backend -> Custom layout shader is not valid!");
+        }
+
+        for (uint32 i = 0; i < cmd->setCount; i++)
+        {
+            LOGA(m_descriptorSets.GetItemR(cmd->descriptorSetHandles[i]).isValid, "Backend -> Binding an invalid descriptor set!");
+        }
+    }
+
+    void NullBackend::CMD_BindConstants(uint8* data, NullCommandStream&)
+    {
+        CMDBindConstants* cmd = reinterpret_cast<CMDBindConstants*>(data);
+        LOGA(cmd->data != nullptr && cmd->stagesSize != 0, "Backend -> Binding constants without data or stages!");
+    }
+
+    void NullBackend::CMD_Dispatch(uint8*, NullCommandStream& stream)
+    {
+        LOGA(m_shaders.GetItemR(stream.boundShader).isCompute, "Backend -> Dispatching without a compute shader bound!");
+    }
+
+    void NullBackend::CMD_ExecuteSecondaryStream(uint8* data, NullCommandStream& stream)
+    {
+        CMDExecuteSecondaryStream* cmd = reinterpret_cast<CMDExecuteSecondaryStream*>(data);
+        const auto&                sr  = m_cmdStreams.GetItemR(cmd->secondaryStream->m_gpuHandle);
+        LOGA(sr.isValid && sr.type == CommandType::Secondary, "Backend -> Executing a stream that is not a valid secondary stream!");
+        stream.executedSecondaries.push_back(cmd->secondaryStream);
+    }
+
+    void NullBackend::CMD_Barrier(uint8* data, NullCommandStream&)
+    {
+        CMDBarrier* cmd = reinterpret_cast<CMDBarrier*>(data);
+
+        for (uint32 i = 0; i < cmd->textureBarrierCount; i++)
+        {
+            const auto& barrier = cmd->textureBarriers[i];
+
+            if (barrier.isSwapchain)
+            {
+                LOGA(m_swapchains.GetItemR(static_cast<uint8>(barrier.texture)).isValid, "Backend -> Barrier on an invalid swapchain!");
+            }
+            else
+            {
+                LOGA(m_textures.GetItemR(barrier.texture).isValid, "Backend -> Barrier on an invalid texture!");
+            }
+        }
+
+        for (uint32 i = 0; i < cmd->resourceBarrierCount; i++)
+        {
+            LOGA(m_resources.GetItemR(cmd->resourceBarriers[i].resource).isValid, "Backend -> Barrier on an invalid resource!");
+        }
+    }
+
+    void NullBackend::CMD_Debug(uint8*, NullCommandStream&)
+    {
+    }
+
+    void NullBackend::CMD_DebugBeginLabel(uint8*, NullCommandStream& stream)
+    {
+        stream.labelDepth++;
+    }
+
+    void NullBackend::CMD_DebugEndLabel(uint8*, NullCommandStream& stream)
+    {
+        LOGA(stream.labelDepth != 0, "Backend -> Ending a debug label that was never started!");
+        stream.labelDepth--;
+    }
+
+    void NullBackend::CMD_WriteTimestamp(uint8* data, NullCommandStream& stream)
+    {
+        CMDWriteTimestamp* cmd  = reinterpret_cast<CMDWriteTimestamp*>(data);
+        auto&              pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.isValid, "Backend -> Writing a timestamp into an invalid query pool!");
+        LOGA(pool.type == QueryType::Timestamp, "Backend -> Writing a timestamp into a query pool of a different type!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Timestamp query index is out of bounds!");
+        LOGA(stream.type == CommandType::Graphics || stream.type == CommandType::Secondary, "Backend -> Timestamps can only be written from graphics or secondary streams!");
+        stream.writtenQueries.push_back({cmd->queryPool, cmd->queryIndex});
+    }
+
+    void NullBackend::CMD_BeginQuery(uint8* data, NullCommandStream& stream)
+    {
+        CMDBeginQuery* cmd  = reinterpret_cast<CMDBeginQuery*>(data);
+        auto&          pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.isValid, "Backend -> Beginning a query in an invalid query pool!");
+        LOGA(pool.type != QueryType::Timestamp, "Backend -> Timestamp queries are written with CMDWriteTimestamp!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Query index is out of bounds!");
+        LOGA(pool.type != QueryType::Occlusion || stream.inRenderPass, "Backend -> Occlusion queries must begin inside a render pass!");
+
+        const LINAGX_PAIR<uint16, uint32> query = {cmd->queryPool, cmd->queryIndex};
+        LOGA(LINAGX_FIND_IF(stream.activeQueries.begin(), stream.activeQueries.end(), [&query](const LINAGX_PAIR<uint16, uint32>& active) -> bool { return active == query; }) == stream.activeQueries.end(), "Backend -> Beginning a query that is already active!");
+        stream.activeQueries.push_back(query);
+    }
+
+    void NullBackend::CMD_EndQuery(uint8* data, NullCommandStream& stream)
+    {
+        CMDEndQuery* cmd  = reinterpret_cast<CMDEndQuery*>(data);
+        auto&        pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.isValid, "Backend -> Ending a query in an invalid query pool!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Query index is out of bounds!");
+
+        const LINAGX_PAIR<uint16, uint32> query = {cmd->queryPool, cmd->queryIndex};
+        const auto                        it    = LINAGX_FIND_IF(stream.activeQueries.begin(), stream.activeQueries.end(), [&query](const LINAGX_PAIR<uint16, uint32>& active) -> bool { return active == query; });
+        LOGA(it != stream.activeQueries.end(), "Backend -> Ending a query that was never started!");
+
+        if (it != stream.activeQueries.end())
+            stream.activeQueries.erase(it);
+
+        stream.writtenQueries.push_back(query);
+    }
+
+    void NullBackend::CMD_ResolveQueries(uint8* data, NullCommandStream& stream)
+    {
+        CMDResolveQueries* cmd  = reinterpret_cast<CMDResolveQueries*>(data);
+        const auto&        pool = m_queryPools.GetItemR(cmd->queryPool);
+        const auto&        dst  = m_resources.GetItemR(cmd->destination);
+        LOGA(pool.isValid, "Backend -> Resolving queries of an invalid query pool!");
+        LOGA(dst.isValid, "Backend -> Resolving queries into an invalid resource!");
+        LOGA(!stream.inRenderPass, "Backend -> Queries can't be resolved inside a render pass!");
+        LOGA(cmd->firstQuery + cmd->queryCount <= pool.queryCount, "Backend -> Resolved query range is out of bounds!");
+        LOGA(pool.type == QueryType::PipelineStatistics || cmd->destinationOffset + cmd->queryCount * sizeof(uint64) <= dst.size, "Backend -> Resolved queries don't fit into the destination resource!");
+    }
+
+    void NullBackend::CMD_BeginConditionalRendering(uint8* data, NullCommandStream& stream)
+    {
+        CMDBeginConditionalRendering* cmd = reinterpret_cast<CMDBeginConditionalRendering*>(data);
+        const auto&                   res = m_resources.GetItemR(cmd->resource);
+        LOGA(res.isValid, "Backend -> Conditional rendering on an invalid resource!");
+        LOGA(cmd->offset % 8 == 0 && cmd->offset + sizeof(uint64) <= res.size, "Backend -> Conditional rendering offset is misaligned or out of bounds!");
+        LOGA(!stream.inConditional, "Backend -> Conditional rendering can't be nested!");
+        stream.inConditional = true;
+    }
+
+    void NullBackend::CMD_EndConditionalRendering(uint8*, NullCommandStream& stream)
+    {
+        LOGA(stream.inConditional, "Backend -> Ending conditional rendering that was never started!");
+        stream.inConditional = false;
+    }
+
+} // namespace LinaGX
@@ -0,0 +1,197 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "LinaGX/Core/Input.hpp"
+#include "LinaGX/Core/InputMappings.hpp"
+#include <cwctype>
+
+// Input for platforms without a window system, states are only driven by the Window feed functions.
+
+namespace LinaGX
+{
+    void Input::GetCharacterInfoFromKeycode(uint32 keycode, wchar_t& outWChar, uint16& outMask)
+    {
+        wchar_t ch   = static_cast<wchar_t>(keycode);
+        uint16  mask = 0;
+
+        if (ch == L' ')
+            mask |= Whitespace;
+        else
+        {
+            if (std::iswalnum(ch))
+            {
+                if (std::iswdigit(ch))
+                    mask |= Number;
+                else
+                    mask |= Letter;
+            }
+            else if (std::iswpunct(ch))
+            {
+                mask |= Symbol;
+
+                if (ch == L'-' || ch == L'+' || ch == L'*' || ch == L'/')
+                    mask |= Operator;
+
+                if (ch == L'-' || ch == L'+')
+                    mask |= Sign;
+            }
+            else
+                mask |= Control;
+        }
+
+        if (ch == L'.' || ch == L',')
+            mask |= Separator;
+
+        if (mask & (Letter | Number | Whitespace | Separator | Symbol))
+            mask |= Printable;
+
+        outWChar = ch;
+        outMask  = mask;
+    }
+
+    bool Input::IsControlPressed()
+    {
+        return GetKey(LINAGX_KEY_LCTRL) || GetKey(LINAGX_KEY_RCTRL) || GetKey(LINAGX_KEY_LALT) || GetKey(LINAGX_KEY_RALT) || GetKey(LINAGX_KEY_TAB) || GetKey(LINAGX_KEY_CAPSLOCK);
+    }
+
+    bool Input::GetKey(int keycode)
+    {
+        if (!m_appActive || keycode < 0 || keycode >= NUM_KEY_STATES)
+            return false;
+
+        return m_currentStates[keycode];
+    }
+
+    bool Input::GetKeyDown(int keyCode)
+    {
+        return GetKey(keyCode) && !m_previousStates[keyCode];
+    }
+
+    bool Input::GetKeyUp(int keyCode)
+    {
+        if (!m_appActive || keyCode < 0 || keyCode >= NUM_KEY_STATES)
+            return false;
+
+        return !m_currentStates[keyCode] && m_previousStates[keyCode];
+    }
+
+    bool Input::GetMouseButton(int button)
+    {
+        if (!m_appActive || button < 0 || button >= NUM_MOUSE_STATES)
+            return false;
+
+        return m_currentMouseStates[button];
+    }
+
+    bool Input::GetMouseButtonDown(int button)
+    {
+        return GetMouseButton(button) && !m_prevMouseStates[button];
+    }
+
+    bool Input::GetMouseButtonUp(int button)
+    {
+        if (!m_appActive || button < 0 || button >= NUM_MOUSE_STATES)
+            return false;
+
+        return !m_currentMouseStates[button] && m_prevMouseStates[button];
+    }
+
+    void Input::SetMousePosition(const LGXVector2i& mp)
+    {
+        m_currentMousePositionAbs.x = static_cast<float>(mp.x);
+        m_currentMousePositionAbs.y = static_cast<float>(mp.y);
+        m_previousMousePosition     = m_currentMousePositionAbs;
+    }
+
+    void Input::Tick()
+    {
+        m_mouseDelta.x          = m_currentMousePositionAbs.x - m_previousMousePosition.x;
+        m_mouseDelta.y          = m_currentMousePositionAbs.y - m_previousMousePosition.y;
+        m_previousMousePosition = m_currentMousePositionAbs;
+    }
+
+    void Input::EndFrame()
+    {
+        for (int i = 0; i < NUM_KEY_STATES; i++)
+            m_previousStates[i] = m_currentStates[i];
+
+        for (int i = 0; i < NUM_MOUSE_STATES; i++)
+            m_prevMouseStates[i] = m_currentMouseStates[i];
+
+        m_mouseScroll = 0.0f;
+    }
+
+    void Input::WindowFeedKey(uint32 key, int32 scanCode, InputAction action, Window* window)
+    {
+        if (key < NUM_KEY_STATES)
+            m_currentStates[key] = action != InputAction::Released;
+
+        for (auto* l : m_listeners)
+            l->OnKey(key, scanCode, action, window);
+    }
+
+    void Input::WindowFeedMouseButton(uint32 button, InputAction action, Window* window)
+    {
+        if (button < NUM_MOUSE_STATES)
+            m_currentMouseStates[button] = action != InputAction::Released;
+
+        for (auto* l : m_listeners)
+            l->OnMouse(button, action, window);
+    }
+
+    void Input::WindowFeedActivateApp(bool activate)
+    {
+        m_appActive = activate;
+    }
+
+    void Input::WindowFeedMouseWheel(float delta, Window* window)
+    {
+        m_mouseScroll = delta;
+
+        for (auto* l : m_listeners)
+            l->OnMouseWheel(delta, window);
+    }
+
+    void Input::WindowFeedDelta(int32 deltaX, int32 deltaY)
+    {
+    }
+
+    void Input::WindowFeedMousePosition(const LGXVector2& pos, Window* window)
+    {
+        m_currentMousePositionAbs = pos;
+
+        for (auto* l : m_listeners)
+            l->OnMouseMove(pos, window);
+    }
+} // namespace LinaGX
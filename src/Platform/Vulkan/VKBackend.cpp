@@ -40,6 +40,7 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/Core/Commands.hpp"
 #include "LinaGX/Core/Instance.hpp"
 #include "LinaGX/Core/CommandStream.hpp"
+#include "LinaGX/Core/RedundantStateFilter.hpp"
 
 #define VMA_IMPLEMENTATION
 #include "LinaGX/Platform/Vulkan/SDK/vk_mem_alloc.h"
@@ -47,9 +48,11 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace LinaGX
 {
 
-    PFN_vkSetDebugUtilsObjectNameEXT g_vkSetDebugUtilsObjectNameEXT;
-    PFN_vkCmdBeginDebugUtilsLabelEXT g_vkCmdBeginDebugUtilsLabelEXT;
-    PFN_vkCmdEndDebugUtilsLabelEXT   g_vkCmdEndDebugUtilsLabelEXT;
+    PFN_vkSetDebugUtilsObjectNameEXT      g_vkSetDebugUtilsObjectNameEXT;
+    PFN_vkCmdBeginDebugUtilsLabelEXT      g_vkCmdBeginDebugUtilsLabelEXT;
+    PFN_vkCmdEndDebugUtilsLabelEXT        g_vkCmdEndDebugUtilsLabelEXT;
+    PFN_vkCmdBeginConditionalRenderingEXT g_vkCmdBeginConditionalRenderingEXT;
+    PFN_vkCmdEndConditionalRenderingEXT   g_vkCmdEndConditionalRenderingEXT;
     // PFN_vkCmdSetCheckpointNV         g_vkCmdSetCheckpointNVEXT;
     // PFN_vkGetQueueCheckpointDataNV   g_vkCmdGetQueueCheckpointDataNVEXT;
 
@@ -86,6 +89,8 @@ namespace LinaGX
 #define LGX_VK_MAJOR 1
 #define LGX_VK_MINOR 3
 
+#define DESCRIPTOR_UPDATE_BATCH 32
+
     LINAGX_STRING LinaGX_VkErr(VkResult errorCode)
     {
         switch (errorCode)
@@ -565,6 +570,91 @@ namespace LinaGX
         }
     }
 
+    /// <summary>
+    /// Appends transitions of the subresources in range from oldLayouts to newLayouts, both indexed by layer * mipLevels + mip.
+    /// Mips sharing the same layouts within a layer go into one barrier, identical runs on consecutive layers are merged into it as well.
+    /// </summary>
+    void AppendImageBarriers(LINAGX_VEC<VkImageMemoryBarrier2>& out, const VKBTexture2D& txt, const VkImageLayout* oldLayouts, const VkImageLayout* newLayouts, const VkImageSubresourceRange& range, VkPipelineStageFlags2 srcStages, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStages, VkAccessFlags2 dstAccess, bool skipUnchanged)
+    {
+        const size_t firstBarrier = out.size();
+        const uint32 mipEnd       = range.baseMipLevel + range.levelCount;
+
+        for (uint32 layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+        {
+            const uint32 layerStart = layer * txt.mipLevels;
+            uint32       mip        = range.baseMipLevel;
+
+            while (mip < mipEnd)
+            {
+                const VkImageLayout oldLayout = oldLayouts[layerStart + mip];
+                const VkImageLayout newLayout = newLayouts[layerStart + mip];
+                uint32              end       = mip + 1;
+
+                while (end < mipEnd && oldLayouts[layerStart + end] == oldLayout && newLayouts[layerStart + end] == newLayout)
+                    end++;
+
+                if (skipUnchanged && oldLayout == newLayout)
+                {
+                    mip = end;
+                    continue;
+                }
+
+                auto it = LINAGX_FIND_IF(out.begin() + firstBarrier, out.end(), [&](const VkImageMemoryBarrier2& b) -> bool {
+                    return b.oldLayout == oldLayout && b.newLayout == newLayout && b.subresourceRange.baseMipLevel == mip && b.subresourceRange.levelCount == end - mip && b.subresourceRange.baseArrayLayer + b.subresourceRange.layerCount == layer;
+                });
+
+                if (it != out.end())
+                    it->subresourceRange.layerCount++;
+                else
+                {
+                    VkImageMemoryBarrier2 barrier           = {};
+                    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                    barrier.image                           = txt.img;
+                    barrier.oldLayout                       = oldLayout;
+                    barrier.newLayout                       = newLayout;
+                    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.srcStageMask                    = srcStages;
+                    barrier.srcAccessMask                   = srcAccess;
+                    barrier.dstStageMask                    = dstStages;
+                    barrier.dstAccessMask                   = dstAccess;
+                    barrier.subresourceRange.aspectMask     = txt.aspectFlags;
+                    barrier.subresourceRange.baseMipLevel   = mip;
+                    barrier.subresourceRange.levelCount     = end - mip;
+                    barrier.subresourceRange.baseArrayLayer = layer;
+                    barrier.subresourceRange.layerCount     = 1;
+                    out.push_back(barrier);
+                }
+
+                mip = end;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Brings a swapchain image from the layout another stream left it in to the one a stream was recorded against.
+    /// </summary>
+    void AppendSwapchainFixup(LINAGX_VEC<VkImageMemoryBarrier2>& out, const VKBSwapchain& swp, uint32 imageIndex, VkImageLayout oldLayout, VkImageLayout newLayout)
+    {
+        VkImageMemoryBarrier2 barrier           = {};
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.image                           = swp.imgs[imageIndex];
+        barrier.oldLayout                       = oldLayout;
+        barrier.newLayout                       = newLayout;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.srcStageMask                    = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.srcAccessMask                   = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        barrier.dstStageMask                    = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask                   = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+        out.push_back(barrier);
+    }
+
     VkImageAspectFlags GetVKAspectFlags(DepthStencilAspect depthStencilAspect)
     {
         switch (depthStencilAspect)
@@ -718,65 +808,189 @@ namespace LinaGX
         }
     }
 
-    VkAccessFlags GetVKAccessMaskFromLayout(VkImageLayout layout)
+    // Source scope of a barrier only needs to make the writes available.
+    constexpr VkAccessFlags2 WRITE_ACCESS_FLAGS = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+    VkAccessFlags2 GetVKAccessMaskFromLayout(VkImageLayout layout)
     {
         switch (layout)
         {
         case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+            return VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
         case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
         case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
         case VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        case VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL:
+        case VK_IMAGE_LAYOUT_STENCIL_READ_ONLY_OPTIMAL:
+            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT;
         case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-            return VK_ACCESS_TRANSFER_READ_BIT;
+            return VK_ACCESS_2_TRANSFER_READ_BIT;
         case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            return VK_ACCESS_TRANSFER_WRITE_BIT;
+            return VK_ACCESS_2_TRANSFER_WRITE_BIT;
         case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-            return VK_ACCESS_SHADER_READ_BIT;
-        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-            return VK_ACCESS_MEMORY_READ_BIT;
+            return VK_ACCESS_2_SHADER_READ_BIT;
         default:
-            return VK_ACCESS_MEMORY_READ_BIT;
+            return VK_ACCESS_2_NONE;
         }
     }
 
-    VkAccessFlags GetVKAccessMaskFromResourceBarrier(ResourceBarrierState state)
+    VkAccessFlags2 GetVKAccessMaskFromResourceBarrier(ResourceBarrierState state)
     {
         switch (state)
         {
         case LinaGX::ResourceBarrierState::TransferRead:
-            return VK_ACCESS_TRANSFER_READ_BIT;
+            return VK_ACCESS_2_TRANSFER_READ_BIT;
         case LinaGX::ResourceBarrierState::TransferWrite:
-            return VK_ACCESS_TRANSFER_WRITE_BIT;
+            return VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        case LinaGX::ResourceBarrierState::ConditionalRenderingRead:
+            return VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT;
         default:
-            return 0;
+            return VK_ACCESS_2_NONE;
         }
     }
 
-    VkPipelineStageFlags GetVKPipelineStageFromLayout(VkImageLayout layout, bool sampledOutsideFragment)
+    VkPipelineStageFlags2 GetVKPipelineStageFromLayout(VkImageLayout layout, bool isSwapchain)
     {
         switch (layout)
         {
         case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            return VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
         case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
         case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
         case VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL:
-            return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            return VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        case VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL:
+        case VK_IMAGE_LAYOUT_STENCIL_READ_ONLY_OPTIMAL:
+            return VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
         case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
         case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            return VK_PIPELINE_STAGE_TRANSFER_BIT;
-        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL: {
-            if (sampledOutsideFragment)
-                return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-            else
-                return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        }
+            return VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        case VK_IMAGE_LAYOUT_UNDEFINED:
         case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-            return VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            // Swapchain images are acquired with a semaphore waited on at color attachment output.
+            return isSwapchain ? VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_2_NONE;
+        default:
+            return VK_PIPELINE_STAGE_2_NONE;
+        }
+    }
+
+    VkPipelineStageFlags2 GetVKPipelineStageFromResourceBarrier(ResourceBarrierState state)
+    {
+        switch (state)
+        {
+        case LinaGX::ResourceBarrierState::TransferRead:
+        case LinaGX::ResourceBarrierState::TransferWrite:
+            return VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        case LinaGX::ResourceBarrierState::ConditionalRenderingRead:
+            return VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT;
+        default:
+            return VK_PIPELINE_STAGE_2_NONE;
+        }
+    }
+
+    VkPipelineStageFlags2 GetVKPipelineStageFromAccess(VkAccessFlags2 access)
+    {
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+
+        if (access & VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            stages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+
+        if (access & (VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT))
+            stages |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+
+        if (access & (VK_ACCESS_2_UNIFORM_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT))
+            stages |= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+        if (access & VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT)
+            stages |= VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+
+        if (access & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT))
+            stages |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+        if (access & (VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT))
+            stages |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+        if (access & (VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT))
+            stages |= VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+
+        if (access & (VK_ACCESS_2_HOST_READ_BIT | VK_ACCESS_2_HOST_WRITE_BIT))
+            stages |= VK_PIPELINE_STAGE_2_HOST_BIT;
+
+        if (access & VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT)
+            stages |= VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT;
+
+        // Memory read & write are valid on any stage, they don't widen the mask.
+        return stages;
+    }
+
+    /// <summary>
+    /// Stages & accesses a barrier recorded in a stream of the given type might use, graphics stages are invalid on compute & transfer queues.
+    /// </summary>
+    void GetVKSupportedBarrierMasks(CommandType type, VkPipelineStageFlags2& stages, VkAccessFlags2& access)
+    {
+        const VkPipelineStageFlags2 commonStages = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_2_HOST_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        const VkAccessFlags2        commonAccess = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_READ_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+        if (type == CommandType::Compute)
+        {
+            stages = commonStages | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            access = commonAccess | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_UNIFORM_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+        }
+        else if (type == CommandType::Transfer)
+        {
+            stages = commonStages;
+            access = commonAccess;
+        }
+        else
+        {
+            stages = ~VkPipelineStageFlags2(0);
+            access = ~VkAccessFlags2(0);
+        }
+    }
+
+    /// <summary>
+    /// Legacy barriers use the command's stages as is. With synchronization2, stages and access left at 0 by the user are derived from the state the barrier transitions from/to,
+    /// and restricted to what the stream's queue supports. Falls back to the command's stages if nothing could be derived, e.g. the previous use was on another queue.
+    /// </summary>
+    void GetVKBarrierMasks(VkPipelineStageFlags2& stages, VkAccessFlags2& access, uint32 userStages, uint32 userAccess, VkPipelineStageFlags2 stateStages, VkAccessFlags2 stateAccess, uint32 commandStages, CommandType type, bool synchronization2)
+    {
+        if (!synchronization2)
+        {
+            stages = commandStages;
+            access = userAccess;
+            return;
+        }
+
+        VkPipelineStageFlags2 supportedStages = 0;
+        VkAccessFlags2        supportedAccess = 0;
+        GetVKSupportedBarrierMasks(type, supportedStages, supportedAccess);
+
+        access = (userAccess != 0 ? userAccess : stateAccess) & supportedAccess;
+        stages = userStages != 0 ? userStages : ((stateStages | GetVKPipelineStageFromAccess(access)) & supportedStages);
+
+        if (stages == 0)
+            stages = commandStages;
+
+        // Access requires a stage performing it.
+        if (stages == 0)
+            access = 0;
+    }
+
+    VkQueryType GetVKQueryType(QueryType type)
+    {
+        switch (type)
+        {
+        case LinaGX::QueryType::Occlusion:
+            return VK_QUERY_TYPE_OCCLUSION;
+        case LinaGX::QueryType::PipelineStatistics:
+            return VK_QUERY_TYPE_PIPELINE_STATISTICS;
         default:
-            return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            return VK_QUERY_TYPE_TIMESTAMP;
         }
     }
 
@@ -816,6 +1030,21 @@ namespace LinaGX
             return VK_RESOLVE_MODE_NONE;
         }
     }
+    static void* VKAPI_CALL VkAllocationFunction(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
+    {
+        return AllocateMemory(size, AllocationTag::Driver, alignment);
+    }
+
+    static void* VKAPI_CALL VkReallocationFunction(void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
+    {
+        return ReallocateMemory(pOriginal, size, AllocationTag::Driver, alignment);
+    }
+
+    static void VKAPI_CALL VkFreeFunction(void* pUserData, void* pMemory)
+    {
+        FreeMemory(pMemory);
+    }
+
     static VKAPI_ATTR VkBool32 VKAPI_CALL VkDebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData)
     {
         switch (messageSeverity)
@@ -835,6 +1064,10 @@ namespace LinaGX
 
     uint16 VKBackend::CreateUserSemaphore()
     {
+        const uint16 handle = m_userSemaphores.AddItem({});
+        if (handle == m_userSemaphores.InvalidHandle)
+            return handle;
+
         VKBUserSemaphore item = {};
         item.isValid          = true;
 
@@ -851,7 +1084,8 @@ namespace LinaGX
 
         VkResult result = vkCreateSemaphore(m_device, &info, m_allocator, &item.ptr);
         VK_CHECK_RESULT(result, "Failed creating semaphore.");
-        return m_userSemaphores.AddItem(item);
+        m_userSemaphores.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyUserSemaphore(uint16 handle)
@@ -884,6 +1118,10 @@ namespace LinaGX
 
     uint8 VKBackend::CreateSwapchain(const SwapchainDesc& desc)
     {
+        const uint8 handle = m_swapchains.AddItem({});
+        if (handle == m_swapchains.InvalidHandle)
+            return handle;
+
         VKBSwapchain swp;
 
         VkSurfaceKHR surface;
@@ -894,7 +1132,7 @@ namespace LinaGX
         surfaceCreateInfo.pNext                       = nullptr;
         surfaceCreateInfo.hinstance                   = static_cast<HINSTANCE>(desc.osHandle);
         surfaceCreateInfo.hwnd                        = static_cast<HWND>(desc.window);
-        vkCreateWin32SurfaceKHR(m_vkInstance, &surfaceCreateInfo, nullptr, &surface);
+        vkCreateWin32SurfaceKHR(m_vkInstance, &surfaceCreateInfo, m_allocator, &surface);
 #else
         LOGA(false, "Backend -> Vulkan backend is only supported for Windows at the moment!");
 #endif
@@ -909,7 +1147,8 @@ namespace LinaGX
                                .set_desired_present_mode(presentMode)
                                .set_desired_extent(desc.width, desc.height)
                                .set_desired_format({swpFormat, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR})
-                               .set_desired_min_image_count(Config.backbufferCount);
+                               .set_desired_min_image_count(Config.backbufferCount)
+                               .set_allocation_callbacks(m_allocator);
 
         vkb::Swapchain vkbSwapchain = swapchainBuilder.build().value();
         swp.ptr                     = vkbSwapchain.swapchain;
@@ -942,7 +1181,8 @@ namespace LinaGX
 
         LOGT("Backend -> Successfuly created swapchain with size %d x %d", desc.width, desc.height);
 
-        return m_swapchains.AddItem(swp);
+        m_swapchains.GetItemR(handle) = swp;
+        return handle;
     }
 
     void VKBackend::DestroySwapchain(uint8 handle)
@@ -995,6 +1235,7 @@ namespace LinaGX
                                           .set_desired_extent(desc.width, desc.height)
                                           .set_desired_format({swp.format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR})
                                           .set_required_min_image_count(Config.backbufferCount)
+                                          .set_allocation_callbacks(m_allocator)
                                           .build()
                                           .value();
         swp.ptr    = vkbSwapchain.swapchain;
@@ -1036,7 +1277,12 @@ namespace LinaGX
 
     uint16 VKBackend::CreateShader(const ShaderDesc& shaderDesc)
     {
-        VKBShader shader = {};
+        const uint16 handle = m_shaders.AddItem({});
+        if (handle == m_shaders.InvalidHandle)
+            return handle;
+
+        VKBShader shader  = {};
+        shader.usesDrawID = shaderDesc.layout.hasGLDrawID;
 
         for (const ShaderCompileData& data : shaderDesc.stages)
         {
@@ -1125,7 +1371,7 @@ namespace LinaGX
             shaderModule.codeSize                 = data.outBlob.size;
             shaderModule.pCode                    = reinterpret_cast<uint32*>(data.outBlob.ptr);
 
-            VkResult res = vkCreateShaderModule(m_device, &shaderModule, nullptr, &pair.second);
+            VkResult res = vkCreateShaderModule(m_device, &shaderModule, m_allocator, &pair.second);
             VK_CHECK_RESULT(res, "Failed creating shader module");
 
             VkPipelineShaderStageCreateInfo info = VkPipelineShaderStageCreateInfo{};
@@ -1317,7 +1563,7 @@ namespace LinaGX
             computeInfo.stage                       = shaderStages[0];
             computeInfo.layout                      = shader.ptrLayout;
             computeInfo.basePipelineHandle          = VK_NULL_HANDLE;
-            res                                     = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &computeInfo, m_allocator, &shader.ptrPipeline);
+            res                                     = vkCreateComputePipelines(m_device, m_pipelineCache, 1, &computeInfo, m_allocator, &shader.ptrPipeline);
         }
         else
         {
@@ -1339,7 +1585,7 @@ namespace LinaGX
             pipelineInfo.renderPass                   = VK_NULL_HANDLE;
             pipelineInfo.subpass                      = 0;
             pipelineInfo.basePipelineHandle           = VK_NULL_HANDLE;
-            res                                       = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, m_allocator, &shader.ptrPipeline);
+            res                                       = vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &pipelineInfo, m_allocator, &shader.ptrPipeline);
         }
 
         LOGA(res == VK_SUCCESS, "Backend -> Could not create shader pipeline!");
@@ -1350,7 +1596,8 @@ namespace LinaGX
             vkDestroyShaderModule(m_device, mod, m_allocator);
         shader.isValid = true;
         shader.modules.clear();
-        return m_shaders.AddItem(shader);
+        m_shaders.GetItemR(handle) = shader;
+        return handle;
     }
 
     void VKBackend::DestroyShader(uint16 handle)
@@ -1371,7 +1618,7 @@ namespace LinaGX
         m_shaders.RemoveItem(handle);
     }
 
-    uint32 VKBackend::CreateTexture(const TextureDesc& txtDesc)
+    void VKBackend::FillTextureCreateInfo(const TextureDesc& txtDesc, VKBTexture2D& item, VkImageCreateInfo& imgCreateInfo)
     {
         if (txtDesc.width == 0 || txtDesc.height == 0)
         {
@@ -1395,13 +1642,12 @@ namespace LinaGX
 
         LOGA(txtDesc.mipLevels != 0 && txtDesc.arrayLength != 0 && static_cast<uint32>(txtDesc.views.size()) != 0, "Backend -> Mip levels, array length or view count can't be zero!");
 
-        VKBTexture2D item = {};
-        item.flags        = txtDesc.flags;
-        item.isValid      = true;
-        item.arrayLength  = txtDesc.arrayLength;
-        item.mipLevels    = txtDesc.mipLevels;
+        item.flags       = txtDesc.flags;
+        item.isValid     = true;
+        item.arrayLength = txtDesc.arrayLength;
+        item.mipLevels   = txtDesc.mipLevels;
 
-        VkImageCreateInfo imgCreateInfo = VkImageCreateInfo{};
+        imgCreateInfo                   = VkImageCreateInfo{};
         imgCreateInfo.sType             = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imgCreateInfo.pNext             = nullptr;
         imgCreateInfo.imageType         = VK_IMAGE_TYPE_2D;
@@ -1413,8 +1659,17 @@ namespace LinaGX
         imgCreateInfo.tiling            = (txtDesc.flags & TextureFlags::TF_LinearTiling) ? VK_IMAGE_TILING_LINEAR : VK_IMAGE_TILING_OPTIMAL;
         imgCreateInfo.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
         imgCreateInfo.initialLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-        item.imgLayout                  = imgCreateInfo.initialLayout;
         item.extent                     = imgCreateInfo.extent;
+        item.format                     = imgCreateInfo.format;
+        item.samples                    = imgCreateInfo.samples;
+        item.layouts.assign(static_cast<size_t>(txtDesc.arrayLength) * txtDesc.mipLevels, imgCreateInfo.initialLayout);
+
+        if (m_sharedQueueFamilies.size() > 1)
+        {
+            imgCreateInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+            imgCreateInfo.queueFamilyIndexCount = static_cast<uint32>(m_sharedQueueFamilies.size());
+            imgCreateInfo.pQueueFamilyIndices   = m_sharedQueueFamilies.data();
+        }
 
         if (txtDesc.type == TextureType::Texture3D)
             imgCreateInfo.imageType = VK_IMAGE_TYPE_3D;
@@ -1451,15 +1706,11 @@ namespace LinaGX
 
         if (!(txtDesc.flags & TextureFlags::TF_DepthTexture) && !(txtDesc.flags & TextureFlags::TF_StencilTexture))
             item.aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+    }
 
-        VmaAllocationCreateInfo allocinfo = VmaAllocationCreateInfo{};
-        allocinfo.usage                   = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-        allocinfo.requiredFlags           = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-        VkResult res = vmaCreateImage(m_vmaAllocator, &imgCreateInfo, &allocinfo, &item.img, &item.allocation, nullptr);
-        VK_CHECK_RESULT(res, "Failed creating image.");
-
-        VK_NAME_OBJECT(item.img, VK_OBJECT_TYPE_IMAGE, txtDesc.debugName, info);
+    void VKBackend::CreateTextureViews(const TextureDesc& txtDesc, VKBTexture2D& item)
+    {
+        VkResult res = VK_SUCCESS;
 
         auto createView = [&](bool useCubeView, uint32 baseArrayLayer, uint32 layerCount, uint32 baseMipLevel, uint32 mipCount, VkImageView& imgView) {
             VkImageSubresourceRange subResRange = VkImageSubresourceRange{};
@@ -1507,8 +1758,30 @@ namespace LinaGX
             const uint32 remainingMip   = view.mipCount == 0 ? (txtDesc.mipLevels - baseMip) : view.mipCount;
             createView(view.isCubemap, baseLevel, remainingLevel, baseMip, remainingMip, item.imgViews[i]);
         }
+    }
+
+    uint32 VKBackend::CreateTexture(const TextureDesc& txtDesc)
+    {
+        const uint32 handle = m_textures.AddItem({});
+        if (handle == m_textures.InvalidHandle)
+            return handle;
+
+        VKBTexture2D      item          = {};
+        VkImageCreateInfo imgCreateInfo = {};
+        FillTextureCreateInfo(txtDesc, item, imgCreateInfo);
 
-        return m_textures.AddItem(item);
+        VmaAllocationCreateInfo allocinfo = VmaAllocationCreateInfo{};
+        allocinfo.usage                   = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        allocinfo.requiredFlags           = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        VkResult res = vmaCreateImage(m_vmaAllocator, &imgCreateInfo, &allocinfo, &item.img, &item.allocation, nullptr);
+        VK_CHECK_RESULT(res, "Failed creating image.");
+
+        VK_NAME_OBJECT(item.img, VK_OBJECT_TYPE_IMAGE, txtDesc.debugName, info);
+
+        CreateTextureViews(txtDesc, item);
+        m_textures.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyTexture(uint32 handle)
@@ -1520,6 +1793,12 @@ namespace LinaGX
             return;
         }
 
+        if (txt.isTransient)
+        {
+            LOGE("Backend -> Texture is owned by a transient texture group, destroy the group instead!");
+            return;
+        }
+
         for (auto view : txt.imgViews)
             vkDestroyImageView(m_device, view, m_allocator);
 
@@ -1531,6 +1810,10 @@ namespace LinaGX
 
     uint32 VKBackend::CreateResource(const ResourceDesc& desc)
     {
+        const uint32 handle = m_resources.AddItem({});
+        if (handle == m_resources.InvalidHandle)
+            return handle;
+
         VKBResource item = {};
         item.size        = desc.size;
         item.isValid     = true;
@@ -1549,10 +1832,19 @@ namespace LinaGX
             bufferInfo.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         if (desc.typeHintFlags & TH_StorageBuffer)
             bufferInfo.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        if (desc.typeHintFlags & TH_QueryResult)
+            bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT | (m_supportsConditionalRendering ? VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT : 0);
 
         if (bufferInfo.usage == 0)
             bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
+        if (m_sharedQueueFamilies.size() > 1)
+        {
+            bufferInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32>(m_sharedQueueFamilies.size());
+            bufferInfo.pQueueFamilyIndices   = m_sharedQueueFamilies.data();
+        }
+
         VmaAllocationCreateInfo allocInfo = {};
 
         if (desc.heapType == ResourceHeap::CPUVisibleGPUMemory)
@@ -1579,11 +1871,16 @@ namespace LinaGX
         vmaCreateBuffer(m_vmaAllocator, &bufferInfo, &allocInfo, &item.buffer, &item.allocation, nullptr);
         VK_NAME_OBJECT(item.buffer, VK_OBJECT_TYPE_BUFFER, desc.debugName, info);
 
-        return m_resources.AddItem(item);
+        m_resources.GetItemR(handle) = item;
+        return handle;
     }
 
     uint32 VKBackend::CreateSampler(const SamplerDesc& desc)
     {
+        const uint32 handle = m_samplers.AddItem({});
+        if (handle == m_samplers.InvalidHandle)
+            return handle;
+
         VKBSampler item = {};
         item.isValid    = true;
 
@@ -1606,7 +1903,8 @@ namespace LinaGX
         VkResult res = vkCreateSampler(m_device, &info, m_allocator, &item.ptr);
         VK_CHECK_RESULT(res, "Backend -> Could not create sampler!");
         VK_NAME_OBJECT(item.ptr, VK_OBJECT_TYPE_SAMPLER, desc.debugName, sinfo);
-        return m_samplers.AddItem(item);
+        m_samplers.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroySampler(uint32 handle)
@@ -1749,6 +2047,10 @@ namespace LinaGX
 
     uint16 VKBackend::CreateDescriptorSet(const DescriptorSetDesc& desc)
     {
+        const uint16 handle = m_descriptorSets.AddItem({});
+        if (handle == m_descriptorSets.InvalidHandle)
+            return handle;
+
         LOGA(desc.allocationCount > 0, "Backend -> Descriptor set allocation count must be at least 1!");
 
         VKBDescriptorSet item = {};
@@ -1768,12 +2070,13 @@ namespace LinaGX
         allocInfo.descriptorPool              = m_descriptorPool;
         allocInfo.descriptorSetCount          = desc.allocationCount;
         allocInfo.pSetLayouts                 = layouts.data(),
-        item.sets                             = new VkDescriptorSet[desc.allocationCount];
+        item.sets                             = static_cast<VkDescriptorSet*>(AllocateMemory(sizeof(VkDescriptorSet) * desc.allocationCount, AllocationTag::Backend, alignof(VkDescriptorSet)));
 
         VkResult res  = vkAllocateDescriptorSets(m_device, &allocInfo, item.sets);
         item.setCount = desc.allocationCount;
         VK_CHECK_RESULT(res, "Backend -> Could not allocate descriptor set, make sure you have set enough descriptor limits in Configs!");
-        return m_descriptorSets.AddItem(item);
+        m_descriptorSets.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyDescriptorSet(uint16 handle)
@@ -1786,7 +2089,7 @@ namespace LinaGX
         }
 
         vkFreeDescriptorSets(m_device, m_descriptorPool, item.setCount, item.sets);
-        delete[] item.sets;
+        FreeMemory(item.sets);
         vkDestroyDescriptorSetLayout(m_device, item.layout, m_allocator);
 
         m_descriptorSets.RemoveItem(handle);
@@ -1801,18 +2104,8 @@ namespace LinaGX
         LOGA(descriptorCount <= bindingData.descriptorCount, "Backend -> Error updating descriptor buffer as update count exceeds the maximum descriptor count for given binding!");
         LOGA(bindingData.type == DescriptorType::UBO || bindingData.type == DescriptorType::SSBO, "Backend -> You can only use DescriptorUpdateBuffer with descriptors of type UBO and SSBO! Use DescriptorUpdateImage()");
 
-        LINAGX_VEC<VkDescriptorBufferInfo> bufferInfos;
-
-        for (uint32 i = 0; i < descriptorCount; i++)
-        {
-            const auto&            res   = m_resources.GetItemR(desc.buffers[i]);
-            VkDescriptorBufferInfo binfo = {};
-            binfo.buffer                 = res.buffer;
-
-            binfo.offset = desc.offsets.empty() ? 0 : desc.offsets[i];
-            binfo.range  = desc.ranges.empty() ? res.size : desc.ranges[i];
-            bufferInfos.push_back(binfo);
-        }
+        // Written in fixed-size batches from the stack, so updates never touch the heap and stay callable from any thread.
+        VkDescriptorBufferInfo bufferInfos[DESCRIPTOR_UPDATE_BATCH];
 
         const auto&          dscSet = m_descriptorSets.GetItemR(desc.setHandle);
         VkWriteDescriptorSet write  = {};
@@ -1820,10 +2113,29 @@ namespace LinaGX
         write.pNext                 = nullptr;
         write.dstSet                = dscSet.sets[desc.setAllocationIndex];
         write.dstBinding            = desc.binding;
-        write.descriptorCount       = descriptorCount;
         write.descriptorType        = GetVKDescriptorType(bindingData.type, bindingData.useDynamicOffset);
-        write.pBufferInfo           = bufferInfos.data();
-        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        write.pBufferInfo           = bufferInfos;
+
+        for (uint32 batchStart = 0; batchStart < descriptorCount; batchStart += DESCRIPTOR_UPDATE_BATCH)
+        {
+            const uint32 batchCount = Min(descriptorCount - batchStart, static_cast<uint32>(DESCRIPTOR_UPDATE_BATCH));
+
+            for (uint32 j = 0; j < batchCount; j++)
+            {
+                const uint32           i     = batchStart + j;
+                const auto&            res   = m_resources.GetItemR(desc.buffers[i]);
+                VkDescriptorBufferInfo binfo = {};
+                binfo.buffer                 = res.buffer;
+
+                binfo.offset   = desc.offsets.empty() ? 0 : desc.offsets[i];
+                binfo.range    = desc.ranges.empty() ? res.size : desc.ranges[i];
+                bufferInfos[j] = binfo;
+            }
+
+            write.dstArrayElement = batchStart;
+            write.descriptorCount = batchCount;
+            vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        }
     }
 
     void VKBackend::DescriptorUpdateImage(const DescriptorUpdateImageDesc& desc)
@@ -1836,7 +2148,8 @@ namespace LinaGX
         LOGA(txtDescriptorCount <= bindingData.descriptorCount && smpDescriptorCount <= bindingData.descriptorCount, "Backend -> Error updateing descriptor buffer as update count exceeds the maximum descriptor count for given binding!");
         LOGA(bindingData.type == DescriptorType::CombinedImageSampler || bindingData.type == DescriptorType::SeparateSampler || bindingData.type == DescriptorType::SeparateImage, "Backend -> You can only use DescriptorUpdateImage with descriptors of type combined image sampler, separate image or separate sampler! Use DescriptorUpdateBuffer()");
 
-        LINAGX_VEC<VkDescriptorImageInfo> imgInfos;
+        // Written in fixed-size batches from the stack, see DescriptorUpdateBuffer().
+        VkDescriptorImageInfo imgInfos[DESCRIPTOR_UPDATE_BATCH];
 
         VkDescriptorType descriptorType = GetVKDescriptorType(bindingData.type, bindingData.useDynamicOffset);
 
@@ -1846,41 +2159,53 @@ namespace LinaGX
         else
             usedCount = smpDescriptorCount;
 
-        for (uint32 i = 0; i < usedCount; i++)
-        {
-            VkDescriptorImageInfo imgInfo = VkDescriptorImageInfo{};
+        VkWriteDescriptorSet write = {};
+        write.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext                = nullptr;
+        write.dstSet               = m_descriptorSets.GetItemR(desc.setHandle).sets[desc.setAllocationIndex];
+        write.dstBinding           = desc.binding;
+        write.descriptorType       = descriptorType;
+        write.pImageInfo           = imgInfos;
 
-            if (descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER)
-                imgInfo.sampler = m_samplers.GetItemR(desc.samplers[i]).ptr;
+        for (uint32 batchStart = 0; batchStart < usedCount; batchStart += DESCRIPTOR_UPDATE_BATCH)
+        {
+            const uint32 batchCount = Min(usedCount - batchStart, static_cast<uint32>(DESCRIPTOR_UPDATE_BATCH));
 
-            if (descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
+            for (uint32 j = 0; j < batchCount; j++)
             {
-                auto& txt = m_textures.GetItemR(desc.textures[i]);
+                const uint32          i       = batchStart + j;
+                VkDescriptorImageInfo imgInfo = VkDescriptorImageInfo{};
 
-                if (desc.textureViewIndices.empty())
-                    imgInfo.imageView = txt.imgViews[0];
-                else
-                    imgInfo.imageView = txt.imgViews[desc.textureViewIndices[i]];
+                if (descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER)
+                    imgInfo.sampler = m_samplers.GetItemR(desc.samplers[i]).ptr;
+
+                if (descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
+                {
+                    auto& txt = m_textures.GetItemR(desc.textures[i]);
+
+                    if (desc.textureViewIndices.empty())
+                        imgInfo.imageView = txt.imgViews[0];
+                    else
+                        imgInfo.imageView = txt.imgViews[desc.textureViewIndices[i]];
+
+                    imgInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                }
 
-                imgInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imgInfos[j] = imgInfo;
             }
 
-            imgInfos.push_back(imgInfo);
+            write.dstArrayElement = batchStart;
+            write.descriptorCount = batchCount;
+            vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
         }
-
-        VkWriteDescriptorSet write = {};
-        write.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        write.pNext                = nullptr;
-        write.dstSet               = m_descriptorSets.GetItemR(desc.setHandle).sets[desc.setAllocationIndex];
-        write.dstBinding           = desc.binding;
-        write.descriptorCount      = usedCount;
-        write.descriptorType       = descriptorType;
-        write.pImageInfo           = imgInfos.data();
-        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
     }
 
     uint16 VKBackend::CreatePipelineLayout(const PipelineLayoutDesc& desc)
     {
+        const uint16 handle = m_pipelineLayouts.AddItem({});
+        if (handle == m_pipelineLayouts.InvalidHandle)
+            return handle;
+
         VKBPipelineLayout item = {};
         item.isValid           = true;
 
@@ -1915,7 +2240,8 @@ namespace LinaGX
         pipelineLayoutInfo.pPushConstantRanges        = constants.data();
         VkResult res                                  = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, m_allocator, &item.ptr);
         VK_NAME_OBJECT(item.ptr, VK_OBJECT_TYPE_PIPELINE_LAYOUT, desc.debugName, name);
-        return m_pipelineLayouts.AddItem(item);
+        m_pipelineLayouts.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyPipelineLayout(uint16 layout)
@@ -1937,9 +2263,14 @@ namespace LinaGX
 
     uint32 VKBackend::CreateCommandStream(const CommandStreamDesc& desc)
     {
+        const uint32 handle = m_cmdStreams.AddItem({});
+        if (handle == m_cmdStreams.InvalidHandle)
+            return handle;
+
         VKBCommandStream item = {};
-        item.isValid          = true;
-        item.type             = desc.type;
+        item.isValid              = true;
+        item.type                 = desc.type;
+        item.coalesceIndexedDraws = desc.coalesceIndexedDraws;
 
         const uint32 familyIndex = m_queueData[desc.type == CommandType::Secondary ? (uint32)CommandType::Graphics : (uint32)desc.type].second.familyIndex;
 
@@ -1964,7 +2295,8 @@ namespace LinaGX
         VK_CHECK_RESULT(result, "Failed allocating command buffers");
 
         VK_NAME_OBJECT(item.buffer, VK_OBJECT_TYPE_COMMAND_BUFFER, desc.debugName, nameInfo);
-        return m_cmdStreams.AddItem(item);
+        m_cmdStreams.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyCommandStream(uint32 handle)
@@ -1976,12 +2308,12 @@ namespace LinaGX
             return;
         }
 
-        for (const auto& [id, frame] : stream.intermediateResources)
-            DestroyResource(id);
-
-        stream.intermediateResources.clear();
         stream.isValid = false;
         vkDestroyCommandPool(m_device, stream.pool, m_allocator);
+
+        if (stream.indirectMapped != nullptr)
+            DestroyResource(stream.indirectBuffer);
+
         m_cmdStreams.RemoveItem(handle);
     }
 
@@ -1993,43 +2325,174 @@ namespace LinaGX
 
     void VKBackend::CloseCommandStreams(CommandStream** streams, uint32 streamCount)
     {
+        // Streams may be closed from several threads at once, each keeps its own lists so they don't allocate every frame.
+        static thread_local LINAGX_VEC<CommandStream*> closeSecondaries;
+        static thread_local LINAGX_VEC<CommandStream*> closePrimaries;
+        closeSecondaries.clear();
+        closePrimaries.clear();
 
         for (uint32 i = 0; i < streamCount; i++)
         {
-            auto  stream = streams[i];
-            auto& sr     = m_cmdStreams.GetItemR(stream->m_gpuHandle);
-            auto  buffer = sr.buffer;
-            auto  pool   = sr.pool;
+            CommandStream* stream = streams[i];
 
-            if (stream->m_commandCount == 0)
+            if (stream->m_type == CommandType::Secondary)
+            {
+                closeSecondaries.push_back(stream);
+                continue;
+            }
+
+            closePrimaries.push_back(stream);
+
+            if (NeedsTranslation(stream, m_currentFrameIndex) && stream->HasAnyCommand(1ull << CMDID_ExecuteSecondaryStream))
+                InheritRenderPasses(stream);
+        }
+
+        // Translation jobs only write into the coalesced draw buffers, they are created on this thread.
+        for (uint32 i = 0; i < streamCount; i++)
+        {
+            if (NeedsTranslation(streams[i], m_currentFrameIndex))
+                ReserveCoalescedDraws(streams[i]);
+        }
+
+        // Staging buffer creation adds to the shared resource list.
+        const uint64 serialCommandMask = 1ull << CMDID_CopyBufferToTexture2D;
+
+        if (closeSecondaries.empty())
+        {
+            TranslateCommandStreams(streams, streamCount, serialCommandMask, m_currentFrameIndex);
+            return;
+        }
+
+        // Secondary streams have to be recorded before vkCmdExecuteCommands references them, each group is still translated concurrently.
+        TranslateCommandStreams(closeSecondaries.data(), static_cast<uint32>(closeSecondaries.size()), serialCommandMask, m_currentFrameIndex);
+        TranslateCommandStreams(closePrimaries.data(), static_cast<uint32>(closePrimaries.size()), serialCommandMask, m_currentFrameIndex);
+    }
+
+    void VKBackend::TranslateCommandStream(CommandStream* stream)
+    {
+        auto& sr     = m_cmdStreams.GetItemR(stream->m_gpuHandle);
+        auto  buffer = sr.buffer;
+        auto  pool   = sr.pool;
+
+        if (stream->m_commandCount == 0)
+            return;
+
+        vkResetCommandPool(m_device, pool, 0);
+        stream->m_scratchArena.Reset();
+
+        const bool isSecondary = sr.type == CommandType::Secondary;
+        const bool continues   = isSecondary && sr.inheritsRenderPass;
+
+        if (isSecondary && !continues && stream->HasAnyCommand((1ull << CMDID_DrawInstanced) | (1ull << CMDID_DrawIndexedInstanced) | (1ull << CMDID_DrawIndexedIndirect) | (1ull << CMDID_DrawIndirect)))
+        {
+            LOGE("Backend -> Secondary stream records draws but no stream closed together with it executes it within a render pass!");
+        }
+
+        // Secondary streams executed within a render pass continue it, they are recorded against its attachment formats.
+        VkCommandBufferInheritanceRenderingInfo renderingInheritance = VkCommandBufferInheritanceRenderingInfo{};
+        renderingInheritance.sType                                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+        renderingInheritance.pNext                                   = nullptr;
+        renderingInheritance.colorAttachmentCount                    = static_cast<uint32>(sr.inheritedColorFormats.size());
+        renderingInheritance.pColorAttachmentFormats                 = sr.inheritedColorFormats.data();
+        renderingInheritance.depthAttachmentFormat                   = sr.inheritedDepthFormat;
+        renderingInheritance.stencilAttachmentFormat                 = sr.inheritedStencilFormat;
+        renderingInheritance.rasterizationSamples                    = sr.inheritedSamples;
+
+        VkCommandBufferInheritanceInfo inheritance = VkCommandBufferInheritanceInfo{};
+        inheritance.sType                          = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.pNext                          = continues ? &renderingInheritance : nullptr;
+
+        VkCommandBufferBeginInfo beginInfo = VkCommandBufferBeginInfo{};
+        beginInfo.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext                    = nullptr;
+        beginInfo.flags                    = stream->m_isPersistent ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // Persistent buffers are resubmitted while the previous frames' submissions may still be pending.
+        beginInfo.pInheritanceInfo         = isSecondary ? &inheritance : nullptr;
+
+        if (continues)
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+
+        VkResult res = vkBeginCommandBuffer(buffer, &beginInfo);
+        VK_CHECK_RESULT(res, "Failed beginning command buffer.");
+
+        sr.boundShader             = 0;
+        sr.boundShaderUsesDrawID   = false;
+        sr.indirectHead            = 0;
+        sr.pendingDrawCount        = 0;
+        sr.passExecutesSecondaries = false;
+        sr.usesStagingRing         = false;
+        sr.writtenQueries.clear();
+        sr.mergedBarriers          = 0;
+        sr.layoutUses.clear();
+        sr.initialLayouts.clear();
+        sr.finalLayouts.clear();
+        sr.swapchainLayouts.clear();
+
+        // Dynamic state isn't inherited from the executing stream.
+        if (continues)
+        {
+            CMD_SetViewport((uint8*)&sr.inheritedViewport, sr);
+            CMD_SetScissors((uint8*)&sr.inheritedScissors, sr);
+        }
+
+        RedundantStateFilter stateFilter;
+        uint64               elidedCount = 0;
+        const bool           coalesce    = sr.coalesceIndexedDraws && m_supportsMultiDrawIndirect;
+
+        for (uint32 i = 0; i < stream->m_commandCount; i++)
+        {
+            uint8*        data = stream->m_commands[i];
+            LINAGX_TYPEID tid  = 0;
+            LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
+            const size_t increment = sizeof(CommandHeader);
+            uint8*       cmd       = data + increment;
+
+            if (Config.eliminateRedundantState && stateFilter.IsRedundant(tid, cmd))
+            {
+                elidedCount++;
                 continue;
+            }
 
-            vkResetCommandPool(m_device, pool, 0);
+            // Consecutive barriers are merged, anything else that reaches the command buffer has to see them first.
+            if (tid != CMDID_Barrier)
+                FlushBarriers(sr);
 
-            VkCommandBufferBeginInfo beginInfo = VkCommandBufferBeginInfo{};
-            beginInfo.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.pNext                    = nullptr;
-            beginInfo.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            beginInfo.pInheritanceInfo         = nullptr;
-            VkResult res                       = vkBeginCommandBuffer(buffer, &beginInfo);
-            VK_CHECK_RESULT(res, "Failed beginning command buffer.");
+            if (coalesce)
+            {
+                // Elided commands above don't break a run, anything else that reaches the command buffer does.
+                if (tid == CMDID_DrawIndexedInstanced && !sr.boundShaderUsesDrawID)
+                {
+                    CoalesceIndexedDraw(reinterpret_cast<CMDDrawIndexedInstanced*>(cmd), sr);
+                    continue;
+                }
 
-            sr.boundShader = 0;
+                FlushCoalescedDraws(sr);
+            }
 
-            for (uint32 i = 0; i < stream->m_commandCount; i++)
+            if (tid == CMDID_ExecuteSecondaryStream)
             {
-                uint8*        data = stream->m_commands[i];
-                LINAGX_TYPEID tid  = 0;
-                LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
-                const size_t increment = sizeof(LINAGX_TYPEID);
-                uint8*       cmd       = data + increment;
-                auto         it        = LINAGX_FIND_IF(m_cmdFunctions.begin(), m_cmdFunctions.end(), [tid](const LINAGX_PAIR<LINAGX_TYPEID, CommandFunction>& pair) -> bool { return pair.first == tid; });
-                (this->*(it->second))(cmd, sr);
+                i = ExecuteSecondaryStreams(stream, i, sr);
+                continue;
             }
 
-            res = vkEndCommandBuffer(buffer);
-            VK_CHECK_RESULT(res, "Failed ending command buffer!");
+            if (tid == CMDID_BeginRenderPass && stream->HasAnyCommand(1ull << CMDID_ExecuteSecondaryStream))
+                sr.passExecutesSecondaries = PassExecutesSecondaries(stream, i);
+
+            (this->*m_cmdFunctions[tid])(cmd, sr);
         }
+
+        if (coalesce)
+            FlushCoalescedDraws(sr);
+
+        FlushBarriers(sr);
+
+        if (elidedCount != 0)
+            PerformanceStats.elidedCommands.fetch_add(elidedCount, std::memory_order_relaxed);
+
+        if (sr.mergedBarriers != 0)
+            PerformanceStats.mergedBarriers.fetch_add(sr.mergedBarriers, std::memory_order_relaxed);
+
+        res = vkEndCommandBuffer(buffer);
+        VK_CHECK_RESULT(res, "Failed ending command buffer!");
     }
 
     void VKBackend::SubmitCommandStreams(const SubmitDesc& desc)
@@ -2039,9 +2502,6 @@ namespace LinaGX
         auto  it       = LINAGX_FIND_IF(m_flagsPerQueue.begin(), m_flagsPerQueue.end(), [&](const LINAGX_PAIR<VkQueue, std::atomic_flag*>& pair) -> bool { return pair.first == queue.queue; });
         auto  flag     = it->second;
 
-        LINAGX_VEC<VkSubmitInfo> submitInfos;
-        submitInfos.resize(desc.streamCount);
-
         if (Config.multithreadedQueueSubmission)
         {
             // spinlock
@@ -2052,9 +2512,14 @@ namespace LinaGX
 
         queue.wasSubmitted[m_currentFrameIndex] = true;
 
-        auto&                       frame = m_perFrameData[m_currentFrameIndex];
-        LINAGX_VEC<VkCommandBuffer> _buffers;
-        LINAGX_VEC<uint8>           writesToSwapchains;
+        // Everything below is consumed by vkQueueSubmit, so the queue's scratch only needs to live until then.
+        PagedLinearAllocator& scratch = *queue.submitScratch;
+        scratch.Reset();
+
+        auto&            frame               = m_perFrameData[m_currentFrameIndex];
+        VkCommandBuffer* buffers             = scratch.AllocateArray<VkCommandBuffer>(desc.streamCount * 2);
+        uint32           bufferCount         = 0;
+        uint32           swapchainWriteCount = 0;
 
         // Push all valid command buffers into a list.
         for (uint32 i = 0; i < desc.streamCount; i++)
@@ -2069,65 +2534,108 @@ namespace LinaGX
             auto& str = m_cmdStreams.GetItemR(stream->m_gpuHandle);
             LOGA(str.type != CommandType::Secondary, "Backend -> Can not submit command streams of type Secondary directly to the queues! Use CMDExecuteSecondary instead!");
 
-            _buffers.push_back(str.buffer);
+            // Brings the textures into the layouts the stream was recorded against, if streams submitted in between left them in others.
+            if (VkCommandBuffer fixup = ResolveLayouts(str, queuePfd, scratch))
+                buffers[bufferCount++] = fixup;
 
-            if (!str.swapchainWrites.empty())
-                writesToSwapchains.insert(writesToSwapchains.end(), str.swapchainWrites.begin(), str.swapchainWrites.end());
+            buffers[bufferCount++] = str.buffer;
+            swapchainWriteCount += static_cast<uint32>(str.swapchainWrites.size());
 
-            str.swapchainWrites.clear();
+            // Streams are translated concurrently, query state is only touched once they are submitted.
+            if (!str.writtenQueries.empty())
+            {
+                std::lock_guard<std::mutex> lock(m_queryWriteMtx);
+                for (const auto& [handle, slot] : str.writtenQueries)
+                    m_queryPools.GetItemR(handle).written[slot] = 1;
+            }
         }
 
-        VkPipelineStageFlags             waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        LINAGX_VEC<VkSemaphore>          waitSemaphores;
-        LINAGX_VEC<VkPipelineStageFlags> waitStages;
-        LINAGX_VEC<VkSemaphore>          signalSemaphores;
-        LINAGX_VEC<uint64>               waitSemaphoreValues;
-        LINAGX_VEC<uint64>               signalSemaphoreValues;
+        // Worst case: one wait per swapchain write and user semaphore, two internal signals plus user semaphores.
+        const uint32          maxWaits              = swapchainWriteCount + (desc.useWait ? desc.waitCount : 0);
+        const uint32          maxSignals            = 2 + (desc.useSignal ? desc.signalCount : 0);
+        VkPipelineStageFlags  waitStage             = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        VkSemaphore*          waitSemaphores        = scratch.AllocateArray<VkSemaphore>(maxWaits);
+        VkPipelineStageFlags* waitStages            = scratch.AllocateArray<VkPipelineStageFlags>(maxWaits);
+        uint64*               waitSemaphoreValues   = scratch.AllocateArray<uint64>(maxWaits);
+        VkSemaphore*          signalSemaphores      = scratch.AllocateArray<VkSemaphore>(maxSignals);
+        uint64*               signalSemaphoreValues = scratch.AllocateArray<uint64>(maxSignals);
+        uint32                waitCount             = 0;
+        uint32                signalCount           = 0;
 
         if (queue.type == CommandType::Compute && (m_supportsDedicatedComputeQueue || m_supportsSeparateComputeQueue))
             waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
         else if (queue.type == CommandType::Transfer && (m_supportsDedicatedTransferQueue || m_supportsSeparateTransferQueue))
             waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 
-        // If its a graphics queue, we will have to wait on it during StartFrame() for the next frame-in-flight availability.
+        // Every queue is waited on during StartFrame() for the next frame-in-flight availability, so objects used by any of them are retired correctly.
         // Thus, we need to signal its stored semaphore value.
-        if (queue.type == CommandType::Graphics)
+        queue.frameSemaphoreValue++;
+        queuePfd.storedStartFrameSemaphoreValue = queue.frameSemaphoreValue;
+        queuePfd.storedFrameTimelineValue       = SignalFrameTimeline();
+        signalSemaphores[signalCount]           = queuePfd.startFrameWaitSemaphore;
+        signalSemaphoreValues[signalCount++]    = queuePfd.storedStartFrameSemaphoreValue;
+
+        // Staging rings read by this submission are rewound only after it completed, it might belong to a different frame index than the ring.
+        for (uint32 i = 0; i < desc.streamCount; i++)
         {
-            queue.frameSemaphoreValue++;
-            queuePfd.storedStartFrameSemaphoreValue = queue.frameSemaphoreValue;
-            signalSemaphores.push_back(queuePfd.startFrameWaitSemaphore);
-            signalSemaphoreValues.push_back(queuePfd.storedStartFrameSemaphoreValue);
+            if (desc.streams[i]->m_commandCount == 0)
+                continue;
+
+            const auto& str = m_cmdStreams.GetItemR(desc.streams[i]->m_gpuHandle);
+            if (!str.usesStagingRing)
+                continue;
+
+            std::lock_guard<std::mutex> lock(m_stagingRingMtx);
+            auto&                       waits = m_perFrameData[str.stagingRingFrame].stagingRingWaits;
+            auto                        wait  = LINAGX_FIND_IF(waits.begin(), waits.end(), [&](const LINAGX_PAIR<VkSemaphore, uint64>& pair) -> bool { return pair.first == queuePfd.startFrameWaitSemaphore; });
+
+            if (wait == waits.end())
+                waits.push_back({queuePfd.startFrameWaitSemaphore, queuePfd.storedStartFrameSemaphoreValue});
+            else
+                wait->second = queuePfd.storedStartFrameSemaphoreValue;
         }
 
         // If graphics queue, we need to signal a binary semaphore, so that we can wait on it during presentation.
         // Also need to wait for all images to be acquired.
-        if (queue.type == CommandType::Graphics && !writesToSwapchains.empty())
+        if (queue.type == CommandType::Graphics && swapchainWriteCount != 0)
         {
-            for (auto swp : writesToSwapchains)
+            for (uint32 i = 0; i < desc.streamCount; i++)
             {
-                auto& swap = m_swapchains.GetItemR(swp);
+                if (desc.streams[i]->m_commandCount == 0)
+                    continue;
 
-                waitSemaphores.push_back(swap.imageAcquiredSemaphores[m_currentFrameIndex]);
-                waitStages.push_back(waitStage);
-                waitSemaphoreValues.push_back(0); // ignored binary semaphore.
-                swap._submittedQueue          = desc.targetQueue;
-                swap._submittedSemaphoreIndex = queuePfd.submitSemaphoreIndex;
+                for (auto swp : m_cmdStreams.GetItemR(desc.streams[i]->m_gpuHandle).swapchainWrites)
+                {
+                    auto& swap = m_swapchains.GetItemR(swp);
+
+                    waitSemaphores[waitCount]        = swap.imageAcquiredSemaphores[m_currentFrameIndex];
+                    waitStages[waitCount]            = waitStage;
+                    waitSemaphoreValues[waitCount++] = 0; // ignored binary semaphore.
+                    swap._submittedQueue             = desc.targetQueue;
+                    swap._submittedSemaphoreIndex    = queuePfd.submitSemaphoreIndex;
+                }
             }
 
-            signalSemaphores.push_back(queuePfd.submitSemaphoreBuffer[queuePfd.submitSemaphoreIndex]);
-            signalSemaphoreValues.push_back(0);
+            signalSemaphores[signalCount]        = queuePfd.submitSemaphoreBuffer[queuePfd.submitSemaphoreIndex];
+            signalSemaphoreValues[signalCount++] = 0;
             queuePfd.submitSemaphoreIndex++;
         }
 
+        for (uint32 i = 0; i < desc.streamCount; i++)
+        {
+            if (desc.streams[i]->m_commandCount != 0)
+                m_cmdStreams.GetItemR(desc.streams[i]->m_gpuHandle).swapchainWrites.clear();
+        }
+
         // This is for USER signal mechanisms.
         {
             if (desc.useWait)
             {
                 for (uint32 i = 0; i < desc.waitCount; i++)
                 {
-                    waitSemaphores.push_back(m_userSemaphores.GetItem(desc.waitSemaphores[i]).ptr);
-                    waitSemaphoreValues.push_back(desc.waitValues[i]);
-                    waitStages.push_back(waitStage);
+                    waitSemaphores[waitCount]        = m_userSemaphores.GetItemR(desc.waitSemaphores[i]).ptr;
+                    waitStages[waitCount]            = waitStage;
+                    waitSemaphoreValues[waitCount++] = desc.waitValues[i];
                 }
             }
 
@@ -2135,8 +2643,8 @@ namespace LinaGX
             {
                 for (uint32 i = 0; i < desc.signalCount; i++)
                 {
-                    signalSemaphores.push_back(m_userSemaphores.GetItem(desc.signalSemaphores[i]).ptr);
-                    signalSemaphoreValues.push_back(desc.signalValues[i]);
+                    signalSemaphores[signalCount]        = m_userSemaphores.GetItemR(desc.signalSemaphores[i]).ptr;
+                    signalSemaphoreValues[signalCount++] = desc.signalValues[i];
                 }
             }
         }
@@ -2144,21 +2652,21 @@ namespace LinaGX
         VkTimelineSemaphoreSubmitInfo timelineInfo;
         timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
         timelineInfo.pNext                     = NULL;
-        timelineInfo.waitSemaphoreValueCount   = static_cast<uint32>(waitSemaphores.size());
-        timelineInfo.pWaitSemaphoreValues      = waitSemaphoreValues.data();
-        timelineInfo.signalSemaphoreValueCount = static_cast<uint32>(signalSemaphores.size());
-        timelineInfo.pSignalSemaphoreValues    = signalSemaphoreValues.data();
+        timelineInfo.waitSemaphoreValueCount   = waitCount;
+        timelineInfo.pWaitSemaphoreValues      = waitSemaphoreValues;
+        timelineInfo.signalSemaphoreValueCount = signalCount;
+        timelineInfo.pSignalSemaphoreValues    = signalSemaphoreValues;
 
         VkSubmitInfo submitInfo;
         submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.pNext                = &timelineInfo;
-        submitInfo.waitSemaphoreCount   = static_cast<uint32>(waitSemaphores.size());
-        submitInfo.pWaitSemaphores      = waitSemaphores.data();
-        submitInfo.signalSemaphoreCount = static_cast<uint32>(signalSemaphores.size());
-        submitInfo.pSignalSemaphores    = signalSemaphores.data();
-        submitInfo.commandBufferCount   = desc.streamCount;
-        submitInfo.pCommandBuffers      = _buffers.data();
-        submitInfo.pWaitDstStageMask    = waitStages.data();
+        submitInfo.waitSemaphoreCount   = waitCount;
+        submitInfo.pWaitSemaphores      = waitSemaphores;
+        submitInfo.signalSemaphoreCount = signalCount;
+        submitInfo.pSignalSemaphores    = signalSemaphores;
+        submitInfo.commandBufferCount   = bufferCount;
+        submitInfo.pCommandBuffers      = buffers;
+        submitInfo.pWaitDstStageMask    = waitStages;
 
         LOGA((frame.submissionCount < Config.gpuLimits.maxSubmitsPerFrame + 1), "Backend -> Exceeded maximum submissions per frame! Please increase the limit.");
 
@@ -2171,6 +2679,10 @@ namespace LinaGX
 
     uint8 VKBackend::CreateQueue(const QueueDesc& desc)
     {
+        const uint8 handle = m_queues.AddItem({});
+        if (handle == m_queues.InvalidHandle)
+            return handle;
+
         VkQueue targetQueue = nullptr;
 
         if (desc.type == CommandType::Transfer)
@@ -2225,12 +2737,22 @@ namespace LinaGX
                 res = vkCreateSemaphore(m_device, &info, m_allocator, &pfd.submitSemaphoreBuffer[j]);
                 VK_CHECK_RESULT(res, "Failed creating semaphore.");
             }
+
+            VkCommandPoolCreateInfo fixupPoolInfo = VkCommandPoolCreateInfo{};
+            fixupPoolInfo.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            fixupPoolInfo.pNext                   = nullptr;
+            fixupPoolInfo.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            fixupPoolInfo.queueFamilyIndex        = m_queueData[static_cast<uint32>(desc.type)].second.familyIndex;
+            res                                   = vkCreateCommandPool(m_device, &fixupPoolInfo, m_allocator, &pfd.fixupPool);
+            VK_CHECK_RESULT(res, "Failed creating command pool");
         }
 
-        item.queue = targetQueue;
+        item.queue         = targetQueue;
+        item.submitScratch = new PagedLinearAllocator(1024, AllocationTag::Backend);
         item.wasSubmitted.resize(Config.framesInFlight);
 
-        return m_queues.AddItem(item);
+        m_queues.GetItemR(handle) = item;
+        return handle;
     }
 
     void VKBackend::DestroyQueue(uint8 queue)
@@ -2242,6 +2764,16 @@ namespace LinaGX
             return;
         }
 
+        // Staging rings stop waiting on the semaphores destroyed below, the queue is required to be idle by now.
+        {
+            std::lock_guard<std::mutex> lock(m_stagingRingMtx);
+            for (auto& frame : m_perFrameData)
+            {
+                auto& waits = frame.stagingRingWaits;
+                waits.erase(std::remove_if(waits.begin(), waits.end(), [&](const LINAGX_PAIR<VkSemaphore, uint64>& pair) -> bool { return LINAGX_FIND_IF(item.pfd.begin(), item.pfd.end(), [&](const VKBQueuePerFrameData& pfd) -> bool { return pfd.startFrameWaitSemaphore == pair.first; }) != item.pfd.end(); }), waits.end());
+            }
+        }
+
         for (uint32 i = 0; i < Config.framesInFlight; i++)
         {
             auto& pfd = item.pfd[i];
@@ -2251,8 +2783,11 @@ namespace LinaGX
             const uint32 submitSemaphoreSz = Config.gpuLimits.maxSubmitsPerFrame / 2;
             for (uint32 j = 0; j < submitSemaphoreSz; j++)
                 vkDestroySemaphore(m_device, pfd.submitSemaphoreBuffer[j], m_allocator);
+
+            vkDestroyCommandPool(m_device, pfd.fixupPool, m_allocator);
         }
 
+        delete item.submitScratch;
         m_queues.RemoveItem(queue);
     }
 
@@ -2263,17 +2798,333 @@ namespace LinaGX
         return it->second;
     }
 
-    uint16 VKBackend::CreateFence()
+    bool VKBackend::LoadPipelineCache(const uint8* data, size_t size)
     {
-        VkFence           fence = nullptr;
-        VkFenceCreateInfo info  = VkFenceCreateInfo{};
-        info.sType              = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        info.pNext              = nullptr;
+        // Drivers are free to reject foreign data in vkCreatePipelineCache, but not all of them do, validate the header against this device first.
+        VkPipelineCacheHeaderVersionOne header = {};
+        if (data == nullptr || size < sizeof(VkPipelineCacheHeaderVersionOne))
+        {
+            LOGE("Backend -> Pipeline cache data is too small to contain a header!");
+            return false;
+        }
+
+        LINAGX_MEMCPY(&header, data, sizeof(VkPipelineCacheHeaderVersionOne));
+
+        if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+        {
+            LOGE("Backend -> Pipeline cache header is not valid, ignoring the cache!");
+            return false;
+        }
+
+        if (header.vendorID != m_gpuProperties.vendorID || header.deviceID != m_gpuProperties.deviceID || std::memcmp(header.pipelineCacheUUID, m_gpuProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            LOGT("Backend -> Pipeline cache was created by a different device or driver, ignoring the cache.");
+            return false;
+        }
+
+        VkPipelineCacheCreateInfo info = VkPipelineCacheCreateInfo{};
+        info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        info.pNext                     = nullptr;
+        info.flags                     = 0;
+        info.initialDataSize           = size;
+        info.pInitialData              = data;
+
+        VkPipelineCache loaded = nullptr;
+        VkResult        res    = vkCreatePipelineCache(m_device, &info, m_allocator, &loaded);
+        if (res != VK_SUCCESS)
+        {
+            LOGE("Backend -> Failed creating pipeline cache from data! %s", LinaGX_VkErr(res).c_str());
+            return false;
+        }
+
+        // Merge instead of replacing, so pipelines created before loading are kept in the cache.
+        res = vkMergePipelineCaches(m_device, m_pipelineCache, 1, &loaded);
+        vkDestroyPipelineCache(m_device, loaded, m_allocator);
+        if (res != VK_SUCCESS)
+        {
+            LOGE("Backend -> Failed merging pipeline caches! %s", LinaGX_VkErr(res).c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool VKBackend::GetPipelineCacheData(LINAGX_VEC<uint8>& outData)
+    {
+        size_t   size = 0;
+        VkResult res  = vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr);
+        if (res != VK_SUCCESS)
+        {
+            LOGE("Backend -> Failed querying pipeline cache size! %s", LinaGX_VkErr(res).c_str());
+            return false;
+        }
+
+        outData.resize(size);
+        res = vkGetPipelineCacheData(m_device, m_pipelineCache, &size, outData.data());
+        if (res != VK_SUCCESS)
+        {
+            LOGE("Backend -> Failed retrieving pipeline cache data! %s", LinaGX_VkErr(res).c_str());
+            return false;
+        }
+
+        outData.resize(size);
+        return true;
+    }
+
+    uint16 VKBackend::CreateQueryPool(const QueryPoolDesc& desc)
+    {
+        const uint16 handle = m_queryPools.AddItem({});
+        if (handle == m_queryPools.InvalidHandle)
+            return handle;
+
+        if (desc.type == QueryType::Timestamp && m_gpuProperties.limits.timestampComputeAndGraphics == VK_FALSE)
+            LOGE("Backend -> Device doesn't support timestamps on graphics & compute queues, queries will never be available!");
+
+        if (desc.type == QueryType::PipelineStatistics && !m_supportsPipelineStatistics)
+            LOGE("Backend -> Pipeline statistics queries require VKF_PipelineStats!");
+
+        VKBQueryPool item = {};
+        item.isValid      = true;
+        item.type         = desc.type;
+        item.queryCount   = desc.queryCount;
+        item.stride       = (desc.type == QueryType::PipelineStatistics ? sizeof(PipelineStatistics) / sizeof(uint64) : 1) + 1;
+        item.raw.resize(desc.queryCount * item.stride);
+        item.values.resize(desc.queryCount, 0);
+        item.statistics.resize(desc.type == QueryType::PipelineStatistics ? desc.queryCount : 0);
+        item.available.resize(desc.queryCount, 0);
+        item.written.resize(desc.queryCount * Config.framesInFlight, 0);
+
+        VkQueryPoolCreateInfo info = VkQueryPoolCreateInfo{};
+        info.sType                 = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.pNext                 = nullptr;
+        info.flags                 = 0;
+        info.queryType             = GetVKQueryType(desc.type);
+        info.queryCount            = desc.queryCount * Config.framesInFlight;
+
+        // Results are written in bit order, which is the member order of PipelineStatistics.
+        if (desc.type == QueryType::PipelineStatistics)
+            info.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+                                      VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+        VkResult res = vkCreateQueryPool(m_device, &info, m_allocator, &item.ptr);
+        VK_CHECK_RESULT(res, "Backend -> Could not create query pool!");
+        VK_NAME_OBJECT(item.ptr, VK_OBJECT_TYPE_QUERY_POOL, desc.debugName, qinfo);
+
+        // Queries must be reset before their first use, host reset keeps it out of the command streams. Otherwise ResolveLayouts() resets them on submission.
+        if (m_supportsHostQueryReset)
+            vkResetQueryPool(m_device, item.ptr, 0, info.queryCount);
+        m_queryPools.GetItemR(handle) = item;
+        return handle;
+    }
+
+    void VKBackend::DestroyQueryPool(uint16 handle)
+    {
+        auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool to be destroyed is not valid!");
+            return;
+        }
+
+        vkDestroyQueryPool(m_device, item.ptr, m_allocator);
+        m_queryPools.RemoveItem(handle);
+    }
+
+    bool VKBackend::GetQueryResults(uint16 handle, QueryResults& outResults)
+    {
+        const auto& item = m_queryPools.GetItemR(handle);
+        if (!item.isValid)
+        {
+            LOGE("Backend -> Query pool is not valid!");
+            return false;
+        }
+
+        outResults.values     = item.values.data();
+        outResults.statistics = item.statistics.empty() ? nullptr : item.statistics.data();
+        outResults.available  = item.available.data();
+        outResults.queryCount = item.queryCount;
+        return true;
+    }
+
+    uint16 VKBackend::CreateTransientTextureGroup(const TransientTextureGroupDesc& desc, TransientTextureGroupInfo& outInfo)
+    {
+        const uint16 handle = m_transientGroups.AddItem({});
+        if (handle == m_transientGroups.InvalidHandle)
+            return handle;
+
+        VKBTransientTextureGroup group = {};
+        group.isValid                  = true;
+        outInfo                        = {};
+
+        const uint32                    count = static_cast<uint32>(desc.textures.size());
+        LINAGX_VEC<VKBTexture2D>        items(count);
+        LINAGX_VEC<TransientAllocation> allocations(count);
+        LINAGX_VEC<TransientBlock>      blocks;
+
+        // Texture handles are reserved before any image is created, so running out of them leaks nothing.
+        for (uint32 i = 0; i < count; i++)
+        {
+            const uint32 txtHandle = m_textures.AddItem({});
+            if (txtHandle == m_textures.InvalidHandle)
+            {
+                for (auto reserved : group.textures)
+                    m_textures.RemoveItem(reserved);
+                m_transientGroups.RemoveItem(handle);
+                return m_transientGroups.InvalidHandle;
+            }
+            group.textures.push_back(txtHandle);
+        }
+
+        // Images are created without memory first, so the shared blocks can be sized from their requirements.
+        for (uint32 i = 0; i < count; i++)
+        {
+            const auto&       txt           = desc.textures[i];
+            VkImageCreateInfo imgCreateInfo = {};
+            FillTextureCreateInfo(txt.desc, items[i], imgCreateInfo);
+            items[i].isTransient = true;
+
+            VkResult res = vkCreateImage(m_device, &imgCreateInfo, m_allocator, &items[i].img);
+            VK_CHECK_RESULT(res, "Failed creating transient image.");
+
+            VkMemoryRequirements req = {};
+            vkGetImageMemoryRequirements(m_device, items[i].img, &req);
+
+            auto& alloc     = allocations[i];
+            alloc.size      = req.size;
+            alloc.alignment = req.alignment;
+            alloc.key       = req.memoryTypeBits;
+            alloc.firstUse  = txt.firstUse;
+            alloc.lastUse   = txt.lastUse;
+
+            outInfo.requiredSize += req.size;
+        }
+
+        PackTransientAllocations(allocations, blocks);
+
+        for (const auto& block : blocks)
+        {
+            VkMemoryRequirements req = {};
+            req.size                 = block.size;
+            req.alignment            = block.alignment;
+            req.memoryTypeBits       = block.key;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            allocInfo.requiredFlags           = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            VmaAllocation_T* allocation = nullptr;
+            VkResult         res        = vmaAllocateMemory(m_vmaAllocator, &req, &allocInfo, &allocation, nullptr);
+            VK_CHECK_RESULT(res, "Failed allocating transient texture memory.");
+            vmaSetAllocationName(m_vmaAllocator, allocation, desc.debugName);
+
+            group.blocks.push_back(allocation);
+            outInfo.allocatedSize += block.size;
+        }
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            const auto& txt   = desc.textures[i];
+            const auto& alloc = allocations[i];
+
+            VkResult res = vmaBindImageMemory2(m_vmaAllocator, group.blocks[alloc.block], alloc.offset, items[i].img, nullptr);
+            VK_CHECK_RESULT(res, "Failed binding transient image memory.");
+
+            VK_NAME_OBJECT(items[i].img, VK_OBJECT_TYPE_IMAGE, txt.desc.debugName, info);
+            CreateTextureViews(txt.desc, items[i]);
+            m_textures.GetItemR(group.textures[i]) = items[i];
+        }
+
+        LOGT("Backend -> Transient texture group %s placed %llu bytes of textures into %llu bytes.", desc.debugName, static_cast<unsigned long long>(outInfo.requiredSize), static_cast<unsigned long long>(outInfo.allocatedSize));
+
+        outInfo.textures = group.textures;
+        m_transientGroups.GetItemR(handle) = group;
+        return handle;
+    }
+
+    void VKBackend::DestroyTransientTextureGroup(uint16 handle)
+    {
+        auto& group = m_transientGroups.GetItemR(handle);
+        if (!group.isValid)
+        {
+            LOGE("Backend -> Transient texture group to be destroyed is not valid!");
+            return;
+        }
+
+        for (auto txtHandle : group.textures)
+        {
+            auto& txt = m_textures.GetItemR(txtHandle);
+
+            for (auto view : txt.imgViews)
+                vkDestroyImageView(m_device, view, m_allocator);
+
+            vkDestroyImage(m_device, txt.img, m_allocator);
+            txt.isValid = false;
+            m_textures.RemoveItem(txtHandle);
+        }
+
+        for (auto block : group.blocks)
+            vmaFreeMemory(m_vmaAllocator, block);
+
+        group.isValid = false;
+        m_transientGroups.RemoveItem(handle);
+    }
+
+    void VKBackend::ResolveQueries(uint32 frameIndex)
+    {
+        const double period = static_cast<double>(m_gpuProperties.limits.timestampPeriod);
+
+        for (auto& qp : m_queryPools)
+        {
+            if (!qp.isValid)
+                continue;
+
+            const uint32 first   = frameIndex * qp.queryCount;
+            uint8*       written = qp.written.data() + first;
+
+            // No wait flag, queries that weren't written in the frame simply report unavailable.
+            VkResult res = vkGetQueryPoolResults(m_device, qp.ptr, first, qp.queryCount, qp.raw.size() * sizeof(uint64), qp.raw.data(), qp.stride * sizeof(uint64), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+            if (res != VK_SUCCESS && res != VK_NOT_READY)
+            {
+                LOGE("Backend -> Failed reading query pool results! %s", LinaGX_VkErr(res).c_str());
+                continue;
+            }
+
+            for (uint32 i = 0; i < qp.queryCount; i++)
+            {
+                // Queries written in an earlier use of the frame index still report available if they weren't reset since.
+                const uint64* result = qp.raw.data() + i * qp.stride;
+                qp.available[i]      = written[i] && result[qp.stride - 1] != 0 ? 1 : 0;
+                written[i]           = 0;
+
+                if (qp.type == QueryType::PipelineStatistics)
+                    qp.statistics[i] = qp.available[i] ? *reinterpret_cast<const PipelineStatistics*>(result) : PipelineStatistics{};
+                else if (qp.type == QueryType::Timestamp)
+                    qp.values[i] = qp.available[i] ? static_cast<uint64>(static_cast<double>(result[0] & m_timestampMask) * period) : 0;
+                else
+                    qp.values[i] = qp.available[i] ? result[0] : 0;
+            }
+
+            if (m_supportsHostQueryReset)
+                vkResetQueryPool(m_device, qp.ptr, first, qp.queryCount);
+        }
+    }
+
+    uint16 VKBackend::CreateFence()
+    {
+        const uint16 handle = m_fences.AddItem({});
+        if (handle == m_fences.InvalidHandle)
+            return handle;
+
+        VkFence           fence = nullptr;
+        VkFenceCreateInfo info  = VkFenceCreateInfo{};
+        info.sType              = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        info.pNext              = nullptr;
         info.flags              = VK_FENCE_CREATE_SIGNALED_BIT;
 
         VkResult result = vkCreateFence(m_device, &info, m_allocator, &fence);
         VK_CHECK_RESULT(result, "Failed creating fence!");
-        return m_fences.AddItem(fence);
+        m_fences.GetItemR(handle) = fence;
+        return handle;
     }
 
     void VKBackend::DestroyFence(uint16 handle)
@@ -2353,6 +3204,16 @@ namespace LinaGX
             if (vulkan12Features.descriptorBindingSampledImageUpdateAfterBind && vulkan12Features.descriptorBindingUniformBufferUpdateAfterBind)
                 features |= VulkanFeatureFlags::VKF_UpdateAfterBind;
 
+            VkPhysicalDeviceVulkan13Features vulkan13Features = {};
+            vulkan13Features.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            VkPhysicalDeviceFeatures2 features2_3{};
+            features2_3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2_3.pNext = &vulkan13Features;
+            vkGetPhysicalDeviceFeatures2(device, &features2_3);
+
+            if (vulkan13Features.synchronization2)
+                features |= VulkanFeatureFlags::VKF_Synchronization2;
+
             return features;
         }
 
@@ -2373,9 +3234,16 @@ namespace LinaGX
             requiredExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
 
+        // Driver allocations go through Configuration::allocator, accounted under AllocationTag::Driver.
+        m_allocationCallbacks.pUserData       = nullptr;
+        m_allocationCallbacks.pfnAllocation   = VkAllocationFunction;
+        m_allocationCallbacks.pfnReallocation = VkReallocationFunction;
+        m_allocationCallbacks.pfnFree         = VkFreeFunction;
+        m_allocator                           = &m_allocationCallbacks;
+
         // Instance builder
         vkb::InstanceBuilder builder;
-        builder = builder.set_app_name(Config.appName).enable_validation_layers(Config.enableAPIDebugLayers).request_validation_layers(Config.enableAPIDebugLayers).require_api_version(LGX_VK_MAJOR, LGX_VK_MINOR, 0);
+        builder = builder.set_allocation_callbacks(m_allocator).set_app_name(Config.appName).enable_validation_layers(Config.enableAPIDebugLayers).request_validation_layers(Config.enableAPIDebugLayers).require_api_version(LGX_VK_MAJOR, LGX_VK_MINOR, 0);
 
         // Extensions
         for (auto ext : requiredExtensions)
@@ -2453,7 +3321,7 @@ namespace LinaGX
                 LOGE("Backend -> No device were found supporting Vulkan 1.2 Timeline Semaphores!");
 
                 if (m_debugMessenger != nullptr)
-                    vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger);
+                    vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger, m_allocator);
 
                 vkDestroyInstance(m_vkInstance, m_allocator);
 
@@ -2465,7 +3333,7 @@ namespace LinaGX
                 LOGE("Backend -> No device were found supporting Vulkan 1.3 Dynamic Rendering!");
 
                 if (m_debugMessenger != nullptr)
-                    vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger);
+                    vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger, m_allocator);
 
                 vkDestroyInstance(m_vkInstance, m_allocator);
 
@@ -2493,6 +3361,9 @@ namespace LinaGX
         if (Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_MultiDrawIndirect)
             features.multiDrawIndirect = true;
 
+        if (Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_PipelineStats)
+            features.pipelineStatisticsQuery = true;
+
         if (Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_Bindless)
         {
             features.shaderSampledImageArrayDynamicIndexing  = true;
@@ -2516,8 +3387,17 @@ namespace LinaGX
 
         // NV checkpoint debug VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME
 
-        vkb::PhysicalDeviceSelector      selector{inst};
-        vkb::Result<vkb::PhysicalDevice> phyRes = selector.set_minimum_version(LGX_VK_MAJOR, LGX_VK_MINOR).set_required_features_12(vk12Features).defer_surface_initialization().prefer_gpu_device_type(targetDeviceType).allow_any_gpu_device_type(false).set_required_features(features).select(vkb::DeviceSelectionMode::partially_and_fully_suitable);
+        // The device builder enables the features the selector required, selecting again is the only way to add optional ones.
+        auto selectDevice = [&](const VkPhysicalDeviceVulkan12Features& requiredFeatures12) -> vkb::Result<vkb::PhysicalDevice> {
+            vkb::PhysicalDeviceSelector selector{inst};
+
+            if (Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_ConditionalRendering)
+                selector.add_required_extension(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME);
+
+            return selector.set_minimum_version(LGX_VK_MAJOR, LGX_VK_MINOR).set_required_features_12(requiredFeatures12).defer_surface_initialization().prefer_gpu_device_type(targetDeviceType).allow_any_gpu_device_type(false).set_required_features(features).select(vkb::DeviceSelectionMode::partially_and_fully_suitable);
+        };
+
+        vkb::Result<vkb::PhysicalDevice> phyRes = selectDevice(vk12Features);
 
         vkb::PhysicalDevice physicalDevice;
 
@@ -2527,7 +3407,7 @@ namespace LinaGX
             LOGE("Backend -> Failed creating a physical device with requested features!");
 
             if (m_debugMessenger != nullptr)
-                vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger);
+                vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger, m_allocator);
 
             vkDestroyInstance(m_vkInstance, m_allocator);
 
@@ -2536,9 +3416,34 @@ namespace LinaGX
 
         physicalDevice = phyRes.value();
 
+        // Host query reset is optional, without it queries are reset from the command buffers submitted ahead of the streams writing them.
+        {
+            VkPhysicalDeviceVulkan12Features supported12 = {};
+            supported12.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+            VkPhysicalDeviceFeatures2 supported = {};
+            supported.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supported.pNext                     = &supported12;
+            vkGetPhysicalDeviceFeatures2(physicalDevice.physical_device, &supported);
+
+            if (supported12.hostQueryReset)
+            {
+                vk12Features.hostQueryReset                        = true;
+                vkb::Result<vkb::PhysicalDevice> hostQueryResetRes = selectDevice(vk12Features);
+                m_supportsHostQueryReset                           = hostQueryResetRes.has_value();
+
+                if (m_supportsHostQueryReset)
+                    physicalDevice = hostQueryResetRes.value();
+            }
+        }
+
         if (Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_MultiDrawIndirect)
             m_supportsMultiDrawIndirect = true;
 
+        m_supportsPipelineStatistics   = Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_PipelineStats;
+        m_supportsConditionalRendering = Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_ConditionalRendering;
+        m_supportsSynchronization2     = Config.vulkanConfig.enableVulkanFeatures & VulkanFeatureFlags::VKF_Synchronization2;
+
         // create the final Vulkan device
         vkb::DeviceBuilder                           deviceBuilder{physicalDevice};
         VkPhysicalDeviceShaderDrawParametersFeatures shaderDrawParamsFeature;
@@ -2555,6 +3460,21 @@ namespace LinaGX
             deviceBuilder.add_pNext(&mt);
         }
 
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalFeature = VkPhysicalDeviceConditionalRenderingFeaturesEXT{};
+        conditionalFeature.sType                                           = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+        conditionalFeature.conditionalRendering                            = VK_TRUE;
+
+        if (m_supportsConditionalRendering)
+            deviceBuilder.add_pNext(&conditionalFeature);
+
+        // Core in 1.3, per-barrier stage masks with vkCmdPipelineBarrier2.
+        VkPhysicalDeviceSynchronization2Features synchronization2Feature = VkPhysicalDeviceSynchronization2Features{};
+        synchronization2Feature.sType                                    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+        synchronization2Feature.synchronization2                         = VK_TRUE;
+
+        if (m_supportsSynchronization2)
+            deviceBuilder.add_pNext(&synchronization2Feature);
+
         // For using UPDATE_AFTER_BIND_BIT on material bindings - invalid after using VK12 Features
         // VkPhysicalDeviceDescriptorIndexingFeatures descFeatures    = VkPhysicalDeviceDescriptorIndexingFeatures{};
         // descFeatures.sType                                         = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
@@ -2667,7 +3587,7 @@ namespace LinaGX
 
         deviceBuilder.custom_queue_setup(queueDescs);
 
-        vkb::Device vkbDevice = deviceBuilder.build().value();
+        vkb::Device vkbDevice = deviceBuilder.set_allocation_callbacks(m_allocator).build().value();
         m_device              = vkbDevice.device;
         m_gpu                 = physicalDevice.physical_device;
 
@@ -2744,6 +3664,10 @@ namespace LinaGX
         gfx.queues.resize(Config.vulkanConfig.extraGraphicsQueueCount + 1);
         gfx.familyIndex = graphicsQueueFamilies[0];
 
+        // Timestamps are only written on graphics queues, bits above the valid ones are undefined.
+        const uint32 timestampValidBits = queueFamilies[gfx.familyIndex].timestampValidBits;
+        m_timestampMask                 = timestampValidBits >= 64 ? ~0ull : (1ull << timestampValidBits) - 1;
+
         for (uint32 i = 0; i < Config.vulkanConfig.extraGraphicsQueueCount + 1; i++)
         {
             if (get(graphicsQueueFamilies[0], queueIndicesAndOccupiedQueues) < queueFamilies[graphicsQueueFamilies[0]].queueCount)
@@ -2757,6 +3681,13 @@ namespace LinaGX
             }
         }
 
+        // Textures & resources are used across queues without ownership transfers, see RenderGraph.
+        for (const auto& [type, data] : m_queueData)
+        {
+            if (LINAGX_FIND_IF(m_sharedQueueFamilies.begin(), m_sharedQueueFamilies.end(), [&data](uint32 family) -> bool { return family == data.familyIndex; }) == m_sharedQueueFamilies.end())
+                m_sharedQueueFamilies.push_back(data.familyIndex);
+        }
+
         for (const auto& [type, data] : m_queueData)
         {
             for (auto q : data.queues)
@@ -2772,6 +3703,12 @@ namespace LinaGX
         g_vkSetDebugUtilsObjectNameEXT = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(vkGetDeviceProcAddr(m_device, "vkSetDebugUtilsObjectNameEXT"));
         g_vkCmdBeginDebugUtilsLabelEXT = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(vkGetDeviceProcAddr(m_device, "vkCmdBeginDebugUtilsLabelEXT"));
         g_vkCmdEndDebugUtilsLabelEXT   = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(vkGetDeviceProcAddr(m_device, "vkCmdEndDebugUtilsLabelEXT"));
+
+        if (m_supportsConditionalRendering)
+        {
+            g_vkCmdBeginConditionalRenderingEXT = reinterpret_cast<PFN_vkCmdBeginConditionalRenderingEXT>(vkGetDeviceProcAddr(m_device, "vkCmdBeginConditionalRenderingEXT"));
+            g_vkCmdEndConditionalRenderingEXT   = reinterpret_cast<PFN_vkCmdEndConditionalRenderingEXT>(vkGetDeviceProcAddr(m_device, "vkCmdEndConditionalRenderingEXT"));
+        }
         // g_vkCmdSetCheckpointNVEXT      = reinterpret_cast<PFN_vkCmdSetCheckpointNV>(vkGetDeviceProcAddr(m_device, "vkCmdSetCheckpointNV"));
         // g_vkCmdGetQueueCheckpointDataNVEXT = reinterpret_cast<PFN_vkGetQueueCheckpointDataNV>(vkGetDeviceProcAddr(m_device, "vkGetQueueCheckpointDataNV"));
 
@@ -2845,14 +3782,41 @@ namespace LinaGX
             allocatorInfo.physicalDevice         = m_gpu;
             allocatorInfo.device                 = m_device;
             allocatorInfo.instance               = m_vkInstance;
+            allocatorInfo.pAllocationCallbacks   = m_allocator;
             vmaCreateAllocator(&allocatorInfo, &m_vmaAllocator);
         }
 
+        // Pipeline cache, empty until Instance::LoadPipelineCache() merges serialized data into it.
+        {
+            VkPipelineCacheCreateInfo info = VkPipelineCacheCreateInfo{};
+            info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            info.pNext                     = nullptr;
+            info.flags                     = 0;
+            info.initialDataSize           = 0;
+            info.pInitialData              = nullptr;
+
+            VkResult res = vkCreatePipelineCache(m_device, &info, m_allocator, &m_pipelineCache);
+            VK_CHECK_RESULT(res, "Backend -> Could not create pipeline cache!");
+        }
+
         // Per frame data
         {
             for (uint32 i = 0; i < Config.framesInFlight; i++)
             {
                 VKBPerFrameData pfd = {};
+
+                // Upload ring, reset once the frame's semaphores are signalled in StartFrame().
+                if (Config.vulkanConfig.stagingRingSize != 0)
+                {
+                    ResourceDesc ringDesc  = {};
+                    ringDesc.size          = Config.vulkanConfig.stagingRingSize;
+                    ringDesc.typeHintFlags = TH_None;
+                    ringDesc.heapType      = ResourceHeap::StagingHeap;
+                    ringDesc.debugName     = "LinaGX Staging Ring";
+                    pfd.stagingRing        = CreateResource(ringDesc);
+                    MapResource(pfd.stagingRing, pfd.stagingRingMapped);
+                }
+
                 m_perFrameData.push_back(pfd);
             }
         }
@@ -2924,6 +3888,9 @@ namespace LinaGX
         for (uint32 i = 0; i < Config.framesInFlight; i++)
         {
             auto& pfd = m_perFrameData[i];
+
+            if (pfd.stagingRingMapped != nullptr)
+                DestroyResource(pfd.stagingRing);
         }
 
         for (auto& swp : m_swapchains)
@@ -2941,6 +3908,11 @@ namespace LinaGX
             LOGA(!txt.isValid, "Backend -> Some textures were not destroyed!");
         }
 
+        for (auto& group : m_transientGroups)
+        {
+            LOGA(!group.isValid, "Backend -> Some transient texture groups were not destroyed!");
+        }
+
         for (auto& str : m_cmdStreams)
         {
             LOGA(!str.isValid, "Backend -> Some command streams were not destroyed!");
@@ -2976,29 +3948,39 @@ namespace LinaGX
             LOGA(!l.isValid, "Backend -> Some pipeline layouts were not destroyed!");
         }
 
+        for (auto& qp : m_queryPools)
+        {
+            LOGA(!qp.isValid, "Backend -> Some query pools were not destroyed!");
+        }
+
+        vkDestroyPipelineCache(m_device, m_pipelineCache, m_allocator);
         vmaDestroyAllocator(m_vmaAllocator);
         vkDestroyDevice(m_device, m_allocator);
 
         if (m_debugMessenger != nullptr)
-            vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger);
+            vkb::destroy_debug_utils_messenger(m_vkInstance, m_debugMessenger, m_allocator);
 
         vkDestroyInstance(m_vkInstance, m_allocator);
 
         m_queueData.clear();
+        m_sharedQueueFamilies.clear();
     }
 
     void VKBackend::Join()
     {
         const uint64 timeout = static_cast<uint64>(5000000000);
 
-        LINAGX_VEC<VkSemaphore> waitSemaphores;
-        LINAGX_VEC<uint64>      waitSemaphoreValues;
+        m_frameScratch.Reset();
+        const uint32 maxWaits            = Config.framesInFlight * m_queues.GetNextFreeID();
+        VkSemaphore* waitSemaphores      = m_frameScratch.AllocateArray<VkSemaphore>(maxWaits);
+        uint64*      waitSemaphoreValues = m_frameScratch.AllocateArray<uint64>(maxWaits);
+        uint32       waitCount           = 0;
 
         for (uint32 i = 0; i < Config.framesInFlight; i++)
         {
             for (auto& q : m_queues)
             {
-                if (!q.isValid || q.type != CommandType::Graphics || !q.wasSubmitted[i])
+                if (!q.isValid || !q.wasSubmitted[i])
                     continue;
 
                 q.wasSubmitted[i]             = false;
@@ -3006,23 +3988,23 @@ namespace LinaGX
 
                 auto sem = q.pfd[i].startFrameWaitSemaphore;
 
-                if (std::find_if(waitSemaphores.begin(), waitSemaphores.end(), [sem](VkSemaphore s) { return s == sem; }) == waitSemaphores.end())
+                if (std::find(waitSemaphores, waitSemaphores + waitCount, sem) == waitSemaphores + waitCount)
                 {
-                    waitSemaphores.push_back(sem);
-                    waitSemaphoreValues.push_back(q.pfd[i].storedStartFrameSemaphoreValue);
+                    waitSemaphores[waitCount]        = sem;
+                    waitSemaphoreValues[waitCount++] = q.pfd[i].storedStartFrameSemaphoreValue;
                 }
             }
         }
 
-        if (!waitSemaphores.empty())
+        if (waitCount != 0)
         {
             VkSemaphoreWaitInfo waitInfo = VkSemaphoreWaitInfo{};
             waitInfo.sType               = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
             waitInfo.pNext               = nullptr;
             waitInfo.flags               = 0;
-            waitInfo.semaphoreCount      = static_cast<uint32>(waitSemaphores.size());
-            waitInfo.pSemaphores         = waitSemaphores.data();
-            waitInfo.pValues             = waitSemaphoreValues.data();
+            waitInfo.semaphoreCount      = waitCount;
+            waitInfo.pSemaphores         = waitSemaphores;
+            waitInfo.pValues             = waitSemaphoreValues;
             const VkResult result        = vkWaitSemaphores(m_device, &waitInfo, timeout);
             if (result != VK_SUCCESS)
             {
@@ -3044,49 +4026,100 @@ namespace LinaGX
         auto& frame         = m_perFrameData[frameIndex];
 
         // Wait for the queues to finish operations from last time they were used.
-        LINAGX_VEC<VkSemaphore> waitSemaphores;
-        LINAGX_VEC<uint64>      waitSemaphoreValues;
+        m_frameScratch.Reset();
+        const uint32 maxWaits            = m_queues.GetNextFreeID();
+        VkSemaphore* waitSemaphores      = m_frameScratch.AllocateArray<VkSemaphore>(maxWaits);
+        uint64*      waitSemaphoreValues = m_frameScratch.AllocateArray<uint64>(maxWaits);
+        uint32       waitCount           = 0;
+        uint64       completedTimeline   = 0;
 
         for (auto& q : m_queues)
         {
-            if (!q.isValid || q.type != CommandType::Graphics || !q.wasSubmitted[m_currentFrameIndex])
+            if (!q.isValid || !q.wasSubmitted[m_currentFrameIndex])
                 continue;
 
             q.wasSubmitted[m_currentFrameIndex]             = false;
             q.pfd[m_currentFrameIndex].submitSemaphoreIndex = 0;
+            completedTimeline                               = Max(completedTimeline, q.pfd[m_currentFrameIndex].storedFrameTimelineValue);
 
             auto sem = q.pfd[m_currentFrameIndex].startFrameWaitSemaphore;
 
-            if (std::find_if(waitSemaphores.begin(), waitSemaphores.end(), [sem](VkSemaphore s) { return s == sem; }) == waitSemaphores.end())
+            if (std::find(waitSemaphores, waitSemaphores + waitCount, sem) == waitSemaphores + waitCount)
             {
-                waitSemaphores.push_back(sem);
-                waitSemaphoreValues.push_back(q.pfd[m_currentFrameIndex].storedStartFrameSemaphoreValue);
+                waitSemaphores[waitCount]        = sem;
+                waitSemaphoreValues[waitCount++] = q.pfd[m_currentFrameIndex].storedStartFrameSemaphoreValue;
             }
         }
 
         const uint64 timeout = static_cast<uint64>(5000000000);
 
-        if (!waitSemaphores.empty())
+        if (waitCount != 0)
+        {
+            VkSemaphoreWaitInfo waitInfo = VkSemaphoreWaitInfo{};
+            waitInfo.sType               = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.pNext               = nullptr;
+            waitInfo.flags               = 0;
+            waitInfo.semaphoreCount      = waitCount;
+            waitInfo.pSemaphores         = waitSemaphores;
+            waitInfo.pValues             = waitSemaphoreValues;
+            VkResult res                 = vkWaitSemaphores(m_device, &waitInfo, timeout);
+            VK_CHECK_RESULT(res, "Backend -> Failed waiting for semaphores!");
+        }
+
+        CompleteFrameTimeline(completedTimeline);
+
+        // Layout fixups recorded in this frame index completed with the wait above.
+        for (auto& q : m_queues)
+        {
+            if (!q.isValid || q.pfd[m_currentFrameIndex].fixupHead == 0)
+                continue;
+
+            auto& pfd = q.pfd[m_currentFrameIndex];
+            vkResetCommandPool(m_device, pfd.fixupPool, 0);
+            pfd.fixupHead = 0;
+        }
+
+        // Uploads might have been submitted in another frame index, or be still pending on a queue that didn't submit in this one.
+        uint32       ringWaitCount  = 0;
+        VkSemaphore* ringSemaphores = nullptr;
+        uint64*      ringValues     = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(m_stagingRingMtx);
+            ringWaitCount  = static_cast<uint32>(frame.stagingRingWaits.size());
+            ringSemaphores = m_frameScratch.AllocateArray<VkSemaphore>(ringWaitCount);
+            ringValues     = m_frameScratch.AllocateArray<uint64>(ringWaitCount);
+
+            for (uint32 i = 0; i < ringWaitCount; i++)
+            {
+                ringSemaphores[i] = frame.stagingRingWaits[i].first;
+                ringValues[i]     = frame.stagingRingWaits[i].second;
+            }
+
+            frame.stagingRingWaits.clear();
+        }
+
+        if (ringWaitCount != 0)
         {
             VkSemaphoreWaitInfo waitInfo = VkSemaphoreWaitInfo{};
             waitInfo.sType               = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
             waitInfo.pNext               = nullptr;
             waitInfo.flags               = 0;
-            waitInfo.semaphoreCount      = static_cast<uint32>(waitSemaphores.size());
-            waitInfo.pSemaphores         = waitSemaphores.data();
-            waitInfo.pValues             = waitSemaphoreValues.data();
+            waitInfo.semaphoreCount      = ringWaitCount;
+            waitInfo.pSemaphores         = ringSemaphores;
+            waitInfo.pValues             = ringValues;
             VkResult res                 = vkWaitSemaphores(m_device, &waitInfo, timeout);
             VK_CHECK_RESULT(res, "Backend -> Failed waiting for semaphores!");
         }
 
         frame.submissionCount = 0;
+        frame.stagingRingHead = 0;
+
+        ResolveQueries(m_currentFrameIndex);
 
         // Acquire images for each swapchain
-        const uint8 swpSize = m_swapchains.GetNextFreeID();
-        for (uint8 i = 0; i < swpSize; i++)
+        for (auto& swp : m_swapchains)
         {
-            auto& swp = m_swapchains.GetItemR(i);
-
             if (!swp.isValid || swp.width == 0 || swp.height == 0 || !swp.isActive)
             {
                 continue;
@@ -3108,35 +4141,16 @@ namespace LinaGX
             }
         }
 
-        const uint32 cmdSize = m_cmdStreams.GetNextFreeID();
-        for (uint32 i = 0; i < cmdSize; i++)
-        {
-            auto& cs = m_cmdStreams.GetItemR(i);
-
-            if (!cs.isValid)
-                continue;
-
-            for (auto it = cs.intermediateResources.begin(); it != cs.intermediateResources.end();)
-            {
-                if (PerformanceStats.totalFrames > it->second + Config.framesInFlight + 1)
-                {
-                    DestroyResource(it->first);
-                    it = cs.intermediateResources.erase(it);
-                }
-                else
-                    ++it;
-            }
-        }
     }
 
     void VKBackend::Present(const PresentDesc& present)
     {
-        LINAGX_VEC<VkSwapchainKHR> swaps;
-        LINAGX_VEC<uint32>         imageIndices;
-        LINAGX_VEC<VkSemaphore>    waitSemaphores;
-        swaps.reserve(present.swapchainCount);
-        imageIndices.reserve(present.swapchainCount);
-        waitSemaphores.reserve(present.swapchainCount);
+        m_frameScratch.Reset();
+        VkSwapchainKHR* swaps          = m_frameScratch.AllocateArray<VkSwapchainKHR>(present.swapchainCount);
+        uint32*         imageIndices   = m_frameScratch.AllocateArray<uint32>(present.swapchainCount);
+        VkSemaphore*    waitSemaphores = m_frameScratch.AllocateArray<VkSemaphore>(present.swapchainCount);
+        uint32          swapCount      = 0;
+        uint32          waitCount      = 0;
 
         auto& frame = m_perFrameData[m_currentFrameIndex];
 
@@ -3153,36 +4167,26 @@ namespace LinaGX
                 continue;
             }
 
-            swaps.push_back(swp.ptr);
-            imageIndices.push_back(swp._imageIndex);
+            swaps[swapCount]          = swp.ptr;
+            imageIndices[swapCount++] = swp._imageIndex;
 
             auto* smp = m_queues.GetItemR(swp._submittedQueue).pfd[m_currentFrameIndex].submitSemaphoreBuffer[swp._submittedSemaphoreIndex];
 
-            bool found = false;
-            for (auto* sem : waitSemaphores)
-            {
-                if (sem == smp)
-                {
-                    found = true;
-                    break;
-                }
-            }
-
-            if (!found)
-                waitSemaphores.push_back(smp);
+            if (std::find(waitSemaphores, waitSemaphores + waitCount, smp) == waitSemaphores + waitCount)
+                waitSemaphores[waitCount++] = smp;
         }
 
-        if (swaps.empty())
+        if (swapCount == 0)
             return;
 
         VkPresentInfoKHR info   = VkPresentInfoKHR{};
         info.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         info.pNext              = nullptr;
-        info.waitSemaphoreCount = static_cast<uint32>(waitSemaphores.size());
-        info.pWaitSemaphores    = waitSemaphores.data();
-        info.swapchainCount     = static_cast<uint32>(swaps.size());
-        info.pSwapchains        = swaps.data();
-        info.pImageIndices      = imageIndices.data();
+        info.waitSemaphoreCount = waitCount;
+        info.pWaitSemaphores    = waitSemaphores;
+        info.swapchainCount     = swapCount;
+        info.pSwapchains        = swaps;
+        info.pImageIndices      = imageIndices;
 
         VkResult result = vkQueuePresentKHR(m_queues.GetItemR(GetPrimaryQueue(CommandType::Graphics)).queue, &info);
 
@@ -3214,13 +4218,10 @@ namespace LinaGX
             }
         }
 
-        LINAGX_VEC<VkRenderingAttachmentInfo> colorAttachments;
-        colorAttachments.resize(begin->colorAttachmentCount);
-
-        LINAGX_VEC<VkImageView> imageViews;
-        LINAGX_VEC<VkImage>     images;
-        imageViews.resize(begin->colorAttachmentCount);
-        images.resize(begin->colorAttachmentCount);
+        PagedLinearAllocator&      scratch          = stream.streamImpl->m_scratchArena;
+        VkRenderingAttachmentInfo* colorAttachments = scratch.AllocateArray<VkRenderingAttachmentInfo>(begin->colorAttachmentCount);
+        VkImageView*               imageViews       = scratch.AllocateArray<VkImageView>(begin->colorAttachmentCount);
+        VkImage*                   images           = scratch.AllocateArray<VkImage>(begin->colorAttachmentCount);
 
         for (uint32 i = 0; i < begin->colorAttachmentCount; i++)
         {
@@ -3229,6 +4230,7 @@ namespace LinaGX
 
             if (att.isSwapchain)
             {
+                LOGA(!stream.streamImpl->m_isPersistent, "Backend -> Persistent command streams can't reference swapchains, the image changes every frame!");
                 const auto& swp = m_swapchains.GetItemR(static_cast<uint8>(att.texture));
                 imageViews[i]   = swp.views[swp._imageIndex];
                 images[i]       = swp.imgs[swp._imageIndex];
@@ -3287,7 +4289,7 @@ namespace LinaGX
         CMDSetViewport interVP = {};
         CMDSetScissors interSC = {};
         interVP.x              = begin->viewport.x;
-        interVP.y              = begin->viewport.x;
+        interVP.y              = begin->viewport.y;
         interVP.width          = begin->viewport.width;
         interVP.height         = begin->viewport.height;
         interVP.minDepth       = begin->viewport.minDepth;
@@ -3306,18 +4308,23 @@ namespace LinaGX
         VkRenderingInfo renderingInfo      = VkRenderingInfo{};
         renderingInfo.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
         renderingInfo.pNext                = nullptr;
-        renderingInfo.flags                = 0;
+        renderingInfo.flags                = stream.passExecutesSecondaries ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
         renderingInfo.renderArea           = area;
         renderingInfo.layerCount           = 1;
         renderingInfo.viewMask             = 0;
         renderingInfo.pDepthAttachment     = begin->depthStencilAttachment.useDepth ? &depthAttachment : VK_NULL_HANDLE;
         renderingInfo.pStencilAttachment   = begin->depthStencilAttachment.useStencil ? &stencilAttachment : VK_NULL_HANDLE;
         renderingInfo.colorAttachmentCount = begin->colorAttachmentCount;
-        renderingInfo.pColorAttachments    = colorAttachments.data();
+        renderingInfo.pColorAttachments    = colorAttachments;
 
         vkCmdBeginRendering(stream.buffer, &renderingInfo);
-        CMD_SetViewport((uint8*)&interVP, stream);
-        CMD_SetScissors((uint8*)&interSC, stream);
+
+        // Secondary streams set these themselves, see TranslateCommandStream().
+        if (!stream.passExecutesSecondaries)
+        {
+            CMD_SetViewport((uint8*)&interVP, stream);
+            CMD_SetScissors((uint8*)&interSC, stream);
+        }
     }
 
     void VKBackend::CMD_EndRenderPass(uint8* data, VKBCommandStream& stream)
@@ -3325,6 +4332,7 @@ namespace LinaGX
         CMDEndRenderPass* end    = reinterpret_cast<CMDEndRenderPass*>(data);
         auto              buffer = stream.buffer;
         vkCmdEndRendering(buffer);
+        stream.passExecutesSecondaries = false;
     }
 
     void VKBackend::CMD_SetViewport(uint8* data, VKBCommandStream& stream)
@@ -3367,7 +4375,8 @@ namespace LinaGX
         auto             buffer = stream.buffer;
         const auto&      shader = m_shaders.GetItemR(cmd->shader);
         vkCmdBindPipeline(buffer, shader.isCompute ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS, shader.ptrPipeline);
-        stream.boundShader = cmd->shader;
+        stream.boundShader           = cmd->shader;
+        stream.boundShaderUsesDrawID = shader.usesDrawID;
     }
 
     void VKBackend::CMD_DrawInstanced(uint8* data, VKBCommandStream& stream)
@@ -3457,25 +4466,54 @@ namespace LinaGX
             totalDataSize += buf.width * buf.height * buf.bytesPerPixel;
         }
 
-        ResourceDesc stagingDesc  = {};
-        stagingDesc.size          = totalDataSize;
-        stagingDesc.typeHintFlags = TH_None;
-        stagingDesc.heapType      = ResourceHeap::StagingHeap;
-        uint32 stagingHandle      = CreateResource(stagingDesc);
-        stream.intermediateResources.push_back({stagingHandle, PerformanceStats.totalFrames});
+        // Region offsets must be multiples of both 4 and the texel size, lcm(4, bytesPerPixel).
+        const uint32 bpp         = cmd->buffers[0].bytesPerPixel;
+        const uint64 regionAlign = bpp % 4 == 0 ? bpp : (bpp % 2 == 0 ? bpp * 2 : bpp * 4);
 
-        const auto& srcResource = m_resources.GetItemR(stagingHandle);
-        const auto& dstTexture  = m_textures.GetItemR(cmd->destTexture);
+        // Sub-allocate from this frame's ring. CloseCommandStreams() might run on several threads at once, so the range is reserved under the lock.
+        auto&  frame      = m_perFrameData[m_currentFrameIndex];
+        uint64 ringOffset = 0;
+        bool   useRing    = false;
 
-        LINAGX_VEC<VkBufferImageCopy> regions;
+        if (frame.stagingRingMapped != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(m_stagingRingMtx);
+            ringOffset = frame.stagingRingHead % regionAlign == 0 ? frame.stagingRingHead : frame.stagingRingHead + regionAlign - frame.stagingRingHead % regionAlign;
+            useRing    = ringOffset + totalDataSize <= Config.vulkanConfig.stagingRingSize;
 
-        VkOffset3D imageOffset = {};
-        imageOffset.x = imageOffset.y = imageOffset.z = 0;
+            if (useRing)
+                frame.stagingRingHead = ringOffset + totalDataSize;
+        }
 
-        uint32 bufferOffset = 0;
+        uint32 stagingHandle = 0;
+        uint64 bufferOffset  = 0;
+        uint8* mapped        = nullptr;
 
-        uint8* mapped = nullptr;
-        MapResource(stagingHandle, mapped);
+        if (useRing)
+        {
+            stagingHandle           = frame.stagingRing;
+            bufferOffset            = ringOffset;
+            mapped                  = frame.stagingRingMapped;
+            stream.usesStagingRing  = true;
+            stream.stagingRingFrame = m_currentFrameIndex;
+        }
+        else
+        {
+            ResourceDesc stagingDesc  = {};
+            stagingDesc.size          = totalDataSize;
+            stagingDesc.typeHintFlags = TH_None;
+            stagingDesc.heapType      = ResourceHeap::StagingHeap;
+            stagingHandle             = CreateResource(stagingDesc);
+            DeferDestruction(DeferredObjectType::Resource, stagingHandle);
+            MapResource(stagingHandle, mapped);
+        }
+
+        const auto&        srcResource = m_resources.GetItemR(stagingHandle);
+        const auto&        dstTexture  = m_textures.GetItemR(cmd->destTexture);
+        VkBufferImageCopy* regions     = stream.streamImpl->m_scratchArena.AllocateArray<VkBufferImageCopy>(cmd->mipLevels);
+
+        VkOffset3D imageOffset = {};
+        imageOffset.x = imageOffset.y = imageOffset.z = 0;
 
         for (uint32 i = 0; i < cmd->mipLevels; i++)
         {
@@ -3500,16 +4538,17 @@ namespace LinaGX
             copy.imageOffset       = imageOffset;
             copy.imageExtent       = extent;
 
-            regions.push_back(copy);
+            regions[i] = copy;
 
             const uint32 totalSz = txtBuffer.width * txtBuffer.height * txtBuffer.bytesPerPixel;
             std::memcpy(mapped + bufferOffset, txtBuffer.pixels, static_cast<size_t>(totalSz));
             bufferOffset += totalSz;
         }
 
-        UnmapResource(stagingHandle);
+        if (!useRing)
+            UnmapResource(stagingHandle);
 
-        vkCmdCopyBufferToImage(buffer, srcResource.buffer, dstTexture.img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(regions.size()), regions.data());
+        vkCmdCopyBufferToImage(buffer, srcResource.buffer, dstTexture.img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd->mipLevels, regions);
     }
 
     void VKBackend::CMD_CopyTexture2DToBuffer(uint8* data, VKBCommandStream& stream)
@@ -3519,8 +4558,6 @@ namespace LinaGX
         const auto&               srcTexture  = m_textures.GetItemR(cmd->srcTexture);
         const auto&               dstResource = m_resources.GetItemR(cmd->destBuffer);
 
-        LINAGX_VEC<VkBufferImageCopy> regions;
-
         VkOffset3D imageOffset = {};
         imageOffset.x = imageOffset.y = imageOffset.z = 0;
 
@@ -3538,9 +4575,7 @@ namespace LinaGX
         copy.imageOffset       = imageOffset;
         copy.imageExtent       = srcTexture.extent;
 
-        regions.push_back(copy);
-
-        vkCmdCopyImageToBuffer(buffer, srcTexture.img, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstResource.buffer, static_cast<uint32>(regions.size()), regions.data());
+        vkCmdCopyImageToBuffer(buffer, srcTexture.img, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstResource.buffer, 1, &copy);
     }
 
     void VKBackend::CMD_CopyTexture(uint8* data, VKBCommandStream& stream)
@@ -3600,13 +4635,12 @@ namespace LinaGX
         else
             layout = m_pipelineLayouts.GetItemR(cmd->customLayout).ptr;
 
-        LINAGX_VEC<VkDescriptorSet> sets;
-        sets.resize(cmd->setCount);
+        VkDescriptorSet* sets = stream.streamImpl->m_scratchArena.AllocateArray<VkDescriptorSet>(cmd->setCount);
 
         for (uint32 i = 0; i < cmd->setCount; i++)
             sets[i] = m_descriptorSets.GetItemR(cmd->descriptorSetHandles[i]).sets[cmd->allocationIndices == nullptr ? 0 : cmd->allocationIndices[i]];
 
-        vkCmdBindDescriptorSets(buffer, cmd->isCompute ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS, layout, cmd->firstSet, cmd->setCount, sets.data(), cmd->dynamicOffsetCount, cmd->dynamicOffsets);
+        vkCmdBindDescriptorSets(buffer, cmd->isCompute ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS, layout, cmd->firstSet, cmd->setCount, sets, cmd->dynamicOffsetCount, cmd->dynamicOffsets);
     }
 
     void VKBackend::CMD_BindConstants(uint8* data, VKBCommandStream& stream)
@@ -3634,118 +4668,476 @@ namespace LinaGX
     {
         CMDExecuteSecondaryStream* cmd       = reinterpret_cast<CMDExecuteSecondaryStream*>(data);
         auto                       buffer    = stream.buffer;
-        auto                       bufferSec = m_cmdStreams.GetItemR(cmd->secondaryStream->m_gpuHandle).buffer;
-        vkCmdExecuteCommands(stream.buffer, 1, &bufferSec);
+        const auto&                secondary = m_cmdStreams.GetItemR(cmd->secondaryStream->m_gpuHandle);
+        vkCmdExecuteCommands(buffer, 1, &secondary.buffer);
+
+        // The secondary's uploads and queries are handled by this stream's submission.
+        if (secondary.usesStagingRing)
+        {
+            stream.usesStagingRing  = true;
+            stream.stagingRingFrame = secondary.stagingRingFrame;
+        }
+
+        stream.writtenQueries.insert(stream.writtenQueries.end(), secondary.writtenQueries.begin(), secondary.writtenQueries.end());
     }
 
     void VKBackend::CMD_Barrier(uint8* data, VKBCommandStream& stream)
     {
-        CMDBarrier* cmd    = reinterpret_cast<CMDBarrier*>(data);
-        auto        buffer = stream.buffer;
+        CMDBarrier*           cmd     = reinterpret_cast<CMDBarrier*>(data);
+        PagedLinearAllocator& scratch = stream.streamImpl->m_scratchArena;
+        const CommandType     type    = stream.streamImpl->m_type;
 
-        LINAGX_VEC<VkImageMemoryBarrier> imgBarriers;
-        imgBarriers.resize(cmd->textureBarrierCount);
+        // Merged into the pending barriers, unless those touch the same images or buffers, transitions of the same subresource within a single call aren't ordered.
+        const bool hasPending = !stream.pendingImageBarriers.empty() || !stream.pendingBufferBarriers.empty() || !stream.pendingMemoryBarriers.empty();
+        bool       overlaps   = false;
 
-        // VkPipelineStageFlags srcStage = 0, dstStage = 0;
-
-        for (uint32 i = 0; i < cmd->textureBarrierCount; i++)
+        for (uint32 i = 0; hasPending && !overlaps && i < cmd->textureBarrierCount; i++)
         {
             const auto& txtBarrier = cmd->textureBarriers[i];
-
-            VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-            VkImageMemoryBarrier vkBarrier = {};
-            vkBarrier.sType                = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            VkImage     img        = nullptr;
 
             if (txtBarrier.isSwapchain)
             {
-                auto& swp                             = m_swapchains.GetItemR(static_cast<uint32>(txtBarrier.texture));
-                oldLayout                             = swp.imgLayouts[swp._imageIndex];
-                newLayout                             = GetVKImageLayoutTextureBarrier(txtBarrier.toState, 0);
-                swp.imgLayouts[swp._imageIndex]       = newLayout;
-                vkBarrier.image                       = swp.imgs[swp._imageIndex];
-                vkBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                vkBarrier.subresourceRange.layerCount = 1;
-                vkBarrier.subresourceRange.levelCount = 1;
+                const auto& swp = m_swapchains.GetItemR(static_cast<uint32>(txtBarrier.texture));
+                img             = swp.imgs[swp._imageIndex];
             }
             else
+                img = m_textures.GetItemR(txtBarrier.texture).img;
+
+            overlaps = LINAGX_FIND_IF(stream.pendingImageBarriers.begin(), stream.pendingImageBarriers.end(), [img](const VkImageMemoryBarrier2& b) -> bool { return b.image == img; }) != stream.pendingImageBarriers.end();
+        }
+
+        for (uint32 i = 0; hasPending && !overlaps && i < cmd->resourceBarrierCount; i++)
+        {
+            VkBuffer buf = m_resources.GetItemR(cmd->resourceBarriers[i].resource).buffer;
+            overlaps     = LINAGX_FIND_IF(stream.pendingBufferBarriers.begin(), stream.pendingBufferBarriers.end(), [buf](const VkBufferMemoryBarrier2& b) -> bool { return b.buffer == buf; }) != stream.pendingBufferBarriers.end();
+        }
+
+        if (overlaps)
+            FlushBarriers(stream);
+        else if (hasPending)
+            stream.mergedBarriers++;
+
+        for (uint32 i = 0; i < cmd->textureBarrierCount; i++)
+        {
+            const auto& txtBarrier = cmd->textureBarriers[i];
+
+            if (txtBarrier.isSwapchain)
             {
-                auto& txt                             = m_textures.GetItemR(txtBarrier.texture);
-                oldLayout                             = txt.imgLayout;
-                newLayout                             = GetVKImageLayoutTextureBarrier(txtBarrier.toState, txt.flags);
-                txt.imgLayout                         = newLayout;
-                vkBarrier.image                       = txt.img;
-                vkBarrier.subresourceRange.aspectMask = txt.aspectFlags;
-                vkBarrier.subresourceRange.layerCount = txt.arrayLength;
-                vkBarrier.subresourceRange.levelCount = txt.mipLevels;
+                LOGA(!stream.streamImpl->m_isPersistent, "Backend -> Persistent command streams can't reference swapchains, the image changes every frame!");
+                auto&               swp       = m_swapchains.GetItemR(static_cast<uint32>(txtBarrier.texture));
+                auto&               use       = stream.swapchainLayouts[GetSwapchainLayoutUse(stream, static_cast<uint8>(txtBarrier.texture))];
+                const VkImageLayout oldLayout = use.finalLayout == VK_IMAGE_LAYOUT_MAX_ENUM ? use.initialLayout : use.finalLayout;
+                const VkImageLayout newLayout = GetVKImageLayoutTextureBarrier(txtBarrier.toState, 0);
+
+                VkImageMemoryBarrier2 vkBarrier           = {};
+                vkBarrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                vkBarrier.image                           = swp.imgs[swp._imageIndex];
+                vkBarrier.oldLayout                       = oldLayout;
+                vkBarrier.newLayout                       = newLayout;
+                vkBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                vkBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+                vkBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+                vkBarrier.subresourceRange.baseMipLevel   = 0;
+                vkBarrier.subresourceRange.levelCount     = 1;
+                vkBarrier.subresourceRange.baseArrayLayer = 0;
+                vkBarrier.subresourceRange.layerCount     = 1;
+                GetVKBarrierMasks(vkBarrier.srcStageMask, vkBarrier.srcAccessMask, txtBarrier.srcStageFlags, txtBarrier.srcAccessFlags, GetVKPipelineStageFromLayout(oldLayout, true), GetVKAccessMaskFromLayout(oldLayout) & WRITE_ACCESS_FLAGS, cmd->srcStageFlags, type, m_supportsSynchronization2);
+                GetVKBarrierMasks(vkBarrier.dstStageMask, vkBarrier.dstAccessMask, txtBarrier.dstStageFlags, txtBarrier.dstAccessFlags, GetVKPipelineStageFromLayout(newLayout, true), GetVKAccessMaskFromLayout(newLayout), cmd->dstStageFlags, type, m_supportsSynchronization2);
+                use.finalLayout = newLayout;
+                stream.pendingImageBarriers.push_back(vkBarrier);
+                continue;
             }
 
-            vkBarrier.oldLayout                       = oldLayout;
-            vkBarrier.newLayout                       = newLayout;
-            vkBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-            vkBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-            vkBarrier.subresourceRange.baseMipLevel   = 0;
-            vkBarrier.subresourceRange.baseArrayLayer = 0;
+            const auto& txt = m_textures.GetItemR(txtBarrier.texture);
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask              = txt.aspectFlags;
+            range.baseMipLevel            = txtBarrier.baseMip;
+            range.levelCount              = txtBarrier.mipCount == 0 ? txt.mipLevels - txtBarrier.baseMip : txtBarrier.mipCount;
+            range.baseArrayLayer          = txtBarrier.baseLayer;
+            range.layerCount              = txtBarrier.layerCount == 0 ? txt.arrayLength - txtBarrier.baseLayer : txtBarrier.layerCount;
+            LOGA(range.baseMipLevel + range.levelCount <= txt.mipLevels && range.baseArrayLayer + range.layerCount <= txt.arrayLength, "Backend -> Texture barrier subresource range is out of bounds!");
+
+            // Memory might have been used by an aliased texture, nothing to preserve.
+            const bool          discard        = txtBarrier.discardContents && txt.isTransient;
+            const VkImageLayout newLayout      = GetVKImageLayoutTextureBarrier(txtBarrier.toState, txt.flags);
+            const uint32        first          = stream.layoutUses[GetLayoutUse(stream, txtBarrier.texture)].first;
+            const uint32        count          = static_cast<uint32>(txt.layouts.size());
+            VkImageLayout*      initialLayouts = stream.initialLayouts.data() + first;
+            VkImageLayout*      finalLayouts   = stream.finalLayouts.data() + first;
+            VkImageLayout*      oldLayouts     = scratch.AllocateArray<VkImageLayout>(count);
+            VkImageLayout*      newLayouts     = scratch.AllocateArray<VkImageLayout>(count);
+
+            for (uint32 layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+            {
+                for (uint32 mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+                {
+                    const uint32 sub = layer * txt.mipLevels + mip;
 
-            vkBarrier.srcAccessMask = txtBarrier.srcAccessFlags;
-            vkBarrier.dstAccessMask = txtBarrier.dstAccessFlags;
-            imgBarriers[i]          = vkBarrier;
+                    // First transition in the stream doesn't need the layout it was in, if discarding.
+                    if (finalLayouts[sub] == VK_IMAGE_LAYOUT_MAX_ENUM && discard)
+                        initialLayouts[sub] = VK_IMAGE_LAYOUT_UNDEFINED;
 
-            // if (vkBarrier.dstAccessMask & VK_ACCESS_SHADER_READ_BIT && stream.type == LinaGX::CommandType::Transfer)
-            //     vkBarrier.dstAccessMask &= ~VK_ACCESS_SHADER_READ_BIT;
+                    oldLayouts[sub]   = discard ? VK_IMAGE_LAYOUT_UNDEFINED : (finalLayouts[sub] == VK_IMAGE_LAYOUT_MAX_ENUM ? initialLayouts[sub] : finalLayouts[sub]);
+                    newLayouts[sub]   = newLayout;
+                    finalLayouts[sub] = newLayout;
+                }
+            }
 
-            // auto fetchedSrcStage = GetVKPipelineStageFromLayout(oldLayout, sampledOutsideFragment);
+            const size_t firstBarrier = stream.pendingImageBarriers.size();
+            AppendImageBarriers(stream.pendingImageBarriers, txt, oldLayouts, newLayouts, range, 0, 0, 0, 0, false);
 
-            // if (stream.type == LinaGX::CommandType::Transfer && fetchedSrcStage != VK_PIPELINE_STAGE_TRANSFER_BIT)
-            //     srcStage |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            // else
-            //     srcStage |= fetchedSrcStage;
-            //
-            // auto fetchedDestStage = GetVKPipelineStageFromLayout(newLayout, sampledOutsideFragment);
-            //
-            // if (stream.type == LinaGX::CommandType::Transfer && fetchedDestStage != VK_PIPELINE_STAGE_TRANSFER_BIT)
-            //     dstStage |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            // else
-            //     dstStage |= fetchedDestStage;
-        }
+            // The previous layout might differ per subresource, so does the source scope. Discards wait on whatever the command waits on, the memory might be aliased.
+            const uint32 srcStages = discard && txtBarrier.srcStageFlags == 0 ? cmd->srcStageFlags : txtBarrier.srcStageFlags;
 
-        LINAGX_VEC<VkBufferMemoryBarrier> rscBarriers;
-        rscBarriers.resize(cmd->resourceBarrierCount);
+            for (size_t j = firstBarrier; j < stream.pendingImageBarriers.size(); j++)
+            {
+                auto& vkBarrier = stream.pendingImageBarriers[j];
+                GetVKBarrierMasks(vkBarrier.srcStageMask, vkBarrier.srcAccessMask, srcStages, txtBarrier.srcAccessFlags, GetVKPipelineStageFromLayout(vkBarrier.oldLayout, false), GetVKAccessMaskFromLayout(vkBarrier.oldLayout) & WRITE_ACCESS_FLAGS, cmd->srcStageFlags, type, m_supportsSynchronization2);
+                GetVKBarrierMasks(vkBarrier.dstStageMask, vkBarrier.dstAccessMask, txtBarrier.dstStageFlags, txtBarrier.dstAccessFlags, GetVKPipelineStageFromLayout(newLayout, false), GetVKAccessMaskFromLayout(newLayout), cmd->dstStageFlags, type, m_supportsSynchronization2);
+            }
+        }
 
         for (uint32 i = 0; i < cmd->resourceBarrierCount; i++)
         {
             const auto& rscBarrier = cmd->resourceBarriers[i];
             auto&       res        = m_resources.GetItemR(rscBarrier.resource);
 
-            VkBufferMemoryBarrier vkBarrier = {};
-            vkBarrier.sType                 = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            vkBarrier.buffer                = res.buffer;
-            vkBarrier.srcQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
-            vkBarrier.dstQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
-            vkBarrier.size                  = VK_WHOLE_SIZE;
-            vkBarrier.offset                = 0;
-            vkBarrier.srcAccessMask         = rscBarrier.srcAccessFlags;
-            vkBarrier.dstAccessMask         = rscBarrier.dstAccessFlags;
-            rscBarriers[i]                  = vkBarrier;
-        }
+            VkBufferMemoryBarrier2 vkBarrier = {};
+            vkBarrier.sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            vkBarrier.buffer                 = res.buffer;
+            vkBarrier.srcQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+            vkBarrier.dstQueueFamilyIndex    = VK_QUEUE_FAMILY_IGNORED;
+            vkBarrier.size                   = VK_WHOLE_SIZE;
+            vkBarrier.offset                 = 0;
 
-        LINAGX_VEC<VkMemoryBarrier> memBarriers;
-        memBarriers.resize(cmd->memoryBarrierCount);
+            // Previous state of a buffer isn't tracked, source scope comes from the access flags.
+            GetVKBarrierMasks(vkBarrier.srcStageMask, vkBarrier.srcAccessMask, rscBarrier.srcStageFlags, rscBarrier.srcAccessFlags, 0, 0, cmd->srcStageFlags, type, m_supportsSynchronization2);
+            GetVKBarrierMasks(vkBarrier.dstStageMask, vkBarrier.dstAccessMask, rscBarrier.dstStageFlags, rscBarrier.dstAccessFlags, GetVKPipelineStageFromResourceBarrier(rscBarrier.toState), GetVKAccessMaskFromResourceBarrier(rscBarrier.toState), cmd->dstStageFlags, type, m_supportsSynchronization2);
+            stream.pendingBufferBarriers.push_back(vkBarrier);
+        }
 
         for (uint32 i = 0; i < cmd->memoryBarrierCount; i++)
         {
             const auto& memBarrier = cmd->memoryBarriers[i];
 
-            VkMemoryBarrier mb = {};
-            mb.sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-            mb.srcAccessMask   = memBarrier.srcAccessFlags;
-            mb.dstAccessMask   = memBarrier.dstAccessFlags;
-            mb.pNext           = nullptr;
-            memBarriers[i]     = mb;
+            VkMemoryBarrier2 mb = {};
+            mb.sType            = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            mb.pNext            = nullptr;
+            GetVKBarrierMasks(mb.srcStageMask, mb.srcAccessMask, cmd->srcStageFlags, memBarrier.srcAccessFlags, 0, 0, cmd->srcStageFlags, type, m_supportsSynchronization2);
+            GetVKBarrierMasks(mb.dstStageMask, mb.dstAccessMask, cmd->dstStageFlags, memBarrier.dstAccessFlags, 0, 0, cmd->dstStageFlags, type, m_supportsSynchronization2);
+            stream.pendingMemoryBarriers.push_back(mb);
+        }
+
+        // Execution dependency only.
+        if (cmd->textureBarrierCount == 0 && cmd->resourceBarrierCount == 0 && cmd->memoryBarrierCount == 0 && (cmd->srcStageFlags != 0 || cmd->dstStageFlags != 0))
+        {
+            VkMemoryBarrier2 mb = {};
+            mb.sType            = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            mb.srcStageMask     = cmd->srcStageFlags;
+            mb.dstStageMask     = cmd->dstStageFlags;
+            stream.pendingMemoryBarriers.push_back(mb);
+        }
+    }
+
+    void VKBackend::FlushBarriers(VKBCommandStream& stream)
+    {
+        if (stream.pendingImageBarriers.empty() && stream.pendingBufferBarriers.empty() && stream.pendingMemoryBarriers.empty())
+            return;
+
+        RecordBarriers(stream.buffer, static_cast<uint32>(stream.pendingMemoryBarriers.size()), stream.pendingMemoryBarriers.data(), static_cast<uint32>(stream.pendingBufferBarriers.size()), stream.pendingBufferBarriers.data(), static_cast<uint32>(stream.pendingImageBarriers.size()), stream.pendingImageBarriers.data(), stream.streamImpl->m_scratchArena);
+
+        stream.pendingImageBarriers.clear();
+        stream.pendingBufferBarriers.clear();
+        stream.pendingMemoryBarriers.clear();
+    }
+
+    void VKBackend::RecordBarriers(VkCommandBuffer buffer, uint32 memoryBarrierCount, const VkMemoryBarrier2* memoryBarriers, uint32 bufferBarrierCount, const VkBufferMemoryBarrier2* bufferBarriers, uint32 imageBarrierCount, const VkImageMemoryBarrier2* imageBarriers, PagedLinearAllocator& scratch)
+    {
+        if (m_supportsSynchronization2)
+        {
+            VkDependencyInfo dependencyInfo         = {};
+            dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.memoryBarrierCount       = memoryBarrierCount;
+            dependencyInfo.pMemoryBarriers          = memoryBarriers;
+            dependencyInfo.bufferMemoryBarrierCount = bufferBarrierCount;
+            dependencyInfo.pBufferMemoryBarriers    = bufferBarriers;
+            dependencyInfo.imageMemoryBarrierCount  = imageBarrierCount;
+            dependencyInfo.pImageMemoryBarriers     = imageBarriers;
+            vkCmdPipelineBarrier2(buffer, &dependencyInfo);
+            return;
+        }
+
+        // Legacy barriers share the stages, all of them were recorded with their command's stages anyway.
+        VkPipelineStageFlags   srcStages = 0;
+        VkPipelineStageFlags   dstStages = 0;
+        VkMemoryBarrier*       memory    = scratch.AllocateArray<VkMemoryBarrier>(memoryBarrierCount);
+        VkBufferMemoryBarrier* buffers   = scratch.AllocateArray<VkBufferMemoryBarrier>(bufferBarrierCount);
+        VkImageMemoryBarrier*  images    = scratch.AllocateArray<VkImageMemoryBarrier>(imageBarrierCount);
+
+        for (uint32 i = 0; i < memoryBarrierCount; i++)
+        {
+            const auto& src         = memoryBarriers[i];
+            memory[i]               = {};
+            memory[i].sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memory[i].srcAccessMask = static_cast<VkAccessFlags>(src.srcAccessMask);
+            memory[i].dstAccessMask = static_cast<VkAccessFlags>(src.dstAccessMask);
+            srcStages |= static_cast<VkPipelineStageFlags>(src.srcStageMask);
+            dstStages |= static_cast<VkPipelineStageFlags>(src.dstStageMask);
+        }
+
+        for (uint32 i = 0; i < bufferBarrierCount; i++)
+        {
+            const auto& src                = bufferBarriers[i];
+            buffers[i]                     = {};
+            buffers[i].sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            buffers[i].srcAccessMask       = static_cast<VkAccessFlags>(src.srcAccessMask);
+            buffers[i].dstAccessMask       = static_cast<VkAccessFlags>(src.dstAccessMask);
+            buffers[i].srcQueueFamilyIndex = src.srcQueueFamilyIndex;
+            buffers[i].dstQueueFamilyIndex = src.dstQueueFamilyIndex;
+            buffers[i].buffer              = src.buffer;
+            buffers[i].offset              = src.offset;
+            buffers[i].size                = src.size;
+            srcStages |= static_cast<VkPipelineStageFlags>(src.srcStageMask);
+            dstStages |= static_cast<VkPipelineStageFlags>(src.dstStageMask);
+        }
+
+        for (uint32 i = 0; i < imageBarrierCount; i++)
+        {
+            const auto& src               = imageBarriers[i];
+            images[i]                     = {};
+            images[i].sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            images[i].srcAccessMask       = static_cast<VkAccessFlags>(src.srcAccessMask);
+            images[i].dstAccessMask       = static_cast<VkAccessFlags>(src.dstAccessMask);
+            images[i].oldLayout           = src.oldLayout;
+            images[i].newLayout           = src.newLayout;
+            images[i].srcQueueFamilyIndex = src.srcQueueFamilyIndex;
+            images[i].dstQueueFamilyIndex = src.dstQueueFamilyIndex;
+            images[i].image               = src.image;
+            images[i].subresourceRange    = src.subresourceRange;
+            srcStages |= static_cast<VkPipelineStageFlags>(src.srcStageMask);
+            dstStages |= static_cast<VkPipelineStageFlags>(src.dstStageMask);
+        }
+
+        vkCmdPipelineBarrier(buffer, srcStages, dstStages, 0, memoryBarrierCount, memory, bufferBarrierCount, buffers, imageBarrierCount, images);
+    }
+
+    uint32 VKBackend::GetLayoutUse(VKBCommandStream& stream, uint32 texture)
+    {
+        for (uint32 i = 0; i < static_cast<uint32>(stream.layoutUses.size()); i++)
+        {
+            if (stream.layoutUses[i].texture == texture)
+                return i;
+        }
+
+        const auto&  txt = m_textures.GetItemR(texture);
+        VKBLayoutUse use = {};
+        use.texture      = texture;
+        use.first        = static_cast<uint32>(stream.initialLayouts.size());
+
+        // Assume the layouts of the last submission, ResolveLayouts() fixes them up if another stream changes them before this one is submitted.
+        {
+            std::lock_guard<std::mutex> lock(m_layoutMtx);
+            stream.initialLayouts.insert(stream.initialLayouts.end(), txt.layouts.begin(), txt.layouts.end());
+        }
+
+        stream.finalLayouts.resize(stream.initialLayouts.size(), VK_IMAGE_LAYOUT_MAX_ENUM);
+        stream.layoutUses.push_back(use);
+        return static_cast<uint32>(stream.layoutUses.size() - 1);
+    }
+
+    uint32 VKBackend::GetSwapchainLayoutUse(VKBCommandStream& stream, uint8 swapchain)
+    {
+        const auto& swp = m_swapchains.GetItemR(swapchain);
+
+        for (uint32 i = 0; i < static_cast<uint32>(stream.swapchainLayouts.size()); i++)
+        {
+            if (stream.swapchainLayouts[i].swapchain == swapchain && stream.swapchainLayouts[i].imageIndex == swp._imageIndex)
+                return i;
+        }
+
+        VKBSwapchainLayoutUse use = {};
+        use.swapchain             = swapchain;
+        use.imageIndex            = swp._imageIndex;
+
+        // Same as textures, assume the layout of the last submission and let ResolveLayouts() fix it up.
+        {
+            std::lock_guard<std::mutex> lock(m_layoutMtx);
+            use.initialLayout = swp.imgLayouts[swp._imageIndex];
+        }
+
+        stream.swapchainLayouts.push_back(use);
+        return static_cast<uint32>(stream.swapchainLayouts.size() - 1);
+    }
+
+    void VKBackend::InheritLayouts(VKBCommandStream& stream, const VKBCommandStream& secondary)
+    {
+        PagedLinearAllocator& scratch = stream.streamImpl->m_scratchArena;
+
+        for (const auto& secondaryUse : secondary.swapchainLayouts)
+        {
+            if (secondaryUse.finalLayout == VK_IMAGE_LAYOUT_MAX_ENUM)
+                continue;
+
+            auto&               use     = stream.swapchainLayouts[GetSwapchainLayoutUse(stream, secondaryUse.swapchain)];
+            const VkImageLayout current = use.finalLayout == VK_IMAGE_LAYOUT_MAX_ENUM ? use.initialLayout : use.finalLayout;
+
+            if (secondaryUse.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED && secondaryUse.initialLayout != current)
+                AppendSwapchainFixup(stream.pendingImageBarriers, m_swapchains.GetItemR(secondaryUse.swapchain), secondaryUse.imageIndex, current, secondaryUse.initialLayout);
+
+            use.finalLayout = secondaryUse.finalLayout;
         }
 
-        vkCmdPipelineBarrier(buffer, cmd->srcStageFlags, cmd->dstStageFlags, 0, cmd->memoryBarrierCount, memBarriers.data(), cmd->resourceBarrierCount, rscBarriers.data(), cmd->textureBarrierCount, imgBarriers.data());
+        for (const auto& secondaryUse : secondary.layoutUses)
+        {
+            const auto&          txt              = m_textures.GetItemR(secondaryUse.texture);
+            const uint32         count            = static_cast<uint32>(txt.layouts.size());
+            const uint32         first            = stream.layoutUses[GetLayoutUse(stream, secondaryUse.texture)].first;
+            VkImageLayout*       initialLayouts   = stream.initialLayouts.data() + first;
+            VkImageLayout*       finalLayouts     = stream.finalLayouts.data() + first;
+            const VkImageLayout* secondaryInitial = secondary.initialLayouts.data() + secondaryUse.first;
+            const VkImageLayout* secondaryFinal   = secondary.finalLayouts.data() + secondaryUse.first;
+            VkImageLayout*       oldLayouts       = scratch.AllocateArray<VkImageLayout>(count);
+            VkImageLayout*       newLayouts       = scratch.AllocateArray<VkImageLayout>(count);
+            bool                 needsTransition  = false;
+
+            for (uint32 sub = 0; sub < count; sub++)
+            {
+                const VkImageLayout current = finalLayouts[sub] == VK_IMAGE_LAYOUT_MAX_ENUM ? initialLayouts[sub] : finalLayouts[sub];
+                oldLayouts[sub]             = current;
+                newLayouts[sub]             = current;
+
+                if (secondaryFinal[sub] == VK_IMAGE_LAYOUT_MAX_ENUM)
+                    continue;
+
+                // Secondary was recorded against another layout, transition before executing it.
+                if (secondaryInitial[sub] != VK_IMAGE_LAYOUT_UNDEFINED && secondaryInitial[sub] != current)
+                {
+                    newLayouts[sub] = secondaryInitial[sub];
+                    needsTransition = true;
+                }
+
+                finalLayouts[sub] = secondaryFinal[sub];
+            }
+
+            if (!needsTransition)
+                continue;
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask              = txt.aspectFlags;
+            range.levelCount              = txt.mipLevels;
+            range.layerCount              = txt.arrayLength;
+            AppendImageBarriers(stream.pendingImageBarriers, txt, oldLayouts, newLayouts, range, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, true);
+        }
+    }
+
+    VkCommandBuffer VKBackend::ResolveLayouts(VKBCommandStream& stream, VKBQueuePerFrameData& queuePfd, PagedLinearAllocator& scratch)
+    {
+        const bool resetsQueries = !m_supportsHostQueryReset && !stream.writtenQueries.empty();
+
+        if (stream.layoutUses.empty() && stream.swapchainLayouts.empty() && !resetsQueries)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(m_layoutMtx);
+        m_layoutFixups.clear();
+
+        for (const auto& use : stream.layoutUses)
+        {
+            auto& txt = m_textures.GetItemR(use.texture);
+            if (!txt.isValid)
+                continue;
+
+            const uint32         count          = static_cast<uint32>(txt.layouts.size());
+            const VkImageLayout* initialLayouts = stream.initialLayouts.data() + use.first;
+            const VkImageLayout* finalLayouts   = stream.finalLayouts.data() + use.first;
+            VkImageLayout*       assumed        = scratch.AllocateArray<VkImageLayout>(count);
+            bool                 needsFixup     = false;
+
+            for (uint32 sub = 0; sub < count; sub++)
+            {
+                assumed[sub] = txt.layouts[sub];
+
+                if (finalLayouts[sub] != VK_IMAGE_LAYOUT_MAX_ENUM && initialLayouts[sub] != VK_IMAGE_LAYOUT_UNDEFINED && initialLayouts[sub] != txt.layouts[sub])
+                {
+                    assumed[sub] = initialLayouts[sub];
+                    needsFixup   = true;
+                }
+            }
+
+            if (needsFixup)
+            {
+                VkImageSubresourceRange range = {};
+                range.aspectMask              = txt.aspectFlags;
+                range.levelCount              = txt.mipLevels;
+                range.layerCount              = txt.arrayLength;
+                AppendImageBarriers(m_layoutFixups, txt, txt.layouts.data(), assumed, range, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, true);
+            }
+
+            for (uint32 sub = 0; sub < count; sub++)
+            {
+                if (finalLayouts[sub] != VK_IMAGE_LAYOUT_MAX_ENUM)
+                    txt.layouts[sub] = finalLayouts[sub];
+            }
+        }
+
+        for (const auto& use : stream.swapchainLayouts)
+        {
+            auto& swp = m_swapchains.GetItemR(use.swapchain);
+            if (!swp.isValid || use.finalLayout == VK_IMAGE_LAYOUT_MAX_ENUM || use.imageIndex >= static_cast<uint32>(swp.imgLayouts.size()))
+                continue;
+
+            VkImageLayout& current = swp.imgLayouts[use.imageIndex];
+
+            if (use.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED && use.initialLayout != current)
+                AppendSwapchainFixup(m_layoutFixups, swp, use.imageIndex, current, use.initialLayout);
+
+            current = use.finalLayout;
+        }
+
+        if (m_layoutFixups.empty() && !resetsQueries)
+            return nullptr;
+
+        // Recorded per submission from the queue's pool of this frame, the stream's own pool is reset on every translation.
+        if (queuePfd.fixupHead == static_cast<uint32>(queuePfd.fixupBuffers.size()))
+        {
+            VkCommandBufferAllocateInfo allocInfo = VkCommandBufferAllocateInfo{};
+            allocInfo.sType                       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.pNext                       = nullptr;
+            allocInfo.commandPool                 = queuePfd.fixupPool;
+            allocInfo.level                       = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount          = 1;
+
+            VkCommandBuffer allocated = nullptr;
+            VkResult        res       = vkAllocateCommandBuffers(m_device, &allocInfo, &allocated);
+            VK_CHECK_RESULT(res, "Failed allocating command buffers");
+            queuePfd.fixupBuffers.push_back(allocated);
+        }
+
+        VkCommandBuffer buffer = queuePfd.fixupBuffers[queuePfd.fixupHead++];
+
+        VkCommandBufferBeginInfo beginInfo = VkCommandBufferBeginInfo{};
+        beginInfo.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext                    = nullptr;
+        beginInfo.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo         = nullptr;
+
+        VkResult res = vkBeginCommandBuffer(buffer, &beginInfo);
+        VK_CHECK_RESULT(res, "Failed beginning command buffer.");
+
+        if (!m_layoutFixups.empty())
+            RecordBarriers(buffer, 0, nullptr, 0, nullptr, static_cast<uint32>(m_layoutFixups.size()), m_layoutFixups.data(), scratch);
+
+        // Without host query reset, outside of any render pass and ahead of the stream on the same queue.
+        if (resetsQueries)
+        {
+            for (const auto& [handle, slot] : stream.writtenQueries)
+                vkCmdResetQueryPool(buffer, m_queryPools.GetItemR(handle).ptr, slot, 1);
+        }
+
+        res = vkEndCommandBuffer(buffer);
+        VK_CHECK_RESULT(res, "Failed ending command buffer!");
+        return buffer;
     }
 
     void VKBackend::CMD_Debug(uint8* data, VKBCommandStream& stream)
@@ -3764,6 +5156,289 @@ namespace LinaGX
         VK_CMD_END_LABEL(stream.buffer);
     }
 
+    void VKBackend::CMD_WriteTimestamp(uint8* data, VKBCommandStream& stream)
+    {
+        CMDWriteTimestamp* cmd  = reinterpret_cast<CMDWriteTimestamp*>(data);
+        const auto&        pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.type == QueryType::Timestamp, "Backend -> Writing a timestamp into a query pool of a different type!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Timestamp query index is out of bounds!");
+        LOGA(stream.type == CommandType::Graphics || stream.type == CommandType::Secondary, "Backend -> Timestamps can only be written from graphics or secondary streams!");
+        const uint32 slot = m_currentFrameIndex * pool.queryCount + cmd->queryIndex;
+        vkCmdWriteTimestamp(stream.buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool.ptr, slot);
+        stream.writtenQueries.push_back({cmd->queryPool, slot});
+    }
+
+    void VKBackend::CMD_BeginQuery(uint8* data, VKBCommandStream& stream)
+    {
+        CMDBeginQuery* cmd  = reinterpret_cast<CMDBeginQuery*>(data);
+        const auto&    pool = m_queryPools.GetItemR(cmd->queryPool);
+        LOGA(pool.type != QueryType::Timestamp, "Backend -> Timestamp queries are written with CMDWriteTimestamp!");
+        LOGA(cmd->queryIndex < pool.queryCount, "Backend -> Query index is out of bounds!");
+        const uint32 slot = m_currentFrameIndex * pool.queryCount + cmd->queryIndex;
+        vkCmdBeginQuery(stream.buffer, pool.ptr, slot, 0);
+        stream.writtenQueries.push_back({cmd->queryPool, slot});
+    }
+
+    void VKBackend::CMD_EndQuery(uint8* data, VKBCommandStream& stream)
+    {
+        CMDEndQuery* cmd  = reinterpret_cast<CMDEndQuery*>(data);
+        const auto&  pool = m_queryPools.GetItemR(cmd->queryPool);
+        vkCmdEndQuery(stream.buffer, pool.ptr, m_currentFrameIndex * pool.queryCount + cmd->queryIndex);
+    }
+
+    void VKBackend::CMD_ResolveQueries(uint8* data, VKBCommandStream& stream)
+    {
+        CMDResolveQueries* cmd    = reinterpret_cast<CMDResolveQueries*>(data);
+        const auto&        pool   = m_queryPools.GetItemR(cmd->queryPool);
+        const auto&        dst    = m_resources.GetItemR(cmd->destination);
+        const uint64       stride = (pool.stride - 1) * sizeof(uint64);
+        LOGA(cmd->firstQuery + cmd->queryCount <= pool.queryCount, "Backend -> Resolved query range is out of bounds!");
+
+        // Waits on the GPU timeline only, the queries must have been ended earlier in the frame.
+        vkCmdCopyQueryPoolResults(stream.buffer, pool.ptr, m_currentFrameIndex * pool.queryCount + cmd->firstQuery, cmd->queryCount, dst.buffer, cmd->destinationOffset, stride, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    }
+
+    void VKBackend::CMD_BeginConditionalRendering(uint8* data, VKBCommandStream& stream)
+    {
+        CMDBeginConditionalRendering* cmd = reinterpret_cast<CMDBeginConditionalRendering*>(data);
+        LOGA(m_supportsConditionalRendering, "Backend -> Conditional rendering requires VKF_ConditionalRendering!");
+
+        // Reads the lower 32 bits of the resolved 64 bit value, enough for zero/non-zero occlusion results.
+        VkConditionalRenderingBeginInfoEXT info = VkConditionalRenderingBeginInfoEXT{};
+        info.sType                              = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+        info.pNext                              = nullptr;
+        info.buffer                             = m_resources.GetItemR(cmd->resource).buffer;
+        info.offset                             = cmd->offset;
+        info.flags                              = cmd->inverted ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : 0;
+        g_vkCmdBeginConditionalRenderingEXT(stream.buffer, &info);
+    }
+
+    void VKBackend::CMD_EndConditionalRendering(uint8* data, VKBCommandStream& stream)
+    {
+        g_vkCmdEndConditionalRenderingEXT(stream.buffer);
+    }
+
+    void VKBackend::ReserveCoalescedDraws(CommandStream* stream)
+    {
+        auto& sr = m_cmdStreams.GetItemR(stream->m_gpuHandle);
+        if (!sr.coalesceIndexedDraws || !m_supportsMultiDrawIndirect || !stream->HasAnyCommand(1ull << CMDID_DrawIndexedInstanced))
+            return;
+
+        // Every indexed draw may end up in the buffer, so it never has to grow while the command buffer is recorded against it.
+        uint32 drawCount = 0;
+        for (uint32 i = 0; i < stream->m_commandCount; i++)
+        {
+            LINAGX_TYPEID tid = 0;
+            LINAGX_MEMCPY(&tid, stream->m_commands[i], sizeof(LINAGX_TYPEID));
+            if (tid == CMDID_DrawIndexedInstanced)
+                drawCount++;
+        }
+
+        if (drawCount <= sr.indirectCapacity)
+            return;
+
+        uint32 capacity = sr.indirectCapacity == 0 ? 256 : sr.indirectCapacity;
+        while (capacity < drawCount)
+            capacity *= 2;
+
+        ResourceDesc desc  = {};
+        desc.size          = capacity * sizeof(IndexedIndirectCommand);
+        desc.typeHintFlags = TH_IndirectBuffer;
+        desc.heapType      = ResourceHeap::StagingHeap;
+        desc.debugName     = "LinaGX Coalesced Draws";
+
+        const uint32 handle = CreateResource(desc);
+        if (handle == m_resources.InvalidHandle)
+            return;
+
+        uint8* mapped = nullptr;
+        MapResource(handle, mapped);
+
+        // The command buffer is about to be re-recorded, so nothing still pending references the old buffer, deferring is only a safety net.
+        if (sr.indirectMapped != nullptr)
+            DeferDestruction(DeferredObjectType::Resource, sr.indirectBuffer);
+
+        sr.indirectBuffer   = handle;
+        sr.indirectMapped   = mapped;
+        sr.indirectCapacity = capacity;
+    }
+
+    void VKBackend::CoalesceIndexedDraw(const CMDDrawIndexedInstanced* cmd, VKBCommandStream& stream)
+    {
+        // Guaranteed minimum of maxDrawIndirectCount when multiDrawIndirect is supported.
+        if (stream.pendingDrawCount == 65535)
+            FlushCoalescedDraws(stream);
+
+        // The buffer couldn't be reserved, record the draw as it is.
+        if (stream.indirectHead == stream.indirectCapacity)
+        {
+            FlushCoalescedDraws(stream);
+            CMD_DrawIndexedInstanced(reinterpret_cast<uint8*>(const_cast<CMDDrawIndexedInstanced*>(cmd)), stream);
+            return;
+        }
+
+        IndexedIndirectCommand* entry = reinterpret_cast<IndexedIndirectCommand*>(stream.indirectMapped) + stream.indirectHead;
+        entry->indexCountPerInstance  = cmd->indexCountPerInstance;
+        entry->instanceCount          = cmd->instanceCount;
+        entry->startIndexLocation     = cmd->startIndexLocation;
+        entry->baseVertexLocation     = cmd->baseVertexLocation;
+        entry->startInstanceLocation  = cmd->startInstanceLocation;
+
+        if (stream.pendingDrawCount == 0)
+            stream.pendingDrawStart = stream.indirectHead;
+
+        stream.indirectHead++;
+        stream.pendingDrawCount++;
+    }
+
+    void VKBackend::FlushCoalescedDraws(VKBCommandStream& stream)
+    {
+        if (stream.pendingDrawCount == 0)
+            return;
+
+        if (stream.pendingDrawCount == 1)
+        {
+            // Not worth an indirect draw, give the entry back.
+            const IndexedIndirectCommand& entry = reinterpret_cast<IndexedIndirectCommand*>(stream.indirectMapped)[stream.pendingDrawStart];
+            vkCmdDrawIndexed(stream.buffer, entry.indexCountPerInstance, entry.instanceCount, entry.startIndexLocation, entry.baseVertexLocation, entry.startInstanceLocation);
+            stream.indirectHead--;
+        }
+        else
+        {
+            const auto& indBuffer = m_resources.GetItemR(stream.indirectBuffer);
+            vkCmdDrawIndexedIndirect(stream.buffer, indBuffer.buffer, stream.pendingDrawStart * sizeof(IndexedIndirectCommand), stream.pendingDrawCount, sizeof(IndexedIndirectCommand));
+            PerformanceStats.coalescedDraws.fetch_add(stream.pendingDrawCount, std::memory_order_relaxed);
+        }
+
+        stream.pendingDrawCount = 0;
+    }
+
+    void VKBackend::InheritRenderPasses(CommandStream* stream)
+    {
+        const CMDBeginRenderPass* pass = nullptr;
+
+        for (uint32 i = 0; i < stream->m_commandCount; i++)
+        {
+            uint8*        data = stream->m_commands[i];
+            LINAGX_TYPEID tid  = 0;
+            LINAGX_MEMCPY(&tid, data, sizeof(LINAGX_TYPEID));
+            uint8* cmd = data + sizeof(CommandHeader);
+
+            if (tid == CMDID_BeginRenderPass)
+                pass = reinterpret_cast<CMDBeginRenderPass*>(cmd);
+            else if (tid == CMDID_EndRenderPass)
+                pass = nullptr;
+
+            if (tid != CMDID_ExecuteSecondaryStream)
+                continue;
+
+            auto& sec              = m_cmdStreams.GetItemR(reinterpret_cast<CMDExecuteSecondaryStream*>(cmd)->secondaryStream->m_gpuHandle);
+            sec.inheritsRenderPass = pass != nullptr;
+            sec.inheritedColorFormats.clear();
+
+            if (pass == nullptr)
+                continue;
+
+            sec.inheritedSamples = VK_SAMPLE_COUNT_1_BIT;
+
+            for (uint32 j = 0; j < pass->colorAttachmentCount; j++)
+            {
+                const auto& att = pass->colorAttachments[j];
+
+                if (att.isSwapchain)
+                    sec.inheritedColorFormats.push_back(m_swapchains.GetItemR(static_cast<uint8>(att.texture)).format);
+                else
+                {
+                    const auto& txt = m_textures.GetItemR(att.texture);
+                    sec.inheritedColorFormats.push_back(txt.format);
+                    sec.inheritedSamples = txt.samples;
+                }
+            }
+
+            const auto& depthStencil   = pass->depthStencilAttachment;
+            sec.inheritedDepthFormat   = VK_FORMAT_UNDEFINED;
+            sec.inheritedStencilFormat = VK_FORMAT_UNDEFINED;
+
+            if (depthStencil.useDepth || depthStencil.useStencil)
+            {
+                const auto& txt            = m_textures.GetItemR(depthStencil.texture);
+                sec.inheritedDepthFormat   = depthStencil.useDepth ? txt.format : VK_FORMAT_UNDEFINED;
+                sec.inheritedStencilFormat = depthStencil.useStencil ? txt.format : VK_FORMAT_UNDEFINED;
+                sec.inheritedSamples       = txt.samples;
+            }
+
+            sec.inheritedViewport.x        = pass->viewport.x;
+            sec.inheritedViewport.y        = pass->viewport.y;
+            sec.inheritedViewport.width    = pass->viewport.width;
+            sec.inheritedViewport.height   = pass->viewport.height;
+            sec.inheritedViewport.minDepth = pass->viewport.minDepth;
+            sec.inheritedViewport.maxDepth = pass->viewport.maxDepth;
+            sec.inheritedScissors.x        = pass->scissors.x;
+            sec.inheritedScissors.y        = pass->scissors.y;
+            sec.inheritedScissors.width    = pass->scissors.width;
+            sec.inheritedScissors.height   = pass->scissors.height;
+        }
+    }
+
+    bool VKBackend::PassExecutesSecondaries(CommandStream* stream, uint32 beginIndex)
+    {
+        bool executesSecondaries = false;
+        bool recordsInline       = false;
+
+        for (uint32 i = beginIndex + 1; i < stream->m_commandCount; i++)
+        {
+            LINAGX_TYPEID tid = 0;
+            LINAGX_MEMCPY(&tid, stream->m_commands[i], sizeof(LINAGX_TYPEID));
+
+            if (tid == CMDID_EndRenderPass)
+                break;
+
+            if (tid == CMDID_ExecuteSecondaryStream)
+                executesSecondaries = true;
+            else if (tid != CMDID_Debug && tid != CMDID_DebugBeginLabel && tid != CMDID_DebugEndLabel)
+                recordsInline = true;
+        }
+
+        if (executesSecondaries && recordsInline)
+        {
+            LOGE("Backend -> Render passes executing secondary streams can't record any other commands, move them into a secondary stream!");
+        }
+
+        return executesSecondaries;
+    }
+
+    uint32 VKBackend::ExecuteSecondaryStreams(CommandStream* stream, uint32 firstIndex, VKBCommandStream& sr)
+    {
+        // Consecutive secondary streams are stitched together with a single vkCmdExecuteCommands.
+        uint32 lastIndex = firstIndex;
+
+        for (uint32 i = firstIndex + 1; i < stream->m_commandCount; i++)
+        {
+            LINAGX_TYPEID tid = 0;
+            LINAGX_MEMCPY(&tid, stream->m_commands[i], sizeof(LINAGX_TYPEID));
+
+            if (tid != CMDID_ExecuteSecondaryStream)
+                break;
+
+            lastIndex = i;
+        }
+
+        const uint32     count   = lastIndex - firstIndex + 1;
+        VkCommandBuffer* buffers = stream->m_scratchArena.AllocateArray<VkCommandBuffer>(count);
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            const CMDExecuteSecondaryStream* cmd       = reinterpret_cast<CMDExecuteSecondaryStream*>(stream->m_commands[firstIndex + i] + sizeof(CommandHeader));
+            const auto&                      secondary = m_cmdStreams.GetItemR(cmd->secondaryStream->m_gpuHandle);
+            buffers[i]                                 = secondary.buffer;
+            InheritLayouts(sr, secondary);
+        }
+
+        FlushBarriers(sr);
+        vkCmdExecuteCommands(sr.buffer, count, buffers);
+        return lastIndex;
+    }
+
     //  void VKBackend::CMD_ComputeBarrier(uint8* data, VKBCommandStream& stream)
     // {
     //     CMDComputeBarrier* cmd    = reinterpret_cast<CMDComputeBarrier*>(data);
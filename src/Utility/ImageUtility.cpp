@@ -36,6 +36,15 @@ OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LinaGX/Common/Math.hpp"
 #include "LinaGX/Common/CommonConfig.hpp"
 
+// Image memory is accounted under AllocationTag::Assets, FreeImage() releases it.
+#define STBI_MALLOC(sz)             LinaGX::AllocateMemory(sz, LinaGX::AllocationTag::Assets)
+#define STBI_REALLOC(p, newsz)      LinaGX::ReallocateMemory(p, newsz, LinaGX::AllocationTag::Assets)
+#define STBI_FREE(p)                LinaGX::FreeMemory(p)
+#define STBIR_MALLOC(size, context) LinaGX::AllocateMemory(size, LinaGX::AllocationTag::Assets)
+#define STBIR_FREE(ptr, context)    LinaGX::FreeMemory(ptr)
+#define STBIW_MALLOC(sz)            LinaGX::AllocateMemory(sz, LinaGX::AllocationTag::Assets)
+#define STBIW_REALLOC(p, newsz)     LinaGX::ReallocateMemory(p, newsz, LinaGX::AllocationTag::Assets)
+#define STBIW_FREE(p)               LinaGX::FreeMemory(p)
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -58,11 +67,8 @@ namespace LinaGX
 
         if (is16 && !force8bit)
         {
-            auto pixels           = stbi_load_16(path, &w, &h, &ch, channels);
+            outData.pixels        = reinterpret_cast<uint8*>(stbi_load_16(path, &w, &h, &ch, channels));
             outData.bytesPerPixel = channels == 0 ? static_cast<uint32>(ch) * 2 : channels * 2;
-            outData.pixels        = new uint8[w * h * outData.bytesPerPixel];
-            LINAGX_MEMCPY(outData.pixels, pixels, w * h * outData.bytesPerPixel);
-            stbi_image_free(pixels);
         }
         else
         {
@@ -112,7 +118,7 @@ namespace LinaGX
             TextureBuffer mipData     = {};
             mipData.width             = width;
             mipData.height            = height;
-            mipData.pixels            = (uint8*)std::malloc(width * height * sourceData.bytesPerPixel);
+            mipData.pixels            = static_cast<uint8*>(AllocateMemory(width * height * sourceData.bytesPerPixel, AllocationTag::Assets));
             mipData.bytesPerPixel     = sourceData.bytesPerPixel;
             const stbir_colorspace cs = linearColorSpace ? stbir_colorspace::STBIR_COLORSPACE_LINEAR : stbir_colorspace::STBIR_COLORSPACE_SRGB;
 
@@ -123,7 +123,7 @@ namespace LinaGX
                     {
                         LOGA((image.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE || image.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT), "Unsupported pixel type!");
 
-                        texture->buffer.pixels        = new unsigned char[image.image.size()];
+                        texture->buffer.pixels        = static_cast<uint8*>(AllocateMemory(image.image.size(), AllocationTag::Assets));
                         texture->buffer.width         = image.width;
                         texture->buffer.height        = image.height;
                         texture->buffer.bytesPerPixel = image.bits / 8 * image.component;
@@ -83,6 +83,11 @@ namespace LinaGX
 
         return wideStrCopy;
 #endif
+
+#if !defined(LINAGX_PLATFORM_WINDOWS) && !defined(LINAGX_PLATFORM_APPLE)
+        LOGE("Platform Utility -> CharToWChar is not supported on this platform!");
+        return nullptr;
+#endif
     }
 
     LINAGX_STRING ReadFileContentsAsString(const char* filePath)
@@ -100,7 +105,7 @@ namespace LinaGX
         uint32 rowPitch = (width * bytesPerPixel + (alignment - 1)) & ~(alignment - 1);
 
         // create a new buffer with the adjusted pitch
-        char* buffer = (char*)LINAGX_MALLOC(rowPitch * height);
+        char* buffer = static_cast<char*>(AllocateMemory(rowPitch * height, AllocationTag::Backend));
 
         // copy each row from the original data to the new buffer
         char* src = static_cast<char*>(data);
@@ -0,0 +1,914 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "LinaGX/Utility/RenderGraph.hpp"
+#include "LinaGX/Core/Instance.hpp"
+#include "LinaGX/Core/CommandStream.hpp"
+#include "LinaGX/Core/Commands.hpp"
+#include "LinaGX/Common/CommonConfig.hpp"
+
+namespace LinaGX
+{
+    namespace
+    {
+        constexpr uint8 RG_PRIMARY_QUEUE = 255;
+
+        uint32 GetShaderStageFlags(CommandType type)
+        {
+            if (type == CommandType::Compute)
+                return PSF_Compute;
+
+            if (type == CommandType::Transfer)
+                return PSF_Transfer;
+
+            return PSF_VertexShader | PSF_FragmentShader | PSF_Compute;
+        }
+
+        /// <summary>
+        /// Work from another queue is ordered by a semaphore wait, which the backends perform at the color attachment stage on graphics queues.
+        /// Barriers after such a wait only need to chain with it.
+        /// </summary>
+        uint32 GetQueueWaitStageFlags(CommandType type)
+        {
+            return type == CommandType::Graphics ? PSF_ColorAttachment : PSF_TopOfPipe;
+        }
+
+        uint32 GetTextureAccessFlags(TextureState state)
+        {
+            switch (state)
+            {
+            case TextureState::ColorAttachment:
+                return AF_ColorAttachmentRead | AF_ColorAttachmentWrite;
+            case TextureState::DepthStencilAttachment:
+                return AF_DepthStencilAttachmentRead | AF_DepthStencilAttachmentWrite;
+            case TextureState::ShaderRead:
+                return AF_ShaderRead;
+            case TextureState::DepthRead:
+            case TextureState::StencilRead:
+            case TextureState::DepthStencilRead:
+                return AF_ShaderRead | AF_DepthStencilAttachmentRead;
+            case TextureState::TransferSource:
+                return AF_TransferRead;
+            case TextureState::TransferDestination:
+                return AF_TransferWrite;
+            case TextureState::Present:
+            default:
+                return 0;
+            }
+        }
+
+        uint32 GetTextureStageFlags(TextureState state, CommandType type, bool isSource)
+        {
+            switch (state)
+            {
+            case TextureState::ColorAttachment:
+                return PSF_ColorAttachment;
+            case TextureState::DepthStencilAttachment:
+                return PSF_EarlyFragment | PSF_LateFragment;
+            case TextureState::ShaderRead:
+                return GetShaderStageFlags(type);
+            case TextureState::DepthRead:
+            case TextureState::StencilRead:
+            case TextureState::DepthStencilRead:
+                return type == CommandType::Graphics ? (GetShaderStageFlags(type) | PSF_EarlyFragment | PSF_LateFragment) : GetShaderStageFlags(type);
+            case TextureState::TransferSource:
+            case TextureState::TransferDestination:
+                return PSF_Transfer;
+            case TextureState::Present:
+            default:
+                // Coming out of present, chain with the image acquire wait.
+                return isSource ? GetQueueWaitStageFlags(type) : static_cast<uint32>(PSF_BottomOfPipe);
+            }
+        }
+
+        uint32 GetResourceAccessFlags(RGResourceAccess access)
+        {
+            switch (access)
+            {
+            case RGResourceAccess::VertexRead:
+                return AF_VertexAttributeRead;
+            case RGResourceAccess::IndexRead:
+                return AF_IndexRead;
+            case RGResourceAccess::IndirectRead:
+                return AF_IndirectCommandRead;
+            case RGResourceAccess::UniformRead:
+                return AF_UniformRead;
+            case RGResourceAccess::ShaderRead:
+                return AF_ShaderRead;
+            case RGResourceAccess::ShaderWrite:
+                return AF_ShaderRead | AF_ShaderWrite;
+            case RGResourceAccess::TransferRead:
+                return AF_TransferRead;
+            case RGResourceAccess::TransferWrite:
+                return AF_TransferWrite;
+            case RGResourceAccess::ConditionalRenderingRead:
+            default:
+                return AF_ConditionalRenderingRead;
+            }
+        }
+
+        uint32 GetResourceStageFlags(RGResourceAccess access, CommandType type)
+        {
+            switch (access)
+            {
+            case RGResourceAccess::VertexRead:
+            case RGResourceAccess::IndexRead:
+                return PSF_VertexInput;
+            case RGResourceAccess::IndirectRead:
+                return PSF_DrawIndirect;
+            case RGResourceAccess::UniformRead:
+            case RGResourceAccess::ShaderRead:
+            case RGResourceAccess::ShaderWrite:
+                return GetShaderStageFlags(type);
+            case RGResourceAccess::TransferRead:
+            case RGResourceAccess::TransferWrite:
+                return PSF_Transfer;
+            case RGResourceAccess::ConditionalRenderingRead:
+            default:
+                return PSF_ConditionalRendering;
+            }
+        }
+
+        /// <summary>
+        /// Only the accesses with a matching ResourceBarrierState are transitioned, the rest are synchronized with memory barriers.
+        /// </summary>
+        bool GetResourceBarrierState(RGResourceAccess access, ResourceBarrierState& outState)
+        {
+            if (access == RGResourceAccess::TransferRead)
+                outState = ResourceBarrierState::TransferRead;
+            else if (access == RGResourceAccess::TransferWrite)
+                outState = ResourceBarrierState::TransferWrite;
+            else if (access == RGResourceAccess::ConditionalRenderingRead)
+                outState = ResourceBarrierState::ConditionalRenderingRead;
+            else
+                return false;
+
+            return true;
+        }
+
+        /// <summary>
+        /// State of a node while walking the live passes in Compile().
+        /// </summary>
+        struct NodeTracker
+        {
+            TextureState         state           = TextureState::ShaderRead;
+            bool                 hasBarrierState = false;
+            ResourceBarrierState barrierState    = ResourceBarrierState::TransferRead;
+            uint32               accessFlags     = 0; // All accesses since the last barrier.
+            uint32               stageFlags      = 0;
+            bool                 written         = false; // Whether a write happened since the last barrier.
+            int32                lastBatch       = -1;
+            int32                writeBatch      = -1;
+            LINAGX_VEC<uint32>   readBatches; // Batches reading since the last write.
+        };
+
+        constexpr uint32 WRITE_ACCESS_FLAGS = AF_ShaderWrite | AF_ColorAttachmentWrite | AF_DepthStencilAttachmentWrite | AF_TransferWrite | AF_MemoryWrite;
+
+        /// <summary>
+        /// Accesses to the transient textures of a queue, a texture can alias any of them so its first barrier waits for all.
+        /// </summary>
+        struct TransientQueueAccess
+        {
+            uint8  queue            = 0;
+            uint32 stageFlags       = 0;
+            uint32 writeAccessFlags = 0;
+        };
+
+        struct TransientDiscard
+        {
+            uint32 pass           = 0;
+            uint8  queue          = 0;
+            uint32 dstAccessFlags = 0;
+        };
+
+        void AddWait(LINAGX_VEC<uint32>& waits, const LINAGX_VEC<uint32>& batchQueues, uint32 batch)
+        {
+            // Waiting for the latest batch of a queue covers all the earlier ones.
+            for (auto& wait : waits)
+            {
+                if (batchQueues[wait] == batchQueues[batch])
+                {
+                    wait = wait > batch ? wait : batch;
+                    return;
+                }
+            }
+
+            waits.push_back(batch);
+        }
+    } // namespace
+
+    RenderGraph::RenderGraph(Instance* lgx, const CommandStreamDesc& streamDesc)
+        : m_lgx(lgx), m_streamDesc(streamDesc)
+    {
+        m_streamDesc.debugName  = "LinaGXRenderGraphStream";
+        m_streamDesc.persistent = false;
+        m_streamPools.resize(Config.framesInFlight);
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        for (auto& pool : m_streamPools)
+        {
+            for (auto& streams : pool.streams)
+            {
+                for (auto* stream : streams)
+                    m_lgx->DestroyCommandStream(stream);
+            }
+        }
+
+        for (const auto& qs : m_semaphores)
+            m_lgx->DestroyUserSemaphore(qs.semaphore);
+
+        DestroyTransientTextures();
+    }
+
+    uint32 RenderGraph::AddNode(const Node& node)
+    {
+        m_compiled = false;
+        m_nodes.push_back(node);
+        return static_cast<uint32>(m_nodes.size() - 1);
+    }
+
+    uint32 RenderGraph::ImportTexture(uint32 texture, TextureState initialState, TextureState finalState)
+    {
+        Node node         = {};
+        node.handle       = texture;
+        node.isTexture    = true;
+        node.initialState = initialState;
+        node.finalState   = finalState;
+        return AddNode(node);
+    }
+
+    uint32 RenderGraph::ImportSwapchain(uint8 swapchain, TextureState initialState, TextureState finalState)
+    {
+        Node node         = {};
+        node.handle       = swapchain;
+        node.isTexture    = true;
+        node.isSwapchain  = true;
+        node.isOutput     = true;
+        node.initialState = initialState;
+        node.finalState   = finalState;
+        return AddNode(node);
+    }
+
+    uint32 RenderGraph::ImportResource(uint32 resource)
+    {
+        Node node   = {};
+        node.handle = resource;
+        return AddNode(node);
+    }
+
+    uint32 RenderGraph::CreateTransientTexture(const TextureDesc& desc)
+    {
+        m_transientDescs.push_back(desc);
+
+        Node node        = {};
+        node.isTexture   = true;
+        node.isTransient = true;
+        node.transient   = static_cast<uint32>(m_transientDescs.size() - 1);
+        return AddNode(node);
+    }
+
+    uint32 RenderGraph::AddPass(const RGPassDesc& desc)
+    {
+        LOGA(desc.type != CommandType::Secondary, "RenderGraph -> Passes are recorded into primary streams, secondary type is not supported!");
+
+        Pass pass = {};
+        pass.desc = desc;
+
+        if (pass.desc.queue == RG_PRIMARY_QUEUE)
+            pass.desc.queue = m_lgx->GetPrimaryQueue(desc.type);
+
+        m_compiled = false;
+        m_passes.push_back(pass);
+        return static_cast<uint32>(m_passes.size() - 1);
+    }
+
+    void RenderGraph::AddAccess(uint32 pass, const Access& access)
+    {
+        LOGA(pass < static_cast<uint32>(m_passes.size()) && access.node < static_cast<uint32>(m_nodes.size()), "RenderGraph -> Invalid pass or node handle!");
+        LOGA(!m_nodes[access.node].isSwapchain || m_passes[pass].desc.type == CommandType::Graphics, "RenderGraph -> Swapchains can only be accessed by graphics passes!");
+
+        auto& accesses = m_passes[pass].accesses;
+        for (const auto& existing : accesses)
+        {
+            LOGA(existing.node != access.node, "RenderGraph -> A texture or resource can only be declared once per pass, declare the write if the pass both reads and writes it!");
+        }
+
+        m_compiled = false;
+        accesses.push_back(access);
+    }
+
+    void RenderGraph::ReadTexture(uint32 pass, uint32 texture, TextureState state)
+    {
+        LOGA(m_nodes[texture].isTexture, "RenderGraph -> Node is not a texture!");
+        Access access = {};
+        access.node   = texture;
+        access.state  = state;
+        AddAccess(pass, access);
+    }
+
+    void RenderGraph::WriteTexture(uint32 pass, uint32 texture, TextureState state)
+    {
+        LOGA(m_nodes[texture].isTexture, "RenderGraph -> Node is not a texture!");
+        Access access = {};
+        access.node   = texture;
+        access.state  = state;
+        access.write  = true;
+        AddAccess(pass, access);
+    }
+
+    void RenderGraph::ReadResource(uint32 pass, uint32 resource, RGResourceAccess resourceAccess)
+    {
+        LOGA(!m_nodes[resource].isTexture, "RenderGraph -> Node is not a resource!");
+        Access access   = {};
+        access.node     = resource;
+        access.resource = resourceAccess;
+        AddAccess(pass, access);
+    }
+
+    void RenderGraph::WriteResource(uint32 pass, uint32 resource, RGResourceAccess resourceAccess)
+    {
+        LOGA(!m_nodes[resource].isTexture, "RenderGraph -> Node is not a resource!");
+        Access access   = {};
+        access.node     = resource;
+        access.resource = resourceAccess;
+        access.write    = true;
+        AddAccess(pass, access);
+    }
+
+    void RenderGraph::MarkOutput(uint32 handle)
+    {
+        m_compiled               = false;
+        m_nodes[handle].isOutput = true;
+    }
+
+    void RenderGraph::Compile()
+    {
+        m_batches.clear();
+        m_statistics           = {};
+        m_statistics.passCount = static_cast<uint32>(m_passes.size());
+
+        // Walk backwards from the outputs, a pass is live if it has side effects or writes to something a live pass or the outside needs.
+        // Needed nodes are never cleared on writes, as attachments might be loaded, so earlier writers are kept conservatively.
+        LINAGX_VEC<bool> nodeNeeded(m_nodes.size(), false);
+        for (size_t i = 0; i < m_nodes.size(); i++)
+            nodeNeeded[i] = m_nodes[i].isOutput;
+
+        for (int32 i = static_cast<int32>(m_passes.size()) - 1; i >= 0; i--)
+        {
+            auto& pass = m_passes[i];
+            bool  live = pass.desc.sideEffects;
+
+            for (const auto& access : pass.accesses)
+            {
+                if (access.write && nodeNeeded[access.node])
+                    live = true;
+            }
+
+            pass.culled = !live;
+
+            if (!live)
+            {
+                m_statistics.culledPassCount++;
+                continue;
+            }
+
+            for (const auto& access : pass.accesses)
+                nodeNeeded[access.node] = true;
+        }
+
+        CreateTransientTextures();
+
+        // Consecutive live passes on the same queue go into a single submission.
+        LINAGX_VEC<uint32> batchQueues;
+        LINAGX_VEC<uint32> passBatches(m_passes.size(), 0);
+        uint32             streamCounts[3] = {0, 0, 0};
+
+        for (uint32 i = 0; i < static_cast<uint32>(m_passes.size()); i++)
+        {
+            const auto& pass = m_passes[i];
+            if (pass.culled)
+                continue;
+
+            if (m_batches.empty() || m_batches.back().queue != pass.desc.queue)
+            {
+                Batch batch       = {};
+                batch.queue       = pass.desc.queue;
+                batch.type        = pass.desc.type;
+                batch.streamIndex = streamCounts[static_cast<uint32>(pass.desc.type)]++;
+                m_batches.push_back(batch);
+                batchQueues.push_back(pass.desc.queue);
+            }
+
+            passBatches[i] = static_cast<uint32>(m_batches.size() - 1);
+            m_batches.back().passes.push_back(i);
+        }
+
+        // Derive barriers & cross-queue waits in execution order.
+        LINAGX_VEC<NodeTracker> trackers(m_nodes.size());
+        for (size_t i = 0; i < m_nodes.size(); i++)
+        {
+            const auto& node = m_nodes[i];
+            if (!node.isTexture || node.isTransient)
+                continue;
+
+            trackers[i].state       = node.initialState;
+            trackers[i].accessFlags = GetTextureAccessFlags(node.initialState);
+        }
+
+        LINAGX_VEC<TransientQueueAccess> transientAccesses;
+        LINAGX_VEC<TransientDiscard>     transientDiscards;
+
+        for (uint32 i = 0; i < static_cast<uint32>(m_passes.size()); i++)
+        {
+            auto& pass    = m_passes[i];
+            pass.barriers = {};
+
+            if (pass.culled)
+                continue;
+
+            const uint32 batchIndex = passBatches[i];
+            auto&        batch      = m_batches[batchIndex];
+            MemBarrier   memBarrier = {};
+
+            for (const auto& access : pass.accesses)
+            {
+                const auto&  node        = m_nodes[access.node];
+                auto&        tracker     = trackers[access.node];
+                const bool   otherQueue  = tracker.lastBatch != -1 && batchQueues[tracker.lastBatch] != batch.queue;
+                const uint32 dstAccess   = node.isTexture ? GetTextureAccessFlags(access.state) : GetResourceAccessFlags(access.resource);
+                const uint32 dstStage    = node.isTexture ? GetTextureStageFlags(access.state, batch.type, false) : GetResourceStageFlags(access.resource, batch.type);
+                uint32       srcAccess   = tracker.accessFlags;
+                uint32       srcStage    = tracker.stageFlags;
+                bool         needBarrier = access.write || tracker.written;
+
+                // Read after write, or any access after reads on another queue, has to wait for those batches.
+                if (tracker.writeBatch != -1 && batchQueues[tracker.writeBatch] != batch.queue)
+                    AddWait(batch.waitBatches, batchQueues, static_cast<uint32>(tracker.writeBatch));
+
+                if (access.write)
+                {
+                    for (auto readBatch : tracker.readBatches)
+                    {
+                        if (batchQueues[readBatch] != batch.queue)
+                            AddWait(batch.waitBatches, batchQueues, readBatch);
+                    }
+                }
+
+                // Transient contents are undefined on first use, whatever aliased the memory before is waited for after the walk.
+                const bool discard = node.isTransient && tracker.lastBatch == -1;
+
+                if (discard)
+                {
+                    needBarrier = true;
+                    srcAccess   = 0;
+                    srcStage    = PSF_TopOfPipe;
+                    transientDiscards.push_back({i, batch.queue, dstAccess});
+                }
+                else if (node.isTexture)
+                {
+                    needBarrier = needBarrier || tracker.state != access.state;
+
+                    if (tracker.lastBatch == -1)
+                        srcStage = GetTextureStageFlags(tracker.state, batch.type, true);
+                }
+
+                if (node.isTransient)
+                {
+                    auto it = std::find_if(transientAccesses.begin(), transientAccesses.end(), [&](const TransientQueueAccess& ta) { return ta.queue == batch.queue; });
+                    if (it == transientAccesses.end())
+                    {
+                        transientAccesses.push_back({batch.queue, 0, 0});
+                        it = transientAccesses.end() - 1;
+                    }
+
+                    it->stageFlags |= dstStage;
+                    it->writeAccessFlags |= dstAccess & WRITE_ACCESS_FLAGS;
+                }
+
+                ResourceBarrierState barrierState    = ResourceBarrierState::TransferRead;
+                const bool           hasBarrierState = !node.isTexture && GetResourceBarrierState(access.resource, barrierState);
+                if (hasBarrierState)
+                    needBarrier = needBarrier || !tracker.hasBarrierState || tracker.barrierState != barrierState;
+
+                // The semaphore wait already made the other queue's writes available.
+                if (otherQueue)
+                {
+                    srcAccess = 0;
+                    srcStage  = GetQueueWaitStageFlags(batch.type);
+                }
+
+                if (needBarrier)
+                {
+                    if (node.isTexture)
+                    {
+                        TextureBarrier barrier  = {};
+                        barrier.texture         = node.handle;
+                        barrier.isSwapchain     = node.isSwapchain;
+                        barrier.toState         = access.state;
+                        barrier.srcAccessFlags  = srcAccess;
+                        barrier.dstAccessFlags  = dstAccess;
+                        barrier.discardContents = discard;
+                        barrier.srcStageFlags   = discard ? 0 : srcStage; // Discards wait on every transient of the queue, see below.
+                        barrier.dstStageFlags   = dstStage;
+                        pass.barriers.textureBarriers.push_back(barrier);
+                    }
+                    else if (hasBarrierState)
+                    {
+                        ResourceBarrier barrier = {};
+                        barrier.resource        = node.handle;
+                        barrier.toState         = barrierState;
+                        barrier.srcAccessFlags  = srcAccess;
+                        barrier.dstAccessFlags  = dstAccess;
+                        barrier.srcStageFlags   = srcStage;
+                        barrier.dstStageFlags   = dstStage;
+                        pass.barriers.resourceBarriers.push_back(barrier);
+                    }
+                    else
+                    {
+                        memBarrier.srcAccessFlags |= srcAccess;
+                        memBarrier.dstAccessFlags |= dstAccess;
+                    }
+
+                    pass.barriers.srcStageFlags |= srcStage == 0 ? static_cast<uint32>(PSF_TopOfPipe) : srcStage;
+                    pass.barriers.dstStageFlags |= dstStage;
+
+                    tracker.accessFlags = dstAccess;
+                    tracker.stageFlags  = dstStage;
+                    tracker.written     = access.write;
+                }
+                else
+                {
+                    // Read after read in the same state, merge so a later write waits for both.
+                    tracker.accessFlags |= dstAccess;
+                    tracker.stageFlags |= dstStage;
+                }
+
+                if (node.isTexture)
+                    tracker.state = access.state;
+
+                if (hasBarrierState)
+                {
+                    tracker.hasBarrierState = true;
+                    tracker.barrierState    = barrierState;
+                }
+
+                if (access.write)
+                {
+                    tracker.writeBatch = static_cast<int32>(batchIndex);
+                    tracker.readBatches.clear();
+                }
+                else if (tracker.readBatches.empty() || tracker.readBatches.back() != batchIndex)
+                    tracker.readBatches.push_back(batchIndex);
+
+                tracker.lastBatch = static_cast<int32>(batchIndex);
+            }
+
+            if (memBarrier.srcAccessFlags != 0 || memBarrier.dstAccessFlags != 0)
+                pass.barriers.memoryBarriers.push_back(memBarrier);
+        }
+
+        // Memory of a transient texture might have been used by any transient on the same queue, within this frame or the previous one.
+        for (const auto& discard : transientDiscards)
+        {
+            const auto it = std::find_if(transientAccesses.begin(), transientAccesses.end(), [&](const TransientQueueAccess& ta) { return ta.queue == discard.queue; });
+            auto&      barriers = m_passes[discard.pass].barriers;
+            barriers.srcStageFlags |= it->stageFlags;
+
+            if (it->writeAccessFlags == 0)
+                continue;
+
+            if (barriers.memoryBarriers.empty())
+                barriers.memoryBarriers.push_back({});
+
+            barriers.memoryBarriers.back().srcAccessFlags |= it->writeAccessFlags;
+            barriers.memoryBarriers.back().dstAccessFlags |= discard.dstAccessFlags;
+        }
+
+        // Imported textures go back to their final state after the last batch using them.
+        for (uint32 i = 0; i < static_cast<uint32>(m_nodes.size()); i++)
+        {
+            const auto& node    = m_nodes[i];
+            const auto& tracker = trackers[i];
+
+            if (!node.isTexture || node.isTransient || tracker.lastBatch == -1 || tracker.state == node.finalState)
+                continue;
+
+            auto& batch = m_batches[tracker.lastBatch];
+
+            TextureBarrier barrier = {};
+            barrier.texture        = node.handle;
+            barrier.isSwapchain    = node.isSwapchain;
+            barrier.toState        = node.finalState;
+            barrier.srcAccessFlags = tracker.accessFlags;
+            barrier.dstAccessFlags = GetTextureAccessFlags(node.finalState);
+            barrier.srcStageFlags  = tracker.stageFlags;
+            barrier.dstStageFlags  = GetTextureStageFlags(node.finalState, batch.type, false);
+            batch.finalBarriers.textureBarriers.push_back(barrier);
+            batch.finalBarriers.srcStageFlags |= tracker.stageFlags;
+            batch.finalBarriers.dstStageFlags |= GetTextureStageFlags(node.finalState, batch.type, false);
+        }
+
+        for (auto& batch : m_batches)
+        {
+            for (auto wait : batch.waitBatches)
+                m_batches[wait].signal = true;
+
+            m_statistics.queueWaits += static_cast<uint32>(batch.waitBatches.size());
+        }
+
+        for (auto& batch : m_batches)
+        {
+            if (batch.signal)
+                GetQueueSemaphore(batch.queue);
+
+            for (auto passIndex : batch.passes)
+            {
+                const auto& barriers = m_passes[passIndex].barriers;
+                const bool  any      = !barriers.textureBarriers.empty() || !barriers.resourceBarriers.empty() || !barriers.memoryBarriers.empty();
+                m_statistics.barrierCount += any ? 1 : 0;
+                m_statistics.textureBarriers += static_cast<uint32>(barriers.textureBarriers.size());
+                m_statistics.resourceBarriers += static_cast<uint32>(barriers.resourceBarriers.size());
+                m_statistics.memoryBarriers += static_cast<uint32>(barriers.memoryBarriers.size());
+            }
+
+            m_statistics.barrierCount += batch.finalBarriers.textureBarriers.empty() ? 0 : 1;
+            m_statistics.textureBarriers += static_cast<uint32>(batch.finalBarriers.textureBarriers.size());
+        }
+
+        m_statistics.batchCount = static_cast<uint32>(m_batches.size());
+        m_compiled              = true;
+    }
+
+    void RenderGraph::Execute()
+    {
+        LOGA(m_compiled, "RenderGraph -> Graph was modified, call Compile() before executing!");
+
+        const uint32 frameIndex = m_lgx->GetCurrentFrameIndex();
+        m_frameStreams.clear();
+
+        for (const auto& batch : m_batches)
+        {
+            CommandStream* stream = GetStream(frameIndex, batch);
+
+            for (auto passIndex : batch.passes)
+            {
+                const auto& pass = m_passes[passIndex];
+                RecordBarriers(stream, pass.barriers);
+
+                CMDDebugBeginLabel* label = stream->AddCommand<CMDDebugBeginLabel>();
+                label->label              = pass.desc.name;
+
+                if (pass.desc.record)
+                    pass.desc.record(stream);
+
+                stream->AddCommand<CMDDebugEndLabel>();
+            }
+
+            RecordBarriers(stream, batch.finalBarriers);
+            m_frameStreams.push_back(stream);
+        }
+
+        if (m_frameStreams.empty())
+            return;
+
+        m_lgx->CloseCommandStreams(m_frameStreams.data(), static_cast<uint32>(m_frameStreams.size()));
+
+        for (uint32 i = 0; i < static_cast<uint32>(m_batches.size()); i++)
+        {
+            auto& batch = m_batches[i];
+
+            m_waitSemaphores.clear();
+            m_waitValues.clear();
+
+            for (auto wait : batch.waitBatches)
+            {
+                m_waitSemaphores.push_back(GetQueueSemaphore(m_batches[wait].queue).semaphore);
+                m_waitValues.push_back(m_batches[wait].signalValue);
+            }
+
+            uint16 signalSemaphore = 0;
+
+            if (batch.signal)
+            {
+                auto& qs          = GetQueueSemaphore(batch.queue);
+                batch.signalValue = ++qs.value;
+                signalSemaphore   = qs.semaphore;
+            }
+
+            SubmitDesc submit       = {};
+            submit.targetQueue      = batch.queue;
+            submit.streams          = &m_frameStreams[i];
+            submit.streamCount      = 1;
+            submit.useWait          = !m_waitSemaphores.empty();
+            submit.waitCount        = static_cast<uint32>(m_waitSemaphores.size());
+            submit.waitSemaphores   = m_waitSemaphores.data();
+            submit.waitValues       = m_waitValues.data();
+            submit.useSignal        = batch.signal;
+            submit.signalCount      = batch.signal ? 1 : 0;
+            submit.signalSemaphores = &signalSemaphore;
+            submit.signalValues     = &batch.signalValue;
+            m_lgx->SubmitCommandStreams(submit);
+        }
+    }
+
+    void RenderGraph::Reset()
+    {
+        DestroyTransientTextures();
+        m_transientDescs.clear();
+        m_nodes.clear();
+        m_passes.clear();
+        m_batches.clear();
+        m_statistics = {};
+        m_compiled   = false;
+    }
+
+    bool RenderGraph::IsPassCulled(uint32 pass) const
+    {
+        return m_passes[pass].culled;
+    }
+
+    uint32 RenderGraph::GetTexture(uint32 handle) const
+    {
+        LOGA(!m_nodes[handle].isTransient || m_compiled, "RenderGraph -> Transient textures are created by Compile()!");
+        return m_nodes[handle].handle;
+    }
+
+    void RenderGraph::CreateTransientTextures()
+    {
+        DestroyTransientTextures();
+
+        struct Lifetime
+        {
+            int32 firstUse = -1;
+            int32 lastUse  = -1;
+            uint8 queue    = 0;
+        };
+
+        LINAGX_VEC<Lifetime> lifetimes(m_transientDescs.size());
+        LINAGX_VEC<uint8>    queues;
+
+        for (uint32 i = 0; i < static_cast<uint32>(m_passes.size()); i++)
+        {
+            const auto& pass = m_passes[i];
+            if (pass.culled)
+                continue;
+
+            for (const auto& access : pass.accesses)
+            {
+                const auto& node = m_nodes[access.node];
+                if (!node.isTransient)
+                    continue;
+
+                auto& lt = lifetimes[node.transient];
+                LOGA(lt.firstUse == -1 || lt.queue == pass.desc.queue, "RenderGraph -> Transient textures can only be used on a single queue!");
+
+                if (lt.firstUse == -1)
+                {
+                    lt.firstUse = static_cast<int32>(i);
+                    lt.queue    = pass.desc.queue;
+
+                    if (std::find(queues.begin(), queues.end(), pass.desc.queue) == queues.end())
+                        queues.push_back(pass.desc.queue);
+                }
+
+                lt.lastUse = static_cast<int32>(i);
+            }
+        }
+
+        for (auto queue : queues)
+        {
+            TransientTextureGroupDesc groupDesc = {};
+            groupDesc.debugName                 = "RenderGraphTransients";
+            LINAGX_VEC<uint32> groupNodes;
+
+            for (uint32 i = 0; i < static_cast<uint32>(m_nodes.size()); i++)
+            {
+                const auto& node = m_nodes[i];
+                if (!node.isTransient)
+                    continue;
+
+                const auto& lt = lifetimes[node.transient];
+                if (lt.firstUse == -1 || lt.queue != queue)
+                    continue;
+
+                TransientTextureDesc desc = {};
+                desc.desc                 = m_transientDescs[node.transient];
+                desc.firstUse             = static_cast<uint32>(lt.firstUse);
+                desc.lastUse              = static_cast<uint32>(lt.lastUse);
+                groupDesc.textures.push_back(desc);
+                groupNodes.push_back(i);
+            }
+
+            TransientTextureGroupInfo info = {};
+            m_transientGroups.push_back(m_lgx->CreateTransientTextureGroup(groupDesc, info));
+
+            for (size_t i = 0; i < groupNodes.size(); i++)
+                m_nodes[groupNodes[i]].handle = info.textures[i];
+
+            m_statistics.transientMemory += info.allocatedSize;
+            m_statistics.transientUnaliased += info.requiredSize;
+        }
+    }
+
+    void RenderGraph::DestroyTransientTextures()
+    {
+        for (auto group : m_transientGroups)
+            m_lgx->DestroyTransientTextureGroup(group);
+
+        m_transientGroups.clear();
+    }
+
+    void RenderGraph::RecordBarriers(CommandStream* stream, const Barriers& barriers)
+    {
+        const uint32 textureCount  = static_cast<uint32>(barriers.textureBarriers.size());
+        const uint32 resourceCount = static_cast<uint32>(barriers.resourceBarriers.size());
+        const uint32 memoryCount   = static_cast<uint32>(barriers.memoryBarriers.size());
+
+        if (textureCount == 0 && resourceCount == 0 && memoryCount == 0)
+            return;
+
+        CMDBarrier* barrier    = stream->AddCommand<CMDBarrier>();
+        barrier->srcStageFlags = barriers.srcStageFlags;
+        barrier->dstStageFlags = barriers.dstStageFlags;
+
+        if (textureCount != 0)
+        {
+            barrier->textureBarrierCount = textureCount;
+            barrier->textureBarriers     = stream->EmplaceInline<TextureBarrier>((void*)barriers.textureBarriers.data(), sizeof(TextureBarrier) * textureCount);
+        }
+
+        if (resourceCount != 0)
+        {
+            barrier->resourceBarrierCount = resourceCount;
+            barrier->resourceBarriers     = stream->EmplaceInline<ResourceBarrier>((void*)barriers.resourceBarriers.data(), sizeof(ResourceBarrier) * resourceCount);
+        }
+
+        if (memoryCount != 0)
+        {
+            barrier->memoryBarrierCount = memoryCount;
+            barrier->memoryBarriers     = stream->EmplaceInline<MemBarrier>((void*)barriers.memoryBarriers.data(), sizeof(MemBarrier) * memoryCount);
+        }
+    }
+
+    RenderGraph::QueueSemaphore& RenderGraph::GetQueueSemaphore(uint8 queue)
+    {
+        for (auto& qs : m_semaphores)
+        {
+            if (qs.queue == queue)
+                return qs;
+        }
+
+        QueueSemaphore qs = {};
+        qs.queue          = queue;
+        qs.semaphore      = m_lgx->CreateUserSemaphore();
+        m_semaphores.push_back(qs);
+        return m_semaphores.back();
+    }
+
+    CommandStream* RenderGraph::GetStream(uint32 frameIndex, const Batch& batch)
+    {
+        auto& streams = m_streamPools[frameIndex].streams[static_cast<uint32>(batch.type)];
+
+        while (streams.size() <= batch.streamIndex)
+        {
+            CommandStreamDesc desc = m_streamDesc;
+            desc.type              = batch.type;
+            streams.push_back(m_lgx->CreateCommandStream(desc));
+        }
+
+        return streams[batch.streamIndex];
+    }
+} // namespace LinaGX
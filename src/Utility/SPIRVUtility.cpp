@@ -442,7 +442,21 @@ namespace LinaGX
 
     bool SPIRVUtility::GLSL2SPV(ShaderStage stg, const LINAGX_STRING& pShader, const LINAGX_STRING& includePath, DataBlob& compiledBlob, ShaderLayout& outLayout, BackendAPI targetAPI)
     {
-        LINAGX_STRING fullShaderStr = "";
+        LINAGX_STRING processedShader = "";
+        bool          usesDrawID      = false;
+        if (!CompileGLSL(stg, pShader, includePath, compiledBlob, processedShader, usesDrawID, targetAPI))
+            return false;
+
+        if (usesDrawID)
+            outLayout.hasGLDrawID = true;
+
+        ReflectSPV(stg, compiledBlob, processedShader, outLayout);
+        return true;
+    }
+
+    bool SPIRVUtility::CompileGLSL(ShaderStage stg, const LINAGX_STRING& pShader, const LINAGX_STRING& includePath, DataBlob& compiledBlob, LINAGX_STRING& outProcessedShader, bool& outUsesDrawID, BackendAPI targetAPI)
+    {
+        LINAGX_STRING& fullShaderStr = outProcessedShader;
         GetShaderTextWithIncludes(fullShaderStr, pShader, includePath);
 
         auto replace = [&fullShaderStr](const LINAGX_STRING& search, const LINAGX_STRING& replace) -> bool {
@@ -466,7 +480,7 @@ namespace LinaGX
         {
             if (replace("LGX_DRAW_ID", "LGX_GET_DRAW_ID()"))
             {
-                outLayout.hasGLDrawID          = true;
+                outUsesDrawID                  = true;
                 const LINAGX_STRING constDecl  = "\nint LGX_GET_DRAW_ID() { return 0; } \n";
                 size_t              versionPos = fullShaderStr.find("#version");
 
@@ -484,7 +498,7 @@ namespace LinaGX
         else
             replace("LGX_DRAW_ID", "gl_DrawID");
 
-        if (targetAPI == BackendAPI::Vulkan || targetAPI == BackendAPI::Metal)
+        if (targetAPI == BackendAPI::Vulkan || targetAPI == BackendAPI::Metal || targetAPI == BackendAPI::Null)
         {
             replace("LGX_DEFINE_INDEXED_INDIRECT;", "struct LGXIndexedIndirectCommand\n{\n uint indexCount;\n uint instanceCount;\n uint firstIndex;\n int vertexOffset;\n uint firstInstance;\n};\n");
             replace("LGX_DEFINE_INDIRECT;", "struct LGXIndirectCommand\n{\n uint vertexCount;\n uint instanceCount;\n uint startVertex;\n uint baseInstance;\n};\n");
@@ -589,8 +603,12 @@ namespace LinaGX
 
         glslang_program_delete(program);
         glslang_shader_delete(shader);
+        return true;
+    }
 
-        spirv_cross::CompilerGLSL    compiler(std::move(spirvBinary));
+    void SPIRVUtility::ReflectSPV(ShaderStage stg, const DataBlob& spv, const LINAGX_STRING& fullShaderStr, ShaderLayout& outLayout)
+    {
+        spirv_cross::CompilerGLSL    compiler(reinterpret_cast<const uint32*>(spv.ptr), spv.size / sizeof(uint32));
         spirv_cross::ShaderResources resources       = compiler.get_shader_resources();
         auto                         activeResources = compiler.get_active_interface_variables();
 
@@ -1011,8 +1029,6 @@ namespace LinaGX
                 }
             }
         }
-
-        return true;
     }
 
     spv::ExecutionModel GetExecStage(ShaderStage stg)
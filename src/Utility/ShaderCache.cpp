@@ -0,0 +1,573 @@
+/*
+This file is a part of: LinaGX
+https://github.com/inanevin/LinaGX
+
+Author: Inan Evin
+http://www.inanevin.com
+
+The 2-Clause BSD License
+
+Copyright (c) [2023-] Inan Evin
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+   1. Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "LinaGX/Utility/ShaderCache.hpp"
+#include "LinaGX/Utility/SPIRVUtility.hpp"
+#include "LinaGX/Common/CommonConfig.hpp"
+#include <fstream>
+#include <cstdio>
+#include <type_traits>
+
+namespace LinaGX
+{
+    std::mutex                            ShaderCache::s_mtx;
+    LINAGX_MAP<uint64, LINAGX_VEC<uint8>> ShaderCache::s_entries;
+
+    namespace
+    {
+        constexpr uint32 SHADER_CACHE_MAGIC   = 0x4353474C; // LGSC
+        constexpr uint32 SHADER_CACHE_VERSION = 1;
+        constexpr uint64 FNV64_OFFSET_BASIS   = 14695981039346656037ull;
+        constexpr uint64 FNV64_PRIME          = 1099511628211ull;
+
+        void HashBytes(uint64& hash, const void* data, size_t size)
+        {
+            const uint8* bytes = static_cast<const uint8*>(data);
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= bytes[i];
+                hash *= FNV64_PRIME;
+            }
+        }
+
+        class CacheWriter
+        {
+        public:
+            CacheWriter(LINAGX_VEC<uint8>& data)
+                : m_data(data){};
+
+            template <typename T>
+            void Write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= 4, "Use a fixed size overload for wider types!");
+                const uint32 widened = static_cast<uint32>(value);
+                WriteBytes(&widened, sizeof(uint32));
+            }
+
+            void Write(uint64 value)
+            {
+                WriteBytes(&value, sizeof(uint64));
+            }
+
+            void WriteSize(size_t value)
+            {
+                Write(static_cast<uint64>(value));
+            }
+
+            void Write(const LINAGX_STRING& str)
+            {
+                WriteSize(str.size());
+                WriteBytes(str.data(), str.size());
+            }
+
+            void WriteBytes(const void* data, size_t size)
+            {
+                const uint8* bytes = static_cast<const uint8*>(data);
+                m_data.insert(m_data.end(), bytes, bytes + size);
+            }
+
+            template <typename T>
+            void WriteVec(const LINAGX_VEC<T>& vec)
+            {
+                WriteSize(vec.size());
+                for (const T& v : vec)
+                    Write(v);
+            }
+
+            template <typename A, typename B>
+            void WritePairVec(const LINAGX_VEC<LINAGX_PAIR<A, B>>& vec)
+            {
+                WriteSize(vec.size());
+                for (const auto& [a, b] : vec)
+                {
+                    Write(a);
+                    Write(b);
+                }
+            }
+
+        private:
+            LINAGX_VEC<uint8>& m_data;
+        };
+
+        class CacheReader
+        {
+        public:
+            CacheReader(const uint8* data, size_t size, size_t offset)
+                : m_data(data), m_size(size), m_offset(offset){};
+
+            template <typename T>
+            void Read(T& value)
+            {
+                uint32 widened = 0;
+                ReadBytes(&widened, sizeof(uint32));
+                value = static_cast<T>(widened);
+            }
+
+            void Read(uint64& value)
+            {
+                ReadBytes(&value, sizeof(uint64));
+            }
+
+            void ReadSize(size_t& value)
+            {
+                uint64 v = 0;
+                Read(v);
+                value = static_cast<size_t>(v);
+            }
+
+            void Read(LINAGX_STRING& str)
+            {
+                size_t size = 0;
+                ReadSize(size);
+                if (!Has(size))
+                    return;
+
+                str.assign(reinterpret_cast<const char*>(m_data + m_offset), size);
+                m_offset += size;
+            }
+
+            void ReadBytes(void* out, size_t size)
+            {
+                if (!Has(size))
+                    return;
+
+                LINAGX_MEMCPY(out, m_data + m_offset, size);
+                m_offset += size;
+            }
+
+            template <typename T>
+            void ReadVec(LINAGX_VEC<T>& vec)
+            {
+                size_t count = 0;
+                ReadSize(count);
+                if (!Has(count))
+                    return;
+
+                vec.resize(count);
+                for (T& v : vec)
+                    Read(v);
+            }
+
+            template <typename A, typename B>
+            void ReadPairVec(LINAGX_VEC<LINAGX_PAIR<A, B>>& vec)
+            {
+                size_t count = 0;
+                ReadSize(count);
+                if (!Has(count))
+                    return;
+
+                vec.resize(count);
+                for (auto& [a, b] : vec)
+                {
+                    Read(a);
+                    Read(b);
+                }
+            }
+
+            // Every element takes at least a byte, so comparing element counts against the remaining size also rejects corrupt counts.
+            bool Has(size_t size)
+            {
+                if (m_failed || size > m_size - m_offset)
+                    m_failed = true;
+
+                return !m_failed;
+            }
+
+            inline bool Failed() const
+            {
+                return m_failed;
+            }
+
+            inline size_t GetOffset() const
+            {
+                return m_offset;
+            }
+
+        private:
+            const uint8* m_data   = nullptr;
+            size_t       m_size   = 0;
+            size_t       m_offset = 0;
+            bool         m_failed = false;
+        };
+
+        void WriteMember(CacheWriter& w, const ShaderStructMember& m)
+        {
+            w.Write(m.type);
+            w.WriteSize(m.size);
+            w.WriteSize(m.offset);
+            w.WriteSize(m.alignment);
+            w.Write(m.name);
+            w.Write(m.elementSize);
+            w.WriteSize(m.arrayStride);
+            w.WriteSize(m.matrixStride);
+        }
+
+        void ReadMember(CacheReader& r, ShaderStructMember& m)
+        {
+            r.Read(m.type);
+            r.ReadSize(m.size);
+            r.ReadSize(m.offset);
+            r.ReadSize(m.alignment);
+            r.Read(m.name);
+            r.Read(m.elementSize);
+            r.ReadSize(m.arrayStride);
+            r.ReadSize(m.matrixStride);
+        }
+
+        void WriteMembers(CacheWriter& w, const LINAGX_VEC<ShaderStructMember>& members)
+        {
+            w.WriteSize(members.size());
+            for (const auto& m : members)
+                WriteMember(w, m);
+        }
+
+        void ReadMembers(CacheReader& r, LINAGX_VEC<ShaderStructMember>& members)
+        {
+            size_t count = 0;
+            r.ReadSize(count);
+            if (!r.Has(count))
+                return;
+
+            members.resize(count);
+            for (auto& m : members)
+                ReadMember(r, m);
+        }
+    } // namespace
+
+    uint64 ShaderCache::ComputeKey(const LINAGX_VEC<ShaderCompileData>& compileData, BackendAPI targetAPI)
+    {
+        uint64 hash = FNV64_OFFSET_BASIS;
+
+        const uint32 header[3] = {SHADER_CACHE_VERSION, static_cast<uint32>(targetAPI), static_cast<uint32>(Config.enableShaderDebugInformation)};
+        HashBytes(hash, header, sizeof(header));
+
+        LINAGX_STRING preprocessed = "";
+        for (const ShaderCompileData& data : compileData)
+        {
+            // Hash the text with includes resolved, so editing an included file invalidates the entry.
+            SPIRVUtility::GetShaderTextWithIncludes(preprocessed, data.text, data.includePath);
+
+            const uint32 stage = static_cast<uint32>(data.stage);
+            const uint64 size  = static_cast<uint64>(preprocessed.size());
+            HashBytes(hash, &stage, sizeof(uint32));
+            HashBytes(hash, &size, sizeof(uint64));
+            HashBytes(hash, preprocessed.data(), preprocessed.size());
+        }
+
+        return hash;
+    }
+
+    bool ShaderCache::Load(uint64 key, LINAGX_VEC<ShaderCompileData>& compileData, ShaderLayout& outLayout)
+    {
+        LINAGX_VEC<uint8> entry;
+
+        {
+            std::lock_guard<std::mutex> lock(s_mtx);
+            auto                        it = s_entries.find(key);
+            if (it != s_entries.end())
+                entry = it->second;
+        }
+
+        if (entry.empty() && Config.shaderCacheDirectory != nullptr)
+        {
+            std::ifstream file(GetEntryPath(key), std::ios::binary | std::ios::ate);
+            if (!file.is_open())
+                return false;
+
+            const std::streamsize size = file.tellg();
+            if (size <= 0)
+                return false;
+
+            entry.resize(static_cast<size_t>(size));
+            file.seekg(0, std::ios::beg);
+            if (!file.read(reinterpret_cast<char*>(entry.data()), size))
+                return false;
+        }
+
+        if (entry.empty())
+            return false;
+
+        CacheReader r(entry.data(), entry.size(), 0);
+
+        uint32 magic = 0, version = 0, stageCount = 0;
+        r.Read(magic);
+        r.Read(version);
+        r.Read(stageCount);
+
+        if (r.Failed() || magic != SHADER_CACHE_MAGIC || version != SHADER_CACHE_VERSION || stageCount != static_cast<uint32>(compileData.size()))
+        {
+            LOGE("ShaderCache -> Cache entry is not valid, shader will be recompiled.");
+            return false;
+        }
+
+        LINAGX_VEC<DataBlob> blobs;
+        blobs.resize(stageCount);
+
+        bool valid = true;
+        for (uint32 i = 0; i < stageCount && valid; i++)
+        {
+            ShaderStage stage = ShaderStage::Vertex;
+            size_t      size  = 0;
+            r.Read(stage);
+            r.ReadSize(size);
+
+            valid = !r.Failed() && stage == compileData[i].stage && r.Has(size);
+            if (!valid)
+                break;
+
+            blobs[i].ptr  = new uint8[size];
+            blobs[i].size = size;
+            r.ReadBytes(blobs[i].ptr, size);
+        }
+
+        size_t       offset = r.GetOffset();
+        ShaderLayout layout = {};
+        valid               = valid && DeserializeLayout(entry.data(), entry.size(), offset, layout);
+
+        if (!valid)
+        {
+            for (DataBlob& blob : blobs)
+                delete[] blob.ptr;
+
+            LOGE("ShaderCache -> Cache entry is not valid, shader will be recompiled.");
+            return false;
+        }
+
+        for (uint32 i = 0; i < stageCount; i++)
+            compileData[i].outBlob = blobs[i];
+
+        outLayout = layout;
+
+        // Promote disk hits to memory.
+        {
+            std::lock_guard<std::mutex> lock(s_mtx);
+            s_entries.try_emplace(key, std::move(entry));
+        }
+
+        return true;
+    }
+
+    void ShaderCache::Store(uint64 key, const LINAGX_VEC<ShaderCompileData>& compileData, const ShaderLayout& layout)
+    {
+        LINAGX_VEC<uint8> entry;
+        CacheWriter       w(entry);
+
+        w.Write(SHADER_CACHE_MAGIC);
+        w.Write(SHADER_CACHE_VERSION);
+        w.Write(static_cast<uint32>(compileData.size()));
+
+        for (const ShaderCompileData& data : compileData)
+        {
+            w.Write(data.stage);
+            w.WriteSize(data.outBlob.size);
+            w.WriteBytes(data.outBlob.ptr, data.outBlob.size);
+        }
+
+        SerializeLayout(layout, entry);
+
+        if (Config.shaderCacheDirectory != nullptr)
+        {
+            // Write to a temporary file first, so a concurrent or interrupted write never leaves a truncated entry behind.
+            const LINAGX_STRING path    = GetEntryPath(key);
+            const LINAGX_STRING tmpPath = path + ".tmp";
+
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            const bool    written = file.is_open() && file.write(reinterpret_cast<const char*>(entry.data()), static_cast<std::streamsize>(entry.size()));
+            file.close();
+
+            std::remove(path.c_str());
+            if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+            {
+                std::remove(tmpPath.c_str());
+                LOGE("ShaderCache -> Failed writing cache entry %s", path.c_str());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(s_mtx);
+        s_entries[key] = std::move(entry);
+    }
+
+    void ShaderCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mtx);
+        s_entries.clear();
+    }
+
+    void ShaderCache::SerializeLayout(const ShaderLayout& layout, LINAGX_VEC<uint8>& outData)
+    {
+        CacheWriter w(outData);
+
+        w.WriteSize(layout.vertexInputs.size());
+        for (const auto& input : layout.vertexInputs)
+        {
+            w.Write(input.name);
+            w.Write(input.location);
+            w.Write(input.elements);
+            w.WriteSize(input.size);
+            w.Write(input.format);
+            w.WriteSize(input.offset);
+        }
+
+        w.WriteSize(layout.descriptorSetLayouts.size());
+        for (const auto& setLayout : layout.descriptorSetLayouts)
+        {
+            w.WriteSize(setLayout.bindings.size());
+            for (const auto& binding : setLayout.bindings)
+            {
+                w.Write(binding.type);
+                w.Write(binding.name);
+                w.WriteVec(binding.stages);
+                WriteMembers(w, binding.structMembers);
+                w.WritePairVec(binding.isActive);
+                w.WritePairVec(binding.mslBufferID);
+                w.Write(binding.spvID);
+                w.Write(binding.binding);
+                w.Write(binding.descriptorCount);
+                w.WriteSize(binding.size);
+                w.Write(binding.isWritable);
+                w.Write(binding.isArrayType);
+            }
+        }
+
+        w.WriteSize(layout.constants.size());
+        for (const auto& ct : layout.constants)
+        {
+            w.WriteSize(ct.size);
+            w.Write(ct.set);
+            w.Write(ct.binding);
+            WriteMembers(w, ct.members);
+            w.WriteVec(ct.stages);
+            w.Write(ct.name);
+            w.WritePairVec(ct.isActive);
+        }
+
+        w.WritePairVec(layout.constantsMSLBuffers);
+        w.WritePairVec(layout.entryPoints);
+        w.WritePairVec(layout.mslMaxBufferIDs);
+        w.Write(layout.constantsSet);
+        w.Write(layout.constantsBinding);
+        w.Write(layout.totalDescriptors);
+        w.Write(layout.hasGLDrawID);
+        w.Write(layout.drawIDBinding);
+    }
+
+    bool ShaderCache::DeserializeLayout(const uint8* data, size_t size, size_t& offset, ShaderLayout& outLayout)
+    {
+        CacheReader r(data, size, offset);
+
+        size_t inputCount = 0;
+        r.ReadSize(inputCount);
+        if (!r.Has(inputCount))
+            return false;
+
+        outLayout.vertexInputs.resize(inputCount);
+        for (auto& input : outLayout.vertexInputs)
+        {
+            r.Read(input.name);
+            r.Read(input.location);
+            r.Read(input.elements);
+            r.ReadSize(input.size);
+            r.Read(input.format);
+            r.ReadSize(input.offset);
+        }
+
+        size_t setCount = 0;
+        r.ReadSize(setCount);
+        if (!r.Has(setCount))
+            return false;
+
+        outLayout.descriptorSetLayouts.resize(setCount);
+        for (auto& setLayout : outLayout.descriptorSetLayouts)
+        {
+            size_t bindingCount = 0;
+            r.ReadSize(bindingCount);
+            if (!r.Has(bindingCount))
+                return false;
+
+            setLayout.bindings.resize(bindingCount);
+            for (auto& binding : setLayout.bindings)
+            {
+                r.Read(binding.type);
+                r.Read(binding.name);
+                r.ReadVec(binding.stages);
+                ReadMembers(r, binding.structMembers);
+                r.ReadPairVec(binding.isActive);
+                r.ReadPairVec(binding.mslBufferID);
+                r.Read(binding.spvID);
+                r.Read(binding.binding);
+                r.Read(binding.descriptorCount);
+                r.ReadSize(binding.size);
+                r.Read(binding.isWritable);
+                r.Read(binding.isArrayType);
+            }
+        }
+
+        size_t constantCount = 0;
+        r.ReadSize(constantCount);
+        if (!r.Has(constantCount))
+            return false;
+
+        outLayout.constants.resize(constantCount);
+        for (auto& ct : outLayout.constants)
+        {
+            r.ReadSize(ct.size);
+            r.Read(ct.set);
+            r.Read(ct.binding);
+            ReadMembers(r, ct.members);
+            r.ReadVec(ct.stages);
+            r.Read(ct.name);
+            r.ReadPairVec(ct.isActive);
+        }
+
+        r.ReadPairVec(outLayout.constantsMSLBuffers);
+        r.ReadPairVec(outLayout.entryPoints);
+        r.ReadPairVec(outLayout.mslMaxBufferIDs);
+        r.Read(outLayout.constantsSet);
+        r.Read(outLayout.constantsBinding);
+        r.Read(outLayout.totalDescriptors);
+        r.Read(outLayout.hasGLDrawID);
+        r.Read(outLayout.drawIDBinding);
+
+        offset = r.GetOffset();
+        return !r.Failed();
+    }
+
+    LINAGX_STRING ShaderCache::GetEntryPath(uint64 key)
+    {
+        char name[32] = {};
+        std::snprintf(name, sizeof(name), "%016llx.lgxshader", static_cast<unsigned long long>(key));
+        return LINAGX_STRING(Config.shaderCacheDirectory) + "/" + name;
+    }
+} // namespace LinaGX